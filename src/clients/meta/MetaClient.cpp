@@ -2465,6 +2465,15 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
     } else {
       req.disk_parts_ref() = diskParts;
     }
+
+    // the loads change all the time, they are reported by every heartbeat
+    std::unordered_map<GraphSpaceID, cpp2::PartLoadList> partLoads;
+    if (listener_ != nullptr) {
+      listener_->fetchPartLoads(partLoads);
+    }
+    if (!partLoads.empty()) {
+      req.part_loads_ref() = std::move(partLoads);
+    }
   }
 
   // info used in the agent, only set once
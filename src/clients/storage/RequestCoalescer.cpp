@@ -0,0 +1,78 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "clients/storage/RequestCoalescer.h"
+
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+DEFINE_bool(enable_storage_client_coalescing,
+            false,
+            "Whether to merge the concurrent GetNeighbors/GetProp requests to the same storaged");
+DEFINE_int32(storage_client_coalesce_window_ms,
+             0,
+             "The window to wait for the requests to merge, 0 means only the requests sent in "
+             "the same loop of io thread are merged");
+DEFINE_int32(storage_client_coalesce_max_rows,
+             1024,
+             "The merged request is sent at once when it has so many rows");
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+bool profiling(const apache::thrift::optional_field_ref<const cpp2::RequestCommon&> common) {
+  return common.has_value() && common->profile_detail_ref().value_or(false);
+}
+
+}  // namespace
+
+std::string GetNeighborsCoalescer::signature(const cpp2::GetNeighborsRequest& req) const {
+  const auto& spec = req.get_traverse_spec();
+  // The vertices expanded locally are not the input vertices, the groups aggregated are not
+  // split by vertex, and the top N edges of a vertex depend on the other vertices
+  if (profiling(req.common_ref()) || spec.local_steps_ref().value_or(0) > 0 ||
+      spec.aggregate_ref().has_value() ||
+      (spec.order_by_ref().has_value() && !spec.order_by_ref()->empty())) {
+    return "";
+  }
+  std::string sig;
+  apache::thrift::CompactSerializer::serialize(spec, &sig);
+  auto spaceId = req.get_space_id();
+  sig.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+  for (const auto& name : req.get_column_names()) {
+    sig.append(name).append(1, '\0');
+  }
+  return sig;
+}
+
+std::string GetPropCoalescer::signature(const cpp2::GetPropRequest& req) const {
+  // Only the vertex props are returned by rows keyed by vertex id, and the order and limit are
+  // applied on all rows
+  if (profiling(req.common_ref()) || req.edge_props_ref().has_value() ||
+      (req.order_by_ref().has_value() && !req.order_by_ref()->empty()) ||
+      req.limit_ref().value_or(std::numeric_limits<int64_t>::max()) <
+          std::numeric_limits<int64_t>::max()) {
+    return "";
+  }
+  cpp2::GetPropRequest sigReq;
+  sigReq.space_id_ref() = req.get_space_id();
+  if (req.vertex_props_ref().has_value()) {
+    sigReq.vertex_props_ref() = *req.vertex_props_ref();
+  }
+  if (req.expressions_ref().has_value()) {
+    sigReq.expressions_ref() = *req.expressions_ref();
+  }
+  sigReq.dedup_ref() = req.get_dedup();
+  if (req.filter_ref().has_value()) {
+    sigReq.filter_ref() = *req.filter_ref();
+  }
+  std::string sig;
+  apache::thrift::CompactSerializer::serialize(sigReq, &sig);
+  return sig;
+}
+
+}  // namespace storage
+}  // namespace nebula
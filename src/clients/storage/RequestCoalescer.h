@@ -0,0 +1,270 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CLIENTS_STORAGE_REQUESTCOALESCER_H_
+#define CLIENTS_STORAGE_REQUESTCOALESCER_H_
+
+#include <folly/ThreadLocal.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
+
+#include "clients/storage/stats/StorageClientStats.h"
+#include "common/base/Base.h"
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/HostAddr.h"
+#include "common/stats/StatsManager.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+DECLARE_bool(enable_storage_client_coalescing);
+DECLARE_int32(storage_client_coalesce_window_ms);
+DECLARE_int32(storage_client_coalesce_max_rows);
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Send a request to the host by the send function, the implementation decides how to send it.
+ * The interface does not depend on the request type, so it could be used by all kinds of requests.
+ */
+template <class Request, class Response>
+class RequestSender {
+ public:
+  using SendFunc = std::function<folly::Future<Response>(const Request&)>;
+
+  virtual ~RequestSender() = default;
+
+  /**
+   * @brief Must be called in the thread of evb, and req must be kept until the response is
+   * returned.
+   */
+  virtual folly::Future<Response> submit(folly::EventBase* evb,
+                                         const HostAddr& host,
+                                         const Request& req,
+                                         SendFunc send) = 0;
+};
+
+/**
+ * Merge the concurrent read requests to the same host into one rpc, and split the response back
+ * to each caller. Requests could be merged only if they are the same except the vertices to read,
+ * the rows of merged request are deduplicated by vertex id in each part, and each caller gets the
+ * result rows of its own vertices.
+ *
+ * The requests are merged on the io thread which sends them, within one loop of the event base
+ * or the window of storage_client_coalesce_window_ms. So the batches are thread local and need no
+ * lock, and the merged rpc is sent over the client of that thread, which pipelines the rpcs of
+ * all batches on the same connection.
+ */
+template <class Request, class Response>
+class RequestCoalescer : public RequestSender<Request, Response> {
+ public:
+  using SendFunc = typename RequestSender<Request, Response>::SendFunc;
+
+  folly::Future<Response> submit(folly::EventBase* evb,
+                                 const HostAddr& host,
+                                 const Request& req,
+                                 SendFunc send) override {
+    auto sig = signature(req);
+    if (sig.empty()) {
+      return send(req);
+    }
+    auto& batches = (*batches_)[host];
+    auto it = batches.find(sig);
+    bool newBatch = it == batches.end();
+    if (newBatch) {
+      auto batch = std::make_shared<Batch>();
+      batch->merged = req;
+      batch->merged.parts_ref()->clear();
+      // The merged request does not belong to any single query
+      batch->merged.common_ref().reset();
+      batch->send = std::move(send);
+      it = batches.emplace(sig, std::move(batch)).first;
+    }
+    auto batch = it->second;
+    for (const auto& [partId, rows] : req.get_parts()) {
+      auto& mergedRows = (*batch->merged.parts_ref())[partId];
+      auto& vids = batch->vids[partId];
+      for (const auto& row : rows) {
+        if (!row.values.empty() && vids.emplace(row.values.front()).second) {
+          mergedRows.emplace_back(row);
+          batch->rows++;
+        }
+      }
+    }
+    batch->callers.emplace_back();
+    batch->callers.back().req = &req;
+    auto future = batch->callers.back().promise.getFuture();
+    if (batch->rows >= static_cast<size_t>(FLAGS_storage_client_coalesce_max_rows)) {
+      flush(host, sig, batch);
+    } else if (newBatch) {
+      auto cb = [this, host, sig, batch]() { flush(host, sig, batch); };
+      if (FLAGS_storage_client_coalesce_window_ms > 0) {
+        evb->runAfterDelay(std::move(cb), FLAGS_storage_client_coalesce_window_ms);
+      } else {
+        evb->runInLoop(std::move(cb));
+      }
+    }
+    return future;
+  }
+
+ protected:
+  /**
+   * @brief All fields of the request except the vertices to read, requests are merged only if
+   * their signatures are the same. Empty if the request could not be merged.
+   */
+  virtual std::string signature(const Request& req) const = 0;
+
+  // Whether each vertex is returned only once
+  virtual bool dedup(const Request& req) const = 0;
+
+  virtual const DataSet* dataSet(const Response& resp) const = 0;
+
+  virtual void setDataSet(Response& resp, DataSet&& ds) const = 0;
+
+ private:
+  struct Caller {
+    // Owned by the caller until the response is returned
+    const Request* req;
+    folly::Promise<Response> promise;
+  };
+
+  struct Batch {
+    Request merged;
+    // vertex ids in the merged request of each part
+    std::unordered_map<PartitionID, std::unordered_set<Value>> vids;
+    size_t rows{0};
+    std::vector<Caller> callers;
+    SendFunc send;
+    bool flushed{false};
+  };
+
+  void flush(const HostAddr& host, const std::string& sig, std::shared_ptr<Batch> batch) {
+    if (batch->flushed) {
+      return;
+    }
+    batch->flushed = true;
+    auto& batches = (*batches_)[host];
+    auto it = batches.find(sig);
+    if (it != batches.end() && it->second == batch) {
+      batches.erase(it);
+    }
+    if (batch->callers.size() == 1) {
+      auto& caller = batch->callers.front();
+      batch->send(*caller.req).thenTry([batch](folly::Try<Response>&& t) {
+        batch->callers.front().promise.setTry(std::move(t));
+      });
+      return;
+    }
+    stats::StatsManager::addValue(kNumRpcCoalescedToStoraged, batch->callers.size() - 1);
+    batch->send(batch->merged).thenTry([this, batch](folly::Try<Response>&& t) {
+      if (t.hasException()) {
+        for (auto& caller : batch->callers) {
+          caller.promise.setException(t.exception());
+        }
+        return;
+      }
+      const auto& merged = t.value();
+      const auto* ds = dataSet(merged);
+      std::unordered_map<Value, size_t> index;
+      if (ds != nullptr) {
+        index.reserve(ds->rows.size());
+        for (size_t i = 0; i < ds->rows.size(); ++i) {
+          if (!ds->rows[i].values.empty()) {
+            index.emplace(ds->rows[i].values.front(), i);
+          }
+        }
+      }
+      for (auto& caller : batch->callers) {
+        caller.promise.setValue(split(merged, ds, index, *caller.req));
+      }
+    });
+  }
+
+  Response split(const Response& merged,
+                 const DataSet* ds,
+                 const std::unordered_map<Value, size_t>& index,
+                 const Request& req) const {
+    Response resp;
+    auto result = merged.get_result();
+    auto& failedParts = *result.failed_parts_ref();
+    failedParts.erase(std::remove_if(failedParts.begin(),
+                                     failedParts.end(),
+                                     [&req](const auto& code) {
+                                       return req.get_parts().count(code.get_part_id()) == 0;
+                                     }),
+                      failedParts.end());
+    resp.result_ref() = std::move(result);
+    if (ds == nullptr) {
+      return resp;
+    }
+    DataSet out;
+    out.colNames = ds->colNames;
+    std::unordered_set<Value> seen;
+    bool needDedup = dedup(req);
+    for (const auto& [partId, rows] : req.get_parts()) {
+      for (const auto& row : rows) {
+        if (row.values.empty()) {
+          continue;
+        }
+        const auto& vid = row.values.front();
+        if (needDedup && !seen.emplace(vid).second) {
+          continue;
+        }
+        auto found = index.find(vid);
+        if (found != index.end()) {
+          out.rows.emplace_back(ds->rows[found->second]);
+        }
+      }
+    }
+    setDataSet(resp, std::move(out));
+    return resp;
+  }
+
+ private:
+  // host => signature => batch, of the current io thread
+  folly::ThreadLocal<
+      std::unordered_map<HostAddr, std::unordered_map<std::string, std::shared_ptr<Batch>>>>
+      batches_;
+};
+
+class GetNeighborsCoalescer final
+    : public RequestCoalescer<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse> {
+ protected:
+  std::string signature(const cpp2::GetNeighborsRequest& req) const override;
+
+  bool dedup(const cpp2::GetNeighborsRequest&) const override {
+    return false;
+  }
+
+  const DataSet* dataSet(const cpp2::GetNeighborsResponse& resp) const override {
+    return resp.get_vertices();
+  }
+
+  void setDataSet(cpp2::GetNeighborsResponse& resp, DataSet&& ds) const override {
+    resp.vertices_ref() = std::move(ds);
+  }
+};
+
+class GetPropCoalescer final
+    : public RequestCoalescer<cpp2::GetPropRequest, cpp2::GetPropResponse> {
+ protected:
+  std::string signature(const cpp2::GetPropRequest& req) const override;
+
+  bool dedup(const cpp2::GetPropRequest& req) const override {
+    return req.get_dedup();
+  }
+
+  const DataSet* dataSet(const cpp2::GetPropResponse& resp) const override {
+    return resp.get_props();
+  }
+
+  void setDataSet(cpp2::GetPropResponse& resp, DataSet&& ds) const override {
+    resp.props_ref() = std::move(ds);
+  }
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // CLIENTS_STORAGE_REQUESTCOALESCER_H_
@@ -50,7 +50,9 @@ StorageRpcRespFuture<cpp2::GetNeighborsResponse> StorageClient::getNeighbors(
     bool random,
     const std::vector<cpp2::OrderBy>& orderBy,
     int64_t limit,
-    const Expression* filter) {
+    const Expression* filter,
+    int32_t localSteps,
+    const cpp2::AggregateSpec* aggregate) {
   auto cbStatus = getIdFromRow(param.space, false);
   if (!cbStatus.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::GetNeighborsResponse>>(
@@ -97,14 +99,22 @@ StorageRpcRespFuture<cpp2::GetNeighborsResponse> StorageClient::getNeighbors(
     if (filter != nullptr) {
       spec.filter_ref() = filter->encode();
     }
+    if (localSteps > 0) {
+      spec.local_steps_ref() = localSteps;
+    }
+    if (aggregate != nullptr) {
+      spec.aggregate_ref() = *aggregate;
+    }
     req.traverse_spec_ref() = std::move(spec);
   }
 
-  return collectResponse(param.evb,
-                         std::move(requests),
-                         [](ThriftClientType* client, const cpp2::GetNeighborsRequest& r) {
-                           return client->future_getNeighbors(r);
-                         });
+  return collectResponse(
+      param.evb,
+      std::move(requests),
+      [](ThriftClientType* client, const cpp2::GetNeighborsRequest& r) {
+        return client->future_getNeighbors(r);
+      },
+      FLAGS_enable_storage_client_coalescing ? &getNeighborsCoalescer_ : nullptr);
 }
 
 StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::addVertices(
@@ -236,9 +246,12 @@ StorageRpcRespFuture<cpp2::GetPropResponse> StorageClient::getProps(
   }
 
   return collectResponse(
-      param.evb, std::move(requests), [](ThriftClientType* client, const cpp2::GetPropRequest& r) {
+      param.evb,
+      std::move(requests),
+      [](ThriftClientType* client, const cpp2::GetPropRequest& r) {
         return client->future_getProps(r);
-      });
+      },
+      FLAGS_enable_storage_client_coalescing ? &getPropCoalescer_ : nullptr);
 }
 
 StorageRpcRespFuture<cpp2::ExecResponse> StorageClient::deleteEdges(
@@ -486,7 +499,8 @@ StorageRpcRespFuture<cpp2::LookupIndexResp> StorageClient::lookupIndex(
     int32_t tagOrEdge,
     const std::vector<std::string>& returnCols,
     std::vector<storage::cpp2::OrderBy> orderBy,
-    int64_t limit) {
+    int64_t limit,
+    const cpp2::AggregateSpec* aggregate) {
   // TODO(sky) : instead of isEdge and tagOrEdge to nebula::cpp2::SchemaID for graph layer.
   auto space = param.space;
   auto status = getHostParts(space);
@@ -518,6 +532,9 @@ StorageRpcRespFuture<cpp2::LookupIndexResp> StorageClient::lookupIndex(
     req.common_ref() = common;
     req.limit_ref() = limit;
     req.order_by_ref() = orderBy;
+    if (aggregate != nullptr) {
+      req.aggregate_ref() = *aggregate;
+    }
   }
 
   return collectResponse(param.evb,
@@ -560,9 +577,11 @@ StorageRpcRespFuture<cpp2::ScanResponse> StorageClient::scanEdge(
     const CommonRequestParam& param,
     const std::vector<cpp2::EdgeProp>& edgeProp,
     int64_t limit,
-    const Expression* filter) {
+    const Expression* filter,
+    const std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
+    bool enableSnapshot) {
   std::unordered_map<HostAddr, cpp2::ScanEdgeRequest> requests;
-  auto status = getHostPartsWithCursor(param.space);
+  auto status = getHostPartsWithCursor(param.space, cursors);
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ScanResponse>>(
         std::runtime_error(status.status().toString()));
@@ -579,6 +598,7 @@ StorageRpcRespFuture<cpp2::ScanResponse> StorageClient::scanEdge(
       req.filter_ref() = filter->encode();
     }
     req.common_ref() = param.toReqCommon();
+    req.enable_snapshot_ref() = enableSnapshot;
   }
 
   return collectResponse(
@@ -591,9 +611,11 @@ StorageRpcRespFuture<cpp2::ScanResponse> StorageClient::scanVertex(
     const CommonRequestParam& param,
     const std::vector<cpp2::VertexProp>& vertexProp,
     int64_t limit,
-    const Expression* filter) {
+    const Expression* filter,
+    const std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
+    bool enableSnapshot) {
   std::unordered_map<HostAddr, cpp2::ScanVertexRequest> requests;
-  auto status = getHostPartsWithCursor(param.space);
+  auto status = getHostPartsWithCursor(param.space, cursors);
   if (!status.ok()) {
     return folly::makeFuture<StorageRpcResponse<cpp2::ScanResponse>>(
         std::runtime_error(status.status().toString()));
@@ -610,6 +632,7 @@ StorageRpcRespFuture<cpp2::ScanResponse> StorageClient::scanVertex(
       req.filter_ref() = filter->encode();
     }
     req.common_ref() = param.toReqCommon();
+    req.enable_snapshot_ref() = enableSnapshot;
   }
 
   return collectResponse(param.evb,
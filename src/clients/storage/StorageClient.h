@@ -80,7 +80,11 @@ class StorageClient
       bool random = false,
       const std::vector<cpp2::OrderBy>& orderBy = std::vector<cpp2::OrderBy>(),
       int64_t limit = std::numeric_limits<int64_t>::max(),
-      const Expression* filter = nullptr);
+      const Expression* filter = nullptr,
+      // expand the neighbors in the same storage host for at most localSteps more steps
+      int32_t localSteps = 0,
+      // aggregate the edges in storage, which returns the partial groups instead of neighbors
+      const cpp2::AggregateSpec* aggregate = nullptr);
 
   StorageRpcRespFuture<cpp2::GetPropResponse> getProps(
       const CommonRequestParam& param,
@@ -143,21 +147,30 @@ class StorageClient
       int32_t tagOrEdge,
       const std::vector<std::string>& returnCols,
       std::vector<storage::cpp2::OrderBy> orderBy,
-      int64_t limit);
+      int64_t limit,
+      const cpp2::AggregateSpec* aggregate = nullptr);
 
   StorageRpcRespFuture<cpp2::GetNeighborsResponse> lookupAndTraverse(
       const CommonRequestParam& param, cpp2::IndexSpec indexSpec, cpp2::TraverseSpec traverseSpec);
 
-  StorageRpcRespFuture<cpp2::ScanResponse> scanEdge(const CommonRequestParam& param,
-                                                    const std::vector<cpp2::EdgeProp>& vertexProp,
-                                                    int64_t limit,
-                                                    const Expression* filter);
+  // Scan all parts from the beginning if cursors is null, otherwise continue the parts in cursors
+  // with the cursors returned by the previous page. With enableSnapshot, all pages of a part are
+  // read from the same snapshot as long as its cursor is passed back in time.
+  StorageRpcRespFuture<cpp2::ScanResponse> scanEdge(
+      const CommonRequestParam& param,
+      const std::vector<cpp2::EdgeProp>& vertexProp,
+      int64_t limit,
+      const Expression* filter,
+      const std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors = nullptr,
+      bool enableSnapshot = false);
 
   StorageRpcRespFuture<cpp2::ScanResponse> scanVertex(
       const CommonRequestParam& param,
       const std::vector<cpp2::VertexProp>& vertexProp,
       int64_t limit,
-      const Expression* filter);
+      const Expression* filter,
+      const std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors = nullptr,
+      bool enableSnapshot = false);
 
   folly::SemiFuture<StorageRpcResponse<cpp2::KVGetResponse>> get(GraphSpaceID space,
                                                                  std::vector<std::string>&& keys,
@@ -189,6 +202,9 @@ class StorageClient
 
   StatusOr<std::function<const VertexID&(const cpp2::DelTags&)>> getIdFromDelTags(
       GraphSpaceID space) const;
+
+  GetNeighborsCoalescer getNeighborsCoalescer_;
+  GetPropCoalescer getPropCoalescer_;
 };
 
 }  // namespace storage
@@ -119,7 +119,8 @@ folly::SemiFuture<StorageRpcResponse<Response>>
 StorageClientBase<ClientType, ClientManagerType>::collectResponse(
     folly::EventBase* evb,
     std::unordered_map<HostAddr, Request> requests,
-    RemoteFunc&& remoteFunc) {
+    RemoteFunc&& remoteFunc,
+    RequestSender<Request, Response>* coalescer) {
   using TransportException = apache::thrift::transport::TTransportException;
   auto context = std::make_shared<ResponseContext<Request, RemoteFunc, Response>>(
       requests.size(), std::move(remoteFunc));
@@ -133,12 +134,16 @@ StorageClientBase<ClientType, ClientManagerType>::collectResponse(
     DCHECK(res.second);
     evb = ioThreadPool_->getEventBase();
     // Invoke the remote method
-    folly::via(evb, [this, evb, context, host, spaceId, res]() mutable {
+    folly::via(evb, [this, evb, context, host, spaceId, res, coalescer]() mutable {
       auto client = clientsMan_->client(host, evb, false, FLAGS_storage_client_timeout_ms);
       // Result is a pair of <Request&, bool>
       auto start = time::WallClock::fastNowInMicroSec();
-      context
-          ->serverMethod(client.get(), *res.first)
+      auto future = coalescer == nullptr
+                        ? context->serverMethod(client.get(), *res.first)
+                        : coalescer->submit(evb, host, *res.first, [context, client](auto& r) {
+                            return context->serverMethod(client.get(), r);
+                          });
+      std::move(future)
           // Future process code will be executed on the IO thread
           // Since all requests are sent using the same eventbase, all
           // then-callback will be executed on the same IO thread
@@ -358,14 +363,24 @@ StorageClientBase<ClientType, ClientManagerType>::getHostParts(GraphSpaceID spac
 template <typename ClientType, typename ClientManagerType>
 StatusOr<std::unordered_map<HostAddr, std::unordered_map<PartitionID, cpp2::ScanCursor>>>
 StorageClientBase<ClientType, ClientManagerType>::getHostPartsWithCursor(
-    GraphSpaceID spaceId) const {
+    GraphSpaceID spaceId, const std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors) const {
   std::unordered_map<HostAddr, std::unordered_map<PartitionID, cpp2::ScanCursor>> hostParts;
   auto status = metaClient_->partsNum(spaceId);
   if (!status.ok()) {
     return Status::Error("Space not found, spaceid: %d", spaceId);
   }
 
-  // TODO support cursor
+  if (cursors != nullptr) {
+    for (const auto& [partId, cursor] : *cursors) {
+      auto leader = getLeader(spaceId, partId);
+      if (!leader.ok()) {
+        return leader.status();
+      }
+      hostParts[leader.value()].emplace(partId, cursor);
+    }
+    return hostParts;
+  }
+
   cpp2::ScanCursor c;
   auto parts = status.value();
   for (auto partId = 1; partId <= parts; partId++) {
@@ -10,6 +10,7 @@
 #include <folly/futures/Future.h>
 
 #include "clients/meta/MetaClient.h"
+#include "clients/storage/RequestCoalescer.h"
 #include "common/base/Base.h"
 #include "common/base/StatusOr.h"
 #include "common/meta/Common.h"
@@ -130,6 +131,8 @@ class StorageClientBase {
   void invalidLeader(GraphSpaceID spaceId, PartitionID partId);
   void invalidLeader(GraphSpaceID spaceId, std::vector<PartitionID>& partsId);
 
+  // The requests are sent by coalescer if it is not null, which may merge them with the
+  // concurrent requests to the same host
   template <class Request,
             class RemoteFunc,
             class Response =
@@ -137,7 +140,8 @@ class StorageClientBase {
   folly::SemiFuture<StorageRpcResponse<Response>> collectResponse(
       folly::EventBase* evb,
       std::unordered_map<HostAddr, Request> requests,
-      RemoteFunc&& remoteFunc);
+      RemoteFunc&& remoteFunc,
+      RequestSender<Request, Response>* coalescer = nullptr);
 
   template <class Request,
             class RemoteFunc,
@@ -166,8 +170,11 @@ class StorageClientBase {
       std::unordered_map<PartitionID, std::vector<typename Container::value_type>>>>
   clusterIdsToHosts(GraphSpaceID spaceId, const Container& ids, GetIdFunc f) const;
 
+  // All parts from the beginning if cursors is null, otherwise only the parts in cursors
   StatusOr<std::unordered_map<HostAddr, std::unordered_map<PartitionID, cpp2::ScanCursor>>>
-  getHostPartsWithCursor(GraphSpaceID spaceId) const;
+  getHostPartsWithCursor(
+      GraphSpaceID spaceId,
+      const std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors = nullptr) const;
 
   virtual StatusOr<meta::PartHosts> getPartHosts(GraphSpaceID spaceId, PartitionID partId) const {
     CHECK(metaClient_ != nullptr);
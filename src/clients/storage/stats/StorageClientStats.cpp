@@ -9,12 +9,15 @@ namespace nebula {
 
 stats::CounterId kNumRpcSentToStoraged;
 stats::CounterId kNumRpcSentToStoragedFailed;
+stats::CounterId kNumRpcCoalescedToStoraged;
 
 void initStorageClientStats() {
   kNumRpcSentToStoraged =
       stats::StatsManager::registerStats("num_rpc_sent_to_storaged", "rate, sum");
   kNumRpcSentToStoragedFailed =
       stats::StatsManager::registerStats("num_rpc_sent_to_storaged_failed", "rate, sum");
+  kNumRpcCoalescedToStoraged =
+      stats::StatsManager::registerStats("num_rpc_coalesced_to_storaged", "rate, sum");
 }
 
 }  // namespace nebula
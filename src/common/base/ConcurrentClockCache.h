@@ -0,0 +1,286 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_BASE_CONCURRENTCLOCKCACHE_H_
+#define COMMON_BASE_CONCURRENTCLOCKCACHE_H_
+
+#include <folly/concurrency/ConcurrentHashMap.h>
+
+#include <list>
+
+#include "common/base/Base.h"
+#include "common/base/StatusOr.h"
+#include "common/stats/StatsManager.h"
+
+namespace nebula {
+
+/**
+ * A cache for read heavy workloads, e.g. the caches of vertices, neighbors and schemas.
+ *
+ * Compared to ConcurrentLRUCache, reading never takes a lock: the entries are looked up in a
+ * folly::ConcurrentHashMap, and the recency is kept by a reference bit set on hit instead of
+ * moving the entry in a list. The entries are evicted by the CLOCK algorithm, i.e. the hand
+ * sweeps the entries of shard and evicts the first one not referenced since the last sweep,
+ * which is done while inserting under the lock of shard.
+ *
+ * The capacity is the total charge of the entries, which is given by the caller on insert and is
+ * usually the estimated bytes of the entry, so the memory held by the cache is bounded. If the
+ * name is given, the hits, misses and evicts are exported by StatsManager as "<name>_cache_hits",
+ * "<name>_cache_misses" and "<name>_cache_evicts".
+ */
+template <typename K, typename V>
+class ConcurrentClockCache final {
+ public:
+  explicit ConcurrentClockCache(size_t capacity,
+                                uint32_t shardsExp = 4,
+                                const std::string& name = "")
+      : shardsMask_((1 << shardsExp) - 1) {
+    CHECK_GT(capacity, shardsMask_);
+    if (!name.empty()) {
+      hitsId_ = stats::StatsManager::registerStats(name + "_cache_hits", "rate, sum");
+      missesId_ = stats::StatsManager::registerStats(name + "_cache_misses", "rate, sum");
+      evictsId_ = stats::StatsManager::registerStats(name + "_cache_evicts", "rate, sum");
+    }
+    auto shardsNum = shardsMask_ + 1;
+    auto capPerShard = capacity / shardsNum;
+    shards_.reserve(shardsNum);
+    for (size_t i = 0; i < shardsNum; i++) {
+      auto cap = i == shardsNum - 1 ? capacity - capPerShard * (shardsNum - 1) : capPerShard;
+      shards_.emplace_back(std::make_unique<Shard>(this, cap));
+    }
+  }
+
+  bool contains(const K& key) const {
+    return shard(key).map.find(key) != shard(key).map.cend();
+  }
+
+  StatusOr<V> get(const K& key) {
+    auto& s = shard(key);
+    auto it = s.map.find(key);
+    if (it == s.map.cend()) {
+      s.addStats(s.pendingMisses, missesId_, misses_);
+      return Status::Error();
+    }
+    const auto& entry = it->second;
+    // Avoid writing the shared cache line if it is set already
+    if (!entry->referenced.load(std::memory_order_relaxed)) {
+      entry->referenced.store(true, std::memory_order_relaxed);
+    }
+    s.addStats(s.pendingHits, hitsId_, hits_);
+    return entry->value;
+  }
+
+  /**
+   * @brief Insert or overwrite the entry, which is not inserted if the charge exceeds the
+   * capacity of shard
+   */
+  void insert(K key, V val, size_t charge) {
+    shard(key).insert(std::move(key), std::move(val), charge);
+  }
+
+  void evict(const K& key) {
+    shard(key).evict(key);
+  }
+
+  void clear() {
+    for (auto& s : shards_) {
+      s->clear();
+    }
+  }
+
+  // The total charge of the entries
+  size_t usage() const {
+    size_t usage = 0;
+    for (const auto& s : shards_) {
+      usage += s->usage.load(std::memory_order_relaxed);
+    }
+    return usage;
+  }
+
+  size_t size() const {
+    size_t size = 0;
+    for (const auto& s : shards_) {
+      size += s->map.size();
+    }
+    return size;
+  }
+
+  uint64_t hits() const {
+    auto hits = hits_.load(std::memory_order_relaxed);
+    for (const auto& s : shards_) {
+      hits += s->pendingHits.load(std::memory_order_relaxed);
+    }
+    return hits;
+  }
+
+  uint64_t misses() const {
+    auto misses = misses_.load(std::memory_order_relaxed);
+    for (const auto& s : shards_) {
+      misses += s->pendingMisses.load(std::memory_order_relaxed);
+    }
+    return misses;
+  }
+
+  uint64_t evicts() const {
+    return evicts_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Flush the stats of shard to the totals and StatsManager every so many operations
+  static constexpr uint64_t kStatsBatch = 256;
+
+  struct Entry {
+    Entry(K k, V v, size_t c) : key(std::move(k)), value(std::move(v)), charge(c) {}
+
+    const K key;
+    const V value;
+    const size_t charge;
+    std::atomic<bool> referenced{false};
+    // Removed from map, and waiting for the hand to drop it from ring
+    bool removed{false};
+  };
+
+  struct Shard {
+    Shard(ConcurrentClockCache* c, size_t cap) : cache(c), capacity(cap) {}
+
+    void insert(K&& key, V&& val, size_t charge) {
+      if (charge > capacity) {
+        return;
+      }
+      auto entry = std::make_shared<Entry>(key, std::move(val), charge);
+      std::lock_guard<std::mutex> guard(lock);
+      auto it = map.find(key);
+      if (it != map.cend()) {
+        remove(it->second);
+      }
+      while (usage.load(std::memory_order_relaxed) + charge > capacity && !ring.empty()) {
+        sweep();
+      }
+      map.insert_or_assign(std::move(key), entry);
+      // Just behind the hand, so it is the last one to visit
+      ring.insert(hand, std::move(entry));
+      usage.fetch_add(charge, std::memory_order_relaxed);
+    }
+
+    void evict(const K& key) {
+      std::lock_guard<std::mutex> guard(lock);
+      auto it = map.find(key);
+      if (it != map.cend()) {
+        auto entry = it->second;
+        map.erase(key);
+        remove(entry);
+      }
+      // Drop the removed entries once they are the majority of ring
+      if (removed * 2 > ring.size()) {
+        for (auto iter = ring.begin(); iter != ring.end();) {
+          if (!(*iter)->removed) {
+            ++iter;
+            continue;
+          }
+          bool atHand = iter == hand;
+          iter = ring.erase(iter);
+          if (atHand) {
+            hand = iter;
+          }
+        }
+        removed = 0;
+      }
+    }
+
+    void clear() {
+      std::lock_guard<std::mutex> guard(lock);
+      map.clear();
+      ring.clear();
+      hand = ring.end();
+      removed = 0;
+      usage.store(0, std::memory_order_relaxed);
+    }
+
+    // Must be called with lock held, the entry is dropped from ring by the hand later
+    void remove(const std::shared_ptr<Entry>& entry) {
+      if (!entry->removed) {
+        entry->removed = true;
+        removed++;
+        usage.fetch_sub(entry->charge, std::memory_order_relaxed);
+      }
+    }
+
+    // Must be called with lock held, move the hand by one entry
+    void sweep() {
+      if (hand == ring.end()) {
+        hand = ring.begin();
+      }
+      const auto& entry = *hand;
+      if (!entry->removed && entry->referenced.load(std::memory_order_relaxed)) {
+        // Give it a second chance
+        entry->referenced.store(false, std::memory_order_relaxed);
+        ++hand;
+        return;
+      }
+      if (entry->removed) {
+        removed--;
+      } else {
+        map.erase(entry->key);
+        usage.fetch_sub(entry->charge, std::memory_order_relaxed);
+        cache->addEvicts();
+      }
+      hand = ring.erase(hand);
+    }
+
+    void addStats(std::atomic<uint64_t>& pending,
+                  const folly::Optional<stats::CounterId>& id,
+                  std::atomic<uint64_t>& total) {
+      if (pending.fetch_add(1, std::memory_order_relaxed) + 1 < kStatsBatch) {
+        return;
+      }
+      auto delta = pending.exchange(0, std::memory_order_relaxed);
+      if (delta == 0) {
+        return;
+      }
+      total.fetch_add(delta, std::memory_order_relaxed);
+      if (id.has_value()) {
+        stats::StatsManager::addValue(*id, delta);
+      }
+    }
+
+    ConcurrentClockCache* cache;
+    const size_t capacity;
+    folly::ConcurrentHashMap<K, std::shared_ptr<Entry>> map;
+    std::atomic<size_t> usage{0};
+    std::atomic<uint64_t> pendingHits{0};
+    std::atomic<uint64_t> pendingMisses{0};
+
+    // Protect the writes of map and the ring
+    std::mutex lock;
+    std::list<std::shared_ptr<Entry>> ring;
+    typename std::list<std::shared_ptr<Entry>>::iterator hand{ring.end()};
+    size_t removed{0};
+  };
+
+  Shard& shard(const K& key) const {
+    return *shards_[std::hash<K>()(key) & shardsMask_];
+  }
+
+  void addEvicts() {
+    evicts_.fetch_add(1, std::memory_order_relaxed);
+    if (evictsId_.has_value()) {
+      stats::StatsManager::addValue(*evictsId_);
+    }
+  }
+
+  const size_t shardsMask_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  folly::Optional<stats::CounterId> hitsId_;
+  folly::Optional<stats::CounterId> missesId_;
+  folly::Optional<stats::CounterId> evictsId_;
+  // The hits and misses are flushed from shards in batch
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evicts_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_BASE_CONCURRENTCLOCKCACHE_H_
@@ -0,0 +1,659 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/base/Regex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace nebula {
+
+namespace {
+
+// The count of repetitions and the number of NFA states beyond which std::regex is used
+constexpr int32_t kMaxRepeat = 1000;
+constexpr size_t kMaxStates = 10000;
+
+using ByteClass = std::bitset<256>;
+
+struct Node {
+  enum class Type : uint8_t {
+    kClass,
+    kConcat,
+    kAlternate,
+    kRepeat,
+    kBegin,
+    kEnd,
+  };
+
+  explicit Node(Type t) : type(t) {}
+
+  Type type;
+  ByteClass cls;
+  std::vector<std::unique_ptr<Node>> children;
+  // The count of repetitions, max is -1 if unbounded
+  int32_t min{0};
+  int32_t max{0};
+};
+
+using NodePtr = std::unique_ptr<Node>;
+
+NodePtr makeClass(const ByteClass& cls) {
+  auto node = std::make_unique<Node>(Node::Type::kClass);
+  node->cls = cls;
+  return node;
+}
+
+ByteClass byteClass(uint8_t byte) {
+  ByteClass cls;
+  cls.set(byte);
+  return cls;
+}
+
+ByteClass rangeClass(uint8_t lo, uint8_t hi) {
+  ByteClass cls;
+  for (auto c = lo; c <= hi; ++c) {
+    cls.set(c);
+    if (c == hi) {
+      break;
+    }
+  }
+  return cls;
+}
+
+// The same as the classes of the "C" locale used by std::regex
+ByteClass digitClass() {
+  return rangeClass('0', '9');
+}
+
+ByteClass wordClass() {
+  return rangeClass('a', 'z') | rangeClass('A', 'Z') | digitClass() | byteClass('_');
+}
+
+ByteClass spaceClass() {
+  ByteClass cls;
+  for (auto c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+    cls.set(static_cast<uint8_t>(c));
+  }
+  return cls;
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+}  // namespace
+
+// Parse the pattern into a tree of nodes, and build the NFA from it. A pattern not supported is
+// reported by returning nullptr while parsing.
+class RegexCompiler final {
+ public:
+  RegexCompiler(const std::string& pattern, Regex* regex) : pattern_(pattern), regex_(regex) {}
+
+  // Return false if any feature of the pattern is not supported
+  bool compile() {
+    auto node = parseAlternate();
+    if (node == nullptr || pos_ != pattern_.size()) {
+      return false;
+    }
+    auto match = addState(Regex::State::Kind::kMatch);
+    auto start = build(node.get(), match);
+    if (states().size() > kMaxStates) {
+      return false;
+    }
+    regex_->start_ = start;
+    regex_->prefix_ = prefix(node.get());
+    return true;
+  }
+
+ private:
+  bool atEnd() const {
+    return pos_ >= pattern_.size();
+  }
+
+  bool consume(char c) {
+    if (!atEnd() && pattern_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  NodePtr parseAlternate() {
+    auto node = parseConcat();
+    if (node == nullptr || atEnd() || pattern_[pos_] != '|') {
+      return node;
+    }
+    auto alternate = std::make_unique<Node>(Node::Type::kAlternate);
+    alternate->children.emplace_back(std::move(node));
+    while (consume('|')) {
+      node = parseConcat();
+      if (node == nullptr) {
+        return nullptr;
+      }
+      alternate->children.emplace_back(std::move(node));
+    }
+    return alternate;
+  }
+
+  NodePtr parseConcat() {
+    auto concat = std::make_unique<Node>(Node::Type::kConcat);
+    while (!atEnd() && pattern_[pos_] != '|' && pattern_[pos_] != ')') {
+      auto node = parseRepeat();
+      if (node == nullptr) {
+        return nullptr;
+      }
+      concat->children.emplace_back(std::move(node));
+    }
+    return concat;
+  }
+
+  NodePtr parseRepeat() {
+    auto atom = parseAtom();
+    if (atom == nullptr || atEnd()) {
+      return atom;
+    }
+    int32_t min = 0;
+    int32_t max = -1;
+    switch (pattern_[pos_]) {
+      case '*':
+        ++pos_;
+        break;
+      case '+':
+        ++pos_;
+        min = 1;
+        break;
+      case '?':
+        ++pos_;
+        max = 1;
+        break;
+      case '{':
+        if (!parseCount(&min, &max)) {
+          return nullptr;
+        }
+        break;
+      default:
+        return atom;
+    }
+    // A lazy quantifier matches the same strings as the greedy one
+    consume('?');
+    if (!atEnd() && std::strchr("*+?{", pattern_[pos_]) != nullptr) {
+      return nullptr;
+    }
+    if (atom->type == Node::Type::kBegin || atom->type == Node::Type::kEnd) {
+      return nullptr;
+    }
+    auto repeat = std::make_unique<Node>(Node::Type::kRepeat);
+    repeat->min = min;
+    repeat->max = max;
+    repeat->children.emplace_back(std::move(atom));
+    return repeat;
+  }
+
+  // Parse `{n}`, `{n,}` or `{n,m}`
+  bool parseCount(int32_t* min, int32_t* max) {
+    ++pos_;
+    if (!parseNumber(min)) {
+      return false;
+    }
+    if (consume('}')) {
+      *max = *min;
+      return true;
+    }
+    if (!consume(',')) {
+      return false;
+    }
+    if (consume('}')) {
+      *max = -1;
+      return true;
+    }
+    return parseNumber(max) && consume('}') && *min <= *max;
+  }
+
+  bool parseNumber(int32_t* n) {
+    auto begin = pos_;
+    *n = 0;
+    while (!atEnd() && std::isdigit(static_cast<uint8_t>(pattern_[pos_]))) {
+      *n = *n * 10 + (pattern_[pos_++] - '0');
+      if (*n > kMaxRepeat) {
+        return false;
+      }
+    }
+    return pos_ > begin;
+  }
+
+  NodePtr parseAtom() {
+    auto c = pattern_[pos_];
+    switch (c) {
+      case '^':
+        ++pos_;
+        return std::make_unique<Node>(Node::Type::kBegin);
+      case '$':
+        ++pos_;
+        return std::make_unique<Node>(Node::Type::kEnd);
+      case '.': {
+        ++pos_;
+        ByteClass cls;
+        cls.set();
+        cls.reset('\n');
+        cls.reset('\r');
+        return makeClass(cls);
+      }
+      case '(': {
+        ++pos_;
+        // Only the non-capturing group, but not the lookaheads
+        if (consume('?') && !consume(':')) {
+          return nullptr;
+        }
+        auto node = parseAlternate();
+        if (node == nullptr || !consume(')')) {
+          return nullptr;
+        }
+        return node;
+      }
+      case '[': {
+        ByteClass cls;
+        return parseClass(&cls) ? makeClass(cls) : nullptr;
+      }
+      case '\\': {
+        ByteClass cls;
+        return parseEscape(&cls) ? makeClass(cls) : nullptr;
+      }
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+      case '}':
+      case ']':
+        return nullptr;
+      default:
+        ++pos_;
+        return makeClass(byteClass(static_cast<uint8_t>(c)));
+    }
+  }
+
+  bool parseEscape(ByteClass* cls) {
+    ++pos_;
+    if (atEnd()) {
+      return false;
+    }
+    auto c = static_cast<uint8_t>(pattern_[pos_++]);
+    switch (c) {
+      case 'd':
+        *cls = digitClass();
+        return true;
+      case 'D':
+        *cls = ~digitClass();
+        return true;
+      case 'w':
+        *cls = wordClass();
+        return true;
+      case 'W':
+        *cls = ~wordClass();
+        return true;
+      case 's':
+        *cls = spaceClass();
+        return true;
+      case 'S':
+        *cls = ~spaceClass();
+        return true;
+      case 'n':
+        *cls = byteClass('\n');
+        return true;
+      case 'r':
+        *cls = byteClass('\r');
+        return true;
+      case 't':
+        *cls = byteClass('\t');
+        return true;
+      case 'f':
+        *cls = byteClass('\f');
+        return true;
+      case 'v':
+        *cls = byteClass('\v');
+        return true;
+      case 'x': {
+        if (pos_ + 2 > pattern_.size()) {
+          return false;
+        }
+        auto hi = hexValue(pattern_[pos_]);
+        auto lo = hexValue(pattern_[pos_ + 1]);
+        if (hi < 0 || lo < 0) {
+          return false;
+        }
+        pos_ += 2;
+        *cls = byteClass(static_cast<uint8_t>(hi * 16 + lo));
+        return true;
+      }
+      default:
+        // The backreferences, word boundaries and other escapes of letters or digits are not
+        // supported, while the others escape the char itself
+        if (c >= 0x80 || std::isalnum(c)) {
+          return false;
+        }
+        *cls = byteClass(c);
+        return true;
+    }
+  }
+
+  bool parseClass(ByteClass* cls) {
+    ++pos_;
+    bool negated = consume('^');
+    if (consume(']')) {
+      return false;
+    }
+    while (!consume(']')) {
+      int lo = -1;
+      ByteClass atom;
+      if (!parseClassAtom(&atom, &lo)) {
+        return false;
+      }
+      if (pos_ + 1 < pattern_.size() && pattern_[pos_] == '-' && pattern_[pos_ + 1] != ']') {
+        ++pos_;
+        int hi = -1;
+        if (!parseClassAtom(&atom, &hi)) {
+          return false;
+        }
+        // The ranges of non-ASCII bytes depend on the signedness of char in std::regex
+        if (lo < 0 || hi < 0 || lo >= 0x80 || hi >= 0x80 || lo > hi) {
+          return false;
+        }
+        atom = rangeClass(static_cast<uint8_t>(lo), static_cast<uint8_t>(hi));
+      }
+      *cls |= atom;
+    }
+    if (negated) {
+      cls->flip();
+    }
+    return true;
+  }
+
+  // Parse a char or an escape in the class, `single` is the char if it is a single one
+  bool parseClassAtom(ByteClass* cls, int* single) {
+    if (atEnd()) {
+      return false;
+    }
+    auto c = pattern_[pos_];
+    if (c == '\\') {
+      // The escape `\b` means a backspace in the class
+      if (pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] == 'b') {
+        return false;
+      }
+      if (!parseEscape(cls)) {
+        return false;
+      }
+      if (cls->count() == 1) {
+        for (int i = 0; i < 256; ++i) {
+          if (cls->test(i)) {
+            *single = i;
+          }
+        }
+      }
+      return true;
+    }
+    // The classes like `[:alpha:]` are not supported
+    if (c == '[' && pos_ + 1 < pattern_.size() &&
+        std::strchr(":=.", pattern_[pos_ + 1]) != nullptr) {
+      return false;
+    }
+    ++pos_;
+    *single = static_cast<uint8_t>(c);
+    *cls = byteClass(static_cast<uint8_t>(c));
+    return true;
+  }
+
+  std::vector<Regex::State>& states() {
+    return regex_->states_;
+  }
+
+  int32_t addState(Regex::State::Kind kind, int32_t out = -1) {
+    states().emplace_back(Regex::State{kind, -1, out, -1});
+    return states().size() - 1;
+  }
+
+  // Build the NFA of node followed by `next` backwards, return its start state
+  int32_t build(const Node* node, int32_t next) {
+    if (states().size() > kMaxStates) {
+      return next;
+    }
+    switch (node->type) {
+      case Node::Type::kClass: {
+        auto state = addState(Regex::State::Kind::kByte, next);
+        regex_->classes_.emplace_back(node->cls);
+        states()[state].cls = regex_->classes_.size() - 1;
+        return state;
+      }
+      case Node::Type::kBegin:
+        return addState(Regex::State::Kind::kBegin, next);
+      case Node::Type::kEnd:
+        return addState(Regex::State::Kind::kEnd, next);
+      case Node::Type::kConcat:
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+          next = build(it->get(), next);
+        }
+        return next;
+      case Node::Type::kAlternate: {
+        auto state = build(node->children.back().get(), next);
+        for (auto i = static_cast<int32_t>(node->children.size()) - 2; i >= 0; --i) {
+          auto first = build(node->children[i].get(), next);
+          auto split = addState(Regex::State::Kind::kSplit, first);
+          states()[split].out1 = state;
+          state = split;
+        }
+        return state;
+      }
+      case Node::Type::kRepeat: {
+        const auto* child = node->children.front().get();
+        auto state = next;
+        if (node->max < 0) {
+          auto loop = addState(Regex::State::Kind::kSplit);
+          auto body = build(child, loop);
+          states()[loop].out = body;
+          states()[loop].out1 = next;
+          state = loop;
+        } else {
+          // e{0,k} is built as (e(e(...)?)?)?
+          for (auto i = node->min; i < node->max; ++i) {
+            auto body = build(child, state);
+            auto split = addState(Regex::State::Kind::kSplit, body);
+            states()[split].out1 = next;
+            state = split;
+          }
+        }
+        for (auto i = 0; i < node->min; ++i) {
+          state = build(child, state);
+        }
+        return state;
+      }
+    }
+    return next;
+  }
+
+  // The leading single chars of the top-level concatenation
+  static std::string prefix(const Node* node) {
+    std::string prefix;
+    if (node->type != Node::Type::kConcat) {
+      return prefix;
+    }
+    for (const auto& child : node->children) {
+      if (child->type == Node::Type::kBegin) {
+        continue;
+      }
+      const auto* atom = child.get();
+      bool repeated = atom->type == Node::Type::kRepeat;
+      if (repeated) {
+        if (atom->min == 0) {
+          break;
+        }
+        atom = atom->children.front().get();
+      }
+      if (atom->type != Node::Type::kClass || atom->cls.count() != 1) {
+        break;
+      }
+      for (int i = 0; i < 256; ++i) {
+        if (atom->cls.test(i)) {
+          prefix.push_back(static_cast<char>(i));
+        }
+      }
+      // The char repeated is only known to be the first of the rest
+      if (repeated) {
+        break;
+      }
+    }
+    return prefix;
+  }
+
+  const std::string& pattern_;
+  Regex* regex_;
+  size_t pos_{0};
+};
+
+Regex::Regex(const std::string& pattern) {
+  RegexCompiler compiler(pattern, this);
+  if (!compiler.compile()) {
+    states_.clear();
+    classes_.clear();
+    prefix_.clear();
+    fallback_ = std::make_unique<std::regex>(pattern);
+    return;
+  }
+  std::vector<bool> visited(states_.size(), false);
+  closure(start_, true, visited, startStates_);
+  std::sort(startStates_.begin(), startStates_.end());
+  acceptEmpty_ = accept(startStates_, true);
+  startDState_ = dstate(startStates_);
+}
+
+bool Regex::match(const std::string& str) const {
+  if (fallback_ != nullptr) {
+    return std::regex_match(str, *fallback_);
+  }
+  if (str.empty()) {
+    return acceptEmpty_;
+  }
+  auto current = startDState_;
+  for (auto c : str) {
+    auto byte = static_cast<uint8_t>(c);
+    auto next = dstates_[current].next[byte];
+    current = next >= 0 ? next : transit(current, byte);
+    if (dstates_[current].states.empty()) {
+      return false;
+    }
+  }
+  return dstates_[current].accept;
+}
+
+void Regex::closure(int32_t state,
+                    bool atBegin,
+                    std::vector<bool>& visited,
+                    std::vector<int32_t>& set) const {
+  std::vector<int32_t> stack{state};
+  while (!stack.empty()) {
+    auto id = stack.back();
+    stack.pop_back();
+    if (visited[id]) {
+      continue;
+    }
+    visited[id] = true;
+    const auto& s = states_[id];
+    switch (s.kind) {
+      case State::Kind::kSplit:
+        stack.emplace_back(s.out1);
+        stack.emplace_back(s.out);
+        break;
+      case State::Kind::kBegin:
+        if (atBegin) {
+          stack.emplace_back(s.out);
+        }
+        break;
+      default:
+        // The kEnd is kept, and followed only at the end of string
+        set.emplace_back(id);
+    }
+  }
+}
+
+bool Regex::accept(const std::vector<int32_t>& states, bool atBegin) const {
+  std::vector<bool> visited(states_.size(), false);
+  std::vector<int32_t> stack(states.begin(), states.end());
+  while (!stack.empty()) {
+    auto id = stack.back();
+    stack.pop_back();
+    if (visited[id]) {
+      continue;
+    }
+    visited[id] = true;
+    const auto& s = states_[id];
+    switch (s.kind) {
+      case State::Kind::kMatch:
+        return true;
+      case State::Kind::kSplit:
+        stack.emplace_back(s.out1);
+        stack.emplace_back(s.out);
+        break;
+      case State::Kind::kBegin:
+        if (atBegin) {
+          stack.emplace_back(s.out);
+        }
+        break;
+      case State::Kind::kEnd:
+        stack.emplace_back(s.out);
+        break;
+      case State::Kind::kByte:
+        break;
+    }
+  }
+  return false;
+}
+
+int32_t Regex::dstate(std::vector<int32_t> states) const {
+  std::sort(states.begin(), states.end());
+  states.erase(std::unique(states.begin(), states.end()), states.end());
+  auto iter = dstateIds_.find(states);
+  if (iter != dstateIds_.end()) {
+    return iter->second;
+  }
+  DState d;
+  d.next.fill(-1);
+  d.accept = accept(states, false);
+  d.states = states;
+  dstates_.emplace_back(std::move(d));
+  int32_t id = dstates_.size() - 1;
+  dstateIds_.emplace(std::move(states), id);
+  return id;
+}
+
+int32_t Regex::transit(int32_t from, uint8_t byte) const {
+  if (dstates_.size() >= kMaxDStates) {
+    auto states = dstates_[from].states;
+    dstates_.clear();
+    dstateIds_.clear();
+    startDState_ = dstate(startStates_);
+    from = dstate(std::move(states));
+  }
+  std::vector<bool> visited(states_.size(), false);
+  std::vector<int32_t> next;
+  for (auto id : dstates_[from].states) {
+    const auto& s = states_[id];
+    if (s.kind == State::Kind::kByte && classes_[s.cls].test(byte)) {
+      closure(s.out, false, visited, next);
+    }
+  }
+  auto to = dstate(std::move(next));
+  dstates_[from].next[byte] = to;
+  return to;
+}
+
+}  // namespace nebula
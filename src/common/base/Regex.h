@@ -0,0 +1,108 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_BASE_REGEX_H_
+#define COMMON_BASE_REGEX_H_
+
+#include <array>
+#include <bitset>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace nebula {
+
+/**
+ * A regular expression of the ECMAScript grammar matched against the whole string, the same as
+ * `std::regex_match`, but in time linear to the length of string.
+ *
+ * The pattern is compiled into a NFA, and matched by a DFA whose states are built lazily from the
+ * sets of NFA states while matching, so each byte is a lookup of the transition table once the
+ * states are cached. The bytes are matched one by one as `std::regex` does for `char`.
+ *
+ * The literals, `.`, character classes, escapes like `\d`, groups, alternations, quantifiers
+ * (greedy or lazy, which are the same for a whole match) and the anchors `^` `$` are supported.
+ * A pattern using any other feature, e.g. backreferences or lookaheads, is matched by
+ * `std::regex` instead, which also reports the invalid patterns by throwing `std::regex_error`.
+ *
+ * The cache of DFA states makes matching not thread-safe.
+ */
+class Regex final {
+ public:
+  // Throw std::regex_error if the pattern is invalid
+  explicit Regex(const std::string& pattern);
+
+  // Whether the whole string matches the pattern
+  bool match(const std::string& str) const;
+
+  // The literal every string matched starts with, which may be empty
+  const std::string& prefix() const {
+    return prefix_;
+  }
+
+  // Whether matched by the automaton instead of std::regex
+  bool isAutomaton() const {
+    return fallback_ == nullptr;
+  }
+
+ private:
+  friend class RegexCompiler;
+
+  struct State {
+    enum class Kind : uint8_t {
+      // Consume a byte of the class
+      kByte,
+      // Go to both `out` and `out1` without consuming
+      kSplit,
+      // Assert at the begin or end of string
+      kBegin,
+      kEnd,
+      kMatch,
+    };
+    Kind kind;
+    int32_t cls{-1};
+    int32_t out{-1};
+    int32_t out1{-1};
+  };
+
+  struct DState {
+    // The NFA states other than kSplit and kBegin, sorted
+    std::vector<int32_t> states;
+    // The DFA state after each byte, -1 if not built yet
+    std::array<int32_t, 256> next;
+    bool accept{false};
+  };
+
+  // At most so many DFA states are cached, the cache is cleared once it is full
+  static constexpr size_t kMaxDStates = 256;
+
+  // Add the state and the states reachable without consuming into the set
+  void closure(int32_t state,
+               bool atBegin,
+               std::vector<bool>& visited,
+               std::vector<int32_t>& set) const;
+  // Whether the states reach the match at the end of string
+  bool accept(const std::vector<int32_t>& states, bool atBegin) const;
+  int32_t dstate(std::vector<int32_t> states) const;
+  int32_t transit(int32_t from, uint8_t byte) const;
+
+  std::unique_ptr<std::regex> fallback_;
+  std::vector<State> states_;
+  std::vector<std::bitset<256>> classes_;
+  int32_t start_{-1};
+  // The NFA states at the begin of string, and whether it matches the empty string
+  std::vector<int32_t> startStates_;
+  bool acceptEmpty_{false};
+  std::string prefix_;
+
+  mutable int32_t startDState_{-1};
+  mutable std::vector<DState> dstates_;
+  mutable std::map<std::vector<int32_t>, int32_t> dstateIds_;
+};
+
+}  // namespace nebula
+#endif  // COMMON_BASE_REGEX_H_
@@ -0,0 +1,100 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "common/base/Base.h"
+#include "common/base/ConcurrentClockCache.h"
+
+namespace nebula {
+
+TEST(ConcurrentClockCacheTest, SimpleTest) {
+  ConcurrentClockCache<int32_t, std::string> cache(1024);
+  cache.insert(10, "ten", 1);
+  {
+    auto v = cache.get(10);
+    EXPECT_TRUE(v.ok());
+    EXPECT_EQ("ten", v.value());
+  }
+  {
+    auto v = cache.get(5);
+    EXPECT_FALSE(v.ok());
+  }
+  EXPECT_TRUE(cache.contains(10));
+  EXPECT_EQ(1, cache.hits());
+  EXPECT_EQ(1, cache.misses());
+
+  // Overwrite
+  cache.insert(10, "TEN", 3);
+  EXPECT_EQ("TEN", cache.get(10).value());
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(3, cache.usage());
+
+  cache.evict(10);
+  EXPECT_FALSE(cache.contains(10));
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.usage());
+  EXPECT_EQ(0, cache.evicts());
+}
+
+TEST(ConcurrentClockCacheTest, EvictByChargeTest) {
+  // One shard of 100 bytes
+  ConcurrentClockCache<int32_t, std::string> cache(100, 0);
+  for (int32_t i = 0; i < 10; i++) {
+    cache.insert(i, std::to_string(i), 10);
+  }
+  EXPECT_EQ(100, cache.usage());
+  EXPECT_EQ(0, cache.evicts());
+
+  // The referenced ones get a second chance
+  for (int32_t i = 0; i < 5; i++) {
+    EXPECT_TRUE(cache.get(i).ok());
+  }
+  cache.insert(10, "10", 30);
+  EXPECT_EQ(100, cache.usage());
+  EXPECT_EQ(3, cache.evicts());
+  for (int32_t i = 0; i < 5; i++) {
+    EXPECT_TRUE(cache.contains(i));
+  }
+  for (int32_t i = 5; i < 8; i++) {
+    EXPECT_FALSE(cache.contains(i));
+  }
+  EXPECT_TRUE(cache.contains(10));
+
+  // Larger than the capacity
+  cache.insert(11, "11", 101);
+  EXPECT_FALSE(cache.contains(11));
+
+  cache.clear();
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.usage());
+}
+
+TEST(ConcurrentClockCacheTest, MultiThreadsTest) {
+  ConcurrentClockCache<int32_t, int32_t> cache(1024, 4, "clock_cache_test");
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < 8; t++) {
+    threads.emplace_back([&cache, t]() {
+      for (int32_t i = 0; i < 10000; i++) {
+        auto key = (i * 7 + t) % 2048;
+        auto v = cache.get(key);
+        if (v.ok()) {
+          EXPECT_EQ(key, v.value());
+        } else {
+          cache.insert(key, key, sizeof(int32_t));
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_LE(cache.usage(), 1024);
+  EXPECT_EQ(8 * 10000, cache.hits() + cache.misses());
+}
+
+}  // namespace nebula
@@ -0,0 +1,88 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/base/Regex.h"
+
+namespace nebula {
+
+TEST(Regex, SameAsStdRegex) {
+  std::vector<std::string> patterns = {
+      "",         "a",          "abc",        "a*",          "a+b",       "a?b?c?",
+      "(ab)*c",   "a|b|",       "^abc$",      "^$",          "$^",        "a{2}",
+      "a{2,}",    "a{1,3}b",    "(a{0,2}b){2}", ".*",        ".+x",       "[abc]+",
+      "[^abc]*",  "[a-z0-9_]+", "\\d+\\w+",   "\\s*\\S+",    "[\\d.]+",   "a.c",
+      "\\.",      "x*?y",       "(?:ab|cd)+", "[-a]+",       "[a-]+",     "\\x41+",
+      "a\\|b",    "(a*)*",      "(a|b)*abb",  "a^b",         "(^a|b)+",   "(a$|b)*",
+      "\\D\\W\\S", "(x+x+)+y",  "(a|ab)(c|bcd)(d*)",
+  };
+  std::vector<std::string> strs = {
+      "",      "a",     "b",     "ab",    "abc",      "aa",    "aab",  "abb",   "aabb",
+      "babb",  "abcd",  "abbcd", "c",     "ababc",    "xy",    "xxy",  "123abc", "abc123",
+      "a.c",   "a\nc",  "a\rc",  "  foo", "1.5",      ".",     "cdab", "-a-",   "AAA",
+      "a|b",   "é",     "\n",    "a-",    "xxxxxxxxxxxxxxxxxxxxxxxxxy",
+  };
+  for (const auto& pattern : patterns) {
+    Regex regex(pattern);
+    EXPECT_TRUE(regex.isAutomaton()) << pattern;
+    std::regex expected(pattern);
+    for (const auto& str : strs) {
+      auto matched = regex.match(str);
+      EXPECT_EQ(std::regex_match(str, expected), matched) << pattern << " " << str;
+      if (matched) {
+        EXPECT_EQ(0, str.compare(0, regex.prefix().size(), regex.prefix())) << pattern;
+      }
+    }
+  }
+}
+
+TEST(Regex, Linear) {
+  // Backtracking takes exponential time for it
+  Regex regex("(x+x+)+y");
+  std::string str(100000, 'x');
+  EXPECT_FALSE(regex.match(str));
+  EXPECT_TRUE(regex.match(str + "y"));
+  // More DFA states than cached
+  Regex many("[0-9a-f]*a[0-9a-f]{8}");
+  std::string hex;
+  for (int i = 0; i < 10000; ++i) {
+    hex.push_back("0123456789abcdef"[(i * 7919) % 16]);
+  }
+  std::regex expected("[0-9a-f]*a[0-9a-f]{8}");
+  for (size_t len = hex.size() - 20; len <= hex.size(); ++len) {
+    auto str = hex.substr(0, len);
+    EXPECT_EQ(std::regex_match(str, expected), many.match(str)) << len;
+  }
+}
+
+TEST(Regex, Fallback) {
+  for (const auto& pattern : {"\\b", "(a)\\1", "(?=a)a", "[[:alpha:]]+", "\\q", "a{1001}"}) {
+    Regex regex(pattern);
+    EXPECT_FALSE(regex.isAutomaton()) << pattern;
+    EXPECT_TRUE(regex.prefix().empty());
+  }
+  EXPECT_TRUE(Regex("(a)b\\1").match("aba"));
+  EXPECT_TRUE(Regex("[[:digit:]]+").match("123"));
+  for (const auto& pattern : {"*a", "a{2,1}", "(", ")", "[", "a{", "\\"}) {
+    EXPECT_THROW(Regex regex(pattern), std::regex_error) << pattern;
+  }
+}
+
+TEST(Regex, Prefix) {
+  EXPECT_EQ("abc", Regex("abc").prefix());
+  EXPECT_EQ("abc", Regex("^abc.*").prefix());
+  EXPECT_EQ("Re", Regex("Re\\w*").prefix());
+  EXPECT_EQ("a", Regex("a+b").prefix());
+  EXPECT_EQ("a.", Regex("a\\.b?").prefix());
+  EXPECT_EQ("é", Regex("é+").prefix());
+  EXPECT_EQ("", Regex("a*b").prefix());
+  EXPECT_EQ("", Regex("ab|ac").prefix());
+  EXPECT_EQ("", Regex("(ab)c").prefix());
+  EXPECT_EQ("", Regex("[ab]c").prefix());
+}
+
+}  // namespace nebula
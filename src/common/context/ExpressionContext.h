@@ -9,6 +9,7 @@
 #include <folly/RWSpinLock.h>
 
 #include "common/base/Base.h"
+#include "common/base/Regex.h"
 #include "common/datatypes/DataSet.h"
 #include "common/datatypes/Value.h"
 
@@ -61,10 +62,10 @@ class ExpressionContext {
   virtual Value getColumn(int32_t index) const = 0;
 
   // Get regex
-  const std::regex& getRegex(const std::string& pattern) {
+  const Regex& getRegex(const std::string& pattern) {
     auto iter = regex_.find(pattern);
     if (iter == regex_.end()) {
-      iter = regex_.emplace(pattern, std::regex(pattern)).first;
+      iter = regex_.emplace(pattern, Regex(pattern)).first;
     }
     return iter->second;
   }
@@ -72,7 +73,7 @@ class ExpressionContext {
   virtual void setVar(const std::string& var, Value val) = 0;
 
  private:
-  std::unordered_map<std::string, std::regex> regex_;
+  std::unordered_map<std::string, Regex> regex_;
 };
 
 }  // namespace nebula
@@ -556,11 +556,19 @@ void Value::setFloat(double&& v) {
 }
 
 void Value::setStr(const std::string& v) {
+  if (type_ == Type::STRING) {
+    *value_.sVal = v;
+    return;
+  }
   clear();
   setS(v);
 }
 
 void Value::setStr(std::string&& v) {
+  if (type_ == Type::STRING) {
+    *value_.sVal = std::move(v);
+    return;
+  }
   clear();
   setS(std::move(v));
 }
@@ -1236,6 +1244,11 @@ Value& Value::operator=(const Value& rhs) {
   if (this == &rhs) {
     return *this;
   }
+  if (type_ == Type::STRING && rhs.type_ == Type::STRING) {
+    // reuse the box and its buffer
+    *value_.sVal = *rhs.value_.sVal;
+    return *this;
+  }
   clear();
   if (rhs.type_ == Type::__EMPTY__) {
     return *this;
@@ -111,6 +111,23 @@ BENCHMARK(HashIntValue, n) {
   }
 }
 
+BENCHMARK_DRAW_LINE();
+
+// Copy the rows of string vids, which is the common case of Project/Dedup/Join
+BENCHMARK(CopyStringValues, n) {
+  std::vector<Value> values;
+  BENCHMARK_SUSPEND {
+    values.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      values.emplace_back(randomString(10));
+    }
+  }
+  for (size_t round = 0; round < 10; round++) {
+    auto copies = values;
+    folly::doNotOptimizeAway(copies);
+  }
+}
+
 int main() {
   folly::runBenchmarks();
   return 0;
@@ -1630,6 +1630,52 @@ TEST(Value, Ctor) {
   // Value v2(&tmp);
 }
 
+TEST(Value, StringBox) {
+  std::string longStr(100, 'a');
+  {
+    std::vector<Value> values;
+    for (int i = 0; i < 10000; ++i) {
+      values.emplace_back(i % 2 == 0 ? folly::to<std::string>(i) : longStr);
+    }
+    auto copies = values;
+    EXPECT_EQ(values, copies);
+  }
+  {
+    Value v("short");
+    Value copy = v;
+    EXPECT_EQ("short", copy.getStr());
+    // assign between strings in place
+    copy = Value(longStr);
+    EXPECT_EQ(longStr, copy.getStr());
+    copy.setStr("x");
+    EXPECT_EQ("x", copy.getStr());
+    copy.setStr(std::string(longStr));
+    EXPECT_EQ(longStr, copy.getStr());
+    // assign between different types
+    copy = 1;
+    EXPECT_EQ(1, copy.getInt());
+    copy = v;
+    EXPECT_EQ("short", copy.getStr());
+    Value moved(std::move(copy));
+    EXPECT_EQ("short", moved.getStr());
+    EXPECT_EQ("short", moved.moveStr());
+    EXPECT_TRUE(moved.empty());
+  }
+  {
+    // the values are released by other threads
+    std::vector<Value> values;
+    std::thread producer([&values]() {
+      for (int i = 0; i < 100; ++i) {
+        values.emplace_back(folly::to<std::string>(i));
+      }
+    });
+    producer.join();
+    std::thread consumer([&values]() { values.clear(); });
+    consumer.join();
+    EXPECT_TRUE(values.empty());
+  }
+}
+
 TEST(Value, ToString) {
   {
     Duration d;
@@ -39,7 +39,7 @@ class BinaryExpression : public Expression {
     return rhs_;
   }
 
-  void setRight(Expression* expr) {
+  virtual void setRight(Expression* expr) {
     rhs_ = expr;
   }
 
@@ -0,0 +1,477 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/expression/ExprProgram.h"
+
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/FunctionCallExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "common/expression/VariableExpression.h"
+
+DEFINE_bool(enable_expr_program,
+            true,
+            "Whether to evaluate the filters and projections by compiled programs");
+
+namespace nebula {
+
+namespace {
+
+// The comparisons the same as RelationalExpression, whose operands are of the same type
+template <typename T>
+bool compare(Expression::Kind kind, const T& lhs, const T& rhs) {
+  switch (kind) {
+    case Expression::Kind::kRelEQ:
+      return lhs == rhs;
+    case Expression::Kind::kRelNE:
+      return !(lhs == rhs);
+    case Expression::Kind::kRelLT:
+      return lhs < rhs;
+    case Expression::Kind::kRelLE:
+      return lhs < rhs || lhs == rhs;
+    case Expression::Kind::kRelGT:
+      return !(lhs < rhs) && !(lhs == rhs);
+    default:
+      return !(lhs < rhs) || lhs == rhs;
+  }
+}
+
+Value compare(Expression::Kind kind, const Value& lhs, const Value& rhs) {
+  switch (kind) {
+    case Expression::Kind::kRelEQ:
+      return lhs.equal(rhs);
+    case Expression::Kind::kRelNE:
+      return !lhs.equal(rhs);
+    case Expression::Kind::kRelLT:
+      return lhs.lessThan(rhs);
+    case Expression::Kind::kRelLE:
+      return lhs.lessThan(rhs) || lhs.equal(rhs);
+    case Expression::Kind::kRelGT:
+      return !lhs.lessThan(rhs) && !lhs.equal(rhs);
+    default:
+      return !lhs.lessThan(rhs) || lhs.equal(rhs);
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<ExprProgram> ExprProgram::compile(Expression* expr) {
+  std::unique_ptr<ExprProgram> program(new ExprProgram());
+  program->result_ = program->compileExpr(DCHECK_NOTNULL(expr));
+  // The values are not moved any more
+  for (uint32_t i = 0; i < program->regs_.size(); ++i) {
+    program->regs_[i] = &program->values_[i];
+  }
+  return program;
+}
+
+const Value& ExprProgram::eval(ExpressionContext& ctx) {
+  const auto size = code_.size();
+  for (size_t pc = 0; pc < size; ++pc) {
+    const auto& instr = code_[pc];
+    switch (instr.op) {
+      case Op::kAndStep:
+        if (andStep(values_[instr.dst], *regs_[instr.lhs])) {
+          pc = instr.aux - 1;
+        }
+        break;
+      case Op::kOrStep:
+        if (orStep(values_[instr.dst], *regs_[instr.lhs])) {
+          pc = instr.aux - 1;
+        }
+        break;
+      default:
+        exec(instr, &ctx);
+    }
+  }
+  return *regs_[result_];
+}
+
+uint32_t ExprProgram::compileExpr(Expression* expr) {
+  switch (expr->kind()) {
+    case Expression::Kind::kConstant:
+      return constant(static_cast<ConstantExpression*>(expr)->value());
+    case Expression::Kind::kInputProperty: {
+      auto* propExpr = static_cast<PropertyExpression*>(expr);
+      return emit(Op::kInputProp, 0, 0, prop(propExpr->sym(), propExpr->prop()));
+    }
+    case Expression::Kind::kVarProperty: {
+      auto* propExpr = static_cast<PropertyExpression*>(expr);
+      return emit(Op::kVarProp, 0, 0, prop(propExpr->sym(), propExpr->prop()));
+    }
+    case Expression::Kind::kDstProperty: {
+      auto* propExpr = static_cast<PropertyExpression*>(expr);
+      return emit(Op::kDstProp, 0, 0, prop(propExpr->sym(), propExpr->prop()));
+    }
+    case Expression::Kind::kSrcProperty: {
+      auto* propExpr = static_cast<PropertyExpression*>(expr);
+      return emit(Op::kSrcProp, 0, 0, prop(propExpr->sym(), propExpr->prop()));
+    }
+    case Expression::Kind::kTagProperty: {
+      auto* propExpr = static_cast<PropertyExpression*>(expr);
+      return emit(Op::kTagProp, 0, 0, prop(propExpr->sym(), propExpr->prop()));
+    }
+    case Expression::Kind::kEdgeProperty:
+    case Expression::Kind::kEdgeSrc:
+    case Expression::Kind::kEdgeType:
+    case Expression::Kind::kEdgeRank:
+    case Expression::Kind::kEdgeDst: {
+      auto* propExpr = static_cast<PropertyExpression*>(expr);
+      return emit(Op::kEdgeProp, 0, 0, prop(propExpr->sym(), propExpr->prop()));
+    }
+    case Expression::Kind::kVar:
+      return emit(Op::kVar, 0, 0, prop(static_cast<VariableExpression*>(expr)->var(), ""));
+    case Expression::Kind::kAdd:
+    case Expression::Kind::kMinus:
+    case Expression::Kind::kMultiply:
+    case Expression::Kind::kDivision:
+    case Expression::Kind::kMod: {
+      static const std::unordered_map<Expression::Kind, Op> ops = {
+          {Expression::Kind::kAdd, Op::kAdd},
+          {Expression::Kind::kMinus, Op::kMinus},
+          {Expression::Kind::kMultiply, Op::kMultiply},
+          {Expression::Kind::kDivision, Op::kDivision},
+          {Expression::Kind::kMod, Op::kMod},
+      };
+      auto* binary = static_cast<BinaryExpression*>(expr);
+      auto lhs = compileExpr(binary->left());
+      auto rhs = compileExpr(binary->right());
+      return emitFoldable(ops.at(expr->kind()), lhs, rhs);
+    }
+    case Expression::Kind::kUnaryPlus:
+    case Expression::Kind::kUnaryNegate:
+    case Expression::Kind::kUnaryNot:
+    case Expression::Kind::kIsNull:
+    case Expression::Kind::kIsNotNull:
+    case Expression::Kind::kIsEmpty:
+    case Expression::Kind::kIsNotEmpty: {
+      static const std::unordered_map<Expression::Kind, Op> ops = {
+          {Expression::Kind::kUnaryPlus, Op::kPlus},
+          {Expression::Kind::kUnaryNegate, Op::kNegate},
+          {Expression::Kind::kUnaryNot, Op::kNot},
+          {Expression::Kind::kIsNull, Op::kIsNull},
+          {Expression::Kind::kIsNotNull, Op::kIsNotNull},
+          {Expression::Kind::kIsEmpty, Op::kIsEmpty},
+          {Expression::Kind::kIsNotEmpty, Op::kIsNotEmpty},
+      };
+      auto operand = compileExpr(static_cast<UnaryExpression*>(expr)->operand());
+      return emitFoldable(ops.at(expr->kind()), operand);
+    }
+    case Expression::Kind::kRelEQ:
+    case Expression::Kind::kRelNE:
+    case Expression::Kind::kRelLT:
+    case Expression::Kind::kRelLE:
+    case Expression::Kind::kRelGT:
+    case Expression::Kind::kRelGE:
+      return compileRelational(expr);
+    case Expression::Kind::kRelIn:
+    case Expression::Kind::kRelNotIn:
+      return compileIn(expr);
+    case Expression::Kind::kLogicalAnd:
+    case Expression::Kind::kLogicalOr:
+      return compileLogical(expr);
+    case Expression::Kind::kFunctionCall:
+      return compileCall(expr);
+    default:
+      return fallback(expr);
+  }
+}
+
+uint32_t ExprProgram::compileRelational(Expression* expr) {
+  auto* binary = static_cast<BinaryExpression*>(expr);
+  auto lhs = compileExpr(binary->left());
+  auto rhs = compileExpr(binary->right());
+  auto index = static_cast<uint8_t>(expr->kind()) - static_cast<uint8_t>(Expression::Kind::kRelEQ);
+  auto op = static_cast<Op>(static_cast<uint8_t>(Op::kEQ) + index);
+  if (isConstant_[rhs] && !isConstant_[lhs]) {
+    // The lhs of the same type is compared without going through Value
+    if (values_[rhs].isInt()) {
+      op = static_cast<Op>(static_cast<uint8_t>(Op::kEQInt) + index);
+    } else if (values_[rhs].isStr()) {
+      op = static_cast<Op>(static_cast<uint8_t>(Op::kEQStr) + index);
+    }
+  }
+  return emitFoldable(op, lhs, rhs);
+}
+
+uint32_t ExprProgram::compileIn(Expression* expr) {
+  auto* binary = static_cast<BinaryExpression*>(expr);
+  auto set = InSet::make(binary->right());
+  if (set == nullptr) {
+    return fallback(expr);
+  }
+  bool negated = expr->kind() == Expression::Kind::kRelNotIn;
+  auto lhs = compileExpr(binary->left());
+  if (isConstant_[lhs]) {
+    return constant(set->in(values_[lhs], negated));
+  }
+  sets_.emplace_back(std::move(set));
+  return emit(negated ? Op::kNotIn : Op::kIn, lhs, 0, sets_.size() - 1);
+}
+
+uint32_t ExprProgram::compileLogical(Expression* expr) {
+  auto* logical = static_cast<LogicalExpression*>(expr);
+  bool isAnd = expr->kind() == Expression::Kind::kLogicalAnd;
+  auto start = code_.size();
+  auto init = constant(Value(isAnd));
+  auto dst = emit(Op::kInit, init);
+  std::vector<size_t> steps;
+  bool allConstant = true;
+  for (auto* operand : logical->operands()) {
+    auto reg = compileExpr(operand);
+    allConstant = allConstant && isConstant_[reg];
+    steps.push_back(code_.size());
+    emit(isAnd ? Op::kAndStep : Op::kOrStep, reg);
+  }
+  if (allConstant) {
+    Value acc(isAnd);
+    for (auto step : steps) {
+      const auto& value = values_[code_[step].lhs];
+      if (isAnd ? andStep(acc, value) : orStep(acc, value)) {
+        break;
+      }
+    }
+    code_.resize(start);
+    return constant(std::move(acc));
+  }
+  for (auto step : steps) {
+    code_[step].dst = dst;
+    code_[step].aux = code_.size();
+  }
+  return dst;
+}
+
+uint32_t ExprProgram::compileCall(Expression* expr) {
+  auto* call = static_cast<FunctionCallExpression*>(expr);
+  auto func = FunctionManager::get(call->name(), call->args()->numArgs());
+  if (!func.ok()) {
+    return fallback(expr);
+  }
+  Call c;
+  c.func = std::move(func).value();
+  bool allConstant = true;
+  for (auto* arg : call->args()->args()) {
+    auto reg = compileExpr(arg);
+    allConstant = allConstant && isConstant_[reg];
+    c.argRegs.push_back(reg);
+  }
+  c.args.assign(c.argRegs.size(), std::cref(Value::kEmpty));
+  auto isPure = FunctionManager::getIsPure(call->name(), call->args()->numArgs());
+  if (allConstant && isPure.ok() && isPure.value()) {
+    for (size_t i = 0; i < c.argRegs.size(); ++i) {
+      c.args[i] = std::cref(values_[c.argRegs[i]]);
+    }
+    return constant(c.func(c.args));
+  }
+  calls_.emplace_back(std::move(c));
+  return emit(Op::kCall, 0, 0, calls_.size() - 1);
+}
+
+uint32_t ExprProgram::emit(Op op, uint32_t lhs, uint32_t rhs, uint32_t aux) {
+  uint32_t dst = regs_.size();
+  regs_.push_back(nullptr);
+  values_.emplace_back();
+  isConstant_.push_back(false);
+  code_.push_back(Instr{op, dst, lhs, rhs, aux});
+  return dst;
+}
+
+uint32_t ExprProgram::emitFoldable(Op op, uint32_t lhs, uint32_t rhs) {
+  auto dst = emit(op, lhs, rhs);
+  bool unary = op >= Op::kPlus && op <= Op::kIsNotEmpty;
+  if (!isConstant_[lhs] || (!unary && !isConstant_[rhs])) {
+    return dst;
+  }
+  // The values may be moved while compiling
+  regs_[lhs] = &values_[lhs];
+  regs_[rhs] = &values_[rhs];
+  auto instr = code_.back();
+  code_.pop_back();
+  exec(instr, nullptr);
+  isConstant_[dst] = true;
+  return dst;
+}
+
+uint32_t ExprProgram::constant(Value value) {
+  uint32_t reg = regs_.size();
+  regs_.push_back(nullptr);
+  values_.emplace_back(std::move(value));
+  isConstant_.push_back(true);
+  return reg;
+}
+
+uint32_t ExprProgram::fallback(Expression* expr) {
+  exprs_.emplace_back(expr);
+  return emit(Op::kEval, 0, 0, exprs_.size() - 1);
+}
+
+uint32_t ExprProgram::prop(const std::string& sym, const std::string& prop) {
+  props_.emplace_back(sym, prop);
+  return props_.size() - 1;
+}
+
+void ExprProgram::exec(const Instr& instr, ExpressionContext* ctx) {
+  const auto& lhs = *regs_[instr.lhs];
+  const auto& rhs = *regs_[instr.rhs];
+  auto relKind = [&instr](Op base) {
+    return static_cast<Expression::Kind>(static_cast<uint8_t>(Expression::Kind::kRelEQ) +
+                                         static_cast<uint8_t>(instr.op) -
+                                         static_cast<uint8_t>(base));
+  };
+  switch (instr.op) {
+    case Op::kInputProp:
+      regs_[instr.dst] = &ctx->getInputProp(props_[instr.aux].second);
+      break;
+    case Op::kVarProp:
+      regs_[instr.dst] = &ctx->getVarProp(props_[instr.aux].first, props_[instr.aux].second);
+      break;
+    case Op::kDstProp:
+      regs_[instr.dst] = &ctx->getDstProp(props_[instr.aux].first, props_[instr.aux].second);
+      break;
+    case Op::kVar:
+      regs_[instr.dst] = &ctx->getVar(props_[instr.aux].first);
+      break;
+    case Op::kTagProp:
+      set(instr.dst, ctx->getTagProp(props_[instr.aux].first, props_[instr.aux].second));
+      break;
+    case Op::kEdgeProp:
+      set(instr.dst, ctx->getEdgeProp(props_[instr.aux].first, props_[instr.aux].second));
+      break;
+    case Op::kSrcProp:
+      set(instr.dst, ctx->getSrcProp(props_[instr.aux].first, props_[instr.aux].second));
+      break;
+    case Op::kEval:
+      regs_[instr.dst] = &exprs_[instr.aux]->eval(*ctx);
+      break;
+    case Op::kAdd:
+      set(instr.dst, lhs + rhs);
+      break;
+    case Op::kMinus:
+      set(instr.dst, lhs - rhs);
+      break;
+    case Op::kMultiply:
+      set(instr.dst, lhs * rhs);
+      break;
+    case Op::kDivision:
+      set(instr.dst, lhs / rhs);
+      break;
+    case Op::kMod:
+      set(instr.dst, lhs % rhs);
+      break;
+    case Op::kPlus:
+      set(instr.dst, Value(lhs));
+      break;
+    case Op::kNegate:
+      set(instr.dst, -lhs);
+      break;
+    case Op::kNot:
+      set(instr.dst, !lhs);
+      break;
+    case Op::kIsNull:
+      set(instr.dst, lhs.isNull());
+      break;
+    case Op::kIsNotNull:
+      set(instr.dst, !lhs.isNull());
+      break;
+    case Op::kIsEmpty:
+      set(instr.dst, lhs.empty());
+      break;
+    case Op::kIsNotEmpty:
+      set(instr.dst, !lhs.empty());
+      break;
+    case Op::kEQ:
+    case Op::kNE:
+    case Op::kLT:
+    case Op::kLE:
+    case Op::kGT:
+    case Op::kGE:
+      set(instr.dst, compare(relKind(Op::kEQ), lhs, rhs));
+      break;
+    case Op::kEQInt:
+    case Op::kNEInt:
+    case Op::kLTInt:
+    case Op::kLEInt:
+    case Op::kGTInt:
+    case Op::kGEInt:
+      if (lhs.isInt()) {
+        set(instr.dst, compare(relKind(Op::kEQInt), lhs.getInt(), rhs.getInt()));
+      } else {
+        set(instr.dst, compare(relKind(Op::kEQInt), lhs, rhs));
+      }
+      break;
+    case Op::kEQStr:
+    case Op::kNEStr:
+    case Op::kLTStr:
+    case Op::kLEStr:
+    case Op::kGTStr:
+    case Op::kGEStr:
+      if (lhs.isStr()) {
+        set(instr.dst, compare(relKind(Op::kEQStr), lhs.getStr(), rhs.getStr()));
+      } else {
+        set(instr.dst, compare(relKind(Op::kEQStr), lhs, rhs));
+      }
+      break;
+    case Op::kIn:
+    case Op::kNotIn:
+      set(instr.dst, sets_[instr.aux]->in(lhs, instr.op == Op::kNotIn));
+      break;
+    case Op::kInit:
+      set(instr.dst, Value(lhs));
+      break;
+    case Op::kCall: {
+      auto& call = calls_[instr.aux];
+      for (size_t i = 0; i < call.argRegs.size(); ++i) {
+        call.args[i] = std::cref(*regs_[call.argRegs[i]]);
+      }
+      set(instr.dst, call.func(call.args));
+      break;
+    }
+    case Op::kAndStep:
+    case Op::kOrStep:
+      LOG(FATAL) << "Jumps are executed by the loop of eval";
+  }
+}
+
+// The same as LogicalExpression::evalAnd: BADNULL == false > NULL >= EMPTY > true
+bool ExprProgram::andStep(Value& acc, const Value& value) {
+  if (value.isBadNull() || (value.isBool() && !value.getBool())) {
+    acc = value;
+    return true;
+  }
+  if (!value.isBool()) {
+    if (value.isNull()) {
+      acc = value;
+    } else if (value.empty() && !acc.isNull()) {
+      acc = value;
+    } else {
+      acc = Value::kNullBadType;
+      return true;
+    }
+  }
+  return false;
+}
+
+// The same as LogicalExpression::evalOr: BADNULL == true > NULL >= EMPTY > false
+bool ExprProgram::orStep(Value& acc, const Value& value) {
+  if (value.isBadNull() || (value.isBool() && value.getBool())) {
+    acc = value;
+    return true;
+  }
+  if (!value.isBool()) {
+    if (value.isNull()) {
+      acc = value;
+    } else if (value.empty() && !acc.isNull()) {
+      acc = value;
+    } else {
+      acc = Value::kNullBadType;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace nebula
@@ -0,0 +1,158 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_EXPRESSION_EXPRPROGRAM_H_
+#define COMMON_EXPRESSION_EXPRPROGRAM_H_
+
+#include "common/base/Base.h"
+#include "common/expression/Expression.h"
+#include "common/expression/InSet.h"
+#include "common/function/FunctionManager.h"
+
+DECLARE_bool(enable_expr_program);
+
+namespace nebula {
+
+/**
+ * An expression compiled into a flat program of register based instructions, which is evaluated
+ * by a loop over the instructions instead of the virtual and recursive `Expression::eval`.
+ *
+ * Each instruction writes one register, and a register points to a constant of program, a value
+ * returned by reference from the context, or a value owned by program, so loading the property
+ * of input or variable doesn't copy it. While compiling, the constant subexpressions are folded,
+ * the comparisons with an int or string constant use the opcodes specialized for its type, IN a
+ * constant list looks up the list hashed once, and AND/OR jump over the rest operands once the
+ * result is decided.
+ *
+ * The kinds not compiled, e.g. CASE or list comprehension, are evaluated by calling `eval` of
+ * the subtree, so any expression can be compiled, and the result is always the same as
+ * `Expression::eval`.
+ *
+ * A program keeps the state of evaluation, so it must not be shared by threads, and the
+ * expression must outlive it.
+ */
+class ExprProgram final {
+ public:
+  static std::unique_ptr<ExprProgram> compile(Expression* expr);
+
+  const Value& eval(ExpressionContext& ctx);
+
+  // The number of instructions, 0 if the expression is folded to a constant
+  size_t size() const {
+    return code_.size();
+  }
+
+ private:
+  enum class Op : uint8_t {
+    // Load a property from the context, by reference or by value
+    kInputProp,
+    kVarProp,
+    kDstProp,
+    kVar,
+    kTagProp,
+    kEdgeProp,
+    kSrcProp,
+    // Evaluate the subtree not compiled
+    kEval,
+    // Arithmetic
+    kAdd,
+    kMinus,
+    kMultiply,
+    kDivision,
+    kMod,
+    // Unary
+    kPlus,
+    kNegate,
+    kNot,
+    kIsNull,
+    kIsNotNull,
+    kIsEmpty,
+    kIsNotEmpty,
+    // Relational
+    kEQ,
+    kNE,
+    kLT,
+    kLE,
+    kGT,
+    kGE,
+    // Relational whose rhs is an int constant
+    kEQInt,
+    kNEInt,
+    kLTInt,
+    kLEInt,
+    kGTInt,
+    kGEInt,
+    // Relational whose rhs is a string constant
+    kEQStr,
+    kNEStr,
+    kLTStr,
+    kLEStr,
+    kGTStr,
+    kGEStr,
+    // IN/NOT IN a constant list, `aux` is the hashed list
+    kIn,
+    kNotIn,
+    // Logical, `dst` is the result so far, jump to `aux` once it is decided
+    kInit,
+    kAndStep,
+    kOrStep,
+    kCall,
+  };
+
+  struct Instr {
+    Op op;
+    uint32_t dst;
+    // The registers of operands
+    uint32_t lhs;
+    uint32_t rhs;
+    // The index of side table, or the target of jump
+    uint32_t aux;
+  };
+
+  struct Call {
+    FunctionManager::Function func;
+    std::vector<uint32_t> argRegs;
+    // Bound to the registers before each call, so it is not allocated per row
+    std::vector<FunctionManager::ArgType> args;
+  };
+
+  ExprProgram() = default;
+
+  uint32_t compileExpr(Expression* expr);
+  uint32_t compileRelational(Expression* expr);
+  uint32_t compileLogical(Expression* expr);
+  uint32_t compileIn(Expression* expr);
+  uint32_t compileCall(Expression* expr);
+  uint32_t emit(Op op, uint32_t lhs = 0, uint32_t rhs = 0, uint32_t aux = 0);
+  // Emit the instruction, and fold it if all the operands are constants
+  uint32_t emitFoldable(Op op, uint32_t lhs, uint32_t rhs = 0);
+  uint32_t constant(Value value);
+  uint32_t fallback(Expression* expr);
+  uint32_t prop(const std::string& sym, const std::string& prop);
+
+  // Execute an instruction other than jumps, ctx is nullptr while folding
+  void exec(const Instr& instr, ExpressionContext* ctx);
+  void set(uint32_t reg, Value&& value) {
+    values_[reg] = std::move(value);
+    regs_[reg] = &values_[reg];
+  }
+
+  // The result of AND/OR so far is `acc`, return true if it is decided by the value
+  static bool andStep(Value& acc, const Value& value);
+  static bool orStep(Value& acc, const Value& value);
+
+  std::vector<Instr> code_;
+  std::vector<const Value*> regs_;
+  std::vector<Value> values_;
+  std::vector<bool> isConstant_;
+  uint32_t result_{0};
+  std::vector<std::pair<std::string, std::string>> props_;
+  std::vector<Expression*> exprs_;
+  std::vector<Call> calls_;
+  std::vector<std::unique_ptr<InSet>> sets_;
+};
+
+}  // namespace nebula
+#endif  // COMMON_EXPRESSION_EXPRPROGRAM_H_
@@ -0,0 +1,117 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/expression/InSet.h"
+
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/ContainerExpression.h"
+
+namespace nebula {
+
+std::unique_ptr<InSet> InSet::make(const Expression* expr) {
+  // A set is hashed already
+  if (expr->kind() == Expression::Kind::kConstant) {
+    const auto& value = static_cast<const ConstantExpression*>(expr)->value();
+    return value.isList() ? std::make_unique<InSet>(value.getList().values) : nullptr;
+  }
+  if (expr->kind() != Expression::Kind::kList) {
+    return nullptr;
+  }
+  const auto& items = static_cast<const ListExpression*>(expr)->items();
+  std::vector<Value> values;
+  values.reserve(items.size());
+  for (const auto* item : items) {
+    if (item->kind() != Expression::Kind::kConstant) {
+      return nullptr;
+    }
+    values.emplace_back(static_cast<const ConstantExpression*>(item)->value());
+  }
+  return std::make_unique<InSet>(values);
+}
+
+InSet::InSet(const std::vector<Value>& values) {
+  for (const auto& value : values) {
+    add(value);
+  }
+  std::sort(floats_.begin(), floats_.end());
+  std::sort(numbers_.begin(), numbers_.end());
+}
+
+void InSet::add(const Value& value) {
+  switch (value.type()) {
+    case Value::Type::__EMPTY__:
+      hasEmpty_ = true;
+      break;
+    case Value::Type::NULLVALUE:
+      hasNull_ = true;
+      break;
+    case Value::Type::INT:
+      ints_.emplace(value.getInt());
+      numbers_.emplace_back(static_cast<double>(value.getInt()));
+      break;
+    case Value::Type::FLOAT:
+      // NaN equals nothing
+      if (!std::isnan(value.getFloat())) {
+        floats_.emplace_back(value.getFloat());
+        numbers_.emplace_back(value.getFloat());
+      }
+      break;
+    case Value::Type::BOOL:
+    case Value::Type::STRING:
+    case Value::Type::DATE:
+    case Value::Type::TIME:
+    case Value::Type::DATETIME:
+    case Value::Type::DURATION:
+      values_.emplace(value);
+      break;
+    default:
+      others_.emplace_back(value);
+  }
+}
+
+bool InSet::containsNumber(const std::vector<double>& numbers, double value) {
+  // The first number greater than value - kEpsilon is the only candidate closer than kEpsilon
+  auto it = std::upper_bound(numbers.begin(), numbers.end(), value - kEpsilon);
+  return it != numbers.end() && *it - value < kEpsilon;
+}
+
+bool InSet::contains(const Value& value) const {
+  switch (value.type()) {
+    case Value::Type::__EMPTY__:
+      return hasEmpty_;
+    case Value::Type::NULLVALUE:
+      return hasNull_;
+    case Value::Type::INT:
+      // The ints are compared exactly, and the floats within kEpsilon
+      return ints_.count(value.getInt()) != 0 ||
+             containsNumber(floats_, static_cast<double>(value.getInt()));
+    case Value::Type::FLOAT:
+      return containsNumber(numbers_, value.getFloat());
+    case Value::Type::BOOL:
+    case Value::Type::STRING:
+    case Value::Type::DATE:
+    case Value::Type::TIME:
+    case Value::Type::DATETIME:
+    case Value::Type::DURATION:
+      return values_.count(value) != 0;
+    default:
+      return std::find(others_.begin(), others_.end(), value) != others_.end();
+  }
+}
+
+Value InSet::in(const Value& lhs, bool negated) const {
+  if (lhs.isNull()) {
+    return Value::kNullValue;
+  }
+  if (contains(lhs)) {
+    return !negated;
+  }
+  if (hasNull_) {
+    return Value::kNullValue;
+  }
+  return negated;
+}
+
+}  // namespace nebula
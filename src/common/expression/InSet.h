@@ -0,0 +1,54 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_EXPRESSION_INSET_H_
+#define COMMON_EXPRESSION_INSET_H_
+
+#include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+#include "common/expression/Expression.h"
+
+namespace nebula {
+
+/**
+ * The elements of a constant list on the right of IN/NOT IN, hashed once so that each
+ * evaluation is a lookup instead of a scan of the list, with the same result as
+ * `RelationalExpression`.
+ *
+ * The ints are hashed, and the numbers are also kept sorted as doubles, since an int and a float
+ * are equal within `kEpsilon`. The values of primitive types are hashed, while the containers,
+ * vertices, edges and paths are scanned, whose equality isn't consistent with their hash. Whether
+ * there is a null is known beforehand, so a miss doesn't rescan the list for it.
+ */
+class InSet final {
+ public:
+  // Return nullptr if the expression is not a constant list
+  static std::unique_ptr<InSet> make(const Expression* expr);
+
+  explicit InSet(const std::vector<Value>& values);
+
+  // The result of `lhs IN set`, or of `lhs NOT IN set` if `negated`
+  Value in(const Value& lhs, bool negated) const;
+
+  // Whether any element equals the value
+  bool contains(const Value& value) const;
+
+ private:
+  void add(const Value& value);
+  // Whether any of the sorted numbers is equal to the value within kEpsilon
+  static bool containsNumber(const std::vector<double>& numbers, double value);
+
+  std::unordered_set<int64_t> ints_;
+  // The floats, and all the numbers, sorted
+  std::vector<double> floats_;
+  std::vector<double> numbers_;
+  std::unordered_set<Value> values_;
+  std::vector<Value> others_;
+  bool hasNull_{false};
+  bool hasEmpty_{false};
+};
+
+}  // namespace nebula
+#endif  // COMMON_EXPRESSION_INSET_H_
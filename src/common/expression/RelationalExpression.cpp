@@ -12,6 +12,13 @@
 
 namespace nebula {
 const Value& RelationalExpression::eval(ExpressionContext& ctx) {
+  if (kind_ == Kind::kRelIn || kind_ == Kind::kRelNotIn) {
+    // The constant list is hashed beforehand, and not evaluated per row
+    if (inSet_ != nullptr) {
+      result_ = inSet_->in(lhs_->eval(ctx), kind_ == Kind::kRelNotIn);
+      return result_;
+    }
+  }
   auto& lhs = lhs_->eval(ctx);
   auto& rhs = rhs_->eval(ctx);
 
@@ -42,7 +49,7 @@ const Value& RelationalExpression::eval(ExpressionContext& ctx) {
       } else if (lhs.isStr() && rhs.isStr()) {
         try {
           const auto& r = ctx.getRegex(rhs.getStr());
-          result_ = std::regex_match(lhs.getStr(), r);
+          result_ = r.match(lhs.getStr());
         } catch (const std::exception& ex) {
           LOG(ERROR) << "Regex match error: " << ex.what();
           result_ = Value::kNullBadType;
@@ -260,4 +267,17 @@ void RelationalExpression::accept(ExprVisitor* visitor) {
   visitor->visit(this);
 }
 
+void RelationalExpression::resetFrom(Decoder& decoder) {
+  BinaryExpression::resetFrom(decoder);
+  makeInSet();
+}
+
+void RelationalExpression::makeInSet() {
+  if ((kind_ == Kind::kRelIn || kind_ == Kind::kRelNotIn) && rhs_ != nullptr) {
+    inSet_ = InSet::make(rhs_);
+  } else {
+    inSet_.reset();
+  }
+}
+
 }  // namespace nebula
@@ -7,6 +7,7 @@
 #define COMMON_EXPRESSION_RELATIONALEXPRESSION_H_
 
 #include "common/expression/BinaryExpression.h"
+#include "common/expression/InSet.h"
 
 namespace nebula {
 class RelationalExpression final : public BinaryExpression {
@@ -123,12 +124,26 @@ class RelationalExpression final : public BinaryExpression {
     return true;
   }
 
+  void setRight(Expression* expr) override {
+    BinaryExpression::setRight(expr);
+    makeInSet();
+  }
+
  private:
   explicit RelationalExpression(ObjectPool* pool, Kind kind, Expression* lhs, Expression* rhs)
-      : BinaryExpression(pool, kind, lhs, rhs) {}
+      : BinaryExpression(pool, kind, lhs, rhs) {
+    makeInSet();
+  }
+
+  void resetFrom(Decoder& decoder) override;
+
+  // Hash the rhs of IN/NOT IN if it is a constant list, the rhs is only replaced by setRight
+  // once the expression is built
+  void makeInSet();
 
  private:
   Value result_;
+  std::unique_ptr<InSet> inSet_;
 };
 
 }  // namespace nebula
@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "common/expression/ExprProgram.h"
+#include "common/expression/test/TestBase.h"
+
+namespace nebula {
+
+class ExprProgramTest : public ExpressionTest {
+ protected:
+  Expression *parse(const std::string &exprSymbol) {
+    std::string query = "RETURN " + exprSymbol;
+    nebula::GQLParser gParser(&queryCtxt_);
+    auto result = gParser.parse(query);
+    CHECK(result.ok()) << result.status();
+    sentences_.emplace_back(std::move(result).value());
+    auto *sequentialSentences = static_cast<SequentialSentences *>(sentences_.back().get());
+    auto *yieldSentence = static_cast<YieldSentence *>(sequentialSentences->sentences()[0]);
+    return yieldSentence->yield()->yields()->back()->expr();
+  }
+
+  // The program gives the same result as the expression
+  void testProgram(Expression *expr, size_t size) {
+    auto program = ExprProgram::compile(expr);
+    auto expected = Expression::eval(expr, gExpCtxt);
+    // Evaluated twice to check the registers are reset
+    for (int i = 0; i < 2; ++i) {
+      auto actual = program->eval(gExpCtxt);
+      EXPECT_EQ(expected.type(), actual.type()) << "type check failed: " << expr->toString();
+      EXPECT_EQ(expected, actual) << "check failed: " << expr->toString();
+    }
+    EXPECT_EQ(size, program->size()) << expr->toString();
+  }
+
+  void testProgram(const std::string &exprSymbol, size_t size) {
+    testProgram(parse(exprSymbol), size);
+  }
+
+ private:
+  nebula::graph::QueryContext queryCtxt_;
+  std::vector<std::unique_ptr<Sentence>> sentences_;
+};
+
+TEST_F(ExprProgramTest, ConstantFolding) {
+  testProgram("1 + 2 * 3 - 4 / 2 % 3", 0);
+  testProgram("-(1.5 + 2) > 3 OR NOT (\"a\" < \"b\")", 0);
+  testProgram("true AND (1 == 1) AND NULL", 0);
+  testProgram("abs(-1) + 1", 0);
+  testProgram("1 / 0", 0);
+  testProgram("rand() > 2", 2);
+}
+
+TEST_F(ExprProgramTest, Property) {
+  testProgram("$-.int + 1", 2);
+  testProgram("$-.float * 2 - $-.int", 4);
+  testProgram("$^.source.srcProperty > 10", 2);
+  testProgram("$$.dest.dstProperty <= 3", 2);
+  testProgram("-$-.int IS NOT NULL", 3);
+  testProgram("$-.empty IS EMPTY", 2);
+  testProgram("$-.nonexistent", 1);
+  testProgram(TagPropertyExpression::make(&pool, "tag", "int"), 1);
+  testProgram(EdgePropertyExpression::make(&pool, "edge", "float"), 1);
+}
+
+TEST_F(ExprProgramTest, Relational) {
+  // Specialized for the int constant
+  testProgram("$-.int == 1", 2);
+  testProgram("$-.int != 1", 2);
+  testProgram("$-.int < 2", 2);
+  testProgram("$-.int <= 1", 2);
+  testProgram("$-.int > 0", 2);
+  testProgram("$-.int >= 2", 2);
+  testProgram("$-.float > 1", 2);
+  testProgram("$-.null < 1", 2);
+  testProgram("$-.empty == 1", 2);
+  // Specialized for the string constant
+  testProgram("$-.string16 == \"aaaaaaaaaaaaaaaa\"", 2);
+  testProgram("$-.string16 < \"b\"", 2);
+  testProgram("$-.string16 >= \"b\"", 2);
+  testProgram("$-.int > \"b\"", 2);
+  // Not specialized
+  testProgram("$-.int < 1.5", 2);
+  testProgram("1 < $-.int", 2);
+  testProgram("$-.int == $-.float", 3);
+}
+
+TEST_F(ExprProgramTest, In) {
+  testProgram("$-.int IN [1, 2, 3] AND $-.bool_true", 6);
+  testProgram("$-.int NOT IN [2, 3.0, \"a\"]", 2);
+  testProgram("$-.float IN [1.1, NULL]", 2);
+  testProgram("$-.string16 NOT IN [\"a\", NULL]", 2);
+  testProgram("$-.null IN [1, 2]", 2);
+  testProgram("2 IN [1, 2]", 0);
+  testProgram("$-.int IN {1, 2}", 1);
+}
+
+TEST_F(ExprProgramTest, Logical) {
+  testProgram("$-.int == 1 AND $-.float > 1.0", 7);
+  testProgram("$-.int == 2 AND $-.float > 1.0", 7);
+  testProgram("$-.int == 2 OR $-.float > 1.0", 7);
+  testProgram("$-.int == 2 OR $-.float < 1.0", 7);
+  testProgram("$-.null AND $-.bool_true", 5);
+  testProgram("$-.empty AND $-.bool_true AND $-.null", 9);
+  testProgram("$-.null OR $-.empty OR $-.bool_false", 9);
+  testProgram("$-.int AND $-.bool_true", 5);
+  testProgram("$-.int OR $-.bool_false", 5);
+  testProgram("($-.int > 0 OR $-.int < -1) AND NOT $-.bool_false", 12);
+}
+
+TEST_F(ExprProgramTest, Fallback) {
+  // Function calls
+  testProgram("abs($-.int - 3)", 3);
+  testProgram("concat($-.string16, \"b\", $-.string16)", 3);
+  // Not compiled
+  testProgram("CASE $-.int WHEN 1 THEN \"one\" ELSE \"other\" END", 1);
+  testProgram("$-.int IN [1, $-.int] AND $-.bool_true", 5);
+  testProgram("[1, $-.int][1]", 1);
+}
+
+}  // namespace nebula
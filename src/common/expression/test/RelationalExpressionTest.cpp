@@ -501,6 +501,99 @@ TEST_F(RelationalExpressionTest, InList) {
   }
 }
 
+TEST_F(RelationalExpressionTest, InConstantList) {
+  List list({1,
+             2.5,
+             "a",
+             true,
+             Value(),
+             Date(2022, 1, 1),
+             List({1, 2}),
+             Map({{"k", 1}}),
+             std::numeric_limits<double>::quiet_NaN()});
+  List probes({1,
+               1.0,
+               1.000000001,
+               2,
+               2.5,
+               2.500000001,
+               "a",
+               "b",
+               true,
+               false,
+               Value(),
+               Value::kNullValue,
+               Value::kNullBadType,
+               Date(2022, 1, 1),
+               List({1.0, 2}),
+               List({2, 1}),
+               Map({{"k", 1}}),
+               std::numeric_limits<double>::quiet_NaN()});
+  // The same as scanning the list
+  auto in = [](const List& l, const Value& lhs) -> Value {
+    if (lhs.isNull()) {
+      return Value::kNullValue;
+    }
+    if (l.contains(lhs)) {
+      return true;
+    }
+    return l.contains(Value::kNullValue) ? Value::kNullValue : Value(false);
+  };
+  for (const auto& withNull : {false, true}) {
+    auto rhs = list;
+    if (withNull) {
+      rhs.emplace_back(Value::kNullValue);
+    }
+    auto* inExpr =
+        RelationalExpression::makeIn(&pool, nullptr, ConstantExpression::make(&pool, rhs));
+    auto* notInExpr =
+        RelationalExpression::makeNotIn(&pool, nullptr, ConstantExpression::make(&pool, rhs));
+    for (const auto& probe : probes.values) {
+      auto expected = in(rhs, probe);
+      inExpr->setLeft(ConstantExpression::make(&pool, probe));
+      notInExpr->setLeft(ConstantExpression::make(&pool, probe));
+      auto eval = Expression::eval(inExpr, gExpCtxt);
+      EXPECT_EQ(expected.type(), eval.type()) << inExpr->toString();
+      EXPECT_EQ(expected, eval) << inExpr->toString();
+      eval = Expression::eval(notInExpr, gExpCtxt);
+      EXPECT_EQ(expected.type(), eval.type()) << notInExpr->toString();
+      EXPECT_EQ(expected.isBool() ? Value(!expected.getBool()) : expected, eval)
+          << notInExpr->toString();
+    }
+  }
+}
+
+TEST_F(RelationalExpressionTest, InConstantListReplaced) {
+  auto makeList = [](std::vector<Value> values) {
+    auto *elist = ExpressionList::make(&pool);
+    for (auto &value : values) {
+      elist->add(ConstantExpression::make(&pool, std::move(value)));
+    }
+    return ListExpression::make(&pool, elist);
+  };
+  auto *expr = RelationalExpression::makeIn(
+      &pool, ConstantExpression::make(&pool, 1.000000015), makeList({1.0, 1.00000002, 3}));
+  EXPECT_EQ(Value(true), Expression::eval(expr, gExpCtxt));
+  // The set follows the replaced rhs
+  expr->setRight(makeList({1.0, 2, 3}));
+  EXPECT_EQ(Value(false), Expression::eval(expr, gExpCtxt));
+  expr->setRight(makeList({1.00000003, Value::kNullValue}));
+  EXPECT_EQ(Value::kNullValue, Expression::eval(expr, gExpCtxt));
+  expr->setRight(ConstantExpression::make(&pool, List({1.000000019})));
+  EXPECT_EQ(Value(true), Expression::eval(expr, gExpCtxt));
+  // Decoded with the set
+  auto *decoded = Expression::decode(&pool, Expression::encode(*expr));
+  EXPECT_EQ(*expr, *decoded);
+  EXPECT_EQ(Value(true), Expression::eval(decoded, gExpCtxt));
+  // Not a constant list any more
+  auto *elist = ExpressionList::make(&pool);
+  elist->add(ConstantExpression::make(&pool, 2))
+      .add(ArithmeticExpression::makeMinus(
+          &pool, ConstantExpression::make(&pool, 2.000000015), ConstantExpression::make(&pool, 1)));
+  expr->setRight(ListExpression::make(&pool, elist));
+  EXPECT_EQ(Value(true), Expression::eval(expr, gExpCtxt));
+}
+
 TEST_F(RelationalExpressionTest, InSet) {
   {
     auto *elist = ExpressionList::make(&pool);
@@ -14,6 +14,7 @@
 #include <s2/s2cap.h>
 #include <s2/s2cell.h>
 #include <s2/s2cell_id.h>
+#include <s2/s2cell_union.h>
 #include <s2/s2earth.h>
 #include <s2/s2latlng.h>
 #include <s2/s2polygon.h>
@@ -124,6 +125,41 @@ std::vector<ScanRange> GeoIndex::dWithin(const Geography& g, double distance) co
   }
 }
 
+std::vector<ScanRange> GeoIndex::dWithinRing(const Geography& g,
+                                             double innerDistance,
+                                             double outerDistance) const noexcept {
+  DCHECK(pointsOnly_);
+  if (g.shape() != GeoShape::POINT) {
+    return {};
+  }
+  auto r = g.asS2();
+  if (UNLIKELY(!r)) {
+    return {};
+  }
+
+  const S2Point& gPoint = static_cast<S2PointRegion*>(r.get())->point();
+  S2Cap outerCap(gPoint, S2Earth::ToAngle(util::units::Meters(outerDistance)));
+  S2CellUnion ring(coveringCells(outerCap));
+  if (innerDistance > 0) {
+    // The cells covered by the inner cap entirely have been scanned already
+    S2Cap innerCap(gPoint, S2Earth::ToAngle(util::units::Meters(innerDistance)));
+    S2RegionCoverer rc(rcParams_.s2RegionCovererOpts());
+    std::vector<S2CellId> interior;
+    rc.GetInteriorCovering(innerCap, &interior);
+    ring = ring.Difference(S2CellUnion(std::move(interior)));
+  }
+
+  std::vector<ScanRange> scanRanges;
+  for (const S2CellId& cellId : ring) {
+    if (cellId.is_leaf()) {
+      scanRanges.emplace_back(cellId.id());
+    } else {
+      scanRanges.emplace_back(cellId.range_min().id(), cellId.range_max().id());
+    }
+  }
+  return scanRanges;
+}
+
 std::vector<ScanRange> GeoIndex::intersects(const S2Region& r, bool isPoint) const noexcept {
   auto cells = coveringCells(r, isPoint);
   std::vector<ScanRange> scanRanges;
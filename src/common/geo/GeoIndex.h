@@ -75,6 +75,11 @@ class GeoIndex {
   std::vector<ScanRange> coveredBy(const Geography& g) const noexcept;
   // ST_Distance(g, x, distance), x is the indexed geography column
   std::vector<ScanRange> dWithin(const Geography& g, double distance) const noexcept;
+  // The cells within outerDistance of the point g but not within innerDistance, which are scanned
+  // ring by ring to find the nearest neighbors of g. Only for the column of points.
+  std::vector<ScanRange> dWithinRing(const Geography& g,
+                                     double innerDistance,
+                                     double outerDistance) const noexcept;
 
  private:
   std::vector<ScanRange> intersects(const S2Region& r, bool isPoint = false) const noexcept;
@@ -5,7 +5,9 @@
 
 #include <gtest/gtest.h>
 #include <s2/s2cell_id.h>
+#include <s2/s2earth.h>
 
+#include <cmath>
 #include <cstdint>
 #include <unordered_set>
 
@@ -306,6 +308,51 @@ TEST(indexCells, polygon) {
   }
 }
 
+TEST(dWithinRing, point) {
+  geo::RegionCoverParams rc(0, 30, 8);
+  geo::GeoIndex geoIndex(rc, true);
+  auto center = Geography::fromWKT("POINT(1.0 1.0)").value();
+  // The point north of center by the distance in meters
+  auto north = [](double distance) {
+    double degrees = distance / (S2Earth::RadiusMeters() * M_PI / 180);
+    return Geography::fromWKT(folly::sformat("POINT(1.0 {})", 1.0 + degrees)).value();
+  };
+  auto covered = [&geoIndex](const std::vector<ScanRange>& ranges, const Geography& point) {
+    auto cell = geoIndex.indexCells(point).front();
+    for (auto& range : ranges) {
+      if (range.isRangeScan ? range.rangeMin <= cell && cell <= range.rangeMax
+                            : range.rangeMin == cell) {
+        return true;
+      }
+    }
+    return false;
+  };
+  {
+    auto ranges = geoIndex.dWithinRing(center, 0, 1000);
+    EXPECT_TRUE(covered(ranges, center));
+    EXPECT_TRUE(covered(ranges, north(10)));
+    EXPECT_TRUE(covered(ranges, north(999)));
+  }
+  {
+    // Every point in (1000, 4000] is in the ring
+    auto ranges = geoIndex.dWithinRing(center, 1000, 4000);
+    EXPECT_FALSE(ranges.empty());
+    EXPECT_TRUE(covered(ranges, north(1001)));
+    EXPECT_TRUE(covered(ranges, north(2000)));
+    EXPECT_TRUE(covered(ranges, north(3999)));
+  }
+  {
+    // The ring covering the whole sphere
+    auto ranges = geoIndex.dWithinRing(center, 4000, S2Earth::RadiusMeters() * M_PI);
+    EXPECT_TRUE(covered(ranges, Geography::fromWKT("POINT(-179.0 -1.0)").value()));
+    EXPECT_TRUE(covered(ranges, Geography::fromWKT("POINT(100.0 45.0)").value()));
+  }
+  {
+    auto line = Geography::fromWKT("LINESTRING(1.0 1.0, 2.0 2.0)").value();
+    EXPECT_TRUE(geoIndex.dWithinRing(line, 0, 1000).empty());
+  }
+}
+
 }  // namespace geo
 }  // namespace nebula
 
@@ -53,6 +53,9 @@ struct TccStructTraits<::nebula::ExecutionResponse> {
     } else if (_fname == "comment") {
       fid = 7;
       _ftype = apache::thrift::protocol::T_STRING;
+    } else if (_fname == "cursor_id") {
+      fid = 8;
+      _ftype = apache::thrift::protocol::T_I64;
     }
   }
 };
@@ -104,6 +107,12 @@ uint32_t Cpp2Ops<::nebula::ExecutionResponse>::write(Protocol* proto,
     xfer += proto->writeBinary(*obj->comment);
     xfer += proto->writeFieldEnd();
   }
+  if (obj->cursorId != nullptr) {
+    xfer += proto->writeFieldBegin("cursor_id", apache::thrift::protocol::T_I64, 8);
+    xfer += ::apache::thrift::detail::pm::protocol_methods<::apache::thrift::type_class::integral,
+                                                           int64_t>::write(*proto, *obj->cursorId);
+    xfer += proto->writeFieldEnd();
+  }
   xfer += proto->writeFieldStop();
   xfer += proto->writeStructEnd();
   return xfer;
@@ -183,7 +192,17 @@ _readField_comment : {
   //    this->__isset.comment = true;
 }
 
-  if (UNLIKELY(!_readState.advanceToNextField(proto, 7, 0, apache::thrift::protocol::T_STOP))) {
+  if (UNLIKELY(!_readState.advanceToNextField(proto, 7, 8, apache::thrift::protocol::T_I64))) {
+    goto _loop;
+  }
+_readField_cursor_id : {
+  obj->cursorId = std::make_unique<int64_t>();
+  ::apache::thrift::detail::pm::protocol_methods<::apache::thrift::type_class::integral,
+                                                 int64_t>::read(*proto, *obj->cursorId);
+  //    this->__isset.cursor_id = true;
+}
+
+  if (UNLIKELY(!_readState.advanceToNextField(proto, 8, 0, apache::thrift::protocol::T_STOP))) {
     goto _loop;
   }
 
@@ -257,6 +276,13 @@ _loop:
         goto _skip;
       }
     }
+    case 8: {
+      if (LIKELY(_readState.fieldType == apache::thrift::protocol::T_I64)) {
+        goto _readField_cursor_id;
+      } else {
+        goto _skip;
+      }
+    }
     default: {
 _skip:
       proto->skip(_readState.fieldType);
@@ -301,6 +327,12 @@ uint32_t Cpp2Ops<::nebula::ExecutionResponse>::serializedSize(
     xfer += proto->serializedFieldSize("comment", apache::thrift::protocol::T_STRING, 7);
     xfer += proto->serializedSizeBinary(obj->comment);
   }
+  if (obj->cursorId != nullptr) {
+    xfer += proto->serializedFieldSize("cursor_id", apache::thrift::protocol::T_I64, 8);
+    xfer += ::apache::thrift::detail::pm::
+        protocol_methods<::apache::thrift::type_class::integral, int64_t>::serializedSize<false>(
+            *proto, *obj->cursorId);
+  }
   xfer += proto->serializedSizeStop();
   return xfer;
 }
@@ -339,6 +371,12 @@ uint32_t Cpp2Ops<::nebula::ExecutionResponse>::serializedSizeZC(
     xfer += proto->serializedFieldSize("comment", apache::thrift::protocol::T_STRING, 7);
     xfer += proto->serializedSizeZCBinary(*obj->comment);
   }
+  if (obj->cursorId != nullptr) {
+    xfer += proto->serializedFieldSize("cursor_id", apache::thrift::protocol::T_I64, 8);
+    xfer += ::apache::thrift::detail::pm::
+        protocol_methods<::apache::thrift::type_class::integral, int64_t>::serializedSize<false>(
+            *proto, *obj->cursorId);
+  }
   xfer += proto->serializedSizeStop();
   return xfer;
 }
@@ -173,6 +173,8 @@
   /* transaction */                                                           \
   X(E_OUTDATED_LOCK, -3047)                                                   \
                                                                               \
+  X(E_SCAN_SNAPSHOT_EXPIRED, -3048)                                           \
+                                                                              \
   /* task manager failed */                                                   \
   X(E_INVALID_TASK_PARA, -3051)                                               \
   X(E_USER_CANCEL, -3052)                                                     \
@@ -497,6 +499,7 @@ struct ExecutionResponse {
     errorMsg.reset();
     planDesc.reset();
     comment.reset();
+    cursorId.reset();
   }
 
   void clear() {
@@ -525,6 +528,9 @@ struct ExecutionResponse {
     if (!checkPointer(comment.get(), rhs.comment.get())) {
       return false;
     }
+    if (!checkPointer(cursorId.get(), rhs.cursorId.get())) {
+      return false;
+    }
     return true;
   }
 
@@ -535,6 +541,8 @@ struct ExecutionResponse {
   std::unique_ptr<std::string> errorMsg{nullptr};
   std::unique_ptr<PlanDescription> planDesc{nullptr};
   std::unique_ptr<std::string> comment{nullptr};
+  // Set if there are more rows to fetch by the cursor
+  std::unique_ptr<int64_t> cursorId{nullptr};
 
   // Return the response as a JSON string
   // only errorCode and latencyInUs are required fields, the rest are optional
@@ -624,6 +632,9 @@ struct ExecutionResponse {
     if (comment) {
       resultBody.insert("comment", *comment);
     }
+    if (cursorId) {
+      resultBody.insert("cursorId", *cursorId);
+    }
 
     auto resultArray = folly::dynamic::array();
     resultArray.push_back(resultBody);
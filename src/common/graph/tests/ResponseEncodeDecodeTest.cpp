@@ -59,6 +59,14 @@ TEST(ResponseEncodeDecodeTest, Basic) {
                                          nullptr,
                                          std::make_unique<std::string>("test_space"),
                                          std::make_unique<std::string>("Error Msg.")});
+    resps.emplace_back(ExecutionResponse{ErrorCode::SUCCEEDED,
+                                         233,
+                                         std::make_unique<DataSet>(),
+                                         std::make_unique<std::string>("test_space"),
+                                         nullptr,
+                                         nullptr,
+                                         nullptr,
+                                         std::make_unique<int64_t>(7)});
     for (const auto &resp : resps) {
       std::string buf;
       buf.reserve(128);
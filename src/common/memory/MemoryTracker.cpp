@@ -0,0 +1,36 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/memory/MemoryTracker.h"
+
+namespace nebula {
+
+MemoryTracker::~MemoryTracker() {
+  auto used = used_.load(std::memory_order_relaxed);
+  if (parent_ != nullptr && used != 0) {
+    parent_->release(used);
+  }
+}
+
+void MemoryTracker::consume(int64_t bytes) {
+  for (auto *tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    tracker->used_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+}
+
+void MemoryTracker::release(int64_t bytes) {
+  consume(-bytes);
+}
+
+const MemoryTracker *MemoryTracker::exceeded() const {
+  for (auto *tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    if (tracker->limit_ > 0 && tracker->used() > tracker->limit_) {
+      return tracker;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace nebula
@@ -0,0 +1,63 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_MEMORY_MEMORYTRACKER_H
+#define COMMON_MEMORY_MEMORYTRACKER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace nebula {
+
+/**
+ * MemoryTracker accounts the memory used by an owner, e.g. a query, and the usage is also
+ * accounted to its parent, e.g. the session of the query. Each tracker could have a quota, the
+ * usage is always accounted even beyond the quota, and the owner decides what to do once any
+ * tracker of its ancestors exceeds the quota.
+ */
+class MemoryTracker final {
+ public:
+  /**
+   * @param limit The quota in bytes, no quota if not positive
+   * @param parent The parent tracker, which must outlive this one
+   */
+  explicit MemoryTracker(int64_t limit = 0, MemoryTracker *parent = nullptr)
+      : limit_(limit), parent_(parent) {}
+
+  // Release the usage left from the parent
+  ~MemoryTracker();
+
+  MemoryTracker(const MemoryTracker &) = delete;
+  MemoryTracker &operator=(const MemoryTracker &) = delete;
+
+  void consume(int64_t bytes);
+
+  void release(int64_t bytes);
+
+  int64_t used() const {
+    return used_.load(std::memory_order_relaxed);
+  }
+
+  int64_t limit() const {
+    return limit_;
+  }
+
+  MemoryTracker *parent() const {
+    return parent_;
+  }
+
+  /**
+   * @brief The nearest tracker exceeding its quota from this one to the root, nullptr if none
+   */
+  const MemoryTracker *exceeded() const;
+
+ private:
+  std::atomic<int64_t> used_{0};
+  const int64_t limit_;
+  MemoryTracker *parent_;
+};
+
+}  // namespace nebula
+#endif
@@ -0,0 +1,43 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/memory/MemoryTracker.h"
+
+namespace nebula {
+
+TEST(MemoryTrackerTest, ConsumeAndRelease) {
+  MemoryTracker session(100);
+  {
+    MemoryTracker query1(60, &session);
+    MemoryTracker query2(0, &session);
+    query1.consume(50);
+    query2.consume(30);
+    EXPECT_EQ(50, query1.used());
+    EXPECT_EQ(30, query2.used());
+    EXPECT_EQ(80, session.used());
+    EXPECT_EQ(nullptr, query1.exceeded());
+    EXPECT_EQ(nullptr, query2.exceeded());
+
+    // The query exceeding its own quota
+    query1.consume(20);
+    EXPECT_EQ(&query1, query1.exceeded());
+    EXPECT_EQ(nullptr, query2.exceeded());
+    query1.release(20);
+    EXPECT_EQ(nullptr, query1.exceeded());
+
+    // The query without quota exceeds the quota of session
+    query2.consume(40);
+    EXPECT_EQ(120, session.used());
+    EXPECT_EQ(&session, query2.exceeded());
+    EXPECT_EQ(&session, query1.exceeded());
+  }
+  // The usage left is released from session along with the queries
+  EXPECT_EQ(0, session.used());
+  EXPECT_EQ(nullptr, session.exceeded());
+}
+
+}  // namespace nebula
@@ -50,6 +50,7 @@ std::unordered_map<std::string, std::pair<cpp2::ConfigMode, bool>> GflagsManager
   // The default conf for gflags flags mode
   std::unordered_map<std::string, std::pair<cpp2::ConfigMode, bool>> configModeMap{
       {"max_edge_returned_per_vertex", {cpp2::ConfigMode::MUTABLE, false}},
+      {"max_local_expanded_vertices", {cpp2::ConfigMode::MUTABLE, false}},
       {"minloglevel", {cpp2::ConfigMode::MUTABLE, false}},
       {"v", {cpp2::ConfigMode::MUTABLE, false}},
       {"heartbeat_interval_secs", {cpp2::ConfigMode::MUTABLE, false}},
@@ -7,6 +7,12 @@
 #define COMMON_UTILS_MEMORYLOCKCORE_H
 
 #include <folly/concurrency/ConcurrentHashMap.h>
+#include <folly/executors/GlobalExecutor.h>
+#include <folly/futures/Future.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
 
 #include "common/base/Base.h"
 
@@ -15,6 +21,8 @@ namespace nebula {
 template <typename Key>
 class MemoryLockCore {
  public:
+  using LockCallback = folly::Function<void(bool /* locked */)>;
+
   MemoryLockCore() = default;
 
   ~MemoryLockCore() = default;
@@ -32,7 +40,34 @@ class MemoryLockCore {
   }
 
   void unlock(const Key& key) {
-    hashMap_.erase(key);
+    std::shared_ptr<Waiter> waiter;
+    {
+      auto& stripe = stripeOf(key);
+      std::lock_guard<std::mutex> guard(stripe.lock);
+      auto it = stripe.waiters.find(key);
+      if (it != stripe.waiters.end()) {
+        auto& queue = it->second;
+        while (!queue.empty() && waiter == nullptr) {
+          // skip the waiters which have been expired
+          if (!queue.front()->done.exchange(true)) {
+            waiter = queue.front();
+          }
+          queue.pop_front();
+        }
+        if (queue.empty()) {
+          stripe.waiters.erase(it);
+        }
+      }
+      if (waiter == nullptr) {
+        hashMap_.erase(key);
+        return;
+      }
+    }
+    // keep the key in hashMap_ and hand over the lock to the first waiter
+    folly::getGlobalCPUExecutor()->add([this, batch = std::move(waiter->batch)]() mutable {
+      ++batch->next;
+      lockNext(std::move(batch));
+    });
   }
 
   template <class Iter>
@@ -55,10 +90,26 @@ class MemoryLockCore {
     return lockBatch(collection.begin(), collection.end());
   }
 
+  // Lock the keys one by one without blocking the caller. The keys should be sorted and deduped by
+  // caller, so that all batches acquire the keys in the same order and never deadlock. If a key is
+  // held by others, the rest of the batch is queued as a continuation in the FIFO waiter list of
+  // the key, and the lock is handed over to it directly when released, so waiters are served in
+  // order and nobody could barge in.
+  // `cb` is called with true once all keys are locked, or with false and none of the keys held if
+  // some key is not granted within timeout. It is called in place if the batch never waits,
+  // otherwise on the global cpu executor. The lock core must outlive the batches waiting on it.
+  void lockBatchAsync(std::vector<Key> keys, std::chrono::milliseconds timeout, LockCallback cb) {
+    auto batch = std::make_shared<Batch>();
+    batch->keys = std::move(keys);
+    batch->deadline = std::chrono::steady_clock::now() + timeout;
+    batch->cb = std::move(cb);
+    lockNext(std::move(batch));
+  }
+
   template <class Iter>
   void unlockBatch(Iter begin, Iter end) {
     for (; begin != end; ++begin) {
-      hashMap_.erase(*begin);
+      unlock(*begin);
     }
   }
 
@@ -76,7 +127,97 @@ class MemoryLockCore {
   }
 
  protected:
+  static constexpr size_t kStripeNum = 64;
+
+  struct Batch {
+    std::vector<Key> keys;
+    // keys before next are locked
+    size_t next{0};
+    std::chrono::steady_clock::time_point deadline;
+    LockCallback cb;
+  };
+
+  struct Waiter {
+    std::shared_ptr<Batch> batch;
+    // set by whoever takes the waiter first, either the lock holder granting it or the timer
+    std::atomic<bool> done{false};
+  };
+
+  // Waiters of keys are sharded into stripes, only the contended keys would be put here
+  struct Stripe {
+    std::mutex lock;
+    std::unordered_map<Key, std::deque<std::shared_ptr<Waiter>>> waiters;
+  };
+
+  void lockNext(std::shared_ptr<Batch> batch) {
+    for (; batch->next < batch->keys.size(); ++batch->next) {
+      const auto& key = batch->keys[batch->next];
+      if (try_lock(key)) {
+        continue;
+      }
+      auto remain = std::chrono::duration_cast<std::chrono::milliseconds>(
+          batch->deadline - std::chrono::steady_clock::now());
+      if (remain.count() <= 0) {
+        failBatch(std::move(batch));
+        return;
+      }
+      auto& stripe = stripeOf(key);
+      auto waiter = std::make_shared<Waiter>();
+      waiter->batch = batch;
+      {
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        // the holder may have released the key before we get the stripe lock
+        if (try_lock(key)) {
+          continue;
+        }
+        stripe.waiters[key].emplace_back(waiter);
+      }
+      // the batch may be resumed by others from now on
+      folly::futures::sleep(remain)
+          .via(folly::getGlobalCPUExecutor())
+          .thenValue([this, waiter = std::move(waiter)](auto&&) { expire(waiter); });
+      return;
+    }
+    auto cb = std::move(batch->cb);
+    cb(true);
+  }
+
+  void expire(const std::shared_ptr<Waiter>& waiter) {
+    if (waiter->done.exchange(true)) {
+      // granted already
+      return;
+    }
+    const auto& key = waiter->batch->keys[waiter->batch->next];
+    {
+      auto& stripe = stripeOf(key);
+      std::lock_guard<std::mutex> guard(stripe.lock);
+      auto it = stripe.waiters.find(key);
+      if (it != stripe.waiters.end()) {
+        auto& queue = it->second;
+        auto pos = std::find(queue.begin(), queue.end(), waiter);
+        if (pos != queue.end()) {
+          queue.erase(pos);
+        }
+        if (queue.empty()) {
+          stripe.waiters.erase(it);
+        }
+      }
+    }
+    failBatch(std::move(waiter->batch));
+  }
+
+  void failBatch(std::shared_ptr<Batch> batch) {
+    unlockBatch(batch->keys.begin(), batch->keys.begin() + batch->next);
+    auto cb = std::move(batch->cb);
+    cb(false);
+  }
+
+  Stripe& stripeOf(const Key& key) {
+    return stripes_[std::hash<Key>()(key) % kStripeNum];
+  }
+
   folly::ConcurrentHashMap<Key, int> hashMap_;
+  std::array<Stripe, kStripeNum> stripes_;
 };
 
 }  // namespace nebula
@@ -55,7 +55,9 @@ static const std::unordered_map<
                  {"balance_plan", {"__balance_plan__", nullptr}},
                  {"ft_index", {"__ft_index__", nullptr}},
                  {"local_id", {"__local_id__", MetaKeyUtils::parseLocalIdSpace}},
-                 {"disk_parts", {"__disk_parts__", MetaKeyUtils::parseDiskPartsSpace}}};
+                 {"disk_parts", {"__disk_parts__", MetaKeyUtils::parseDiskPartsSpace}},
+                 // Loads reported by heartbeat are transient, no need to backup
+                 {"part_loads", {"__part_loads__", nullptr}}};
 
 // clang-format off
 static const std::string kSpacesTable         = tableMaps.at("spaces").first;         // NOLINT
@@ -79,6 +81,7 @@ static const std::string kGroupsTable         = systemTableMaps.at("groups").fir
 static const std::string kZonesTable          = systemTableMaps.at("zones").first;    // NOLINT
 static const std::string kListenerTable       = tableMaps.at("listener").first;       // NOLINT
 static const std::string kDiskPartsTable      = tableMaps.at("disk_parts").first;     // NOLINT
+static const std::string kPartLoadsTable      = tableMaps.at("part_loads").first;     // NOLINT
 
 // Used to record the number of vertices and edges in the space
 // The number of vertices of each tag in the space
@@ -1319,4 +1322,51 @@ meta::cpp2::PartitionList MetaKeyUtils::parseDiskPartsVal(const folly::StringPie
   return partList;
 }
 
+/**
+ * partLoadsKey = kPartLoadsTable + len(serialized(hostAddr)) + serialized(hostAddr) + spaceId
+ */
+
+std::string MetaKeyUtils::partLoadsPrefix() {
+  return kPartLoadsTable;
+}
+
+std::string MetaKeyUtils::partLoadsKey(HostAddr addr, GraphSpaceID spaceId) {
+  std::string key;
+  std::string hostStr = serializeHostAddr(addr);
+  size_t hostAddrLen = hostStr.size();
+  key.reserve(kPartLoadsTable.size() + sizeof(size_t) + hostStr.size() + sizeof(GraphSpaceID));
+  key.append(kPartLoadsTable.data(), kPartLoadsTable.size())
+      .append(reinterpret_cast<const char*>(&hostAddrLen), sizeof(size_t))
+      .append(hostStr.data(), hostStr.size())
+      .append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+  return key;
+}
+
+HostAddr MetaKeyUtils::parsePartLoadsHost(const folly::StringPiece& rawData) {
+  auto offset = kPartLoadsTable.size();
+  auto hostAddrLen = *reinterpret_cast<const size_t*>(rawData.begin() + offset);
+  offset += sizeof(size_t);
+  std::string hostAddrStr(rawData.data() + offset, hostAddrLen);
+  return deserializeHostAddr(hostAddrStr);
+}
+
+GraphSpaceID MetaKeyUtils::parsePartLoadsSpace(const folly::StringPiece& rawData) {
+  auto offset = kPartLoadsTable.size();
+  size_t hostAddrLen = *reinterpret_cast<const size_t*>(rawData.begin() + offset);
+  offset += sizeof(size_t) + hostAddrLen;
+  return *reinterpret_cast<const GraphSpaceID*>(rawData.begin() + offset);
+}
+
+std::string MetaKeyUtils::partLoadsVal(const meta::cpp2::PartLoadList& loads) {
+  std::string val;
+  apache::thrift::CompactSerializer::serialize(loads, &val);
+  return val;
+}
+
+meta::cpp2::PartLoadList MetaKeyUtils::parsePartLoadsVal(const folly::StringPiece& rawData) {
+  meta::cpp2::PartLoadList loads;
+  apache::thrift::CompactSerializer::deserialize(rawData, loads);
+  return loads;
+}
+
 }  // namespace nebula
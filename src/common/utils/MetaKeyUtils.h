@@ -416,6 +416,18 @@ class MetaKeyUtils final {
   static std::string diskPartsVal(const meta::cpp2::PartitionList& partList);
 
   static meta::cpp2::PartitionList parseDiskPartsVal(const folly::StringPiece& rawData);
+
+  static std::string partLoadsPrefix();
+
+  static std::string partLoadsKey(HostAddr addr, GraphSpaceID spaceId);
+
+  static HostAddr parsePartLoadsHost(const folly::StringPiece& rawData);
+
+  static GraphSpaceID parsePartLoadsSpace(const folly::StringPiece& rawData);
+
+  static std::string partLoadsVal(const meta::cpp2::PartLoadList& loads);
+
+  static meta::cpp2::PartLoadList parsePartLoadsVal(const folly::StringPiece& rawData);
 };
 
 }  // namespace nebula
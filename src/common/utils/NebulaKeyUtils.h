@@ -77,6 +77,8 @@ class NebulaKeyUtils final {
 
   static std::string systemPartKey(PartitionID partId);
 
+  static std::string systemStatsKey(PartitionID partId);
+
   static std::string kvKey(PartitionID partId, const folly::StringPiece& name);
 
   /**
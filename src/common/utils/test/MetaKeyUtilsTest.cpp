@@ -230,6 +230,24 @@ TEST(MetaKeyUtilsTest, DiskPathsTest) {
   ASSERT_EQ(path, MetaKeyUtils::parseDiskPartsPath(diskPartsKey));
 }
 
+TEST(MetaKeyUtilsTest, PartLoadsTest) {
+  HostAddr addr{"192.168.0.1", 1234};
+  GraphSpaceID spaceId = 1;
+
+  auto partLoadsKey = MetaKeyUtils::partLoadsKey(addr, spaceId);
+  ASSERT_EQ(addr, MetaKeyUtils::parsePartLoadsHost(partLoadsKey));
+  ASSERT_EQ(spaceId, MetaKeyUtils::parsePartLoadsSpace(partLoadsKey));
+
+  meta::cpp2::PartLoad load;
+  load.part_id_ref() = 2;
+  load.disk_size_ref() = 1024;
+  load.read_qps_ref() = 10;
+  load.write_qps_ref() = 5;
+  meta::cpp2::PartLoadList loads;
+  loads.part_loads_ref() = {load};
+  ASSERT_EQ(loads, MetaKeyUtils::parsePartLoadsVal(MetaKeyUtils::partLoadsVal(loads)));
+}
+
 }  // namespace nebula
 
 int main(int argc, char** argv) {
@@ -5,8 +5,123 @@
 
 #include "graph/context/ExecutionContext.h"
 
+#include "common/datatypes/DataSet.h"
+#include "common/datatypes/Edge.h"
+#include "common/datatypes/List.h"
+#include "common/datatypes/Map.h"
+#include "common/datatypes/Path.h"
+#include "common/datatypes/Set.h"
+#include "common/datatypes/Vertex.h"
+
 namespace nebula {
 namespace graph {
+
+namespace {
+
+// The max number of elements read to estimate the size of a container
+constexpr size_t kSampleSize = 32;
+
+// Estimate by the elements evenly sampled
+template <typename T, typename F>
+int64_t estimateElements(const std::vector<T>& elems, F&& elemSize) {
+  if (elems.empty()) {
+    return 0;
+  }
+  auto step = std::max<size_t>(elems.size() / kSampleSize, 1);
+  int64_t sampled = 0;
+  size_t num = 0;
+  for (size_t i = 0; i < elems.size(); i += step) {
+    sampled += elemSize(elems[i]);
+    num++;
+  }
+  return sampled / static_cast<int64_t>(num) * static_cast<int64_t>(elems.size());
+}
+
+// Estimate by the first elements, the unordered containers could not be sampled evenly
+template <typename Container, typename F>
+int64_t estimateUnordered(const Container& elems, F&& elemSize) {
+  if (elems.empty()) {
+    return 0;
+  }
+  int64_t sampled = 0;
+  size_t num = 0;
+  for (auto it = elems.begin(); it != elems.end() && num < kSampleSize; ++it, ++num) {
+    sampled += elemSize(*it);
+  }
+  return sampled / static_cast<int64_t>(num) * static_cast<int64_t>(elems.size());
+}
+
+int64_t estimateProps(const std::unordered_map<std::string, Value>& props) {
+  return estimateUnordered(props, [](const auto& kv) {
+    return static_cast<int64_t>(kv.first.capacity()) + ExecutionContext::estimateSize(kv.second);
+  });
+}
+
+int64_t estimateVertex(const nebula::Vertex& vertex) {
+  int64_t size = sizeof(nebula::Vertex) + ExecutionContext::estimateSize(vertex.vid);
+  for (const auto& tag : vertex.tags) {
+    size += sizeof(nebula::Tag) + tag.name.capacity() + estimateProps(tag.props);
+  }
+  return size;
+}
+
+}  // namespace
+
+// static
+int64_t ExecutionContext::estimateSize(const Value& value) {
+  int64_t size = sizeof(Value);
+  switch (value.type()) {
+    case Value::Type::STRING:
+      size += value.getStr().capacity();
+      break;
+    case Value::Type::LIST:
+      size += sizeof(nebula::List) + estimateElements(value.getList().values, estimateSize);
+      break;
+    case Value::Type::SET:
+      size += sizeof(nebula::Set) + estimateUnordered(value.getSet().values, estimateSize);
+      break;
+    case Value::Type::MAP:
+      size += sizeof(nebula::Map) + estimateProps(value.getMap().kvs);
+      break;
+    case Value::Type::VERTEX:
+      size += estimateVertex(value.getVertex());
+      break;
+    case Value::Type::EDGE: {
+      const auto& edge = value.getEdge();
+      size += sizeof(nebula::Edge) + estimateSize(edge.src) + estimateSize(edge.dst) +
+              edge.name.capacity() + estimateProps(edge.props);
+      break;
+    }
+    case Value::Type::PATH: {
+      const auto& path = value.getPath();
+      size += sizeof(nebula::Path) + estimateVertex(path.src);
+      for (const auto& step : path.steps) {
+        size += sizeof(nebula::Step) + estimateVertex(step.dst) + step.name.capacity() +
+                estimateProps(step.props);
+      }
+      break;
+    }
+    case Value::Type::DATASET: {
+      const auto& ds = value.getDataSet();
+      size += sizeof(nebula::DataSet);
+      for (const auto& col : ds.colNames) {
+        size += col.capacity();
+      }
+      size += estimateElements(ds.rows, [](const nebula::Row& row) {
+        int64_t rowSize = sizeof(nebula::Row);
+        for (const auto& val : row.values) {
+          rowSize += estimateSize(val);
+        }
+        return rowSize;
+      });
+      break;
+    }
+    default:
+      // The others are stored in Value itself, or small enough
+      break;
+  }
+  return size;
+}
 constexpr int64_t ExecutionContext::kLatestVersion;
 constexpr int64_t ExecutionContext::kOldestVersion;
 constexpr int64_t ExecutionContext::kPreviousOneVersion;
@@ -18,12 +133,27 @@ void ExecutionContext::setValue(const std::string& name, Value&& val) {
 }
 
 void ExecutionContext::setResult(const std::string& name, Result&& result) {
+  if (memTracker_ != nullptr && result.core_.value != nullptr) {
+    result.core_.trackedBytes = estimateSize(*result.core_.value);
+    memTracker_->consume(result.core_.trackedBytes);
+  }
   auto& hist = valueMap_[name];
   hist.emplace_back(std::move(result));
 }
 
 void ExecutionContext::dropResult(const std::string& name) {
-  valueMap_[name].clear();
+  auto& hist = valueMap_[name];
+  for (auto& result : hist) {
+    release(result);
+  }
+  hist.clear();
+}
+
+void ExecutionContext::release(Result& result) {
+  if (memTracker_ != nullptr && result.core_.trackedBytes != 0) {
+    memTracker_->release(result.core_.trackedBytes);
+  }
+  result.core_.trackedBytes = 0;
 }
 
 size_t ExecutionContext::numVersions(const std::string& name) const {
@@ -40,7 +170,11 @@ void ExecutionContext::truncHistory(const std::string& name, size_t numVersionsT
       return;
     }
     // Only keep the latest N values
-    it->second.erase(it->second.begin(), it->second.end() - numVersionsToKeep);
+    auto end = it->second.end() - numVersionsToKeep;
+    for (auto result = it->second.begin(); result != end; ++result) {
+      release(*result);
+    }
+    it->second.erase(it->second.begin(), end);
   }
 }
 
@@ -52,6 +186,7 @@ const Value& ExecutionContext::getValue(const std::string& name) const {
 Value ExecutionContext::moveValue(const std::string& name) {
   auto it = valueMap_.find(name);
   if (it != valueMap_.end() && !it->second.empty()) {
+    release(it->second.back());
     return it->second.back().moveValue();
   } else {
     return Value();
@@ -7,6 +7,7 @@
 #define GRAPH_CONTEXT_EXECUTIONCONTEXT_H_
 
 #include "common/datatypes/Value.h"
+#include "common/memory/MemoryTracker.h"
 #include "graph/context/Result.h"
 
 namespace nebula {
@@ -70,12 +71,23 @@ class ExecutionContext {
     return valueMap_.find(name) != valueMap_.end();
   }
 
+  // The results set since are accounted to the tracker until they are dropped
+  void setMemTracker(MemoryTracker* memTracker) {
+    memTracker_ = memTracker;
+  }
+
+  // Estimate the memory used by the value, the large containers are estimated by samples
+  static int64_t estimateSize(const Value& value);
+
  private:
   friend class QueryInstance;
   Value moveValue(const std::string& name);
 
+  void release(Result& result);
+
   // name -> Value with multiple versions
   std::unordered_map<std::string, std::vector<Result>> valueMap_;
+  MemoryTracker* memTracker_{nullptr};
 };
 
 }  // namespace graph
@@ -144,10 +144,12 @@ StatusOr<int64_t> GetNeighborsIter::buildIndex(DataSetIndex* dsIndex) {
     if (colName.find(nebula::kTag) == 0) {  // "_tag"
       NG_RETURN_IF_ERROR(buildPropIndex(colName, i, false, dsIndex));
     } else if (colName.find("_edge") == 0) {
-      NG_RETURN_IF_ERROR(buildPropIndex(colName, i, true, dsIndex));
       if (edgeStartIndex < 0) {
         edgeStartIndex = i;
+      } else if (UNLIKELY(i != edgeStartIndex + dsIndex->edgeProps.size())) {
+        return Status::Error("Edge columns are not continuous.");
       }
+      NG_RETURN_IF_ERROR(buildPropIndex(colName, i, true, dsIndex));
     } else {
       // It is "_vid", "_stats", "_expr" in this situation.
     }
@@ -187,10 +189,27 @@ Status GetNeighborsIter::buildPropIndex(const std::string& props,
     if (UNLIKELY(name.empty() || (name[0] != '+' && name[0] != '-'))) {
       return Status::Error("Bad edge name: %s", name.c_str());
     }
-    dsIndex->tagEdgeNameIndices.emplace(columnId, name);
-    dsIndex->edgePropsMap.emplace(name, std::move(propIdx));
+    propIdx.name = name.substr(1);
+    for (size_t i = 0; i < propIdx.propList.size(); ++i) {
+      auto& prop = propIdx.propList[i];
+      if (prop == kType) {
+        propIdx.typeIdx = i;
+      } else if (prop == kDst) {
+        propIdx.dstIdx = i;
+      } else if (prop == kRank) {
+        propIdx.rankIdx = i;
+      } else if (prop != kSrc) {
+        propIdx.userPropIndices.emplace_back(i);
+      }
+    }
+    dsIndex->edgeProps.emplace_back(std::move(propIdx));
   } else {
-    dsIndex->tagEdgeNameIndices.emplace(columnId, name);
+    propIdx.name = name;
+    for (size_t i = 0; i < propIdx.propList.size(); ++i) {
+      if (propIdx.propList[i] != nebula::kTag) {
+        propIdx.userPropIndices.emplace_back(i);
+      }
+    }
     dsIndex->tagPropsMap.emplace(name, std::move(propIdx));
   }
 
@@ -383,19 +402,13 @@ const Value& GetNeighborsIter::getEdgeProp(const std::string& edge, const std::s
     return Value::kEmpty;
   }
 
-  auto& currentEdge = currentEdgeName();
-  if (edge != "*" && (currentEdge.compare(1, std::string::npos, edge) != 0)) {
-    VLOG(1) << "Current edge: " << currentEdgeName() << " Wanted: " << edge;
-    return Value::kEmpty;
-  }
-  auto index = currentDs_->edgePropsMap.find(currentEdge);
-  if (index == currentDs_->edgePropsMap.end()) {
-    VLOG(1) << "No edge found: " << edge;
-    VLOG(1) << "Current edge: " << currentEdge;
+  auto& edgeProps = currentEdgeProps();
+  if (edge != "*" && edgeProps.name != edge) {
+    VLOG(1) << "Current edge: " << edgeProps.name << " Wanted: " << edge;
     return Value::kEmpty;
   }
-  auto propIndex = index->second.propIndices.find(prop);
-  if (propIndex == index->second.propIndices.end()) {
+  auto propIndex = edgeProps.propIndices.find(prop);
+  if (propIndex == edgeProps.propIndices.end()) {
     VLOG(1) << "No edge prop found: " << prop;
     return Value::kEmpty;
   }
@@ -428,10 +441,9 @@ Value GetNeighborsIter::getVertex(const std::string& name) const {
     DCHECK_EQ(tagPropNameList.size(), propList.values.size());
     Tag tag;
     tag.name = tagProp.first;
-    for (size_t i = 0; i < propList.size(); ++i) {
-      if (tagPropNameList[i] == nebula::kTag) {
-        continue;
-      }
+    auto& userPropIndices = tagProp.second.userPropIndices;
+    tag.props.reserve(userPropIndices.size());
+    for (auto i : userPropIndices) {
       tag.props.emplace(tagPropNameList[i], propList[i]);
     }
     vertex.tags.emplace_back(std::move(tag));
@@ -464,11 +476,18 @@ Value GetNeighborsIter::getEdge() const {
     return Value::kEmpty;
   }
 
+  // Build the edge by the positions resolved for the column, without looking up any prop by name
+  auto& edgeProps = currentEdgeProps();
+  auto& propList = currentEdge_->values;
+  DCHECK_EQ(edgeProps.propList.size(), propList.size());
+  if (edgeProps.typeIdx < 0 || edgeProps.dstIdx < 0 || edgeProps.rankIdx < 0) {
+    return Value::kNullBadType;
+  }
+
   Edge edge;
-  auto edgeName = currentEdgeName().substr(1, std::string::npos);
-  edge.name = edgeName;
+  edge.name = edgeProps.name;
 
-  auto type = getEdgeProp(edgeName, kType);
+  auto& type = propList[edgeProps.typeIdx];
   if (!type.isInt()) {
     return Value::kNullBadType;
   }
@@ -480,32 +499,21 @@ Value GetNeighborsIter::getEdge() const {
   }
   edge.src = srcVal;
 
-  auto& dstVal = getEdgeProp(edgeName, kDst);
+  auto& dstVal = propList[edgeProps.dstIdx];
   if (!SchemaUtil::isValidVid(dstVal)) {
     return Value::kNullBadType;
   }
   edge.dst = dstVal;
 
-  auto& rank = getEdgeProp(edgeName, kRank);
+  auto& rank = propList[edgeProps.rankIdx];
   if (!rank.isInt()) {
     return Value::kNullBadType;
   }
   edge.ranking = rank.getInt();
 
-  auto& edgePropMap = currentDs_->edgePropsMap;
-  auto edgeProp = edgePropMap.find(currentEdgeName());
-  if (edgeProp == edgePropMap.end()) {
-    return Value::kNullValue;
-  }
-  auto& edgeNamePropList = edgeProp->second.propList;
-  auto& propList = currentEdge_->values;
-  DCHECK_EQ(edgeNamePropList.size(), propList.size());
-  for (size_t i = 0; i < propList.size(); ++i) {
-    auto propName = edgeNamePropList[i];
-    if (propName == kSrc || propName == kDst || propName == kRank || propName == kType) {
-      continue;
-    }
-    edge.props.emplace(edgeNamePropList[i], propList[i]);
+  edge.props.reserve(edgeProps.userPropIndices.size());
+  for (auto i : edgeProps.userPropIndices) {
+    edge.props.emplace(edgeProps.propList[i], propList[i]);
   }
   return Value(std::move(edge));
 }
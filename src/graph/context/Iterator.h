@@ -324,9 +324,10 @@ class GetNeighborsIter final : public Iterator {
     goToFirstEdge();
   }
 
-  inline const std::string& currentEdgeName() const {
-    DCHECK(currentDs_->tagEdgeNameIndices.find(colIdx_) != currentDs_->tagEdgeNameIndices.end());
-    return currentDs_->tagEdgeNameIndices.find(colIdx_)->second;
+  inline const auto& currentEdgeProps() const {
+    DCHECK_GT(colIdx_, currentDs_->colLowerBound);
+    DCHECK_LT(colIdx_ - currentDs_->colLowerBound - 1, currentDs_->edgeProps.size());
+    return currentDs_->edgeProps[colIdx_ - currentDs_->colLowerBound - 1];
   }
 
   bool colValid() {
@@ -340,8 +341,17 @@ class GetNeighborsIter final : public Iterator {
 
   struct PropIndex {
     size_t colIdx;
+    // The tag name, or the edge name without direction
+    std::string name;
     std::vector<std::string> propList;
     std::unordered_map<std::string, size_t> propIndices;
+    // The positions of the reserved props of edge, -1 if absent
+    int64_t typeIdx{-1};
+    int64_t dstIdx{-1};
+    int64_t rankIdx{-1};
+    // The positions of the props kept in the Tag or Edge, i.e. all but the reserved ones.
+    // They are resolved once for each dataset rather than compared for each vertex or edge.
+    std::vector<size_t> userPropIndices;
   };
 
   struct DataSetIndex {
@@ -349,13 +359,11 @@ class GetNeighborsIter final : public Iterator {
     // | _vid | _stats | _tag:t1:p1:p2 | _edge:e1:p1:p2 |
     // -> {_vid : 0, _stats : 1, _tag:t1:p1:p2 : 2, _edge:d1:p1:p2 : 3}
     std::unordered_map<std::string, size_t> colIndices;
-    // | _vid | _stats | _tag:t1:p1:p2 | _edge:e1:p1:p2 |
-    // -> {2 : t1, 3 : e1}
-    std::unordered_map<size_t, std::string> tagEdgeNameIndices;
-    // _tag:t1:p1:p2  ->  {t1 : [column_idx, [p1, p2], {p1 : 0, p2 : 1}]}
+    // _tag:t1:p1:p2  ->  {t1 : [column_idx, t1, [p1, p2], {p1 : 0, p2 : 1}]}
     std::unordered_map<std::string, PropIndex> tagPropsMap;
-    // _edge:e1:p1:p2  ->  {e1 : [column_idx, [p1, p2], {p1 : 0, p2 : 1}]}
-    std::unordered_map<std::string, PropIndex> edgePropsMap;
+    // _edge:+e1:p1:p2 | _edge:-e2:p1  ->  [[column_idx, e1, [p1, p2], {p1 : 0, p2 : 1}], ...]
+    // The edge columns are continuous, the one of colIdx is edgeProps[colIdx - colLowerBound - 1]
+    std::vector<PropIndex> edgeProps;
 
     int64_t colLowerBound{-1};
     int64_t colUpperBound{-1};
@@ -0,0 +1,90 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/context/NeighborCache.h"
+
+#include "common/time/WallClock.h"
+#include "graph/context/ExecutionContext.h"
+#include "graph/service/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+NeighborCache* NeighborCache::instance() {
+  static std::unique_ptr<NeighborCache> cache(
+      new NeighborCache(std::max<int64_t>(FLAGS_neighbor_cache_capacity_bytes, 1024 * 1024)));
+  return cache.get();
+}
+
+NeighborCache::NeighborCache(size_t capacity) : cache_(capacity) {}
+
+bool NeighborCache::spaceEnabled(const std::string& spaceName) {
+  if (FLAGS_neighbor_cache_spaces.empty()) {
+    return true;
+  }
+  std::vector<folly::StringPiece> names;
+  folly::split(',', FLAGS_neighbor_cache_spaces, names, true);
+  for (auto name : names) {
+    if (folly::trimWhitespace(name) == spaceName) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string NeighborCache::key(const std::string& signature, const Value& vid) {
+  std::string key;
+  auto len = static_cast<uint32_t>(signature.size());
+  key.reserve(sizeof(uint32_t) + signature.size() + sizeof(int64_t));
+  key.append(reinterpret_cast<const char*>(&len), sizeof(uint32_t));
+  key.append(signature);
+  if (vid.isInt()) {
+    auto id = vid.getInt();
+    key.append(reinterpret_cast<const char*>(&id), sizeof(int64_t));
+  } else {
+    key.append(vid.getStr());
+  }
+  return key;
+}
+
+std::shared_ptr<const NeighborCache::Entry> NeighborCache::get(GraphSpaceID space,
+                                                               const std::string& key) {
+  auto ret = cache_.get(key);
+  if (!ret.ok()) {
+    return nullptr;
+  }
+  auto entry = std::move(ret).value();
+  if (entry->version != version(space) ||
+      entry->expireAt <= time::WallClock::fastNowInMilliSec()) {
+    cache_.evict(key);
+    return nullptr;
+  }
+  return entry;
+}
+
+void NeighborCache::put(GraphSpaceID space,
+                        std::string key,
+                        std::shared_ptr<const std::vector<std::string>> colNames,
+                        Row row,
+                        int64_t version) {
+  // Mutated while fetching
+  if (version != this->version(space)) {
+    return;
+  }
+  // The column names are shared by the rows of a response, so they are not charged
+  int64_t charge = sizeof(Entry) + key.capacity();
+  for (const auto& value : row.values) {
+    charge += ExecutionContext::estimateSize(value);
+  }
+  auto entry = std::make_shared<Entry>();
+  entry->colNames = std::move(colNames);
+  entry->row = std::move(row);
+  entry->version = version;
+  entry->expireAt = time::WallClock::fastNowInMilliSec() + FLAGS_neighbor_cache_ttl_ms;
+  cache_.insert(std::move(key), std::move(entry), charge);
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,96 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_CONTEXT_NEIGHBORCACHE_H_
+#define GRAPH_CONTEXT_NEIGHBORCACHE_H_
+
+#include "common/base/Base.h"
+#include "common/base/ConcurrentClockCache.h"
+#include "common/datatypes/DataSet.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * The rows of GetNeighbors cached in graphd, shared by all queries. A row is keyed by the
+ * signature of the request, i.e. everything except the input vertices, and the vertex id.
+ *
+ * The cache is bounded by neighbor_cache_capacity_bytes, each row is charged by the estimated
+ * bytes of it and its key. A row is stale once it is older than neighbor_cache_ttl_ms, or any
+ * vertex/edge of its space is mutated through this graphd after it is fetched. So the writes of
+ * this graphd are always visible, and the writes of other graphds are visible after the ttl at
+ * most.
+ */
+class NeighborCache final {
+ public:
+  struct Entry {
+    std::shared_ptr<const std::vector<std::string>> colNames;
+    Row row;
+    int64_t version;
+    int64_t expireAt;
+  };
+
+  static NeighborCache* instance();
+
+  // The capacity is in bytes
+  explicit NeighborCache(size_t capacity);
+
+  /**
+   * @brief Whether the space is one of neighbor_cache_spaces, which is all spaces if empty
+   */
+  static bool spaceEnabled(const std::string& spaceName);
+
+  static std::string key(const std::string& signature, const Value& vid);
+
+  /**
+   * @brief The current version of the space, the rows fetched since it are put with it
+   */
+  int64_t version(GraphSpaceID space) const {
+    return versions_[stripe(space)].load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Make all the rows of the space stale, called once the space is mutated
+   */
+  void invalidate(GraphSpaceID space) {
+    versions_[stripe(space)].fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @return nullptr if not found or stale
+   */
+  std::shared_ptr<const Entry> get(GraphSpaceID space, const std::string& key);
+
+  /**
+   * @brief Put the row fetched since the version
+   */
+  void put(GraphSpaceID space,
+           std::string key,
+           std::shared_ptr<const std::vector<std::string>> colNames,
+           Row row,
+           int64_t version);
+
+  // The estimated bytes of the rows cached
+  size_t usage() const {
+    return cache_.usage();
+  }
+
+ private:
+  static constexpr size_t kStripes = 64;
+
+  static size_t stripe(GraphSpaceID space) {
+    return static_cast<size_t>(space) % kStripes;
+  }
+
+  ConcurrentClockCache<std::string, std::shared_ptr<const Entry>> cache_;
+  // The spaces in one stripe share the version
+  std::array<std::atomic<int64_t>, kStripes> versions_{};
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_CONTEXT_NEIGHBORCACHE_H_
@@ -5,6 +5,8 @@
 
 #include "graph/context/QueryContext.h"
 
+#include "graph/service/GraphFlags.h"
+
 namespace nebula {
 namespace graph {
 
@@ -30,7 +32,13 @@ QueryContext::QueryContext() {
 void QueryContext::init() {
   objPool_ = std::make_unique<ObjectPool>();
   ep_ = std::make_unique<ExecutionPlan>();
+  MemoryTracker* sessionTracker = nullptr;
+  if (rctx_ && rctx_->session() != nullptr) {
+    sessionTracker = rctx_->session()->memTracker();
+  }
+  memTracker_ = std::make_unique<MemoryTracker>(FLAGS_query_memory_quota_bytes, sessionTracker);
   ectx_ = std::make_unique<ExecutionContext>();
+  ectx_->setMemTracker(memTracker_.get());
   // copy parameterMap into ExecutionContext
   if (rctx_) {
     for (auto item : rctx_->parameterMap()) {
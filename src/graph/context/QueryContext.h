@@ -87,6 +87,11 @@ class QueryContext {
     return ectx_.get();
   }
 
+  // The memory used by the results of query, also accounted to the session
+  MemoryTracker* memTracker() const {
+    return memTracker_.get();
+  }
+
   ExecutionPlan* plan() const {
     return ep_.get();
   }
@@ -144,6 +149,8 @@ class QueryContext {
   void init();
 
   RequestContextPtr rctx_;
+  // Released before the session, and after all the results
+  std::unique_ptr<MemoryTracker> memTracker_;
   std::unique_ptr<ValidateContext> vctx_;
   std::unique_ptr<ExecutionContext> ectx_;
   std::unique_ptr<ExecutionPlan> ep_;
@@ -89,6 +89,8 @@ class Result final {
     }
 
     bool checkMemory{false};
+    // The bytes accounted to the memory tracker of query, not copied
+    int64_t trackedBytes{0};
     State state;
     std::string msg;
     std::shared_ptr<Value> value;
@@ -59,5 +59,34 @@ TEST(ExecutionContextTest, TestResult) {
   EXPECT_TRUE(result.valuePtr()->isDataSet());
 }
 
+TEST(ExecutionContextTest, TrackMemory) {
+  MemoryTracker session;
+  MemoryTracker query(0, &session);
+  ExecutionContext ctx;
+  ctx.setMemTracker(&query);
+
+  DataSet ds({"a", "b"});
+  for (int64_t i = 0; i < 1000; i++) {
+    ds.rows.emplace_back(Row({Value(i), Value(std::string(100, 'x'))}));
+  }
+  auto dsSize = ExecutionContext::estimateSize(Value(ds));
+  // At least the strings of all rows
+  EXPECT_GT(dsSize, 100 * 1000);
+
+  ctx.setValue("v1", Value(ds));
+  ctx.setValue("v1", Value(ds));
+  ctx.setValue("v2", 10);
+  EXPECT_EQ(2 * dsSize + ExecutionContext::estimateSize(Value(10)), query.used());
+  EXPECT_EQ(query.used(), session.used());
+
+  ctx.truncHistory("v1", 1);
+  EXPECT_EQ(dsSize + ExecutionContext::estimateSize(Value(10)), query.used());
+  ctx.dropResult("v1");
+  EXPECT_EQ(ExecutionContext::estimateSize(Value(10)), query.used());
+  ctx.dropResult("v2");
+  EXPECT_EQ(0, query.used());
+  EXPECT_EQ(0, session.used());
+}
+
 }  // namespace graph
 }  // namespace nebula
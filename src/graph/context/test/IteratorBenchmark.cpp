@@ -18,8 +18,11 @@ namespace nebula {
 namespace graph {
 std::shared_ptr<nebula::Value> setUpIter(int64_t totalEdgeNum) {
   DataSet ds1;
-  ds1.colNames = {
-      kVid, "_stats", "_tag:tag1:prop1:prop2", "_edge:+edge1:prop1:prop2:_dst:_rank", "_expr"};
+  ds1.colNames = {kVid,
+                  "_stats",
+                  "_tag:tag1:prop1:prop2",
+                  "_edge:+edge1:prop1:prop2:_dst:_rank:_type",
+                  "_expr"};
   for (auto i = 0; i < totalEdgeNum / 4; ++i) {
     Row row;
     // _vid
@@ -40,6 +43,7 @@ std::shared_ptr<nebula::Value> setUpIter(int64_t totalEdgeNum) {
       }
       edge.values.emplace_back("2");
       edge.values.emplace_back(j);
+      edge.values.emplace_back(1);
       edges.values.emplace_back(std::move(edge));
     }
     row.values.emplace_back(edges);
@@ -49,8 +53,11 @@ std::shared_ptr<nebula::Value> setUpIter(int64_t totalEdgeNum) {
   }
 
   DataSet ds2;
-  ds2.colNames = {
-      kVid, "_stats", "_tag:tag2:prop1:prop2", "_edge:-edge2:prop1:prop2:_dst:_rank", "_expr"};
+  ds2.colNames = {kVid,
+                  "_stats",
+                  "_tag:tag2:prop1:prop2",
+                  "_edge:-edge2:prop1:prop2:_dst:_rank:_type",
+                  "_expr"};
   for (auto i = totalEdgeNum / 4; i < totalEdgeNum / 2; ++i) {
     Row row;
     // _vid
@@ -71,6 +78,7 @@ std::shared_ptr<nebula::Value> setUpIter(int64_t totalEdgeNum) {
       }
       edge.values.emplace_back("2");
       edge.values.emplace_back(j);
+      edge.values.emplace_back(-2);
       edges.values.emplace_back(std::move(edge));
     }
     row.values.emplace_back(edges);
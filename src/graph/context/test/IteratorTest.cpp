@@ -637,6 +637,18 @@ TEST(IteratorTest, TestHead) {
     GetNeighborsIter iter(val);
     EXPECT_FALSE(iter.valid_);
   }
+  {
+    // tag column between the edge columns
+    DataSet ds;
+    ds.colNames = {
+        kVid, "_stats", "_edge:+edge1:_dst:_rank", "_tag:tag1:prop1", "_edge:-edge1:_dst", "_expr"};
+    List datasets;
+    datasets.values.emplace_back(std::move(ds));
+    auto val = std::make_shared<Value>(std::move(datasets));
+    GetNeighborsIter iter(nullptr);
+    auto status = iter.processList(val);
+    EXPECT_FALSE(status.ok());
+  }
   {
     DataSet ds;
     ds.colNames = {kVid, "_stats", "_tag:tag1:prop1:prop2", "_edge:::", "_expr"};
@@ -0,0 +1,106 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "graph/context/NeighborCache.h"
+#include "graph/service/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(NeighborCacheTest, GetAndPut) {
+  NeighborCache cache(1024 * 1024);
+  auto colNames = std::make_shared<const std::vector<std::string>>(
+      std::vector<std::string>{kVid, "_edge:+like:_dst"});
+  auto key1 = NeighborCache::key("sig1", "a");
+  auto key2 = NeighborCache::key("sig2", "a");
+  EXPECT_NE(key1, key2);
+  EXPECT_NE(NeighborCache::key("sig", 1), NeighborCache::key("sig", 2));
+
+  EXPECT_EQ(nullptr, cache.get(1, key1));
+  cache.put(1, key1, colNames, Row({"a", List({"b"})}), cache.version(1));
+  auto entry = cache.get(1, key1);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(Row({"a", List({"b"})}), entry->row);
+  EXPECT_EQ(*colNames, *entry->colNames);
+  EXPECT_EQ(nullptr, cache.get(1, key2));
+}
+
+TEST(NeighborCacheTest, Invalidate) {
+  NeighborCache cache(1024 * 1024);
+  auto colNames = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{kVid});
+  auto key = NeighborCache::key("sig", "a");
+
+  // Mutated after the row is cached
+  cache.put(1, key, colNames, Row({"a"}), cache.version(1));
+  cache.invalidate(1);
+  EXPECT_EQ(nullptr, cache.get(1, key));
+
+  // Mutated while the row is fetched
+  auto version = cache.version(1);
+  cache.invalidate(1);
+  cache.put(1, key, colNames, Row({"a"}), version);
+  EXPECT_EQ(nullptr, cache.get(1, key));
+
+  // Other spaces are not affected
+  cache.put(2, key, colNames, Row({"a"}), cache.version(2));
+  cache.invalidate(1);
+  EXPECT_NE(nullptr, cache.get(2, key));
+}
+
+TEST(NeighborCacheTest, Expire) {
+  auto ttl = FLAGS_neighbor_cache_ttl_ms;
+  FLAGS_neighbor_cache_ttl_ms = 0;
+  NeighborCache cache(1024 * 1024);
+  auto colNames = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{kVid});
+  auto key = NeighborCache::key("sig", "a");
+  cache.put(1, key, colNames, Row({"a"}), cache.version(1));
+  EXPECT_EQ(nullptr, cache.get(1, key));
+  FLAGS_neighbor_cache_ttl_ms = ttl;
+}
+
+TEST(NeighborCacheTest, Capacity) {
+  // 16 shards of 16KB
+  NeighborCache cache(256 * 1024);
+  auto colNames = std::make_shared<const std::vector<std::string>>(
+      std::vector<std::string>{kVid, "_edge:+like:_dst"});
+  std::string dst(1024, 'x');
+  for (int i = 0; i < 1000; i++) {
+    auto vid = std::to_string(i);
+    cache.put(1, NeighborCache::key("sig", vid), colNames, Row({vid, dst}), cache.version(1));
+  }
+  // The rows are charged by bytes rather than the number of them
+  EXPECT_LE(cache.usage(), 256 * 1024);
+  EXPECT_GT(cache.usage(), 128 * 1024);
+  size_t found = 0;
+  for (int i = 0; i < 1000; i++) {
+    if (cache.get(1, NeighborCache::key("sig", std::to_string(i))) != nullptr) {
+      found++;
+    }
+  }
+  EXPECT_LT(found, 256);
+  EXPECT_GT(found, 0);
+
+  // The row larger than a shard is not cached
+  auto key = NeighborCache::key("sig", "large");
+  cache.put(1, key, colNames, Row({"large", std::string(32 * 1024, 'x')}), cache.version(1));
+  EXPECT_EQ(nullptr, cache.get(1, key));
+}
+
+TEST(NeighborCacheTest, SpaceEnabled) {
+  auto spaces = FLAGS_neighbor_cache_spaces;
+  FLAGS_neighbor_cache_spaces = "";
+  EXPECT_TRUE(NeighborCache::spaceEnabled("nba"));
+  FLAGS_neighbor_cache_spaces = "nba, student";
+  EXPECT_TRUE(NeighborCache::spaceEnabled("nba"));
+  EXPECT_TRUE(NeighborCache::spaceEnabled("student"));
+  EXPECT_FALSE(NeighborCache::spaceEnabled("test"));
+  FLAGS_neighbor_cache_spaces = spaces;
+}
+
+}  // namespace graph
+}  // namespace nebula
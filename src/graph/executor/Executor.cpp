@@ -50,6 +50,7 @@
 #include "graph/executor/admin/UpdateUserExecutor.h"
 #include "graph/executor/admin/ZoneExecutor.h"
 #include "graph/executor/algo/BFSShortestPathExecutor.h"
+#include "graph/executor/algo/BiBFSShortestPathExecutor.h"
 #include "graph/executor/algo/CartesianProductExecutor.h"
 #include "graph/executor/algo/ConjunctPathExecutor.h"
 #include "graph/executor/algo/ProduceAllPathsExecutor.h"
@@ -448,6 +449,9 @@ Executor *Executor::makeExecutor(QueryContext *qctx, const PlanNode *node) {
     case PlanNode::Kind::kBFSShortest: {
       return pool->add(new BFSShortestPathExecutor(node, qctx));
     }
+    case PlanNode::Kind::kBiBFSShortest: {
+      return pool->add(new BiBFSShortestPathExecutor(node, qctx));
+    }
     case PlanNode::Kind::kProduceSemiShortestPath: {
       return pool->add(new ProduceSemiShortestPathExecutor(node, qctx));
     }
@@ -585,6 +589,7 @@ Status Executor::open() {
   }
 
   NG_RETURN_IF_ERROR(checkMemoryWatermark());
+  NG_RETURN_IF_ERROR(checkMemoryQuota());
 
   numRows_ = 0;
   execTime_ = 0;
@@ -619,6 +624,19 @@ Status Executor::checkMemoryWatermark() {
   return Status::OK();
 }
 
+Status Executor::checkMemoryQuota() {
+  auto *memTracker = qctx()->memTracker();
+  auto *exceeded = memTracker != nullptr ? memTracker->exceeded() : nullptr;
+  if (exceeded == nullptr) {
+    return Status::OK();
+  }
+  stats::StatsManager::addValue(kNumQueriesHitMemoryQuota);
+  return Status::Error("Used memory(%ld bytes) of the %s exceeds the quota(%ld bytes)",
+                       exceeded->used(),
+                       exceeded == memTracker ? "query" : "session",
+                       exceeded->limit());
+}
+
 folly::Future<Status> Executor::start(Status status) const {
   return folly::makeFuture(std::move(status)).via(runner());
 }
@@ -653,7 +671,7 @@ Status Executor::finish(Result &&result) {
   if (FLAGS_enable_lifetime_optimize) {
     drop();
   }
-  return Status::OK();
+  return checkMemoryQuota();
 }
 
 Status Executor::finish(Value &&value) {
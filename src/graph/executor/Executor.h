@@ -46,6 +46,9 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
 
   Status checkMemoryWatermark();
 
+  // Fail the query once it or its session exceeds the memory quota
+  Status checkMemoryQuota();
+
   QueryContext *qctx() const {
     return qctx_;
   }
@@ -0,0 +1,217 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/executor/algo/BiBFSShortestPathExecutor.h"
+
+#include "graph/planner/plan/Algo.h"
+
+namespace nebula {
+namespace graph {
+folly::Future<Status> BiBFSShortestPathExecutor::execute() {
+  SCOPED_TIMER(&execTime_);
+  auto* bfs = asNode<BiBFSShortestPath>(node());
+  if (!initialized_) {
+    init();
+  }
+  if (expandLeft_) {
+    auto iter = ectx_->getResult(bfs->leftInputVar()).iter();
+    DCHECK(!!iter);
+    expand(iter.get(), left_);
+  }
+  if (expandRight_) {
+    auto iter = ectx_->getResult(bfs->rightInputVar()).iter();
+    DCHECK(!!iter);
+    expand(iter.get(), right_);
+  }
+  VLOG(1) << "current: " << node()->outputVar() << " left depth: " << left_.depth()
+          << " right depth: " << right_.depth() << " vertices: " << vids_.size();
+
+  DataSet ds;
+  ds.colNames = node()->colNames();
+  auto maxLength = std::min(left_.depth() + right_.depth(), bfs->steps());
+  for (auto length = checkedLength_ + 1; length <= maxLength; ++length) {
+    // Every shortest path with length has exactly one vertex on this depth of left side
+    auto leftDepth = length > right_.depth() ? length - right_.depth() : 0;
+    auto meetIds = meets(leftDepth, length);
+    if (!meetIds.empty()) {
+      VLOG(1) << "Meet at " << meetIds.size() << " vertices, length: " << length;
+      ds = buildPaths(meetIds);
+      break;
+    }
+  }
+  checkedLength_ = std::max(checkedLength_, maxLength);
+
+  const auto& leftFrontier = left_.levels.back();
+  const auto& rightFrontier = right_.levels.back();
+  if (!ds.rows.empty() || checkedLength_ >= bfs->steps() || leftFrontier.empty() ||
+      rightFrontier.empty()) {
+    expandLeft_ = false;
+    expandRight_ = false;
+  } else {
+    expandLeft_ = leftFrontier.size() <= rightFrontier.size();
+    expandRight_ = !expandLeft_;
+  }
+  setFrontier(bfs->leftVidVar(), expandLeft_ ? &left_ : nullptr);
+  setFrontier(bfs->rightVidVar(), expandRight_ ? &right_ : nullptr);
+  return finish(ResultBuilder().value(Value(std::move(ds))).build());
+}
+
+void BiBFSShortestPathExecutor::init() {
+  auto* bfs = asNode<BiBFSShortestPath>(node());
+  // The vid vars only contain the start and end vertex before the first round
+  auto initSide = [this](const std::string& var, Side& side) {
+    std::vector<uint32_t> starts;
+    auto iter = ectx_->getResult(var).iter();
+    for (; iter->valid(); iter->next()) {
+      starts.emplace_back(vertexId(iter->getColumn(0)));
+    }
+    for (auto id : starts) {
+      side.visited[id] = true;
+    }
+    side.levels.emplace_back(std::move(starts));
+  };
+  initSide(bfs->leftVidVar(), left_);
+  initSide(bfs->rightVidVar(), right_);
+  initialized_ = true;
+}
+
+uint32_t BiBFSShortestPathExecutor::vertexId(const Value& vid) {
+  auto ret = vidIndex_.emplace(vid, vids_.size());
+  if (ret.second) {
+    vids_.emplace_back(vid);
+    left_.visited.emplace_back(false);
+    left_.parents.emplace_back();
+    right_.visited.emplace_back(false);
+    right_.parents.emplace_back();
+  }
+  return ret.first->second;
+}
+
+void BiBFSShortestPathExecutor::expand(Iterator* iter, Side& side) {
+  std::vector<uint32_t> frontier;
+  // vertices reached in this round, they could be reached by more than one shortest path
+  std::vector<bool> reached;
+  for (; iter->valid(); iter->next()) {
+    auto edgeVal = iter->getEdge();
+    if (!edgeVal.isEdge()) {
+      continue;
+    }
+    auto& edge = edgeVal.getEdge();
+    auto src = vertexId(edge.src);
+    auto dst = vertexId(edge.dst);
+    if (reached.size() < vids_.size()) {
+      reached.resize(vids_.size(), false);
+    }
+    if (side.visited[dst]) {
+      if (!reached[dst]) {
+        // reached on the previous depth
+        continue;
+      }
+    } else {
+      side.visited[dst] = true;
+      reached[dst] = true;
+      frontier.emplace_back(dst);
+    }
+    edgeNames_.emplace(edge.type, edge.name);
+    side.parents[dst].emplace_back(Link{src, edge.type, edge.ranking});
+  }
+  side.levels.emplace_back(std::move(frontier));
+}
+
+std::vector<uint32_t> BiBFSShortestPathExecutor::meets(size_t leftDepth, size_t length) const {
+  std::vector<uint32_t> ids;
+  auto rightDepth = length - leftDepth;
+  if (leftDepth > left_.depth() || rightDepth > right_.depth()) {
+    return ids;
+  }
+  std::vector<bool> onRight(vids_.size(), false);
+  for (auto id : right_.levels[rightDepth]) {
+    onRight[id] = true;
+  }
+  for (auto id : left_.levels[leftDepth]) {
+    if (onRight[id]) {
+      ids.emplace_back(id);
+    }
+  }
+  return ids;
+}
+
+std::vector<std::vector<Step>> BiBFSShortestPathExecutor::forwardSteps(uint32_t id) const {
+  const auto& links = left_.parents[id];
+  if (links.empty()) {
+    // the start vertex
+    return {{}};
+  }
+  std::vector<std::vector<Step>> result;
+  for (const auto& link : links) {
+    for (auto& steps : forwardSteps(link.parent)) {
+      steps.emplace_back(
+          Step(Vertex(vids_[id], {}), link.type, edgeNames_.at(link.type), link.ranking, {}));
+      result.emplace_back(std::move(steps));
+    }
+  }
+  return result;
+}
+
+std::vector<std::vector<Step>> BiBFSShortestPathExecutor::backwardSteps(uint32_t id) const {
+  const auto& links = right_.parents[id];
+  if (links.empty()) {
+    // the end vertex
+    return {{}};
+  }
+  std::vector<std::vector<Step>> result;
+  for (const auto& link : links) {
+    for (auto& tail : backwardSteps(link.parent)) {
+      // the neighbors of backward direction are reversed edges
+      std::vector<Step> steps;
+      steps.reserve(tail.size() + 1);
+      steps.emplace_back(Step(
+          Vertex(vids_[link.parent], {}), -link.type, edgeNames_.at(link.type), link.ranking, {}));
+      steps.insert(steps.end(),
+                   std::make_move_iterator(tail.begin()),
+                   std::make_move_iterator(tail.end()));
+      result.emplace_back(std::move(steps));
+    }
+  }
+  return result;
+}
+
+DataSet BiBFSShortestPathExecutor::buildPaths(const std::vector<uint32_t>& meetIds) const {
+  DataSet ds;
+  ds.colNames = node()->colNames();
+  const auto& start = vids_[left_.levels.front().front()];
+  for (auto id : meetIds) {
+    auto forward = forwardSteps(id);
+    auto backward = backwardSteps(id);
+    for (const auto& head : forward) {
+      for (const auto& tail : backward) {
+        Path path;
+        path.src = Vertex(start, {});
+        path.steps.reserve(head.size() + tail.size());
+        path.steps.insert(path.steps.end(), head.begin(), head.end());
+        path.steps.insert(path.steps.end(), tail.begin(), tail.end());
+        Row row;
+        row.values.emplace_back(std::move(path));
+        ds.rows.emplace_back(std::move(row));
+      }
+    }
+  }
+  return ds;
+}
+
+void BiBFSShortestPathExecutor::setFrontier(const std::string& var, const Side* side) {
+  DataSet ds;
+  ds.colNames = {kVid};
+  if (side != nullptr) {
+    for (auto id : side->levels.back()) {
+      Row row;
+      row.values.emplace_back(vids_[id]);
+      ds.rows.emplace_back(std::move(row));
+    }
+  }
+  ectx_->setResult(var, ResultBuilder().value(Value(std::move(ds))).build());
+}
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,82 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_EXECUTOR_ALGO_BIBFSSHORTESTPATHEXECUTOR_H_
+#define GRAPH_EXECUTOR_ALGO_BIBFSSHORTESTPATHEXECUTOR_H_
+
+#include "graph/executor/Executor.h"
+
+namespace nebula {
+namespace graph {
+/*
+ * Bidirectional BFS between a single pair of vertices. Vertices are mapped to dense ids once, and
+ * both directions only keep the bitset of visited vertices, the vertex ids of each depth and the
+ * parent links of each vertex. Paths are only materialized at the meeting points.
+ *
+ * Each round expands the direction with the smaller frontier, except the first round which
+ * expands both of them. The frontier of the direction which is not expanded is kept here, and an
+ * empty vid set is written to its GetNeighbors input.
+ */
+class BiBFSShortestPathExecutor final : public Executor {
+ public:
+  BiBFSShortestPathExecutor(const PlanNode* node, QueryContext* qctx)
+      : Executor("BiBFSShortestPath", node, qctx) {}
+
+  folly::Future<Status> execute() override;
+
+ private:
+  struct Link {
+    // dense id of the vertex on the previous depth
+    uint32_t parent;
+    EdgeType type;
+    EdgeRanking ranking;
+  };
+
+  struct Side {
+    // bitset of the vertices reached by this direction
+    std::vector<bool> visited;
+    // vertices reached at each depth, levels.back() is the frontier
+    std::vector<std::vector<uint32_t>> levels;
+    // all links to the vertex on the previous depth, indexed by dense id
+    std::vector<std::vector<Link>> parents;
+
+    size_t depth() const {
+      return levels.size() - 1;
+    }
+  };
+
+  void init();
+
+  uint32_t vertexId(const Value& vid);
+
+  // Reach the next depth of one direction by the neighbors of its frontier
+  void expand(Iterator* iter, Side& side);
+
+  // Find the vertices of the shortest paths with length, whose depth of left side is leftDepth
+  std::vector<uint32_t> meets(size_t leftDepth, size_t length) const;
+
+  std::vector<std::vector<Step>> forwardSteps(uint32_t id) const;
+
+  std::vector<std::vector<Step>> backwardSteps(uint32_t id) const;
+
+  DataSet buildPaths(const std::vector<uint32_t>& meetIds) const;
+
+  void setFrontier(const std::string& var, const Side* side);
+
+ private:
+  bool initialized_{false};
+  bool expandLeft_{true};
+  bool expandRight_{true};
+  std::unordered_map<Value, uint32_t> vidIndex_;
+  std::vector<Value> vids_;
+  std::unordered_map<EdgeType, std::string> edgeNames_;
+  Side left_;
+  Side right_;
+  // the paths not longer than it have been checked
+  size_t checkedLength_{0};
+};
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_EXECUTOR_ALGO_BIBFSSHORTESTPATHEXECUTOR_H_
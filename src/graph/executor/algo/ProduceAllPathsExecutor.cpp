@@ -28,61 +28,91 @@ folly::Future<Status> ProduceAllPathsExecutor::execute() {
       continue;
     }
     auto& edge = edgeVal.getEdge();
-    auto histPaths = historyPaths_.find(edge.src);
-    if (histPaths == historyPaths_.end()) {
-      createPaths(edge, interims);
+    std::vector<size_t> starts;
+    const std::vector<size_t>* prevPaths = nullptr;
+    if (count_ == 0) {
+      auto ret = starts_.emplace(edge.src, nodes_.size());
+      if (ret.second) {
+        nodes_.emplace_back(PathNode{kNoPrev, edge.src, 0, 0});
+      }
+      starts.emplace_back(ret.first->second);
+      prevPaths = &starts;
     } else {
-      buildPaths(histPaths->second, edge, interims);
+      auto found = prev_.find(edge.src);
+      if (found == prev_.end()) {
+        continue;
+      }
+      prevPaths = &found->second;
+    }
+    edgeNames_.emplace(edge.type, edge.name);
+    for (auto prev : *prevPaths) {
+      if (!extendable(prev, edge)) {
+        continue;
+      }
+      nodes_.emplace_back(PathNode{prev, edge.dst, edge.type, edge.ranking});
+      interims[edge.dst].emplace_back(nodes_.size() - 1);
     }
   }
 
+  // Only the paths of this step are materialized
   for (auto& interim : interims) {
+    List paths;
+    paths.values.reserve(interim.second.size());
+    for (auto last : interim.second) {
+      paths.values.emplace_back(buildPath(last));
+    }
     Row row;
-    auto& dst = interim.first;
-    auto& paths = interim.second;
-    row.values.emplace_back(std::move(dst));
-    row.values.emplace_back(List(std::move(paths)));
+    row.values.emplace_back(interim.first);
+    row.values.emplace_back(std::move(paths));
     ds.rows.emplace_back(std::move(row));
-
-    const auto& dstInDs = ds.rows.back().values.front();
-    for (auto& path : ds.rows.back().values.back().getList().values) {
-      historyPaths_[dstInDs].emplace_back(&path.getPath());
-    }
   }
+  prev_ = std::move(interims);
   count_++;
   return finish(ResultBuilder().value(Value(std::move(ds))).build());
 }
 
-void ProduceAllPathsExecutor::createPaths(const Edge& edge, Interims& interims) {
-  Path path;
-  path.src = Vertex(edge.src, {});
-  path.steps.emplace_back(Step(Vertex(edge.dst, {}), edge.type, edge.name, edge.ranking, {}));
-  if (noLoop_ && path.hasDuplicateVertices()) {
-    return;
+bool ProduceAllPathsExecutor::extendable(size_t last, const Edge& edge) const {
+  // the same edge of different directions
+  auto sameEdge = [&edge](const Value& src, const Value& dst, EdgeType type, EdgeRanking ranking) {
+    if (type != edge.type && type != -edge.type) {
+      return false;
+    }
+    if (ranking != edge.ranking) {
+      return false;
+    }
+    if (type == edge.type) {
+      return src == edge.src && dst == edge.dst;
+    }
+    return src == edge.dst && dst == edge.src;
+  };
+  const auto* node = &nodes_[last];
+  for (; node->prev != kNoPrev; node = &nodes_[node->prev]) {
+    if (noLoop_ && node->vid == edge.dst) {
+      return false;
+    }
+    if (sameEdge(nodes_[node->prev].vid, node->vid, node->type, node->ranking)) {
+      return false;
+    }
   }
-  VLOG(1) << "Create path: " << path;
-  interims[edge.dst].emplace_back(std::move(path));
+  // the start vertex
+  return !(noLoop_ && node->vid == edge.dst);
 }
 
-void ProduceAllPathsExecutor::buildPaths(const std::vector<const Path*>& history,
-                                         const Edge& edge,
-                                         Interims& interims) {
-  for (auto* histPath : history) {
-    if (histPath->steps.size() < count_) {
-      continue;
-    } else {
-      Path path = *histPath;
-      path.steps.emplace_back(Step(Vertex(edge.dst, {}), edge.type, edge.name, edge.ranking, {}));
-      if (path.hasDuplicateEdges()) {
-        continue;
-      }
-      if (noLoop_ && path.hasDuplicateVertices()) {
-        continue;
-      }
-      VLOG(1) << "Build path: " << path;
-      interims[edge.dst].emplace_back(std::move(path));
-    }
+Path ProduceAllPathsExecutor::buildPath(size_t last) const {
+  std::vector<const PathNode*> steps;
+  const auto* node = &nodes_[last];
+  for (; node->prev != kNoPrev; node = &nodes_[node->prev]) {
+    steps.emplace_back(node);
+  }
+  Path path;
+  path.src = Vertex(node->vid, {});
+  path.steps.reserve(steps.size());
+  for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+    auto* step = *it;
+    path.steps.emplace_back(
+        Step(Vertex(step->vid, {}), step->type, edgeNames_.at(step->type), step->ranking, {}));
   }
+  return path;
 }
 
 }  // namespace graph
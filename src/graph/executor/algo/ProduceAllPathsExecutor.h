@@ -18,18 +18,33 @@ class ProduceAllPathsExecutor final : public Executor {
   folly::Future<Status> execute() override;
 
  private:
-  // k: dst, v: paths to dst
-  using HistoryPaths = std::unordered_map<Value, std::vector<const Path*>>;
+  // A step of the paths, which is shared by all the paths extended from it
+  struct PathNode {
+    // index of the previous step in nodes_, kNoPrev for the start vertex
+    size_t prev;
+    Value vid;
+    EdgeType type;
+    EdgeRanking ranking;
+  };
 
-  // k: dst, v: paths to dst
-  using Interims = std::unordered_map<Value, std::vector<Value>>;
+  static constexpr size_t kNoPrev = std::numeric_limits<size_t>::max();
 
-  void createPaths(const Edge& edge, Interims& interims);
+  // k: dst, v: index of the last steps of the paths to dst
+  using Interims = std::unordered_map<Value, std::vector<size_t>>;
 
-  void buildPaths(const std::vector<const Path*>& history, const Edge& edge, Interims& interims);
+  // Check whether the path ending with nodes_[last] could be extended by the edge, the path itself
+  // has been checked before.
+  bool extendable(size_t last, const Edge& edge) const;
+
+  Path buildPath(size_t last) const;
 
   size_t count_{0};
-  HistoryPaths historyPaths_;
+  std::vector<PathNode> nodes_;
+  // start vertex -> index in nodes_
+  std::unordered_map<Value, size_t> starts_;
+  std::unordered_map<EdgeType, std::string> edgeNames_;
+  // the paths of last step
+  Interims prev_;
   bool noLoop_{false};
 };
 }  // namespace graph
@@ -6,6 +6,7 @@
 #include "graph/executor/algo/SubgraphExecutor.h"
 
 #include "graph/planner/plan/Algo.h"
+#include "graph/planner/plan/Query.h"
 
 namespace nebula {
 namespace graph {
@@ -15,61 +16,160 @@ folly::Future<Status> SubgraphExecutor::execute() {
   auto* subgraph = asNode<Subgraph>(node());
   DataSet ds;
   ds.colNames = subgraph->colNames();
+  if (finished_) {
+    return finish(ResultBuilder().value(Value(std::move(ds))).build());
+  }
 
-  uint32_t steps = subgraph->steps();
+  // the subgraph contains the vertices within maxStep
+  size_t maxStep = subgraph->steps() - 1;
   const auto& currentStepVal = ectx_->getValue(subgraph->currentStepVar());
   DCHECK(currentStepVal.isInt());
   auto currentStep = currentStepVal.getInt();
-  VLOG(1) << "Current Step is: " << currentStep << " Total Steps is: " << steps;
-
-  if (currentStep == steps) {
-    oneMoreStep();
-    return finish(ResultBuilder().value(Value(std::move(ds))).build());
-  }
+  VLOG(1) << "Current Step is: " << currentStep << " Total Steps is: " << subgraph->steps();
 
-  VLOG(1) << "input: " << subgraph->inputVar() << " output: " << node()->outputVar();
-  auto iter = ectx_->getResult(subgraph->inputVar()).iter();
-  DCHECK(iter && iter->isGetNeighborsIter());
   if (currentStep == 1) {
-    for (; iter->valid(); iter->next()) {
-      const auto& src = iter->getColumn(nebula::kVid);
-      historyVids_.emplace(src);
-    }
-    iter->reset();
+    initStarts();
   }
-  for (; iter->valid(); iter->next()) {
-    const auto& dst = iter->getEdgeProp("*", nebula::kDst);
-    if (historyVids_.emplace(dst).second) {
+  collect(ectx_->getResult(subgraph->inputVar()));
+  updateSteps(maxStep);
+
+  for (auto& step : steps_) {
+    auto& vid = step.first;
+    if (expanded_.find(vid) == expanded_.end() && requested_.emplace(vid).second) {
       Row row;
-      row.values.emplace_back(std::move(dst));
+      row.values.emplace_back(vid);
       ds.rows.emplace_back(std::move(row));
     }
   }
 
+  if (ds.rows.empty() || currentStep >= subgraph->steps()) {
+    buildResult(maxStep);
+    finished_ = true;
+    ds.rows.clear();
+  }
   VLOG(1) << "Next step vid is : " << ds;
   return finish(ResultBuilder().value(Value(std::move(ds))).build());
 }
 
-void SubgraphExecutor::oneMoreStep() {
+void SubgraphExecutor::initStarts() {
   auto* subgraph = asNode<Subgraph>(node());
-  auto output = subgraph->oneMoreStepOutput();
-  VLOG(1) << "OneMoreStep Input: " << subgraph->inputVar() << " Output: " << output;
-  auto iter = ectx_->getResult(subgraph->inputVar()).iter();
-  DCHECK(iter && iter->isGetNeighborsIter());
+  auto* gn = asNode<GetNeighbors>(subgraph->dep());
+  // the start vertices are the input of the first GetNeighbors
+  auto iter = ectx_->getResult(gn->inputVar()).iter();
+  QueryExpressionContext ctx(ectx_);
+  for (; iter->valid(); iter->next()) {
+    auto vid = gn->src()->eval(ctx(iter.get()));
+    if (requested_.emplace(vid).second) {
+      starts_.emplace_back(std::move(vid));
+    }
+  }
+}
+
+void SubgraphExecutor::collect(const Result& result) {
+  auto response = result.valuePtr();
+  if (!response->isList()) {
+    return;
+  }
+  for (const auto& val : response->getList().values) {
+    if (!val.isDataSet()) {
+      continue;
+    }
+    const auto& ds = val.getDataSet();
+    for (const auto& row : ds.rows) {
+      expanded_.emplace(row.values.front(), Neighbors{&ds, &row, {}});
+    }
+  }
+  responses_.emplace_back(std::move(response));
 
-  ResultBuilder builder;
-  builder.value(iter->valuePtr());
-  while (iter->valid()) {
+  auto iter = result.iter();
+  DCHECK(iter && iter->isGetNeighborsIter());
+  for (; iter->valid(); iter->next()) {
     const auto& dst = iter->getEdgeProp("*", nebula::kDst);
-    if (historyVids_.find(dst) == historyVids_.end()) {
-      iter->unstableErase();
-    } else {
-      iter->next();
+    if (dst.empty() || dst.isNull()) {
+      continue;
+    }
+    auto found = expanded_.find(iter->getColumn(nebula::kVid));
+    if (found != expanded_.end()) {
+      found->second.dsts.emplace_back(dst);
+    }
+  }
+}
+
+void SubgraphExecutor::updateSteps(size_t maxStep) {
+  // The vertices expanded by storage may reach a vertex by a longer path first, so the steps are
+  // computed from scratch each round
+  steps_.clear();
+  std::vector<const Value*> current;
+  for (const auto& start : starts_) {
+    if (steps_.emplace(start, 0).second) {
+      current.emplace_back(&start);
+    }
+  }
+  for (size_t step = 1; step <= maxStep && !current.empty(); ++step) {
+    std::vector<const Value*> next;
+    for (const auto* vid : current) {
+      auto found = expanded_.find(*vid);
+      if (found == expanded_.end()) {
+        continue;
+      }
+      for (const auto& dst : found->second.dsts) {
+        if (steps_.emplace(dst, step).second) {
+          next.emplace_back(&dst);
+        }
+      }
+    }
+    current.swap(next);
+  }
+}
+
+void SubgraphExecutor::buildResult(size_t maxStep) {
+  auto* subgraph = asNode<Subgraph>(node());
+  // The neighbors of each step are grouped by the dataset of response, since their columns may be
+  // different
+  std::vector<std::unordered_map<const DataSet*, DataSet>> neighbors(maxStep + 1);
+  for (const auto& vertex : expanded_) {
+    auto found = steps_.find(vertex.first);
+    if (found == steps_.end()) {
+      continue;
     }
+    const auto& expanded = vertex.second;
+    auto& ds = neighbors[found->second][expanded.ds];
+    if (ds.colNames.empty()) {
+      ds.colNames = expanded.ds->colNames;
+    }
+    ds.rows.emplace_back(*expanded.row);
+  }
+
+  for (size_t step = 0; step <= maxStep; ++step) {
+    if (neighbors[step].empty()) {
+      continue;
+    }
+    List list;
+    for (auto& ds : neighbors[step]) {
+      list.values.emplace_back(std::move(ds.second));
+    }
+    ResultBuilder builder;
+    builder.value(Value(std::move(list))).iter(Iterator::Kind::kGetNeighbors);
+    if (step < maxStep) {
+      ectx_->setResult(subgraph->resultVar(), builder.build());
+      continue;
+    }
+    // only keep the edges between the vertices of subgraph in the last step
+    auto result = builder.build();
+    auto iter = result.iter();
+    while (iter->valid()) {
+      const auto& dst = iter->getEdgeProp("*", nebula::kDst);
+      if (steps_.find(dst) == steps_.end()) {
+        iter->unstableErase();
+      } else {
+        iter->next();
+      }
+    }
+    iter->reset();
+    ResultBuilder lastBuilder;
+    lastBuilder.value(iter->valuePtr()).iter(std::move(iter));
+    ectx_->setResult(subgraph->resultVar(), lastBuilder.build());
   }
-  iter->reset();
-  builder.iter(std::move(iter));
-  ectx_->setResult(output, builder.build());
 }
 
 }  // namespace graph
@@ -10,6 +10,13 @@
 
 namespace nebula {
 namespace graph {
+/*
+ * The neighbors of one round may cover more than one step, since storage expands the neighbors
+ * located in the same host locally. So the step of each vertex is computed by BFS over all the
+ * expanded vertices, and the vertices within the steps which are never requested make up the next
+ * round. The neighbors are split into steps after the expansion finishes, and the edges of the
+ * last step only keep the ones whose dst is in the subgraph.
+ */
 class SubgraphExecutor : public Executor {
  public:
   SubgraphExecutor(const PlanNode* node, QueryContext* qctx)
@@ -18,10 +25,29 @@ class SubgraphExecutor : public Executor {
   folly::Future<Status> execute() override;
 
  private:
-  void oneMoreStep();
+  struct Neighbors {
+    const DataSet* ds;
+    const Row* row;
+    std::vector<Value> dsts;
+  };
+
+  void initStarts();
+
+  void collect(const Result& result);
+
+  // Compute the steps from the start vertices, the vertices beyond the max step are skipped
+  void updateSteps(size_t maxStep);
+
+  void buildResult(size_t maxStep);
 
  private:
-  std::unordered_set<Value> historyVids_;
+  bool finished_{false};
+  std::vector<Value> starts_;
+  // keep the responses alive, which the rows of expanded_ point to
+  std::vector<std::shared_ptr<Value>> responses_;
+  std::unordered_map<Value, Neighbors> expanded_;
+  std::unordered_set<Value> requested_;
+  std::unordered_map<Value, size_t> steps_;
 };
 
 }  // namespace graph
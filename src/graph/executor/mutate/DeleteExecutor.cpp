@@ -6,6 +6,7 @@
 #include "DeleteExecutor.h"
 
 #include "common/time/ScopedTimer.h"
+#include "graph/context/NeighborCache.h"
 #include "graph/context/QueryContext.h"
 #include "graph/executor/mutate/DeleteExecutor.h"
 #include "graph/planner/plan/Mutate.h"
@@ -70,7 +71,8 @@ folly::Future<Status> DeleteVerticesExecutor::deleteVertices() {
       ->getStorageClient()
       ->deleteVertices(param, std::move(vertices))
       .via(runner())
-      .ensure([deleteVertTime]() {
+      .ensure([deleteVertTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
         VLOG(1) << "Delete vertices time: " << deleteVertTime.elapsedInUSec() << "us";
       })
       .thenValue([this](storage::StorageRpcResponse<storage::cpp2::ExecResponse> resp) {
@@ -126,7 +128,8 @@ folly::Future<Status> DeleteTagsExecutor::deleteTags() {
       ->getStorageClient()
       ->deleteTags(param, std::move(delTags))
       .via(runner())
-      .ensure([deleteTagTime]() {
+      .ensure([deleteTagTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
         VLOG(1) << "Delete vertices time: " << deleteTagTime.elapsedInUSec() << "us";
       })
       .thenValue([this](storage::StorageRpcResponse<storage::cpp2::ExecResponse> resp) {
@@ -214,7 +217,8 @@ folly::Future<Status> DeleteEdgesExecutor::deleteEdges() {
       ->getStorageClient()
       ->deleteEdges(param, std::move(edgeKeys))
       .via(runner())
-      .ensure([deleteEdgeTime]() {
+      .ensure([deleteEdgeTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
         VLOG(1) << "Delete edge time: " << deleteEdgeTime.elapsedInUSec() << "us";
       })
       .thenValue([this](storage::StorageRpcResponse<storage::cpp2::ExecResponse> resp) {
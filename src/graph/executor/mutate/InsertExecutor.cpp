@@ -6,6 +6,7 @@
 #include "graph/executor/mutate/InsertExecutor.h"
 
 #include "common/time/ScopedTimer.h"
+#include "graph/context/NeighborCache.h"
 #include "graph/context/QueryContext.h"
 #include "graph/planner/plan/Mutate.h"
 #include "graph/service/GraphFlags.h"
@@ -35,7 +36,8 @@ folly::Future<Status> InsertVerticesExecutor::insertVertices() {
                     ivNode->getIfNotExists(),
                     ivNode->getIgnoreExistedIndex())
       .via(runner())
-      .ensure([addVertTime]() {
+      .ensure([addVertTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
         VLOG(1) << "Add vertices time: " << addVertTime.elapsedInUSec() << "us";
       })
       .thenValue([this](storage::StorageRpcResponse<storage::cpp2::ExecResponse> resp) {
@@ -66,8 +68,10 @@ folly::Future<Status> InsertEdgesExecutor::insertEdges() {
                  ieNode->getIfNotExists(),
                  ieNode->getIgnoreExistedIndex())
       .via(runner())
-      .ensure(
-          [addEdgeTime]() { VLOG(1) << "Add edge time: " << addEdgeTime.elapsedInUSec() << "us"; })
+      .ensure([addEdgeTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
+        VLOG(1) << "Add edge time: " << addEdgeTime.elapsedInUSec() << "us";
+      })
       .thenValue([this](storage::StorageRpcResponse<storage::cpp2::ExecResponse> resp) {
         SCOPED_TIMER(&execTime_);
         NG_RETURN_IF_ERROR(handleCompleteness(resp, false));
@@ -6,6 +6,7 @@
 #include "UpdateExecutor.h"
 
 #include "common/time/ScopedTimer.h"
+#include "graph/context/NeighborCache.h"
 #include "graph/context/QueryContext.h"
 #include "graph/planner/plan/Mutate.h"
 #include "graph/service/GraphFlags.h"
@@ -61,7 +62,8 @@ folly::Future<Status> UpdateVertexExecutor::execute() {
                      uvNode->getReturnProps(),
                      uvNode->getCondition())
       .via(runner())
-      .ensure([updateVertTime]() {
+      .ensure([updateVertTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
         VLOG(1) << "Update vertice time: " << updateVertTime.elapsedInUSec() << "us";
       })
       .thenValue([this](StatusOr<storage::cpp2::UpdateResponse> resp) {
@@ -112,7 +114,8 @@ folly::Future<Status> UpdateEdgeExecutor::execute() {
                    ueNode->getReturnProps(),
                    ueNode->getCondition())
       .via(runner())
-      .ensure([updateEdgeTime]() {
+      .ensure([updateEdgeTime, space = param.space]() {
+        NeighborCache::instance()->invalidate(space);
         VLOG(1) << "Update edge time: " << updateEdgeTime.elapsedInUSec() << "us";
       })
       .thenValue([this](StatusOr<storage::cpp2::UpdateResponse> resp) {
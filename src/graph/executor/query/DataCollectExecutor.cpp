@@ -64,13 +64,10 @@ Status DataCollectExecutor::collectSubgraph(const std::vector<std::string>& vars
   DataSet ds;
   ds.colNames = std::move(colNames_);
   std::unordered_set<std::tuple<Value, EdgeType, EdgeRanking, Value>> uniqueEdges;
-  for (auto i = vars.begin(); i != vars.end(); ++i) {
-    const auto& hist = ectx_->getHistory(*i);
-    for (auto j = hist.begin(); j != hist.end(); ++j) {
-      if (i == vars.begin() && j == hist.end() - 1) {
-        continue;
-      }
-      auto iter = (*j).iter();
+  for (auto& var : vars) {
+    // each result is the neighbors of one step
+    for (const auto& result : ectx_->getHistory(var)) {
+      auto iter = result.iter();
       if (!iter->isGetNeighborsIter()) {
         std::stringstream msg;
         msg << "Iterator should be kind of GetNeighborIter, but was: " << iter->kind();
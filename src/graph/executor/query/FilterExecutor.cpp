@@ -5,6 +5,7 @@
 
 #include "graph/executor/query/FilterExecutor.h"
 
+#include "common/expression/ExprProgram.h"
 #include "common/time/ScopedTimer.h"
 #include "graph/context/QueryExpressionContext.h"
 #include "graph/planner/plan/Query.h"
@@ -30,8 +31,9 @@ folly::Future<Status> FilterExecutor::execute() {
   builder.value(result.valuePtr());
   QueryExpressionContext ctx(ectx_);
   auto condition = filter->condition();
+  auto program = FLAGS_enable_expr_program ? ExprProgram::compile(condition) : nullptr;
   while (iter->valid()) {
-    auto val = condition->eval(ctx(iter));
+    auto val = program != nullptr ? program->eval(ctx(iter)) : condition->eval(ctx(iter));
     if (val.isBadNull() || (!val.empty() && !val.isBool() && !val.isNull())) {
       return Status::Error("Wrong type result, the type should be NULL, EMPTY or BOOL");
     }
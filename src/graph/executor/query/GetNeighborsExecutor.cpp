@@ -5,14 +5,18 @@
 
 #include "graph/executor/query/GetNeighborsExecutor.h"
 
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
 #include <sstream>
 
 #include "clients/storage/StorageClient.h"
 #include "common/datatypes/List.h"
 #include "common/datatypes/Vertex.h"
 #include "common/time/ScopedTimer.h"
+#include "graph/context/NeighborCache.h"
 #include "graph/context/QueryContext.h"
 #include "graph/service/GraphFlags.h"
+#include "graph/stats/GraphStats.h"
 
 using nebula::storage::StorageClient;
 using nebula::storage::StorageRpcResponse;
@@ -31,21 +35,44 @@ DataSet GetNeighborsExecutor::buildRequestDataSet() {
 
 folly::Future<Status> GetNeighborsExecutor::execute() {
   DataSet reqDs = buildRequestDataSet();
+  QueryExpressionContext qec(qctx()->ectx());
+  cacheSig_.clear();
+  cachedRows_ = DataSet();
+  if (FLAGS_enable_neighbor_cache && !reqDs.rows.empty() &&
+      NeighborCache::spaceEnabled(qctx()->rctx()->session()->space().name)) {
+    SCOPED_TIMER(&execTime_);
+    cacheSig_ = cacheSignature(reqDs.colNames, gn_->limit(qec), gn_->localSteps(qec));
+    if (!cacheSig_.empty()) {
+      lookupCache(reqDs.rows);
+    }
+  }
+  if (reqDs.rows.empty() && gn_->hasAggregate()) {
+    return finish(ResultBuilder()
+                      .value(Value(DataSet(gn_->colNames())))
+                      .iter(Iterator::Kind::kSequential)
+                      .build());
+  }
   if (reqDs.rows.empty()) {
-    List emptyResult;
+    List result;
+    if (!cachedRows_.rows.empty()) {
+      result.values.emplace_back(std::move(cachedRows_));
+    }
     return finish(ResultBuilder()
-                      .value(Value(std::move(emptyResult)))
+                      .value(Value(std::move(result)))
                       .iter(Iterator::Kind::kGetNeighbors)
                       .build());
   }
 
   time::Duration getNbrTime;
   StorageClient* storageClient = qctx_->getStorageClient();
-  QueryExpressionContext qec(qctx()->ectx());
   StorageClient::CommonRequestParam param(gn_->space(),
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  std::unique_ptr<storage::cpp2::AggregateSpec> aggregate;
+  if (gn_->hasAggregate()) {
+    aggregate = std::make_unique<storage::cpp2::AggregateSpec>(gn_->aggregateSpec());
+  }
   return storageClient
       ->getNeighbors(param,
                      std::move(reqDs.colNames),
@@ -60,7 +87,9 @@ folly::Future<Status> GetNeighborsExecutor::execute() {
                      gn_->random(),
                      gn_->orderBy(),
                      gn_->limit(qec),
-                     gn_->filter())
+                     gn_->filter(),
+                     gn_->localSteps(qec),
+                     aggregate.get())
       .via(runner())
       .ensure([this, getNbrTime]() {
         SCOPED_TIMER(&execTime_);
@@ -84,10 +113,103 @@ folly::Future<Status> GetNeighborsExecutor::execute() {
             otherStats_.emplace("storage_detail", detail);
           }
         }
+        updateCache(resp);
         return handleResponse(resp);
       });
 }
 
+std::string GetNeighborsExecutor::cacheSignature(const std::vector<std::string>& colNames,
+                                                 int64_t limit,
+                                                 int32_t localSteps) const {
+  // The result of random, multiple steps, aggregate or top N is not determined by each input
+  // vertex
+  if (gn_->random() || localSteps > 0 || gn_->hasAggregate() || !gn_->orderBy().empty()) {
+    return "";
+  }
+  storage::cpp2::TraverseSpec spec;
+  spec.edge_types_ref() = gn_->edgeTypes();
+  spec.edge_direction_ref() = gn_->edgeDirection();
+  spec.dedup_ref() = gn_->dedup();
+  if (gn_->statProps() != nullptr) {
+    spec.stat_props_ref() = *gn_->statProps();
+  }
+  if (gn_->vertexProps() != nullptr) {
+    spec.vertex_props_ref() = *gn_->vertexProps();
+  }
+  if (gn_->edgeProps() != nullptr) {
+    spec.edge_props_ref() = *gn_->edgeProps();
+  }
+  if (gn_->exprs() != nullptr) {
+    spec.expressions_ref() = *gn_->exprs();
+  }
+  if (!gn_->orderBy().empty()) {
+    spec.order_by_ref() = gn_->orderBy();
+  }
+  spec.limit_ref() = limit;
+  if (gn_->filter() != nullptr) {
+    spec.filter_ref() = gn_->filter()->encode();
+  }
+  std::string sig;
+  apache::thrift::CompactSerializer::serialize(spec, &sig);
+  auto space = gn_->space();
+  sig.append(reinterpret_cast<const char*>(&space), sizeof(GraphSpaceID));
+  for (const auto& name : colNames) {
+    sig.append(name).append(1, '\0');
+  }
+  return sig;
+}
+
+void GetNeighborsExecutor::lookupCache(std::vector<Row>& rows) {
+  auto* cache = NeighborCache::instance();
+  // Read before the rows, so any mutation since then makes the fetched rows stale
+  cacheVersion_ = cache->version(gn_->space());
+  std::shared_ptr<const std::vector<std::string>> colNames;
+  std::vector<Row> missed;
+  for (auto& row : rows) {
+    auto entry = cache->get(gn_->space(), NeighborCache::key(cacheSig_, row.values.front()));
+    if (entry != nullptr && (colNames == nullptr || *colNames == *entry->colNames)) {
+      if (colNames == nullptr) {
+        colNames = entry->colNames;
+      }
+      cachedRows_.rows.emplace_back(entry->row);
+    } else {
+      missed.emplace_back(std::move(row));
+    }
+  }
+  if (colNames != nullptr) {
+    cachedRows_.colNames = *colNames;
+  }
+  stats::StatsManager::addValue(kNumNeighborCacheHits, cachedRows_.rows.size());
+  stats::StatsManager::addValue(kNumNeighborCacheMisses, missed.size());
+  otherStats_.emplace("neighbor_cache_hits", folly::sformat("{}", cachedRows_.rows.size()));
+  rows = std::move(missed);
+}
+
+void GetNeighborsExecutor::updateCache(const RpcResponse& resps) {
+  if (cacheSig_.empty()) {
+    return;
+  }
+  auto* cache = NeighborCache::instance();
+  for (const auto& resp : resps.responses()) {
+    auto dataset = resp.get_vertices();
+    // The rows of a partially failed response may be incomplete
+    if (dataset == nullptr || !resp.get_result().get_failed_parts().empty()) {
+      continue;
+    }
+    auto colNames = std::make_shared<const std::vector<std::string>>(dataset->colNames);
+    for (const auto& row : dataset->rows) {
+      if (row.values.empty()) {
+        continue;
+      }
+      cache->put(gn_->space(),
+                 NeighborCache::key(cacheSig_, row.values.front()),
+                 colNames,
+                 row,
+                 cacheVersion_);
+    }
+  }
+}
+
 Status GetNeighborsExecutor::handleResponse(RpcResponse& resps) {
   auto result = handleCompleteness(resps, FLAGS_accept_partial_success);
   NG_RETURN_IF_ERROR(result);
@@ -95,7 +217,24 @@ Status GetNeighborsExecutor::handleResponse(RpcResponse& resps) {
   builder.state(result.value());
 
   auto& responses = resps.responses();
+  if (gn_->hasAggregate()) {
+    // The partial groups of all the hosts, which are merged by the Aggregate above
+    DataSet groups(gn_->colNames());
+    for (auto& resp : responses) {
+      if (resp.vertices_ref().has_value()) {
+        auto& rows = resp.vertices_ref()->rows;
+        groups.rows.insert(groups.rows.end(),
+                           std::make_move_iterator(rows.begin()),
+                           std::make_move_iterator(rows.end()));
+      }
+    }
+    builder.value(Value(std::move(groups))).iter(Iterator::Kind::kSequential);
+    return finish(builder.build());
+  }
   List list;
+  if (!cachedRows_.rows.empty()) {
+    list.values.emplace_back(std::move(cachedRows_));
+  }
   for (auto& resp : responses) {
     auto dataset = resp.get_vertices();
     if (dataset == nullptr) {
@@ -28,8 +28,22 @@ class GetNeighborsExecutor final : public StorageAccessExecutor {
   using RpcResponse = storage::StorageRpcResponse<storage::cpp2::GetNeighborsResponse>;
   Status handleResponse(RpcResponse& resps);
 
+  // All fields of the request to storage except the input vertices
+  std::string cacheSignature(const std::vector<std::string>& colNames,
+                             int64_t limit,
+                             int32_t localSteps) const;
+
+  // Move the rows of input vertices found in the neighbor cache to cachedRows_
+  void lookupCache(std::vector<Row>& rows);
+
+  void updateCache(const RpcResponse& resps);
+
  private:
   const GetNeighbors* gn_;
+  // Empty if the neighbor cache is not used
+  std::string cacheSig_;
+  int64_t cacheVersion_{0};
+  DataSet cachedRows_;
 };
 
 }  // namespace graph
@@ -41,6 +41,10 @@ folly::Future<Status> IndexScanExecutor::indexScan() {
                                           qctx()->rctx()->session()->id(),
                                           qctx()->plan()->id(),
                                           qctx()->plan()->isProfileEnabled());
+  std::unique_ptr<storage::cpp2::AggregateSpec> aggregate;
+  if (lookup->hasAggregate()) {
+    aggregate = std::make_unique<storage::cpp2::AggregateSpec>(lookup->aggregateSpec());
+  }
   return storageClient
       ->lookupIndex(param,
                     ictxs,
@@ -48,7 +52,8 @@ folly::Future<Status> IndexScanExecutor::indexScan() {
                     lookup->schemaId(),
                     lookup->returnColumns(),
                     lookup->orderBy(),
-                    lookup->limit(qctx_))
+                    lookup->limit(qctx_),
+                    aggregate.get())
       .via(runner())
       .thenValue([this](StorageRpcResponse<LookupIndexResp> &&rpcResp) {
         addStats(rpcResp, otherStats_);
@@ -81,8 +86,10 @@ Status IndexScanExecutor::handleResp(storage::StorageRpcResponse<Resp> &&rpcResp
     DCHECK_EQ(node()->colNames().size(), v.colNames.size());
     v.colNames = node()->colNames();
   }
-  return finish(
-      ResultBuilder().value(std::move(v)).iter(Iterator::Kind::kProp).state(state).build());
+  // The partial groups are plain rows instead of the props of tag or edge
+  auto kind = asNode<IndexScan>(node())->hasAggregate() ? Iterator::Kind::kSequential
+                                                        : Iterator::Kind::kProp;
+  return finish(ResultBuilder().value(std::move(v)).iter(kind).state(state).build());
 }
 
 }  // namespace graph
@@ -5,6 +5,7 @@
 
 #include "graph/executor/query/ProjectExecutor.h"
 
+#include "common/expression/ExprProgram.h"
 #include "common/time/ScopedTimer.h"
 #include "graph/context/QueryExpressionContext.h"
 #include "graph/planner/plan/Query.h"
@@ -25,10 +26,17 @@ folly::Future<Status> ProjectExecutor::execute() {
   DataSet ds;
   ds.colNames = project->colNames();
   ds.rows.reserve(!iter->isGetNeighborsIter() ? iter->size() : 0);
+  std::vector<std::unique_ptr<ExprProgram>> programs;
+  if (FLAGS_enable_expr_program) {
+    for (auto& col : columns) {
+      programs.emplace_back(ExprProgram::compile(col->expr()));
+    }
+  }
   for (; iter->valid(); iter->next()) {
     Row row;
-    for (auto& col : columns) {
-      Value val = col->expr()->eval(ctx(iter.get()));
+    for (size_t i = 0; i < columns.size(); ++i) {
+      Value val = programs.empty() ? columns[i]->expr()->eval(ctx(iter.get()))
+                                   : programs[i]->eval(ctx(iter.get()));
       row.values.emplace_back(std::move(val));
     }
     ds.rows.emplace_back(std::move(row));
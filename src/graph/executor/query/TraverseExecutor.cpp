@@ -34,6 +34,9 @@ folly::Future<Status> TraverseExecutor::execute() {
 Status TraverseExecutor::close() {
   // clear the members
   reqDs_.rows.clear();
+  inputs_.clear();
+  nodes_.clear();
+  prev_.clear();
   return Executor::close();
 }
 
@@ -49,7 +52,7 @@ Status TraverseExecutor::buildRequestDataSet() {
 
   std::unordered_set<Value> uniqueSet;
   uniqueSet.reserve(iter->size());
-  std::unordered_map<Value, Paths> prev;
+  inputs_.reserve(iter->size());
   const auto& spaceInfo = qctx()->rctx()->session()->space();
   const auto& vidType = *(spaceInfo.spaceDesc.vid_type_ref());
   auto* src = traverse_->src();
@@ -63,14 +66,13 @@ Status TraverseExecutor::buildRequestDataSet() {
       continue;
     }
     // Need copy here, Argument executor may depends on this variable.
-    auto prePath = *iter->row();
-    buildPath(prev, vid, std::move(prePath));
+    inputs_.emplace_back(*iter->row());
+    prev_[vid].emplace_back(inputs_.size() - 1);
     if (!uniqueSet.emplace(vid).second) {
       continue;
     }
     reqDs_.emplace_back(Row({std::move(vid)}));
   }
-  paths_.emplace_back(std::move(prev));
   return Status::OK();
 }
 
@@ -182,20 +184,18 @@ Status TraverseExecutor::buildInterimPath(GetNeighborsIter* iter) {
   const auto& spaceInfo = qctx()->rctx()->session()->space();
   DataSet reqDs;
   reqDs.colNames = reqDs_.colNames;
-  size_t count = 0;
 
-  const std::unordered_map<Value, Paths>& prev = paths_.back();
   if (currentStep_ == 1 && zeroStep()) {
-    paths_.emplace_back();
-    NG_RETURN_IF_ERROR(handleZeroStep(prev, iter->getVertices(), paths_.back(), count));
-    // If 0..0 case, release memory and return immediately.
+    NG_RETURN_IF_ERROR(handleZeroStep(iter->getVertices()));
+    // If 0..0 case, return immediately.
     if (range_ != nullptr && range_->max() == 0) {
-      releasePrevPaths(count);
       return Status::OK();
     }
   }
-  paths_.emplace_back();
-  std::unordered_map<Value, Paths>& current = paths_.back();
+  if (range_ != nullptr && currentStep_ == range_->min()) {
+    resultBegin_ = nodes_.size();
+  }
+  Paths current;
 
   auto* vFilter = traverse_->vFilter();
   auto* eFilter = traverse_->eFilter();
@@ -222,57 +222,50 @@ Status TraverseExecutor::buildInterimPath(GetNeighborsIter* iter) {
     auto srcV = iter->getVertex();
     auto e = iter->getEdge();
     // Join on dst = src
-    auto pathToSrcFound = prev.find(srcV.getVertex().vid);
-    if (pathToSrcFound == prev.end()) {
+    auto pathToSrcFound = prev_.find(srcV.getVertex().vid);
+    if (pathToSrcFound == prev_.end()) {
       return Status::Error("Can't find prev paths.");
     }
     const auto& paths = pathToSrcFound->second;
-    for (auto& prevPath : paths) {
-      if (hasSameEdge(prevPath, e.getEdge())) {
+    for (auto prev : paths) {
+      bool first = currentStep_ == 1;
+      if (first ? hasSameEdge(inputs_[prev], e.getEdge()) : hasSameEdge(prev, e.getEdge())) {
         continue;
       }
       if (uniqueDst.emplace(dst).second) {
-        reqDs.rows.emplace_back(Row({std::move(dst)}));
-      }
-      if (currentStep_ == 1) {
-        Row path;
-        if (traverse_->trackPrevPath()) {
-          path = prevPath;
-        }
-        path.values.emplace_back(srcV);
-        List neighbors;
-        neighbors.values.emplace_back(e);
-        path.values.emplace_back(std::move(neighbors));
-        buildPath(current, dst, std::move(path));
-        ++count;
-      } else {
-        auto path = prevPath;
-        auto& eList = path.values.back().mutableList().values;
-        eList.emplace_back(srcV);
-        eList.emplace_back(e);
-        buildPath(current, dst, std::move(path));
-        ++count;
+        reqDs.rows.emplace_back(Row({dst}));
       }
-    }  // `prevPath'
+      nodes_.emplace_back(PathNode{prev, first, srcV, e});
+      current[dst].emplace_back(nodes_.size() - 1);
+    }  // `prev'
   }    // `iter'
 
-  releasePrevPaths(count);
+  prev_ = std::move(current);
   reqDs_ = std::move(reqDs);
   return Status::OK();
 }
 
-void TraverseExecutor::buildPath(std::unordered_map<Value, std::vector<Row>>& currentPaths,
-                                 const Value& dst,
-                                 Row&& path) {
-  auto pathToDstFound = currentPaths.find(dst);
-  if (pathToDstFound == currentPaths.end()) {
-    Paths interimPaths;
-    interimPaths.emplace_back(std::move(path));
-    currentPaths.emplace(dst, std::move(interimPaths));
-  } else {
-    auto& interimPaths = pathToDstFound->second;
-    interimPaths.emplace_back(std::move(path));
+Row TraverseExecutor::buildPath(size_t last) const {
+  std::vector<const PathNode*> steps;
+  steps.emplace_back(&nodes_[last]);
+  while (!steps.back()->first) {
+    steps.emplace_back(&nodes_[steps.back()->prev]);
+  }
+  Row path;
+  if (traverse_->trackPrevPath()) {
+    path = inputs_[steps.back()->prev];
   }
+  path.values.emplace_back(steps.back()->vertex);
+  List neighbors;
+  neighbors.values.reserve(steps.size() * 2 - 1);
+  for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+    if (it != steps.rbegin()) {
+      neighbors.values.emplace_back((*it)->vertex);
+    }
+    neighbors.values.emplace_back((*it)->edge);
+  }
+  path.values.emplace_back(std::move(neighbors));
+  return path;
 }
 
 Status TraverseExecutor::buildResult() {
@@ -283,17 +276,15 @@ Status TraverseExecutor::buildResult() {
 
   DataSet result;
   result.colNames = traverse_->colNames();
-  result.rows.reserve(cnt_);
-  for (auto& currentStepPaths : paths_) {
-    for (auto& paths : currentStepPaths) {
-      std::move(paths.second.begin(), paths.second.end(), std::back_inserter(result.rows));
-    }
+  result.rows.reserve(nodes_.size() - resultBegin_);
+  for (auto i = resultBegin_; i < nodes_.size(); ++i) {
+    result.rows.emplace_back(buildPath(i));
   }
 
   return finish(ResultBuilder().value(Value(std::move(result))).build());
 }
 
-bool TraverseExecutor::hasSameEdge(const Row& prevPath, const Edge& currentEdge) {
+bool TraverseExecutor::hasSameEdge(const Row& prevPath, const Edge& currentEdge) const {
   for (const auto& v : prevPath.values) {
     if (v.isList()) {
       for (const auto& e : v.getList().values) {
@@ -306,51 +297,33 @@ bool TraverseExecutor::hasSameEdge(const Row& prevPath, const Edge& currentEdge)
   return false;
 }
 
-void TraverseExecutor::releasePrevPaths(size_t cnt) {
-  if (range_ != nullptr) {
-    if (currentStep_ == range_->min() && paths_.size() > 1) {
-      auto rangeEnd = paths_.begin();
-      std::advance(rangeEnd, paths_.size() - 1);
-      paths_.erase(paths_.begin(), rangeEnd);
-    } else if (range_->min() == 0 && currentStep_ == 1 && paths_.size() > 1) {
-      paths_.pop_front();
+bool TraverseExecutor::hasSameEdge(size_t last, const Edge& currentEdge) const {
+  const auto* node = &nodes_[last];
+  while (true) {
+    if (node->edge.isEdge() && node->edge.getEdge().keyEqual(currentEdge)) {
+      return true;
     }
-
-    if (currentStep_ >= range_->min()) {
-      cnt_ += cnt;
+    if (node->first) {
+      break;
     }
-  } else {
-    paths_.pop_front();
-    cnt_ = cnt;
+    node = &nodes_[node->prev];
   }
+  return traverse_->trackPrevPath() && hasSameEdge(inputs_[node->prev], currentEdge);
 }
 
-Status TraverseExecutor::handleZeroStep(const std::unordered_map<Value, Paths>& prev,
-                                        List&& vertices,
-                                        std::unordered_map<Value, Paths>& zeroSteps,
-                                        size_t& count) {
+Status TraverseExecutor::handleZeroStep(List&& vertices) {
   std::unordered_set<Value> uniqueSrc;
   for (auto& srcV : vertices.values) {
     auto src = srcV.getVertex().vid;
     if (!uniqueSrc.emplace(src).second) {
       continue;
     }
-    auto pathToSrcFound = prev.find(src);
-    if (pathToSrcFound == prev.end()) {
+    auto pathToSrcFound = prev_.find(src);
+    if (pathToSrcFound == prev_.end()) {
       return Status::Error("Can't find prev paths.");
     }
-    const auto& paths = pathToSrcFound->second;
-    for (auto& p : paths) {
-      Row path;
-      if (traverse_->trackPrevPath()) {
-        path = p;
-      }
-      path.values.emplace_back(srcV);
-      List neighbors;
-      neighbors.values.emplace_back(srcV);
-      path.values.emplace_back(std::move(neighbors));
-      buildPath(zeroSteps, src, std::move(path));
-      ++count;
+    for (auto prev : pathToSrcFound->second) {
+      nodes_.emplace_back(PathNode{prev, true, srcV, srcV});
     }
   }
   return Status::OK();
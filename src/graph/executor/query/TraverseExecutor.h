@@ -33,8 +33,25 @@ class TraverseExecutor final : public StorageAccessExecutor {
   Status close() override;
 
  private:
-  using Dst = Value;
-  using Paths = std::vector<Row>;
+  FRIEND_TEST(TraverseTest, SharedPrefix);
+  FRIEND_TEST(TraverseTest, StepRange);
+  FRIEND_TEST(TraverseTest, DeadEnd);
+
+  // A step of the paths. Each step is stored only once and shared by all the paths extended from
+  // it, the paths are only materialized in buildResult.
+  struct PathNode {
+    // index of the previous step in nodes_, or index of the input row in inputs_ for the first step
+    size_t prev;
+    bool first;
+    // the src vertex of this step
+    Value vertex;
+    // the edge of this step, which is the src vertex itself for the zero step
+    Value edge;
+  };
+
+  // k: dst, v: index of the last steps of the paths to dst
+  using Paths = std::unordered_map<Value, std::vector<size_t>>;
+
   Status buildRequestDataSet();
 
   folly::Future<Status> traverse();
@@ -58,26 +75,26 @@ class TraverseExecutor final : public StorageAccessExecutor {
     return range_ != nullptr && range_->min() == 0;
   }
 
-  bool hasSameEdge(const Row& prevPath, const Edge& currentEdge);
+  bool hasSameEdge(const Row& prevPath, const Edge& currentEdge) const;
 
-  void releasePrevPaths(size_t cnt);
+  // Check the edges of the path which ends with nodes_[last]
+  bool hasSameEdge(size_t last, const Edge& currentEdge) const;
 
-  void buildPath(std::unordered_map<Value, std::vector<Row>>& currentPaths,
-                 const Value& dst,
-                 Row&& path);
+  Row buildPath(size_t last) const;
 
-  Status handleZeroStep(const std::unordered_map<Value, Paths>& prev,
-                        List&& vertices,
-                        std::unordered_map<Value, Paths>& zeroSteps,
-                        size_t& count);
+  Status handleZeroStep(List&& vertices);
 
  private:
   DataSet reqDs_;
   const Traverse* traverse_{nullptr};
   MatchStepRange* range_{nullptr};
   size_t currentStep_{0};
-  std::list<std::unordered_map<Value, Paths>> paths_;
-  size_t cnt_{0};
+  std::vector<Row> inputs_;
+  std::vector<PathNode> nodes_;
+  // the paths of last step
+  Paths prev_;
+  // the paths in nodes_ starting from it are the result
+  size_t resultBegin_{0};
 };
 
 }  // namespace graph
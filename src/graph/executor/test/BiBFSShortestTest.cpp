@@ -0,0 +1,152 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/executor/algo/BiBFSShortestPathExecutor.h"
+#include "graph/planner/plan/Algo.h"
+#include "graph/planner/plan/Logic.h"
+
+namespace nebula {
+namespace graph {
+class BiBFSShortestTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+    /*
+     *  1->2->4->5
+     *  1->3->4
+     *  2->6->7
+     */
+    edges_ = {{"1", "2"}, {"1", "3"}, {"2", "4"}, {"3", "4"}, {"4", "5"}, {"2", "6"}, {"6", "7"}};
+    for (auto& var : {"from", "to", "forward", "backward"}) {
+      qctx_->symTable()->newVariable(var);
+    }
+  }
+
+  // Mock the result of GetNeighbors for the vids of input var
+  void getNeighbors(const std::string& input, const std::string& output, bool reverse) {
+    DataSet ds;
+    ds.colNames = {kVid,
+                   "_stats",
+                   reverse ? "_edge:-edge1:_type:_dst:_rank" : "_edge:+edge1:_type:_dst:_rank",
+                   "_expr"};
+    auto iter = qctx_->ectx()->getResult(input).iter();
+    for (; iter->valid(); iter->next()) {
+      auto& vid = iter->getColumn(0);
+      List edges;
+      for (auto& edge : edges_) {
+        auto& src = reverse ? edge.second : edge.first;
+        auto& dst = reverse ? edge.first : edge.second;
+        if (src == vid.getStr()) {
+          edges.values.emplace_back(List({reverse ? -1 : 1, dst, 0}));
+        }
+      }
+      Row row;
+      row.values = {vid, Value(), std::move(edges), Value()};
+      ds.rows.emplace_back(std::move(row));
+    }
+    List datasets;
+    datasets.values.emplace_back(std::move(ds));
+    ResultBuilder builder;
+    builder.value(Value(std::move(datasets))).iter(Iterator::Kind::kGetNeighbors);
+    qctx_->ectx()->setResult(output, builder.build());
+  }
+
+  // Run the rounds of loop, return the number of rounds to find the paths
+  size_t run(const std::string& from, const std::string& to, size_t steps, DataSet* paths) {
+    for (auto& start : {std::make_pair("from", from), std::make_pair("to", to)}) {
+      DataSet ds;
+      ds.colNames = {kVid};
+      ds.rows.emplace_back(Row({start.second}));
+      qctx_->ectx()->setResult(start.first, ResultBuilder().value(Value(std::move(ds))).build());
+    }
+    auto* bfs = BiBFSShortestPath::make(qctx_.get(),
+                                        StartNode::make(qctx_.get()),
+                                        StartNode::make(qctx_.get()),
+                                        "from",
+                                        "to",
+                                        steps);
+    bfs->setLeftVar("forward");
+    bfs->setRightVar("backward");
+    bfs->setColNames({kPathStr});
+    auto bfsExe = std::make_unique<BiBFSShortestPathExecutor>(bfs, qctx_.get());
+    for (size_t round = 1; round <= steps; ++round) {
+      getNeighbors("from", "forward", false);
+      getNeighbors("to", "backward", true);
+      auto status = bfsExe->execute().get();
+      EXPECT_TRUE(status.ok());
+      auto& result = qctx_->ectx()->getResult(bfs->outputVar());
+      *paths = result.value().getDataSet();
+      if (!paths->rows.empty()) {
+        std::sort(paths->rows.begin(), paths->rows.end());
+        return round;
+      }
+    }
+    return 0;
+  }
+
+  Path createPath(const std::vector<std::string>& vids) {
+    Path path;
+    path.src = Vertex(vids.front(), {});
+    for (size_t i = 1; i < vids.size(); ++i) {
+      path.steps.emplace_back(Step(Vertex(vids[i], {}), 1, "edge1", 0, {}));
+    }
+    return path;
+  }
+
+ protected:
+  std::unique_ptr<QueryContext> qctx_;
+  std::vector<std::pair<std::string, std::string>> edges_;
+};
+
+TEST_F(BiBFSShortestTest, OneStepPath) {
+  DataSet paths;
+  EXPECT_EQ(1, run("1", "2", 5, &paths));
+  DataSet expected;
+  expected.colNames = {kPathStr};
+  expected.rows.emplace_back(Row({createPath({"1", "2"})}));
+  EXPECT_EQ(expected, paths);
+}
+
+TEST_F(BiBFSShortestTest, MultiplePaths) {
+  DataSet paths;
+  // the first round expands both directions, the second round only expands the backward one
+  EXPECT_EQ(2, run("1", "5", 5, &paths));
+  DataSet expected;
+  expected.colNames = {kPathStr};
+  expected.rows.emplace_back(Row({createPath({"1", "2", "4", "5"})}));
+  expected.rows.emplace_back(Row({createPath({"1", "3", "4", "5"})}));
+  std::sort(expected.rows.begin(), expected.rows.end());
+  EXPECT_EQ(expected, paths);
+
+  // nothing to expand once the paths are found
+  auto iter = qctx_->ectx()->getResult("to").iter();
+  EXPECT_EQ(0, iter->size());
+}
+
+TEST_F(BiBFSShortestTest, OddAndEvenLength) {
+  DataSet paths;
+  EXPECT_EQ(1, run("1", "4", 5, &paths));
+  EXPECT_EQ(2, paths.rows.size());
+
+  EXPECT_EQ(2, run("1", "7", 5, &paths));
+  DataSet expected;
+  expected.colNames = {kPathStr};
+  expected.rows.emplace_back(Row({createPath({"1", "2", "6", "7"})}));
+  EXPECT_EQ(expected, paths);
+}
+
+TEST_F(BiBFSShortestTest, NoPath) {
+  DataSet paths;
+  // exceed the steps
+  EXPECT_EQ(0, run("1", "5", 2, &paths));
+  // unreachable
+  EXPECT_EQ(0, run("5", "1", 5, &paths));
+  EXPECT_EQ(0, run("1", "8", 5, &paths));
+}
+}  // namespace graph
+}  // namespace nebula
@@ -85,9 +85,11 @@ class DataCollectTest : public testing::Test {
       builder.value(Value(std::move(datasets))).iter(Iterator::Kind::kGetNeighbors);
       qctx_->symTable()->newVariable("input_datasets");
       qctx_->ectx()->setResult("input_datasets", builder.build());
-      qctx_->ectx()->setResult(
-          "input_datasets",
-          ResultBuilder().value(Value(std::move(ds2))).iter(Iterator::Kind::kGetNeighbors).build());
+      List nextStep;
+      nextStep.values.emplace_back(std::move(ds2));
+      ResultBuilder nextBuilder;
+      nextBuilder.value(Value(std::move(nextStep))).iter(Iterator::Kind::kGetNeighbors);
+      qctx_->ectx()->setResult("input_datasets", nextBuilder.build());
     }
     {
       DataSet ds;
@@ -107,9 +109,6 @@ class DataCollectTest : public testing::Test {
       ds.colNames = {
           kVid, "_stats", "_tag:tag1:prop1:prop2", "_edge:+edge1:prop1:prop2:_dst:_rank", "_expr"};
       qctx_->symTable()->newVariable("empty_get_neighbors");
-      qctx_->ectx()->setResult(
-          "empty_get_neighbors",
-          ResultBuilder().value(Value(ds)).iter(Iterator::Kind::kGetNeighbors).build());
       qctx_->ectx()->setResult(
           "empty_get_neighbors",
           ResultBuilder().value(Value(std::move(ds))).iter(Iterator::Kind::kGetNeighbors).build());
@@ -175,37 +174,42 @@ TEST_F(DataCollectTest, CollectSubgraph) {
 
   DataSet expected;
   expected.colNames = {"_vertices", "_edges"};
+  // one row for each step
   auto& hist = qctx_->ectx()->getHistory("input_datasets");
-  auto iter = hist[0].iter();
-  auto* gNIter = static_cast<GetNeighborsIter*>(iter.get());
-  Row row;
-  std::unordered_set<Value> vids;
+  ASSERT_EQ(2, hist.size());
   std::unordered_set<std::tuple<Value, int64_t, int64_t, Value>> edgeKeys;
-  List vertices;
-  List edges;
-  auto originVertices = gNIter->getVertices();
-  for (auto& v : originVertices.values) {
-    if (!v.isVertex()) {
-      continue;
-    }
-    if (vids.emplace(v.getVertex().vid).second) {
-      vertices.emplace_back(std::move(v));
-    }
-  }
-  auto originEdges = gNIter->getEdges();
-  for (auto& e : originEdges.values) {
-    if (!e.isEdge()) {
-      continue;
+  for (auto& step : hist) {
+    auto iter = step.iter();
+    auto* gNIter = static_cast<GetNeighborsIter*>(iter.get());
+    Row row;
+    std::unordered_set<Value> vids;
+    List vertices;
+    List edges;
+    auto originVertices = gNIter->getVertices();
+    for (auto& v : originVertices.values) {
+      if (!v.isVertex()) {
+        continue;
+      }
+      if (vids.emplace(v.getVertex().vid).second) {
+        vertices.emplace_back(std::move(v));
+      }
     }
-    auto edgeKey =
-        std::make_tuple(e.getEdge().src, e.getEdge().type, e.getEdge().ranking, e.getEdge().dst);
-    if (edgeKeys.emplace(std::move(edgeKey)).second) {
-      edges.emplace_back(std::move(e));
+    auto originEdges = gNIter->getEdges();
+    for (auto& e : originEdges.values) {
+      if (!e.isEdge()) {
+        continue;
+      }
+      auto edgeKey =
+          std::make_tuple(e.getEdge().src, e.getEdge().type, e.getEdge().ranking, e.getEdge().dst);
+      if (edgeKeys.emplace(std::move(edgeKey)).second) {
+        edges.emplace_back(std::move(e));
+      }
     }
+    row.values.emplace_back(std::move(vertices));
+    row.values.emplace_back(std::move(edges));
+    expected.rows.emplace_back(std::move(row));
   }
-  row.values.emplace_back(std::move(vertices));
-  row.values.emplace_back(std::move(edges));
-  expected.rows.emplace_back(std::move(row));
+  ASSERT_EQ(2, expected.rows.size());
 
   EXPECT_EQ(result.value().getDataSet(), expected);
   EXPECT_EQ(result.state(), Result::State::kSuccess);
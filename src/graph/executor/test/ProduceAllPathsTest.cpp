@@ -450,6 +450,60 @@ TEST_F(ProduceAllPathsTest, AllPath) {
   }
 }
 
+TEST_F(ProduceAllPathsTest, Loop) {
+  qctx_->symTable()->newVariable("loop_input");
+  // 0->1->0
+  auto neighbors = [this](const std::vector<std::string>& srcs) {
+    DataSet ds;
+    ds.colNames = {kVid, "_stats", "_edge:+edge1:_type:_dst:_rank", "_expr"};
+    for (auto& src : srcs) {
+      List edges;
+      edges.values.emplace_back(List({1, src == "0" ? "1" : "0", 0}));
+      ds.rows.emplace_back(Row({src, Value(), std::move(edges), Value()}));
+    }
+    List datasets;
+    datasets.values.emplace_back(std::move(ds));
+    ResultBuilder builder;
+    builder.value(std::move(datasets)).iter(Iterator::Kind::kGetNeighbors);
+    qctx_->ectx()->setResult("loop_input", builder.build());
+  };
+  auto path = [](const std::vector<std::string>& vids) {
+    Path p;
+    p.src = Vertex(vids.front(), {});
+    for (size_t i = 1; i < vids.size(); ++i) {
+      p.steps.emplace_back(Step(Vertex(vids[i], {}), 1, "edge1", 0, {}));
+    }
+    return p;
+  };
+
+  for (bool noLoop : {false, true}) {
+    auto* allPathsNode = ProduceAllPaths::make(qctx_.get(), nullptr);
+    allPathsNode->setInputVar("loop_input");
+    allPathsNode->setColNames({kDst, "_paths"});
+    allPathsNode->setNoLoop(noLoop);
+    auto allPathsExe = std::make_unique<ProduceAllPathsExecutor>(allPathsNode, qctx_.get());
+
+    neighbors({"0"});
+    EXPECT_TRUE(allPathsExe->execute().get().ok());
+    neighbors({"1"});
+    EXPECT_TRUE(allPathsExe->execute().get().ok());
+    auto result = qctx_->ectx()->getResult(allPathsNode->outputVar()).value().getDataSet();
+    DataSet expected;
+    expected.colNames = {kDst, "_paths"};
+    if (!noLoop) {
+      expected.rows.emplace_back(Row({"0", List({path({"0", "1", "0"})})}));
+    }
+    EXPECT_TRUE(verifyAllPaths(result, expected));
+
+    // the path could not go through the same edge again
+    neighbors({"0"});
+    EXPECT_TRUE(allPathsExe->execute().get().ok());
+    result = qctx_->ectx()->getResult(allPathsNode->outputVar()).value().getDataSet();
+    expected.rows.clear();
+    EXPECT_TRUE(verifyAllPaths(result, expected));
+  }
+}
+
 TEST_F(ProduceAllPathsTest, EmptyInput) {
   auto* allPathsNode = ProduceAllPaths::make(qctx_.get(), nullptr);
   allPathsNode->setInputVar("empty_get_neighbors");
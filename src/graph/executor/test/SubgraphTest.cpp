@@ -0,0 +1,115 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/expression/PropertyExpression.h"
+#include "graph/context/QueryContext.h"
+#include "graph/executor/algo/SubgraphExecutor.h"
+#include "graph/planner/plan/Algo.h"
+#include "graph/planner/plan/Logic.h"
+
+namespace nebula {
+namespace graph {
+class SubgraphTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+    /*
+     *  1->2->3->4
+     *  1->5
+     */
+    edges_ = {{"1", "2"}, {"2", "3"}, {"3", "4"}, {"1", "5"}};
+    for (auto& var : {"input", "neighbors", "result", "loop_steps"}) {
+      qctx_->symTable()->newVariable(var);
+    }
+    auto* pool = qctx_->objPool();
+    auto* gn = GetNeighbors::make(qctx_.get(), StartNode::make(qctx_.get()), 1);
+    gn->setSrc(InputPropertyExpression::make(pool, kVid));
+    gn->setInputVar("input");
+    gn->setOutputVar("neighbors");
+    // 2 steps
+    subgraph_ = Subgraph::make(qctx_.get(), gn, "result", "loop_steps", 3);
+    subgraph_->setOutputVar("input");
+    subgraph_->setColNames({kVid});
+  }
+
+  // Mock the response of GetNeighbors, which contains the rows of vids
+  void getNeighbors(const std::vector<std::string>& vids) {
+    DataSet ds;
+    ds.colNames = {kVid, "_stats", "_edge:+edge1:_type:_dst:_rank", "_expr"};
+    for (auto& vid : vids) {
+      List edges;
+      for (auto& edge : edges_) {
+        if (edge.first == vid) {
+          edges.values.emplace_back(List({1, edge.second, 0}));
+        }
+      }
+      Row row;
+      row.values = {vid, Value(), std::move(edges), Value()};
+      ds.rows.emplace_back(std::move(row));
+    }
+    List datasets;
+    datasets.values.emplace_back(std::move(ds));
+    ResultBuilder builder;
+    builder.value(Value(std::move(datasets))).iter(Iterator::Kind::kGetNeighbors);
+    qctx_->ectx()->setResult("neighbors", builder.build());
+  }
+
+  std::vector<Value> run(SubgraphExecutor* exe, int64_t step) {
+    qctx_->ectx()->setValue("loop_steps", step);
+    EXPECT_TRUE(exe->execute().get().ok());
+    std::vector<Value> vids;
+    auto iter = qctx_->ectx()->getResult("input").iter();
+    for (; iter->valid(); iter->next()) {
+      vids.emplace_back(iter->getColumn(0));
+    }
+    std::sort(vids.begin(), vids.end());
+    return vids;
+  }
+
+ protected:
+  std::unique_ptr<QueryContext> qctx_;
+  std::vector<std::pair<std::string, std::string>> edges_;
+  Subgraph* subgraph_{nullptr};
+};
+
+TEST_F(SubgraphTest, LocalExpansion) {
+  DataSet start;
+  start.colNames = {kVid};
+  start.rows.emplace_back(Row({"1"}));
+  qctx_->ectx()->setResult("input", ResultBuilder().value(Value(std::move(start))).build());
+  auto exe = std::make_unique<SubgraphExecutor>(subgraph_, qctx_.get());
+
+  // 2 and 3 are expanded by storage in the first round, 4 is beyond the steps
+  getNeighbors({"1", "2", "3"});
+  EXPECT_EQ(std::vector<Value>({"5"}), run(exe.get(), 1));
+  EXPECT_TRUE(qctx_->ectx()->getHistory("result").empty());
+
+  getNeighbors({"5"});
+  EXPECT_TRUE(run(exe.get(), 2).empty());
+
+  // one result for each step
+  const auto& hist = qctx_->ectx()->getHistory("result");
+  ASSERT_EQ(3, hist.size());
+  std::vector<size_t> vertices = {1, 2, 1};
+  std::vector<size_t> edges = {2, 1, 0};
+  for (size_t i = 0; i < hist.size(); ++i) {
+    auto iter = hist[i].iter();
+    auto* gnIter = static_cast<GetNeighborsIter*>(iter.get());
+    EXPECT_EQ(vertices[i], gnIter->getVertices().values.size());
+    size_t count = 0;
+    for (auto& edge : gnIter->getEdges().values) {
+      count += edge.isEdge() ? 1 : 0;
+    }
+    EXPECT_EQ(edges[i], count);
+  }
+
+  // nothing to do once finished
+  EXPECT_TRUE(run(exe.get(), 3).empty());
+  EXPECT_EQ(3, qctx_->ectx()->getHistory("result").size());
+}
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,191 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/executor/query/TraverseExecutor.h"
+#include "graph/planner/plan/Query.h"
+
+namespace nebula {
+namespace graph {
+class TraverseTest : public testing::Test {
+ protected:
+  static Row makeNeighbors(const std::string& src, const std::vector<std::string>& dsts) {
+    Row row;
+    row.values.emplace_back(src);
+    // _stats = empty
+    row.values.emplace_back(Value());
+    List edges;
+    for (auto& dst : dsts) {
+      List edge;
+      edge.values.emplace_back(1);
+      edge.values.emplace_back(dst);
+      edge.values.emplace_back(0);
+      edges.values.emplace_back(std::move(edge));
+    }
+    row.values.emplace_back(std::move(edges));
+    // _expr = empty
+    row.values.emplace_back(Value());
+    return row;
+  }
+
+  static DataSet makeResponse(std::vector<Row> rows) {
+    DataSet ds;
+    ds.colNames = {kVid, "_stats", "_edge:+edge1:_type:_dst:_rank", "_expr"};
+    ds.rows = std::move(rows);
+    return ds;
+  }
+
+  static Value makeEdge(const std::string& src, const std::string& dst) {
+    return Edge(src, dst, 1, "edge1", 0, {});
+  }
+
+  static ::testing::AssertionResult verifyPaths(DataSet& result, DataSet& expected) {
+    std::sort(result.rows.begin(), result.rows.end());
+    std::sort(expected.rows.begin(), expected.rows.end());
+    return result == expected ? ::testing::AssertionSuccess()
+                              : (::testing::AssertionFailure() << result << " vs. " << expected);
+  }
+
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+    /*
+     *  a->a, a->b, b->c
+     *  input rows {a, b}
+     */
+    {
+      DataSet ds;
+      ds.colNames = {"v"};
+      ds.rows.emplace_back(Row({"a"}));
+      ds.rows.emplace_back(Row({"b"}));
+      qctx_->symTable()->newVariable("input_traverse");
+      ResultBuilder builder;
+      builder.value(Value(std::move(ds)));
+      qctx_->ectx()->setResult("input_traverse", builder.build());
+    }
+    firstStepResult_ = makeResponse({makeNeighbors("a", {"a", "b"}), makeNeighbors("b", {"c"})});
+    secondStepResult_ = makeResponse({makeNeighbors("a", {"a", "b"}),
+                                      makeNeighbors("b", {"c"}),
+                                      makeNeighbors("c", {})});
+
+    meta::cpp2::Session session;
+    session.session_id_ref() = 0;
+    session.user_name_ref() = "root";
+    auto clientSession = ClientSession::create(std::move(session), nullptr);
+    SpaceInfo spaceInfo;
+    spaceInfo.name = "test_space";
+    spaceInfo.id = 1;
+    spaceInfo.spaceDesc.space_name_ref() = "test_space";
+    clientSession->setSpace(std::move(spaceInfo));
+    auto rctx = std::make_unique<RequestContext<ExecutionResponse>>();
+    rctx->setSession(std::move(clientSession));
+    qctx_->setRCtx(std::move(rctx));
+  }
+
+  Traverse* makeTraverse(MatchStepRange* range) {
+    auto* pool = qctx_->objPool();
+    auto* traverse = Traverse::make(qctx_.get(), nullptr, 1);
+    traverse->setSrc(InputPropertyExpression::make(pool, "v"));
+    traverse->setInputVar("input_traverse");
+    traverse->setStepRange(range);
+    traverse->setColNames({"v", "src", "e"});
+    return traverse;
+  }
+
+  // Feed the response of a step to the executor as handleResponse does
+  static Status step(TraverseExecutor* exe, DataSet response) {
+    exe->currentStep_++;
+    List list;
+    list.values.emplace_back(std::move(response));
+    auto iter = std::make_unique<GetNeighborsIter>(std::make_shared<Value>(std::move(list)));
+    return exe->buildInterimPath(iter.get());
+  }
+
+ protected:
+  std::unique_ptr<QueryContext> qctx_;
+  DataSet firstStepResult_;
+  DataSet secondStepResult_;
+};
+
+TEST_F(TraverseTest, SharedPrefix) {
+  MatchStepRange range(1, 2);
+  auto* traverse = makeTraverse(&range);
+  auto exe = std::make_unique<TraverseExecutor>(traverse, qctx_.get());
+  exe->range_ = traverse->stepRange();
+  ASSERT_TRUE(exe->buildRequestDataSet().ok());
+  ASSERT_EQ(2, exe->reqDs_.rows.size());
+
+  ASSERT_TRUE(step(exe.get(), std::move(firstStepResult_)).ok());
+  // a->a, a->b, b->c
+  EXPECT_EQ(3, exe->nodes_.size());
+  ASSERT_TRUE(step(exe.get(), std::move(secondStepResult_)).ok());
+  // a->a->b, a->b->c, a->a->a is dropped since it reuses the edge a->a
+  EXPECT_EQ(5, exe->nodes_.size());
+  // The second step only stores its own edge and shares the prefix
+  EXPECT_FALSE(exe->nodes_[3].first);
+  EXPECT_EQ(0, exe->nodes_[3].prev);
+  EXPECT_FALSE(exe->nodes_[4].first);
+  EXPECT_EQ(1, exe->nodes_[4].prev);
+
+  ASSERT_TRUE(exe->buildResult().ok());
+  auto& result = qctx_->ectx()->getResult(traverse->outputVar());
+  auto ds = result.value().getDataSet();
+
+  DataSet expected;
+  expected.colNames = {"v", "src", "e"};
+  auto a = Value(Vertex("a", {}));
+  auto b = Value(Vertex("b", {}));
+  expected.rows.emplace_back(Row({"a", a, List({makeEdge("a", "a")})}));
+  expected.rows.emplace_back(Row({"a", a, List({makeEdge("a", "b")})}));
+  expected.rows.emplace_back(Row({"b", b, List({makeEdge("b", "c")})}));
+  expected.rows.emplace_back(Row({"a", a, List({makeEdge("a", "a"), a, makeEdge("a", "b")})}));
+  expected.rows.emplace_back(Row({"a", a, List({makeEdge("a", "b"), b, makeEdge("b", "c")})}));
+  EXPECT_TRUE(verifyPaths(ds, expected));
+}
+
+TEST_F(TraverseTest, StepRange) {
+  MatchStepRange range(2, 2);
+  auto* traverse = makeTraverse(&range);
+  auto exe = std::make_unique<TraverseExecutor>(traverse, qctx_.get());
+  exe->range_ = traverse->stepRange();
+  ASSERT_TRUE(exe->buildRequestDataSet().ok());
+  ASSERT_TRUE(step(exe.get(), std::move(firstStepResult_)).ok());
+  ASSERT_TRUE(step(exe.get(), std::move(secondStepResult_)).ok());
+  EXPECT_EQ(3, exe->resultBegin_);
+
+  ASSERT_TRUE(exe->buildResult().ok());
+  auto& result = qctx_->ectx()->getResult(traverse->outputVar());
+  auto ds = result.value().getDataSet();
+
+  // Only the paths of the second step are built
+  DataSet expected;
+  expected.colNames = {"v", "src", "e"};
+  auto a = Value(Vertex("a", {}));
+  auto b = Value(Vertex("b", {}));
+  expected.rows.emplace_back(Row({"a", a, List({makeEdge("a", "a"), a, makeEdge("a", "b")})}));
+  expected.rows.emplace_back(Row({"a", a, List({makeEdge("a", "b"), b, makeEdge("b", "c")})}));
+  EXPECT_TRUE(verifyPaths(ds, expected));
+}
+
+TEST_F(TraverseTest, DeadEnd) {
+  MatchStepRange range(3, 3);
+  auto* traverse = makeTraverse(&range);
+  auto exe = std::make_unique<TraverseExecutor>(traverse, qctx_.get());
+  exe->range_ = traverse->stepRange();
+  ASSERT_TRUE(exe->buildRequestDataSet().ok());
+  ASSERT_TRUE(step(exe.get(), std::move(firstStepResult_)).ok());
+  auto noEdges = makeResponse(
+      {makeNeighbors("a", {}), makeNeighbors("b", {}), makeNeighbors("c", {})});
+  ASSERT_TRUE(step(exe.get(), std::move(noEdges)).ok());
+  EXPECT_TRUE(exe->reqDs_.rows.empty());
+
+  ASSERT_TRUE(exe->buildResult().ok());
+  auto& result = qctx_->ectx()->getResult(traverse->outputVar());
+  EXPECT_TRUE(result.value().getDataSet().rows.empty());
+}
+
+}  // namespace graph
+}  // namespace nebula
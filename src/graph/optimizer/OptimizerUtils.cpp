@@ -5,9 +5,11 @@
 
 #include "graph/optimizer/OptimizerUtils.h"
 
+#include "common/base/Regex.h"
 #include "common/base/Status.h"
 #include "common/datatypes/Value.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
 
 using nebula::meta::cpp2::ColumnDef;
 using nebula::meta::cpp2::IndexItem;
@@ -16,6 +18,18 @@ using nebula::storage::cpp2::IndexQueryContext;
 
 using ExprKind = nebula::Expression::Kind;
 
+DEFINE_bool(enable_optimizer_index_intersection,
+            true,
+            "Whether to intersect the indexes hit by different operands of an AND condition, "
+            "only the indexes hit by equality prefixes are intersected");
+DEFINE_bool(enable_optimizer_index_skip_scan,
+            false,
+            "Whether to skip scan the index whose first field is not hit, the first field must be "
+            "of low cardinality. It is always done if the first field is bool");
+DEFINE_uint32(max_index_scan_ranges,
+              256,
+              "The max number of prefixes or ranges an index scan is expanded to by IN lists");
+
 namespace nebula {
 namespace graph {
 namespace {
@@ -33,16 +47,31 @@ enum class IndexScore : uint8_t {
 struct ScoredColumnHint {
   storage::cpp2::IndexColumnHint hint;
   IndexScore score;
+  // The rows hit are more than the expression, so it must be kept in the filter
+  bool inexact{false};
 };
 
 struct IndexResult {
   const meta::cpp2::IndexItem* index;
   // expressions not used in all `ScoredColumnHint'
   std::vector<const Expression*> unusedExprs;
+  // expressions used by `ScoredColumnHint', only collected for logical expression
+  std::unordered_set<const Expression*> usedExprs;
   std::vector<ScoredColumnHint> hints;
+  // The hints start from the second field of index
+  bool skipScan{false};
+
+  // A skip scan is better than a full scan, and worse than any scan hitting the first field
+  int rank() const {
+    if (skipScan) return 1;
+    return hints.front().score == IndexScore::kNotEqual ? 0 : 2;
+  }
 
   bool operator<(const IndexResult& rhs) const {
     if (hints.empty()) return true;
+    if (!rhs.hints.empty() && rank() != rhs.rank()) {
+      return rank() < rhs.rank();
+    }
     auto sz = std::min(hints.size(), rhs.hints.size());
     for (size_t i = 0; i < sz; i++) {
       if (hints[i].score < rhs.hints[i].score) {
@@ -87,12 +116,85 @@ Status handleRangeIndex(const meta::cpp2::ColumnDef& field,
   return Status::OK();
 }
 
+// `A =~ "abc.*"' hits the index as the range of strings starting with the literal prefix of
+// the pattern, which is inexact
+Status handleRegexIndex(const ColumnDef& field, const Value& value, IndexColumnHint* hint) {
+  auto type = field.get_type().get_type();
+  if (!value.isStr() ||
+      (type != nebula::cpp2::PropertyType::STRING &&
+       type != nebula::cpp2::PropertyType::FIXED_STRING)) {
+    return Status::Error("Invalid regex expression.");
+  }
+  std::string prefix;
+  try {
+    prefix = Regex(value.getStr()).prefix();
+  } catch (const std::exception& e) {
+    return Status::Error("Invalid regex pattern: %s", e.what());
+  }
+  if (prefix.empty()) {
+    return Status::Error("The regex pattern has no literal prefix.");
+  }
+  hint->scan_type_ref() = storage::cpp2::ScanType::RANGE;
+  hint->column_name_ref() = field.get_name();
+  hint->begin_value_ref() = prefix;
+  hint->include_begin_ref() = true;
+  // The least string greater than all the strings starting with the prefix, there is no end if
+  // the prefix is all 0xff
+  while (!prefix.empty() && static_cast<uint8_t>(prefix.back()) == 0xff) {
+    prefix.pop_back();
+  }
+  if (!prefix.empty()) {
+    prefix.back() = static_cast<char>(static_cast<uint8_t>(prefix.back()) + 1);
+    hint->end_value_ref() = std::move(prefix);
+    hint->include_end_ref() = false;
+  }
+  return Status::OK();
+}
+
 void handleEqualIndex(const ColumnDef& field, const Value& value, IndexColumnHint* hint) {
   hint->scan_type_ref() = storage::cpp2::ScanType::PREFIX;
   hint->column_name_ref() = field.get_name();
   hint->begin_value_ref() = value;
 }
 
+// `A IN [a, b]' hits the index as a prefix for each of the values
+StatusOr<ScoredColumnHint> selectInExprIndex(const ColumnDef& field, const Expression* container) {
+  std::vector<Value> values;
+  // NULL never equals to any value
+  auto addValue = [&values](const Value& value) {
+    if (!value.isNull()) {
+      values.emplace_back(value);
+    }
+  };
+  if (container->kind() == Expression::Kind::kConstant) {
+    const auto& list = static_cast<const ConstantExpression*>(container)->value();
+    if (!list.isList()) {
+      return Status::Error("Invalid IN expression.");
+    }
+    for (const auto& value : list.getList().values) {
+      addValue(value);
+    }
+  } else if (container->isContainerExpr()) {
+    for (auto operand : graph::ExpressionUtils::getContainerExprOperands(container)) {
+      if (operand->kind() != Expression::Kind::kConstant) {
+        return Status::Error("The IN list is not constant.");
+      }
+      addValue(static_cast<const ConstantExpression*>(operand)->value());
+    }
+  } else {
+    return Status::Error("Invalid IN expression.");
+  }
+  if (values.size() > FLAGS_max_index_scan_ranges) {
+    return Status::Error("Too many values in the IN list.");
+  }
+  ScoredColumnHint hint;
+  hint.hint.scan_type_ref() = storage::cpp2::ScanType::PREFIX;
+  hint.hint.column_name_ref() = field.get_name();
+  hint.hint.in_values_ref() = std::move(values);
+  hint.score = IndexScore::kPrefix;
+  return hint;
+}
+
 StatusOr<ScoredColumnHint> selectRelExprIndex(const ColumnDef& field,
                                               const RelationalExpression* expr) {
   // TODO(yee): Reverse expression
@@ -106,10 +208,10 @@ StatusOr<ScoredColumnHint> selectRelExprIndex(const ColumnDef& field,
 
   auto right = expr->right();
   if (expr->kind() == Expression::Kind::kRelIn) {  // container expressions
-    DCHECK(right->isContainerExpr());
-  } else {  // other expressions
-    DCHECK(right->kind() == Expression::Kind::kConstant);
+    return selectInExprIndex(field, right);
   }
+  // other expressions
+  DCHECK(right->kind() == Expression::Kind::kConstant);
 
   const auto& value = static_cast<const ConstantExpression*>(right)->value();
 
@@ -132,6 +234,12 @@ StatusOr<ScoredColumnHint> selectRelExprIndex(const ColumnDef& field,
       hint.score = IndexScore::kNotEqual;
       break;
     }
+    case Expression::Kind::kRelREG: {
+      NG_RETURN_IF_ERROR(handleRegexIndex(field, value, &hint.hint));
+      hint.score = IndexScore::kRange;
+      hint.inexact = true;
+      break;
+    }
     default: {
       return Status::Error("Invalid expression kind");
     }
@@ -139,16 +247,19 @@ StatusOr<ScoredColumnHint> selectRelExprIndex(const ColumnDef& field,
   return hint;
 }
 
-StatusOr<IndexResult> selectRelExprIndex(const RelationalExpression* expr, const IndexItem& index) {
+StatusOr<IndexResult> selectRelExprIndex(const RelationalExpression* expr,
+                                         const IndexItem& index,
+                                         size_t firstField) {
   const auto& fields = index.get_fields();
-  if (fields.empty()) {
-    return Status::Error("Index(%s) does not have any fields.", index.get_index_name().c_str());
+  if (fields.size() <= firstField) {
+    return Status::Error("Index(%s) does not have enough fields.", index.get_index_name().c_str());
   }
-  auto status = selectRelExprIndex(fields[0], expr);
+  auto status = selectRelExprIndex(fields[firstField], expr);
   NG_RETURN_IF_ERROR(status);
   IndexResult result;
   result.hints.emplace_back(std::move(status).value());
   result.index = &index;
+  result.skipScan = firstField > 0;
   return result;
 }
 
@@ -212,17 +323,32 @@ bool getIndexColumnHintInExpr(const ColumnDef& field,
                               ScoredColumnHint* hint,
                               std::vector<Expression*>* operands) {
   std::vector<ScoredColumnHint> hints;
+  // The IN list could not be merged with other hints of the field, so it is only used when there
+  // is no other hint, and left to the filter otherwise
+  Expression* inOperand = nullptr;
+  ScoredColumnHint inHint;
   for (auto& operand : expr->operands()) {
     if (!operand->isRelExpr()) continue;
     auto relExpr = static_cast<const RelationalExpression*>(operand);
     auto status = selectRelExprIndex(field, relExpr);
-    if (status.ok()) {
-      hints.emplace_back(std::move(status).value());
-      operands->emplace_back(operand);
+    if (!status.ok()) continue;
+    if (relExpr->kind() == Expression::Kind::kRelIn) {
+      if (inOperand == nullptr) {
+        inOperand = operand;
+        inHint = std::move(status).value();
+      }
+      continue;
     }
+    hints.emplace_back(std::move(status).value());
+    operands->emplace_back(operand);
   }
 
-  if (hints.empty()) return false;
+  if (hints.empty()) {
+    if (inOperand == nullptr) return false;
+    *hint = std::move(inHint);
+    operands->emplace_back(inOperand);
+    return true;
+  }
 
   if (hints.size() == 1) {
     *hint = hints.front();
@@ -234,6 +360,7 @@ bool getIndexColumnHintInExpr(const ColumnDef& field,
   }
   ScoredColumnHint h;
   h.hint.column_name_ref() = field.get_name();
+  h.inexact = std::any_of(hints.begin(), hints.end(), [](const auto& x) { return x.inexact; });
   if (begin.first < end.first) {
     h.hint.scan_type_ref() = storage::cpp2::ScanType::RANGE;
     h.hint.begin_value_ref() = std::move(begin.first);
@@ -272,14 +399,20 @@ std::vector<const Expression*> collectUnusedExpr(
 }
 
 StatusOr<IndexResult> selectLogicalExprIndex(const LogicalExpression* expr,
-                                             const IndexItem& index) {
+                                             const IndexItem& index,
+                                             size_t firstField) {
   if (expr->kind() != Expression::Kind::kLogicalAnd) {
     return Status::Error("Invalid expression kind.");
   }
+  const auto& fields = index.get_fields();
+  if (fields.size() <= firstField) {
+    return Status::Error("Index(%s) does not have enough fields.", index.get_index_name().c_str());
+  }
   IndexResult result;
-  result.hints.reserve(index.get_fields().size());
+  result.hints.reserve(fields.size() - firstField);
   std::unordered_set<const Expression*> usedOperands;
-  for (auto& field : index.get_fields()) {
+  for (auto fieldIter = fields.begin() + firstField; fieldIter != fields.end(); ++fieldIter) {
+    const auto& field = *fieldIter;
     ScoredColumnHint hint;
     std::vector<Expression*> operands;
     if (!getIndexColumnHintInExpr(field, expr, &hint, &operands)) {
@@ -294,22 +427,131 @@ StatusOr<IndexResult> selectLogicalExprIndex(const LogicalExpression* expr,
     return Status::Error("There is not index to use.");
   }
   result.unusedExprs = collectUnusedExpr(expr, usedOperands);
+  result.usedExprs = std::move(usedOperands);
   result.index = &index;
+  result.skipScan = firstField > 0;
   return result;
 }
 
-StatusOr<IndexResult> selectIndex(const Expression* expr, const IndexItem& index) {
+// Select the hints of index starting from the field
+StatusOr<IndexResult> selectIndex(const Expression* expr,
+                                  const IndexItem& index,
+                                  size_t firstField = 0) {
   if (expr->isRelExpr()) {
-    return selectRelExprIndex(static_cast<const RelationalExpression*>(expr), index);
+    return selectRelExprIndex(static_cast<const RelationalExpression*>(expr), index, firstField);
   }
 
   if (expr->isLogicalExpr()) {
-    return selectLogicalExprIndex(static_cast<const LogicalExpression*>(expr), index);
+    return selectLogicalExprIndex(
+        static_cast<const LogicalExpression*>(expr), index, firstField);
   }
 
   return Status::Error("Invalid expression kind.");
 }
 
+// Storage seeks each distinct value of the first field for skip scan, so the field must be of low
+// cardinality. Besides, the value is decoded from the index key, so it must be of fixed length
+// and not nullable.
+bool canSkipScan(const IndexItem& index) {
+  const auto& fields = index.get_fields();
+  if (fields.size() < 2 || fields.front().nullable_ref().value_or(false)) {
+    return false;
+  }
+  switch (fields.front().get_type().get_type()) {
+    case nebula::cpp2::PropertyType::BOOL:
+      return true;
+    case nebula::cpp2::PropertyType::INT64:
+    case nebula::cpp2::PropertyType::INT32:
+    case nebula::cpp2::PropertyType::INT16:
+    case nebula::cpp2::PropertyType::INT8:
+    case nebula::cpp2::PropertyType::TIMESTAMP:
+    case nebula::cpp2::PropertyType::DATE:
+    case nebula::cpp2::PropertyType::TIME:
+    case nebula::cpp2::PropertyType::DATETIME:
+      return FLAGS_enable_optimizer_index_skip_scan;
+    default:
+      return false;
+  }
+}
+
+// Take the prefix hints followed by at most one range hint of index, return false if there are
+// hints left
+bool takeColumnHints(IndexResult* index, bool* isPrefixScan, std::vector<IndexColumnHint>* hints) {
+  hints->reserve(index->hints.size());
+  // The number of prefixes or ranges scanned, which is multiplied by each IN list
+  size_t ranges = 1;
+  auto iter = index->hints.begin();
+  for (; iter != index->hints.end(); ++iter) {
+    auto& hint = *iter;
+    if (hint.hint.in_values_ref().has_value()) {
+      ranges *= std::max<size_t>(hint.hint.in_values_ref()->size(), 1);
+      if (ranges > FLAGS_max_index_scan_ranges) {
+        break;
+      }
+    }
+    if (hint.score == IndexScore::kPrefix) {
+      hints->emplace_back(std::move(hint.hint));
+      *isPrefixScan = true;
+      continue;
+    }
+    if (hint.score == IndexScore::kRange) {
+      hints->emplace_back(std::move(hint.hint));
+      // skip the case first range hint is the last hint
+      // when set filter in index query context
+      ++iter;
+    }
+    break;
+  }
+  return iter == index->hints.end();
+}
+
+// Find the indexes to intersect with the selected one, each of them only uses the operands not
+// used by the indexes selected before. Results are sorted, and the selected one is the last.
+std::vector<storage::cpp2::IntersectIndex> findIntersectIndexes(std::vector<IndexResult>* results) {
+  // At most so many indexes are scanned for a context besides the selected one
+  constexpr size_t kMaxIntersectIndexes = 2;
+  std::vector<storage::cpp2::IntersectIndex> intersects;
+  auto& selected = results->back();
+  std::unordered_set<const Expression*> unused(selected.unusedExprs.begin(),
+                                               selected.unusedExprs.end());
+  for (auto it = results->rbegin() + 1;
+       it != results->rend() && !unused.empty() && intersects.size() < kMaxIntersectIndexes;
+       ++it) {
+    if (it->index == selected.index || it->hints.empty() || it->usedExprs.empty() ||
+        it->skipScan) {
+      continue;
+    }
+    // The ids hit by a range may be far more than the selected index hits, which are all read
+    // and kept by storage for intersecting, so only the equality prefixes are intersected
+    auto allPrefix = std::all_of(it->hints.begin(), it->hints.end(), [](const auto& hint) {
+      return hint.score == IndexScore::kPrefix;
+    });
+    if (!allPrefix) {
+      continue;
+    }
+    auto allUnused = std::all_of(it->usedExprs.begin(), it->usedExprs.end(), [&](auto expr) {
+      return unused.count(expr) > 0;
+    });
+    if (!allUnused) {
+      continue;
+    }
+    bool isPrefixScan = false;
+    std::vector<IndexColumnHint> hints;
+    if (!takeColumnHints(&*it, &isPrefixScan, &hints)) {
+      // Too many prefixes expanded by the IN lists
+      continue;
+    }
+    storage::cpp2::IntersectIndex intersect;
+    intersect.index_id_ref() = it->index->get_index_id();
+    intersect.column_hints_ref() = std::move(hints);
+    intersects.emplace_back(std::move(intersect));
+    for (auto expr : it->usedExprs) {
+      unused.erase(expr);
+    }
+  }
+  return intersects;
+}
+
 }  // namespace
 
 void OptimizerUtils::eraseInvalidIndexItems(
@@ -339,6 +581,9 @@ bool OptimizerUtils::findOptimalIndex(const Expression* condition,
   std::vector<IndexResult> results;
   for (auto& index : indexItems) {
     auto resStatus = selectIndex(condition, *index);
+    if (!resStatus.ok() && canSkipScan(*index)) {
+      resStatus = selectIndex(condition, *index, 1);
+    }
     if (resStatus.ok()) {
       results.emplace_back(std::move(resStatus).value());
     }
@@ -356,36 +601,31 @@ bool OptimizerUtils::findOptimalIndex(const Expression* condition,
   }
 
   *isPrefixScan = false;
-  std::vector<storage::cpp2::IndexColumnHint> hints;
-  hints.reserve(index.hints.size());
-  auto iter = index.hints.begin();
-
   // Use full scan if the highest index score is NotEqual
-  if (iter->score == IndexScore::kNotEqual) {
+  if (index.hints.front().score == IndexScore::kNotEqual) {
     return false;
   }
 
-  for (; iter != index.hints.end(); ++iter) {
-    auto& hint = *iter;
-    if (hint.score == IndexScore::kPrefix) {
-      hints.emplace_back(std::move(hint.hint));
-      *isPrefixScan = true;
-      continue;
-    }
-    if (hint.score == IndexScore::kRange) {
-      hints.emplace_back(std::move(hint.hint));
-      // skip the case first range hint is the last hint
-      // when set filter in index query context
-      ++iter;
-    }
-    break;
-  }
-  // The filter can always be pushed down for lookup query
-  if (iter != index.hints.end() || !index.unusedExprs.empty()) {
+  bool inexact = std::any_of(
+      index.hints.begin(), index.hints.end(), [](const auto& hint) { return hint.inexact; });
+  std::vector<storage::cpp2::IndexColumnHint> hints;
+  bool allHintsTaken = takeColumnHints(&index, isPrefixScan, &hints);
+  // The filter can always be pushed down for lookup query, it also checks the rows hit by
+  // the intersect indexes
+  if (!allHintsTaken || !index.unusedExprs.empty() || inexact) {
     ictx->filter_ref() = condition->encode();
   }
   ictx->index_id_ref() = index.index->get_index_id();
   ictx->column_hints_ref() = std::move(hints);
+  if (index.skipScan) {
+    ictx->skip_scan_ref() = true;
+  }
+  if (FLAGS_enable_optimizer_index_intersection && !index.unusedExprs.empty()) {
+    auto intersects = findIntersectIndexes(&results);
+    if (!intersects.empty()) {
+      ictx->intersect_indexes_ref() = std::move(intersects);
+    }
+  }
   return true;
 }
 
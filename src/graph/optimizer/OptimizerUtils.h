@@ -7,6 +7,10 @@
 
 #include "graph/util/SchemaUtil.h"
 
+DECLARE_bool(enable_optimizer_index_intersection);
+DECLARE_bool(enable_optimizer_index_skip_scan);
+DECLARE_uint32(max_index_scan_ranges);
+
 namespace nebula {
 
 class Expression;
@@ -43,6 +47,10 @@ class OptimizerUtils {
   //   1. iterate all indexes
   //   2. select the best column hint for each index
   //     2.1. generate column hint according to the first field of index
+  //     2.2. an `IN' expression generates a prefix hint for each value of the list, which are
+  //          scanned as multiple ranges by storage
+  //     2.3. if no hint is generated, try the second field of index and skip scan the first
+  //          field, which is only done for low cardinality fields, see `canSkipScan'
   //
   // For logical condition expression(only logical `AND' expression):
   //   1. same steps as above 1, 2
@@ -59,6 +67,8 @@ class OptimizerUtils {
   //       range hint
   //     * check whether filter conditions are used, if not, place the unused expression parts
   //       into column hint filter
+  //   6. if some operands are not used by the selected index, find other indexes whose hints
+  //      only use these operands, and let storage intersect them with the selected index
   //
   // For logical `OR' condition expression, use above steps to generate
   // different `IndexQueryContext' for each operand of filter condition, nebula
@@ -0,0 +1,193 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/GeoKnnIndexScanRule.h"
+
+#include "common/expression/FunctionCallExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/optimizer/OptimizerUtils.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+using nebula::graph::IndexScan;
+using nebula::graph::OptimizerUtils;
+using nebula::graph::Project;
+using nebula::graph::TopN;
+using nebula::storage::cpp2::IndexQueryContext;
+
+using Kind = nebula::graph::PlanNode::Kind;
+using ExprKind = nebula::Expression::Kind;
+using TransformResult = nebula::opt::OptRule::TransformResult;
+
+namespace nebula {
+namespace opt {
+
+namespace {
+
+// Extract the prop and the constant point of ST_Distance(prop, point) or ST_Distance(point, prop)
+bool extractDistance(const Expression* expr, std::string* prop, Geography* point) {
+  if (expr->kind() != ExprKind::kFunctionCall) {
+    return false;
+  }
+  auto* call = static_cast<const FunctionCallExpression*>(expr);
+  auto name = call->name();
+  folly::toLowerAscii(name);
+  if (name != "st_distance" || call->args()->numArgs() != 2) {
+    return false;
+  }
+  const auto& args = call->args()->args();
+  for (size_t i = 0; i < 2; ++i) {
+    auto* propExpr = args[i];
+    if (propExpr->kind() != ExprKind::kTagProperty &&
+        propExpr->kind() != ExprKind::kEdgeProperty) {
+      continue;
+    }
+    auto folded = graph::ExpressionUtils::foldConstantExpr(args[1 - i]);
+    if (!folded.ok() || folded.value()->kind() != ExprKind::kConstant) {
+      continue;
+    }
+    const auto& val = static_cast<const ConstantExpression*>(folded.value())->value();
+    if (!val.isGeography() || val.getGeography().shape() != GeoShape::POINT) {
+      continue;
+    }
+    *prop = static_cast<const PropertyExpression*>(propExpr)->prop();
+    *point = val.getGeography();
+    return true;
+  }
+  return false;
+}
+
+// The expression of the only sort factor of TopN, nullptr if it is not sorted ascending by one
+const Expression* sortExpr(const TopN* topN, const Project* project) {
+  const auto& factors = topN->factors();
+  if (factors.size() != 1 || factors.front().second != OrderFactor::OrderType::ASCEND) {
+    return nullptr;
+  }
+  const auto& columns = project->columns()->columns();
+  if (factors.front().first >= columns.size()) {
+    return nullptr;
+  }
+  return columns[factors.front().first]->expr();
+}
+
+}  // namespace
+
+std::unique_ptr<OptRule> GeoKnnIndexScanRule::kInstance =
+    std::unique_ptr<GeoKnnIndexScanRule>(new GeoKnnIndexScanRule());
+
+GeoKnnIndexScanRule::GeoKnnIndexScanRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern& GeoKnnIndexScanRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      Kind::kTopN,
+      {Pattern::create(Kind::kProject,
+                       {Pattern::create({Kind::kTagIndexFullScan, Kind::kEdgeIndexFullScan})})});
+  return pattern;
+}
+
+bool GeoKnnIndexScanRule::match(OptContext* ctx, const MatchedResult& matched) const {
+  if (!OptRule::match(ctx, matched)) {
+    return false;
+  }
+  auto topN = static_cast<const TopN*>(matched.planNode());
+  auto project = static_cast<const Project*>(matched.planNode({0, 0}));
+  auto scan = static_cast<const IndexScan*>(matched.planNode({0, 0, 0}));
+  // Only the scan of all the vertices or edges, otherwise the neighbors hit by the other
+  // conditions may be not the nearest ones
+  for (auto& ictx : scan->queryContext()) {
+    if ((ictx.column_hints_ref().is_set() && !ictx.get_column_hints().empty()) ||
+        ictx.nearest_neighbors_ref().has_value()) {
+      return false;
+    }
+  }
+  auto expr = sortExpr(topN, project);
+  std::string prop;
+  Geography point;
+  return expr != nullptr && extractDistance(expr, &prop, &point);
+}
+
+StatusOr<TransformResult> GeoKnnIndexScanRule::transform(OptContext* ctx,
+                                                         const MatchedResult& matched) const {
+  auto topNGroupNode = matched.node;
+  auto projectGroupNode = matched.dependencies.front().node;
+  auto scanGroupNode = matched.dependencies.front().dependencies.front().node;
+  auto topN = static_cast<const TopN*>(topNGroupNode->node());
+  auto project = static_cast<const Project*>(projectGroupNode->node());
+  auto scan = static_cast<const IndexScan*>(scanGroupNode->node());
+
+  std::string prop;
+  Geography point;
+  if (!extractDistance(sortExpr(topN, project), &prop, &point)) {
+    return TransformResult::noTransform();
+  }
+
+  auto metaClient = ctx->qctx()->getMetaClient();
+  auto status = scan->isEdge() ? metaClient->getEdgeIndexesFromCache(scan->space())
+                               : metaClient->getTagIndexesFromCache(scan->space());
+  NG_RETURN_IF_ERROR(status);
+  auto indexItems = std::move(status).value();
+  OptimizerUtils::eraseInvalidIndexItems(scan->schemaId(), &indexItems);
+
+  // The rings around the point only cover the cells of points, see GeoIndex::dWithinRing. Besides,
+  // NULL is not in the geography index but sorted after all distances, so the rows of NULL would
+  // be missed if there are less than k points, keep the full scan for the nullable column.
+  auto found = std::find_if(indexItems.begin(), indexItems.end(), [&prop](const auto& item) {
+    const auto& fields = item->get_fields();
+    if (fields.size() != 1 || fields.front().get_name() != prop ||
+        fields.front().nullable_ref().value_or(false)) {
+      return false;
+    }
+    const auto& type = fields.front().get_type();
+    return type.get_type() == nebula::cpp2::PropertyType::GEOGRAPHY &&
+           type.geo_shape_ref().has_value() &&
+           type.geo_shape_ref().value() == meta::cpp2::GeoShape::POINT;
+  });
+  if (found == indexItems.end()) {
+    return TransformResult::noTransform();
+  }
+
+  storage::cpp2::NearestNeighbors nearest;
+  nearest.column_name_ref() = prop;
+  nearest.point_ref() = std::move(point);
+  nearest.k_ref() = topN->offset() + topN->count();
+  IndexQueryContext ictx;
+  ictx.index_id_ref() = (*found)->get_index_id();
+  ictx.nearest_neighbors_ref() = std::move(nearest);
+
+  auto newTopN = static_cast<TopN*>(topN->clone());
+  auto newTopNGroupNode = OptGroupNode::create(ctx, newTopN, topNGroupNode->group());
+
+  auto newProject = static_cast<Project*>(project->clone());
+  auto newProjectGroup = OptGroup::create(ctx);
+  auto newProjectGroupNode = newProjectGroup->makeGroupNode(newProject);
+
+  auto newScan = static_cast<IndexScan*>(scan->clone());
+  newScan->setIndexQueryContext({std::move(ictx)});
+  auto newScanGroup = OptGroup::create(ctx);
+  auto newScanGroupNode = newScanGroup->makeGroupNode(newScan);
+
+  newTopNGroupNode->dependsOn(newProjectGroup);
+  newProjectGroupNode->dependsOn(newScanGroup);
+  for (auto dep : scanGroupNode->dependencies()) {
+    newScanGroupNode->dependsOn(dep);
+  }
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newTopNGroupNode);
+  return result;
+}
+
+std::string GeoKnnIndexScanRule::toString() const {
+  return "GeoKnnIndexScanRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
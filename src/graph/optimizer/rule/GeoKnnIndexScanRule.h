@@ -0,0 +1,64 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_GEOKNNINDEXSCANRULE_H
+#define GRAPH_OPTIMIZER_RULE_GEOKNNINDEXSCANRULE_H
+
+#include "graph/optimizer/OptRule.h"
+
+namespace nebula {
+namespace opt {
+
+// Turn `LOOKUP ... YIELD ST_Distance(prop, point) AS d | ORDER BY $-.d | LIMIT k` into the search
+// of the k nearest neighbors of the point on the geography index of prop, which must be an index
+// of points and NOT NULL. Each part only returns its k nearest neighbors, and the TopN is kept to
+// merge them.
+//  Before:
+//
+//  +---------+---------+
+//  |       TopN        |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |      Project      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |  IndexFullScan    |
+//  +---------+---------+
+//
+//  After:
+//
+//  +---------+---------+
+//  |       TopN        |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |      Project      |
+//  +---------+---------+
+//            |
+//  +---------+---------+
+//  |  IndexScan(knn)   |
+//  +---------+---------+
+class GeoKnnIndexScanRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+
+  StatusOr<OptRule::TransformResult> transform(OptContext *ctx,
+                                               const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  GeoKnnIndexScanRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+#endif
@@ -0,0 +1,350 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/PushAggregateDownStorageRule.h"
+
+#include "common/expression/AggregateExpression.h"
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+#include "graph/visitor/FindVisitor.h"
+#include "graph/visitor/RewriteVisitor.h"
+
+DEFINE_bool(enable_optimizer_push_aggregate_down_storage_rule, true, "");
+
+using nebula::graph::Aggregate;
+using nebula::graph::Explore;
+using nebula::graph::GetNeighbors;
+using nebula::graph::IndexScan;
+using nebula::graph::PlanNode;
+using nebula::graph::Project;
+using nebula::graph::QueryContext;
+
+using ExprKind = nebula::Expression::Kind;
+
+namespace nebula {
+namespace opt {
+namespace {
+
+// The kinds evaluated by storage the same as by graphd, besides the properties
+const std::unordered_set<ExprKind> kPushableKinds = {
+    ExprKind::kConstant,
+    ExprKind::kAdd,
+    ExprKind::kMinus,
+    ExprKind::kMultiply,
+    ExprKind::kDivision,
+    ExprKind::kMod,
+    ExprKind::kUnaryPlus,
+    ExprKind::kUnaryNegate,
+    ExprKind::kUnaryNot,
+    ExprKind::kIsNull,
+    ExprKind::kIsNotNull,
+    ExprKind::kIsEmpty,
+    ExprKind::kIsNotEmpty,
+    ExprKind::kRelEQ,
+    ExprKind::kRelNE,
+    ExprKind::kRelLT,
+    ExprKind::kRelLE,
+    ExprKind::kRelGT,
+    ExprKind::kRelGE,
+    ExprKind::kRelIn,
+    ExprKind::kRelNotIn,
+    ExprKind::kContains,
+    ExprKind::kNotContains,
+    ExprKind::kStartsWith,
+    ExprKind::kNotStartsWith,
+    ExprKind::kEndsWith,
+    ExprKind::kNotEndsWith,
+    ExprKind::kLogicalAnd,
+    ExprKind::kLogicalOr,
+    ExprKind::kLogicalXor,
+    ExprKind::kTypeCasting,
+    ExprKind::kFunctionCall,
+    ExprKind::kList,
+    ExprKind::kSet,
+};
+
+// The properties of the edges explored, or of the rows of index
+const std::unordered_set<ExprKind> kEdgePropKinds = {
+    ExprKind::kEdgeProperty,
+    ExprKind::kEdgeSrc,
+    ExprKind::kEdgeDst,
+    ExprKind::kEdgeRank,
+    ExprKind::kEdgeType,
+};
+
+bool isPushable(const Expression* expr, const Explore* explore) {
+  bool isIndexScan = explore->kind() != PlanNode::Kind::kGetNeighbors;
+  graph::FindVisitor visitor([isIndexScan](const Expression* e) {
+    if (kPushableKinds.count(e->kind()) || kEdgePropKinds.count(e->kind())) {
+      return false;
+    }
+    return !(isIndexScan && e->kind() == ExprKind::kTagProperty);
+  });
+  const_cast<Expression*>(expr)->accept(&visitor);
+  if (visitor.found()) {
+    return false;
+  }
+  if (!isIndexScan) {
+    return true;
+  }
+  // Only the columns returned by the index scan are read by storage
+  const auto& returnCols = static_cast<const IndexScan*>(explore)->returnColumns();
+  auto props = graph::ExpressionUtils::collectAll(expr,
+                                                  {ExprKind::kTagProperty,
+                                                   ExprKind::kEdgeProperty,
+                                                   ExprKind::kEdgeSrc,
+                                                   ExprKind::kEdgeDst,
+                                                   ExprKind::kEdgeRank,
+                                                   ExprKind::kEdgeType});
+  for (auto* prop : props) {
+    const auto& name = static_cast<const PropertyExpression*>(prop)->prop();
+    if (std::find(returnCols.begin(), returnCols.end(), name) == returnCols.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isNumericType(nebula::cpp2::PropertyType type) {
+  switch (type) {
+    case nebula::cpp2::PropertyType::INT8:
+    case nebula::cpp2::PropertyType::INT16:
+    case nebula::cpp2::PropertyType::INT32:
+    case nebula::cpp2::PropertyType::INT64:
+    case nebula::cpp2::PropertyType::FLOAT:
+    case nebula::cpp2::PropertyType::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Whether the expression is always numeric or null, so that sum never results in BAD_TYPE,
+// which is skipped as null while merging the partial sums
+bool isNumeric(const Expression* expr, QueryContext* qctx, GraphSpaceID space) {
+  switch (expr->kind()) {
+    case ExprKind::kConstant:
+      return static_cast<const ConstantExpression*>(expr)->value().isNumeric();
+    case ExprKind::kAdd:
+    case ExprKind::kMinus:
+    case ExprKind::kMultiply:
+    case ExprKind::kDivision:
+    case ExprKind::kMod: {
+      auto* arith = static_cast<const BinaryExpression*>(expr);
+      return isNumeric(arith->left(), qctx, space) && isNumeric(arith->right(), qctx, space);
+    }
+    case ExprKind::kUnaryPlus:
+    case ExprKind::kUnaryNegate:
+      return isNumeric(static_cast<const UnaryExpression*>(expr)->operand(), qctx, space);
+    case ExprKind::kEdgeRank:
+      return true;
+    case ExprKind::kEdgeProperty: {
+      auto* prop = static_cast<const PropertyExpression*>(expr);
+      auto edgeType = qctx->schemaMng()->toEdgeType(space, prop->sym());
+      if (!edgeType.ok()) {
+        return false;
+      }
+      auto schema = qctx->schemaMng()->getEdgeSchema(space, std::abs(edgeType.value()));
+      auto* field = schema == nullptr ? nullptr : schema->field(prop->prop());
+      return field != nullptr && isNumericType(field->type());
+    }
+    case ExprKind::kTagProperty: {
+      auto* prop = static_cast<const PropertyExpression*>(expr);
+      auto tagId = qctx->schemaMng()->toTagID(space, prop->sym());
+      if (!tagId.ok()) {
+        return false;
+      }
+      auto schema = qctx->schemaMng()->getTagSchema(space, tagId.value());
+      auto* field = schema == nullptr ? nullptr : schema->field(prop->prop());
+      return field != nullptr && isNumericType(field->type());
+    }
+    default:
+      return false;
+  }
+}
+
+// Whether the explore node returns all the edges or rows
+bool exploresAll(const Explore* explore, QueryContext* qctx) {
+  if (!explore->orderBy().empty() || explore->hasAggregate()) {
+    return false;
+  }
+  auto* limit = explore->limitExpr();
+  if (limit != nullptr) {
+    if (!graph::ExpressionUtils::isEvaluableExpr(limit, qctx)) {
+      return false;
+    }
+    auto rows = explore->limit(qctx);
+    if (rows >= 0 && rows != std::numeric_limits<int64_t>::max()) {
+      return false;
+    }
+  }
+  if (explore->kind() == PlanNode::Kind::kGetNeighbors) {
+    auto* gn = static_cast<const GetNeighbors*>(explore);
+    return !gn->random() && gn->localStepsExpr() == nullptr && gn->edgeProps() != nullptr &&
+           !gn->edgeProps()->empty();
+  }
+  return !static_cast<const IndexScan*>(explore)->isEmptyResultSet();
+}
+
+}  // namespace
+
+/*static*/ const std::initializer_list<graph::PlanNode::Kind>
+    PushAggregateDownStorageRule::kExploreKinds{
+        graph::PlanNode::Kind::kGetNeighbors,
+        graph::PlanNode::Kind::kIndexScan,
+        graph::PlanNode::Kind::kTagIndexFullScan,
+        graph::PlanNode::Kind::kTagIndexRangeScan,
+        graph::PlanNode::Kind::kTagIndexPrefixScan,
+        graph::PlanNode::Kind::kEdgeIndexFullScan,
+        graph::PlanNode::Kind::kEdgeIndexRangeScan,
+        graph::PlanNode::Kind::kEdgeIndexPrefixScan,
+    };
+
+std::unique_ptr<OptRule> PushAggregateDownStorageRule::kInstance =
+    std::unique_ptr<PushAggregateDownStorageRule>(new PushAggregateDownStorageRule());
+
+PushAggregateDownStorageRule::PushAggregateDownStorageRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &PushAggregateDownStorageRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      graph::PlanNode::Kind::kAggregate,
+      {Pattern::create(graph::PlanNode::Kind::kProject, {Pattern::create(kExploreKinds)})});
+  return pattern;
+}
+
+bool PushAggregateDownStorageRule::match(OptContext *octx, const MatchedResult &matched) const {
+  if (!FLAGS_enable_optimizer_push_aggregate_down_storage_rule) {
+    return false;
+  }
+  if (!OptRule::match(octx, matched)) {
+    return false;
+  }
+  const auto *explore = static_cast<const Explore *>(
+      matched.dependencies.front().dependencies.front().node->node());
+  return exploresAll(explore, octx->qctx());
+}
+
+StatusOr<OptRule::TransformResult> PushAggregateDownStorageRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto *qctx = octx->qctx();
+  auto *pool = qctx->objPool();
+  auto aggGroupNode = matched.node;
+  auto projectGroupNode = matched.dependencies.front().node;
+  auto exploreGroupNode = matched.dependencies.front().dependencies.front().node;
+
+  const auto *agg = static_cast<const Aggregate *>(aggGroupNode->node());
+  const auto *project = static_cast<const Project *>(projectGroupNode->node());
+  const auto *explore = static_cast<const Explore *>(exploreGroupNode->node());
+
+  // Replace the columns of project by their expressions
+  std::unordered_map<std::string, Expression *> columns;
+  auto projColNames = project->colNames();
+  const auto &projColumns = project->columns()->columns();
+  for (size_t i = 0; i < projColNames.size(); ++i) {
+    columns[projColNames[i]] = projColumns[i]->expr();
+  }
+  bool unknown = false;
+  auto matcher = [](const Expression *e) -> bool {
+    return e->kind() == ExprKind::kInputProperty || e->kind() == ExprKind::kVarProperty;
+  };
+  auto rewriter = [&columns, &unknown, pool](const Expression *e) -> Expression * {
+    // The variable may not be the output of project
+    auto found = e->kind() == ExprKind::kInputProperty
+                     ? columns.find(static_cast<const PropertyExpression *>(e)->prop())
+                     : columns.end();
+    if (found == columns.end()) {
+      unknown = true;
+      return ConstantExpression::make(pool);
+    }
+    return found->second->clone();
+  };
+  auto pushDown = [&](const Expression *expr) -> Expression * {
+    auto *rewritten = graph::RewriteVisitor::transform(expr, matcher, rewriter);
+    return unknown || !isPushable(rewritten, explore) ? nullptr : rewritten;
+  };
+
+  std::vector<Expression *> pushedKeys;
+  std::vector<std::string> keyCols;
+  std::vector<Expression *> newKeys;
+  for (auto *key : agg->groupKeys()) {
+    auto *pushed = pushDown(key);
+    if (pushed == nullptr) {
+      return TransformResult::noTransform();
+    }
+    pushedKeys.emplace_back(pushed);
+    keyCols.emplace_back(qctx->vctx()->anonColGen()->getCol());
+    newKeys.emplace_back(InputPropertyExpression::make(pool, keyCols.back()));
+  }
+
+  std::vector<Expression *> pushedAggs;
+  std::vector<std::string> aggCols;
+  std::vector<Expression *> newItems;
+  for (auto *item : agg->groupItems()) {
+    if (item->kind() == ExprKind::kAggregate) {
+      auto *aggExpr = static_cast<AggregateExpression *>(item);
+      auto name = aggExpr->name();
+      std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+      if ((name != "COUNT" && name != "SUM" && name != "MAX" && name != "MIN") ||
+          aggExpr->distinct()) {
+        return TransformResult::noTransform();
+      }
+      auto *arg = pushDown(aggExpr->arg());
+      if (arg == nullptr || (name == "SUM" && !isNumeric(arg, qctx, explore->space()))) {
+        return TransformResult::noTransform();
+      }
+      pushedAggs.emplace_back(AggregateExpression::make(pool, name, arg, false));
+      aggCols.emplace_back(qctx->vctx()->anonColGen()->getCol());
+      // The partial counts are summed, and the others are merged by themselves
+      auto merged = name == "COUNT" ? "SUM" : name;
+      newItems.emplace_back(AggregateExpression::make(
+          pool, merged, InputPropertyExpression::make(pool, aggCols.back()), false));
+      continue;
+    }
+    auto found = std::find_if(agg->groupKeys().begin(),
+                              agg->groupKeys().end(),
+                              [item](const Expression *key) { return *key == *item; });
+    if (found != agg->groupKeys().end()) {
+      newItems.emplace_back(newKeys[found - agg->groupKeys().begin()]->clone());
+    } else if (graph::ExpressionUtils::isEvaluableExpr(item, qctx)) {
+      newItems.emplace_back(item->clone());
+    } else {
+      return TransformResult::noTransform();
+    }
+  }
+
+  auto colNames = keyCols;
+  colNames.insert(colNames.end(), aggCols.begin(), aggCols.end());
+  auto newExplore = static_cast<Explore *>(explore->clone());
+  newExplore->setAggregate(std::move(pushedKeys), std::move(pushedAggs));
+  newExplore->setColNames(std::move(colNames));
+  auto newExploreGroup = OptGroup::create(octx);
+  auto newExploreGroupNode = newExploreGroup->makeGroupNode(newExplore);
+  for (auto dep : exploreGroupNode->dependencies()) {
+    newExploreGroupNode->dependsOn(dep);
+  }
+
+  auto newAgg = Aggregate::make(qctx, newExplore, std::move(newKeys), std::move(newItems));
+  newAgg->setOutputVar(agg->outputVar());
+  newAgg->setColNames(agg->colNames());
+  auto newAggGroupNode = OptGroupNode::create(octx, newAgg, aggGroupNode->group());
+  newAggGroupNode->dependsOn(newExploreGroup);
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newAggGroupNode);
+  return result;
+}
+
+std::string PushAggregateDownStorageRule::toString() const {
+  return "PushAggregateDownStorageRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
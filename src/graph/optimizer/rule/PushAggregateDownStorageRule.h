@@ -0,0 +1,51 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_PUSHAGGREGATEDOWNSTORAGERULE_H_
+#define GRAPH_OPTIMIZER_RULE_PUSHAGGREGATEDOWNSTORAGERULE_H_
+
+#include <initializer_list>
+
+#include "graph/optimizer/OptRule.h"
+
+DECLARE_bool(enable_optimizer_push_aggregate_down_storage_rule);
+
+namespace nebula {
+namespace opt {
+
+/**
+ * Aggregates the edges of [[GetNeighbors]] or the rows of index scan partially in storage, and
+ * merges the partial groups by the [[Aggregate]] above
+ * Required conditions:
+ *  1. Match the pattern
+ *  2. The explore node has no limit, order by, random or local steps
+ *  3. The group keys and the arguments of aggregates only refer to the columns of [[Project]]
+ *     which storage could evaluate, i.e. the properties of edge or index and the constants
+ *  4. The aggregates are count, sum, max or min without distinct, and the argument of sum is
+ *     numeric, the other group items are the group keys or constants
+ * Benefits:
+ *  1. Storage returns one row per group of each part instead of all the edges or rows
+ */
+class PushAggregateDownStorageRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  PushAggregateDownStorageRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+  static const std::initializer_list<graph::PlanNode::Kind> kExploreKinds;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_RULE_PUSHAGGREGATEDOWNSTORAGERULE_H_
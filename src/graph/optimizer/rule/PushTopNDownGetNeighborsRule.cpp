@@ -0,0 +1,132 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/rule/PushTopNDownGetNeighborsRule.h"
+
+#include "graph/optimizer/OptContext.h"
+#include "graph/optimizer/OptGroup.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+DEFINE_bool(enable_optimizer_push_topn_down_get_neighbors_rule, true, "");
+
+using nebula::graph::GetNeighbors;
+using nebula::graph::PlanNode;
+using nebula::graph::Project;
+using nebula::graph::QueryContext;
+using nebula::graph::TopN;
+
+namespace nebula {
+namespace opt {
+
+std::unique_ptr<OptRule> PushTopNDownGetNeighborsRule::kInstance =
+    std::unique_ptr<PushTopNDownGetNeighborsRule>(new PushTopNDownGetNeighborsRule());
+
+PushTopNDownGetNeighborsRule::PushTopNDownGetNeighborsRule() {
+  RuleSet::QueryRules().addRule(this);
+}
+
+const Pattern &PushTopNDownGetNeighborsRule::pattern() const {
+  static Pattern pattern = Pattern::create(
+      graph::PlanNode::Kind::kTopN,
+      {Pattern::create(graph::PlanNode::Kind::kProject,
+                       {Pattern::create(graph::PlanNode::Kind::kGetNeighbors)})});
+  return pattern;
+}
+
+bool PushTopNDownGetNeighborsRule::match(OptContext *octx, const MatchedResult &matched) const {
+  if (!FLAGS_enable_optimizer_push_topn_down_get_neighbors_rule) {
+    return false;
+  }
+  if (!OptRule::match(octx, matched)) {
+    return false;
+  }
+  auto *qctx = octx->qctx();
+  const auto *gn = static_cast<const GetNeighbors *>(
+      matched.dependencies.front().dependencies.front().node->node());
+  // The first N edges limited already are not the top N ones
+  auto *limit = gn->limitExpr();
+  if (limit != nullptr) {
+    if (!graph::ExpressionUtils::isEvaluableExpr(limit, qctx)) {
+      return false;
+    }
+    auto rows = gn->limit(qctx);
+    if (rows >= 0 && rows != std::numeric_limits<int64_t>::max()) {
+      return false;
+    }
+  }
+  return gn->orderBy().empty() && !gn->random() && gn->localStepsExpr() == nullptr &&
+         !gn->hasAggregate() && gn->edgeProps() != nullptr && !gn->edgeProps()->empty();
+}
+
+StatusOr<OptRule::TransformResult> PushTopNDownGetNeighborsRule::transform(
+    OptContext *octx, const MatchedResult &matched) const {
+  auto topNGroupNode = matched.node;
+  auto projectGroupNode = matched.dependencies.front().node;
+  auto gnGroupNode = matched.dependencies.front().dependencies.front().node;
+
+  const auto topN = static_cast<const TopN *>(topNGroupNode->node());
+  const auto project = static_cast<const Project *>(projectGroupNode->node());
+  const auto gn = static_cast<const GetNeighbors *>(gnGroupNode->node());
+
+  int64_t limitRows = topN->offset() + topN->count();
+  const auto &columns = project->columns()->columns();
+
+  std::vector<storage::cpp2::OrderBy> orderBys;
+  orderBys.reserve(topN->factors().size());
+  for (const auto &factor : topN->factors()) {
+    if (factor.first >= columns.size()) {
+      return TransformResult::noTransform();
+    }
+    // Only the props of the edge are sorted by storage, the ones of vertices are not read per edge
+    auto *expr = columns[factor.first]->expr();
+    switch (expr->kind()) {
+      case Expression::Kind::kEdgeProperty:
+      case Expression::Kind::kEdgeRank:
+      case Expression::Kind::kEdgeDst:
+        break;
+      default:
+        return TransformResult::noTransform();
+    }
+    storage::cpp2::OrderBy orderBy;
+    orderBy.prop_ref() = Expression::encode(*expr);
+    orderBy.direction_ref() = factor.second == OrderFactor::OrderType::ASCEND
+                                  ? storage::cpp2::OrderDirection::ASCENDING
+                                  : storage::cpp2::OrderDirection::DESCENDING;
+    orderBys.emplace_back(std::move(orderBy));
+  }
+
+  auto newTopN = static_cast<TopN *>(topN->clone());
+  auto newTopNGroupNode = OptGroupNode::create(octx, newTopN, topNGroupNode->group());
+
+  auto newProject = static_cast<Project *>(project->clone());
+  auto newProjectGroup = OptGroup::create(octx);
+  auto newProjectGroupNode = newProjectGroup->makeGroupNode(newProject);
+
+  auto newGn = static_cast<GetNeighbors *>(gn->clone());
+  newGn->setLimit(limitRows);
+  newGn->setOrderBy(std::move(orderBys));
+  auto newGnGroup = OptGroup::create(octx);
+  auto newGnGroupNode = newGnGroup->makeGroupNode(newGn);
+
+  newTopNGroupNode->dependsOn(newProjectGroup);
+  newProjectGroupNode->dependsOn(newGnGroup);
+  for (auto dep : gnGroupNode->dependencies()) {
+    newGnGroupNode->dependsOn(dep);
+  }
+
+  TransformResult result;
+  result.eraseAll = true;
+  result.newGroupNodes.emplace_back(newTopNGroupNode);
+  return result;
+}
+
+std::string PushTopNDownGetNeighborsRule::toString() const {
+  return "PushTopNDownGetNeighborsRule";
+}
+
+}  // namespace opt
+}  // namespace nebula
@@ -0,0 +1,45 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_RULE_PUSHTOPNDOWNGETNEIGHBORSRULE_H_
+#define GRAPH_OPTIMIZER_RULE_PUSHTOPNDOWNGETNEIGHBORSRULE_H_
+
+#include "graph/optimizer/OptRule.h"
+
+DECLARE_bool(enable_optimizer_push_topn_down_get_neighbors_rule);
+
+namespace nebula {
+namespace opt {
+
+/**
+ * Sorts the edges of each vertex in [[GetNeighbors]] and returns the top N of them, so that the
+ * [[TopN]] above only sorts the candidates
+ * Required conditions:
+ *  1. Match the pattern
+ *  2. The [[GetNeighbors]] has no limit, order by, random, local steps or aggregate
+ *  3. Each sort factor refers to a column of [[Project]] which is a property, rank or dst of edge
+ * Benefits:
+ *  1. Storage returns at most offset + count edges per vertex instead of all the edges
+ */
+class PushTopNDownGetNeighborsRule final : public OptRule {
+ public:
+  const Pattern &pattern() const override;
+
+  bool match(OptContext *ctx, const MatchedResult &matched) const override;
+
+  StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+  std::string toString() const override;
+
+ private:
+  PushTopNDownGetNeighborsRule();
+
+  static std::unique_ptr<OptRule> kInstance;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_RULE_PUSHTOPNDOWNGETNEIGHBORSRULE_H_
@@ -27,6 +27,20 @@ using TransformResult = nebula::opt::OptRule::TransformResult;
 namespace nebula {
 namespace opt {
 
+namespace {
+
+// Whether the list of IN expr is too long to be scanned as multiple prefixes of one index scan
+bool tooManyInValues(const Expression* expr) {
+  auto right = static_cast<const RelationalExpression*>(expr)->right();
+  if (!right->isContainerExpr()) {
+    return false;
+  }
+  return graph::ExpressionUtils::getContainerExprOperands(right).size() >
+         FLAGS_max_index_scan_ranges;
+}
+
+}  // namespace
+
 // The matched expression should be either a OR expression or an expression that could be
 // rewrote to a OR expression. There are 3 scenarios.
 //
@@ -38,6 +52,9 @@ namespace opt {
 // 3. IN expr with its list size > 1, such as A in [a, b] since it can be transformed to (A==a) OR
 // (A==b).
 // If the list has a size of 1, the expr will be matched with OptimizeTagIndexScanByFilterRule.
+//
+// For scenario 2 and 3, the IN expr is scanned as a prefix for each value by one index scan if
+// possible, instead of the union of a scan for each value.
 bool UnionAllIndexScanBaseRule::match(OptContext* ctx, const MatchedResult& matched) const {
   if (!OptRule::match(ctx, matched)) {
     return false;
@@ -109,8 +126,20 @@ StatusOr<TransformResult> UnionAllIndexScanBaseRule::transform(OptContext* ctx,
 
   auto condition = filter->condition();
   auto conditionType = condition->kind();
-  Expression* transformedExpr = condition->clone();
+  std::vector<IndexQueryContext> idxCtxs;
+
+  // The IN exprs of a relational or AND expr hit the index as multiple prefixes or ranges of one
+  // scan, which is cheaper than the union of a scan for each value
+  if (conditionType == ExprKind::kRelIn || conditionType == ExprKind::kLogicalAnd) {
+    IndexQueryContext ictx;
+    bool isPrefixScan = false;
+    if (OptimizerUtils::findOptimalIndex(condition, indexItems, &isPrefixScan, &ictx)) {
+      idxCtxs.emplace_back(std::move(ictx));
+      return makeScan(ctx, matched, std::move(idxCtxs));
+    }
+  }
 
+  Expression* transformedExpr = condition->clone();
   switch (conditionType) {
     // Stand alone IN expr
     // If it has multiple elements in the list, check valid index before expanding to OR expr
@@ -140,9 +169,10 @@ StatusOr<TransformResult> UnionAllIndexScanBaseRule::transform(OptContext* ctx,
 
     // OR expr
     case ExprKind::kLogicalOr: {
-      // Iterate all operands and expand IN exprs if possible
+      // Iterate all operands and expand IN exprs if possible, which is only needed if the list is
+      // too long to be scanned as multiple prefixes
       for (auto& expr : static_cast<LogicalExpression*>(transformedExpr)->operands()) {
-        if (expr->kind() == ExprKind::kRelIn) {
+        if (expr->kind() == ExprKind::kRelIn && tooManyInValues(expr)) {
           if (OptimizerUtils::relExprHasIndex(expr, indexItems)) {
             expr = graph::ExpressionUtils::rewriteInExpr(expr);
           }
@@ -159,7 +189,6 @@ StatusOr<TransformResult> UnionAllIndexScanBaseRule::transform(OptContext* ctx,
   }
 
   DCHECK(transformedExpr->kind() == ExprKind::kLogicalOr);
-  std::vector<IndexQueryContext> idxCtxs;
   auto logicalExpr = static_cast<const LogicalExpression*>(transformedExpr);
   for (auto operand : logicalExpr->operands()) {
     IndexQueryContext ictx;
@@ -169,7 +198,14 @@ StatusOr<TransformResult> UnionAllIndexScanBaseRule::transform(OptContext* ctx,
     }
     idxCtxs.emplace_back(std::move(ictx));
   }
+  return makeScan(ctx, matched, std::move(idxCtxs));
+}
 
+StatusOr<TransformResult> UnionAllIndexScanBaseRule::makeScan(
+    OptContext* ctx, const MatchedResult& matched, std::vector<IndexQueryContext> idxCtxs) const {
+  auto filter = static_cast<const Filter*>(matched.planNode());
+  auto scan = static_cast<const IndexScan*>(matched.planNode({0, 0}));
+  auto* qctx = ctx->qctx();
   auto scanNode = IndexScan::make(qctx, nullptr);
   OptimizerUtils::copyIndexScanData(scan, scanNode, qctx);
   scanNode->setIndexQueryContext(std::move(idxCtxs));
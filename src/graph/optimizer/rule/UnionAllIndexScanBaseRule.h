@@ -7,6 +7,7 @@
 #define GRAPH_OPTIMIZER_RULE_UNIONALLINDEXSCANBASERULE_H_
 
 #include "graph/optimizer/OptRule.h"
+#include "interface/gen-cpp2/storage_types.h"
 
 namespace nebula {
 namespace opt {
@@ -15,6 +16,11 @@ class UnionAllIndexScanBaseRule : public OptRule {
  public:
   bool match(OptContext *ctx, const MatchedResult &matched) const override;
   StatusOr<TransformResult> transform(OptContext *ctx, const MatchedResult &matched) const override;
+
+ private:
+  StatusOr<TransformResult> makeScan(OptContext *ctx,
+                                     const MatchedResult &matched,
+                                     std::vector<storage::cpp2::IndexQueryContext> idxCtxs) const;
 };
 
 }  // namespace opt
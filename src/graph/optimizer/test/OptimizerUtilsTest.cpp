@@ -0,0 +1,255 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "graph/optimizer/OptimizerUtils.h"
+
+using nebula::cpp2::PropertyType;
+using nebula::graph::OptimizerUtils;
+
+namespace nebula {
+namespace opt {
+
+class OptimizerUtilsTest : public testing::Test {
+ protected:
+  using IndexItems = std::vector<std::shared_ptr<meta::cpp2::IndexItem>>;
+
+  static std::shared_ptr<meta::cpp2::IndexItem> makeIndex(IndexID id,
+                                                          const std::vector<std::string>& fields,
+                                                          PropertyType type = PropertyType::INT64) {
+    auto index = std::make_shared<meta::cpp2::IndexItem>();
+    index->index_id_ref() = id;
+    index->index_name_ref() = folly::stringPrintf("idx%d", id);
+    std::vector<meta::cpp2::ColumnDef> cols;
+    for (const auto& field : fields) {
+      meta::cpp2::ColumnDef col;
+      col.name_ref() = field;
+      col.type.type_ref() = type;
+      cols.emplace_back(std::move(col));
+    }
+    index->fields_ref() = std::move(cols);
+    return index;
+  }
+
+  Expression* prop(const std::string& name) {
+    return TagPropertyExpression::make(&pool_, "tag", name);
+  }
+
+  Expression* eq(const std::string& name, Value value) {
+    return RelationalExpression::makeEQ(
+        &pool_, prop(name), ConstantExpression::make(&pool_, std::move(value)));
+  }
+
+  Expression* gt(const std::string& name, Value value) {
+    return RelationalExpression::makeGT(
+        &pool_, prop(name), ConstantExpression::make(&pool_, std::move(value)));
+  }
+
+  Expression* in(const std::string& name, std::vector<Value> values) {
+    return RelationalExpression::makeIn(
+        &pool_, prop(name), ConstantExpression::make(&pool_, List(std::move(values))));
+  }
+
+  Expression* and_(const std::vector<Expression*>& operands) {
+    auto* expr = LogicalExpression::makeAnd(&pool_);
+    for (auto* operand : operands) {
+      expr->addOperand(operand);
+    }
+    return expr;
+  }
+
+  ObjectPool pool_;
+};
+
+TEST_F(OptimizerUtilsTest, IntersectEqualityPrefixes) {
+  IndexItems indexes{makeIndex(1, {"a"}), makeIndex(2, {"b"})};
+  bool isPrefixScan = false;
+  storage::cpp2::IndexQueryContext ictx;
+  ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+      and_({eq("a", 1), eq("b", 2)}), indexes, &isPrefixScan, &ictx));
+  EXPECT_TRUE(isPrefixScan);
+  ASSERT_TRUE(ictx.intersect_indexes_ref().has_value());
+  const auto& intersects = *ictx.intersect_indexes_ref();
+  ASSERT_EQ(1, intersects.size());
+  auto selected = ictx.get_index_id();
+  auto other = *intersects.front().index_id_ref();
+  EXPECT_EQ(3, selected + other);
+  const auto& hints = *intersects.front().column_hints_ref();
+  ASSERT_EQ(1, hints.size());
+  EXPECT_EQ(storage::cpp2::ScanType::PREFIX, hints.front().get_scan_type());
+  EXPECT_EQ(other == 1 ? "a" : "b", hints.front().get_column_name());
+}
+
+TEST_F(OptimizerUtilsTest, NoIntersectRanges) {
+  IndexItems indexes{makeIndex(1, {"a"}), makeIndex(2, {"b"})};
+  {
+    // The range of b may hit far more than a, it is left to the filter
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({eq("a", 1), gt("b", 2)}), indexes, &isPrefixScan, &ictx));
+    EXPECT_EQ(1, ictx.get_index_id());
+    EXPECT_FALSE(ictx.intersect_indexes_ref().has_value());
+    EXPECT_TRUE(ictx.filter_ref().has_value());
+  }
+  {
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({gt("a", 1), eq("b", 2)}), indexes, &isPrefixScan, &ictx));
+    EXPECT_EQ(2, ictx.get_index_id());
+    EXPECT_FALSE(ictx.intersect_indexes_ref().has_value());
+  }
+  {
+    // The selected composite index has a range on its last field
+    IndexItems composite{makeIndex(1, {"a"}), makeIndex(2, {"b", "c"})};
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({gt("a", 1), eq("b", 2), gt("c", 3)}), composite, &isPrefixScan, &ictx));
+    EXPECT_EQ(2, ictx.get_index_id());
+    EXPECT_FALSE(ictx.intersect_indexes_ref().has_value());
+  }
+}
+
+TEST_F(OptimizerUtilsTest, IntersectionDisabled) {
+  FLAGS_enable_optimizer_index_intersection = false;
+  IndexItems indexes{makeIndex(1, {"a"}), makeIndex(2, {"b"})};
+  bool isPrefixScan = false;
+  storage::cpp2::IndexQueryContext ictx;
+  ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+      and_({eq("a", 1), eq("b", 2)}), indexes, &isPrefixScan, &ictx));
+  EXPECT_FALSE(ictx.intersect_indexes_ref().has_value());
+  EXPECT_TRUE(ictx.filter_ref().has_value());
+  FLAGS_enable_optimizer_index_intersection = true;
+}
+
+TEST_F(OptimizerUtilsTest, InValues) {
+  IndexItems indexes{makeIndex(1, {"a", "b"})};
+  {
+    // NULL never equals to any value
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        in("a", {1, Value::kNullValue, 2}), indexes, &isPrefixScan, &ictx));
+    EXPECT_TRUE(isPrefixScan);
+    const auto& hints = ictx.get_column_hints();
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ(storage::cpp2::ScanType::PREFIX, hints.front().get_scan_type());
+    ASSERT_TRUE(hints.front().in_values_ref().has_value());
+    EXPECT_EQ(std::vector<Value>({1, 2}), *hints.front().in_values_ref());
+    EXPECT_FALSE(ictx.filter_ref().has_value());
+  }
+  {
+    // The IN list is expanded along with the prefix of a
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({eq("a", 1), in("b", {3, 4})}), indexes, &isPrefixScan, &ictx));
+    const auto& hints = ictx.get_column_hints();
+    ASSERT_EQ(2, hints.size());
+    EXPECT_FALSE(hints[0].in_values_ref().has_value());
+    EXPECT_EQ(std::vector<Value>({3, 4}), *hints[1].in_values_ref());
+    EXPECT_FALSE(ictx.filter_ref().has_value());
+  }
+  {
+    // The IN list is left to the filter if there is another hint of the field
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({in("a", {1, 2}), gt("a", 0)}), indexes, &isPrefixScan, &ictx));
+    const auto& hints = ictx.get_column_hints();
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ(storage::cpp2::ScanType::RANGE, hints.front().get_scan_type());
+    EXPECT_TRUE(ictx.filter_ref().has_value());
+  }
+  {
+    // 2 * 3 prefixes are more than the max, so b is left to the filter
+    FLAGS_max_index_scan_ranges = 4;
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({in("a", {1, 2}), in("b", {3, 4, 5})}), indexes, &isPrefixScan, &ictx));
+    const auto& hints = ictx.get_column_hints();
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ("a", hints.front().get_column_name());
+    EXPECT_TRUE(ictx.filter_ref().has_value());
+
+    // The IN list longer than the max could not use the index
+    storage::cpp2::IndexQueryContext tooMany;
+    EXPECT_FALSE(OptimizerUtils::findOptimalIndex(
+        in("a", {1, 2, 3, 4, 5}), indexes, &isPrefixScan, &tooMany));
+    FLAGS_max_index_scan_ranges = 256;
+  }
+}
+
+TEST_F(OptimizerUtilsTest, SkipScan) {
+  auto boolIndex = makeIndex(1, {"g", "a"});
+  (*boolIndex->fields_ref())[0].type.type_ref() = PropertyType::BOOL;
+  {
+    // The bool field is always skipped
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(eq("a", 1), {boolIndex}, &isPrefixScan, &ictx));
+    EXPECT_TRUE(ictx.get_skip_scan());
+    const auto& hints = ictx.get_column_hints();
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ("a", hints.front().get_column_name());
+    EXPECT_EQ(storage::cpp2::ScanType::PREFIX, hints.front().get_scan_type());
+  }
+  {
+    // The first field is hit, no need to skip
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(
+        and_({eq("g", true), eq("a", 1)}), {boolIndex}, &isPrefixScan, &ictx));
+    EXPECT_FALSE(ictx.get_skip_scan());
+    EXPECT_EQ(2, ictx.get_column_hints().size());
+  }
+  {
+    // The index hitting the first field is preferred
+    IndexItems indexes{boolIndex, makeIndex(2, {"a"})};
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(eq("a", 1), indexes, &isPrefixScan, &ictx));
+    EXPECT_EQ(2, ictx.get_index_id());
+    EXPECT_FALSE(ictx.get_skip_scan());
+  }
+
+  auto intIndex = makeIndex(3, {"i", "a"});
+  {
+    // The integer field is only skipped if the flag is on
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    EXPECT_FALSE(OptimizerUtils::findOptimalIndex(eq("a", 1), {intIndex}, &isPrefixScan, &ictx));
+
+    FLAGS_enable_optimizer_index_skip_scan = true;
+    ASSERT_TRUE(OptimizerUtils::findOptimalIndex(eq("a", 1), {intIndex}, &isPrefixScan, &ictx));
+    EXPECT_TRUE(ictx.get_skip_scan());
+    FLAGS_enable_optimizer_index_skip_scan = false;
+  }
+  {
+    // The nullable field could not be skipped
+    (*boolIndex->fields_ref())[0].nullable_ref() = true;
+    bool isPrefixScan = false;
+    storage::cpp2::IndexQueryContext ictx;
+    EXPECT_FALSE(OptimizerUtils::findOptimalIndex(eq("a", 1), {boolIndex}, &isPrefixScan, &ictx));
+  }
+}
+
+}  // namespace opt
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
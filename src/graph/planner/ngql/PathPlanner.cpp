@@ -77,14 +77,14 @@ void PathPlanner::buildStart(Starts& starts, std::string& vidsVar, bool reverse)
   }
 }
 
-// loopSteps{0} <= ((steps + 1) / 2)  && (pathVar is Empty || size(pathVar) ==
-// 0)
+// loopSteps{0} <= steps && (pathVar is Empty || size(pathVar) == 0)
+// Each round expands one direction, except the first round which expands both of them.
 Expression* PathPlanner::singlePairLoopCondition(uint32_t steps, const std::string& pathVar) {
   auto loopSteps = pathCtx_->qctx->vctx()->anonVarGen()->getVar();
   pathCtx_->qctx->ectx()->setValue(loopSteps, 0);
   auto* pool = pathCtx_->qctx->objPool();
 
-  auto step = ExpressionUtils::stepCondition(pool, loopSteps, ((steps + 1) / 2));
+  auto step = ExpressionUtils::stepCondition(pool, loopSteps, steps);
   auto empty = ExpressionUtils::equalCondition(pool, pathVar, Value::kEmpty);
   auto zero = ExpressionUtils::zeroCondition(pool, pathVar);
   auto* noFound = LogicalExpression::makeOr(pool, empty, zero);
@@ -241,35 +241,34 @@ PlanNode* PathPlanner::singlePairPath(PlanNode* dep, bool reverse) {
     pathDep = filter;
   }
 
-  auto* path = BFSShortestPath::make(qctx, pathDep);
-  path->setOutputVar(vidsVar);
-  path->setColNames({kVid, kEdgeStr});
-
-  // singlePair startVid dataset
+  // singlePair startVid dataset, the frontier is updated by BiBFSShortestPath in each round
   const auto& starts = reverse ? pathCtx_->to : pathCtx_->from;
   DataSet ds;
-  ds.colNames = {kVid, kEdgeStr};
+  ds.colNames = {kVid};
   Row row;
   row.values.emplace_back(starts.vids.front());
-  row.values.emplace_back(Value::kEmpty);
   ds.rows.emplace_back(std::move(row));
   qctx->ectx()->setResult(vidsVar, ResultBuilder().value(Value(std::move(ds))).build());
-  return path;
+  return pathDep;
 }
 
 SubPlan PathPlanner::singlePairPlan(PlanNode* dep) {
-  auto* forwardPath = singlePairPath(dep, false);
-  auto* backwardPath = singlePairPath(dep, true);
+  auto* forward = singlePairPath(dep, false);
+  auto* backward = singlePairPath(dep, true);
   auto qctx = pathCtx_->qctx;
 
-  auto* conjunct = ConjunctPath::make(
-      qctx, forwardPath, backwardPath, ConjunctPath::PathKind::kBiBFS, pathCtx_->steps.steps());
-  conjunct->setColNames({kPathStr});
+  auto* path = BiBFSShortestPath::make(qctx,
+                                       forward,
+                                       backward,
+                                       pathCtx_->fromVidsVar,
+                                       pathCtx_->toVidsVar,
+                                       pathCtx_->steps.steps());
+  path->setColNames({kPathStr});
 
-  auto* loopCondition = singlePairLoopCondition(pathCtx_->steps.steps(), conjunct->outputVar());
-  auto* loop = Loop::make(qctx, nullptr, conjunct, loopCondition);
+  auto* loopCondition = singlePairLoopCondition(pathCtx_->steps.steps(), path->outputVar());
+  auto* loop = Loop::make(qctx, nullptr, path, loopCondition);
   auto* dc = DataCollect::make(qctx, DataCollect::DCKind::kBFSShortest);
-  dc->setInputVars({conjunct->outputVar()});
+  dc->setInputVars({path->outputVar()});
   dc->addDep(loop);
   dc->setColNames(pathCtx_->colNames);
 
@@ -4,6 +4,8 @@
  */
 #include "graph/planner/ngql/SubgraphPlanner.h"
 
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/VariableExpression.h"
 #include "graph/planner/plan/Algo.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/util/ExpressionUtils.h"
@@ -65,10 +67,20 @@ StatusOr<SubPlan> SubgraphPlanner::nSteps(SubPlan& startVidPlan, const std::stri
   gn->setEdgeProps(std::move(edgeProps).value());
   gn->setInputVar(input);
 
-  auto oneMoreStepOutput = qctx->vctx()->anonVarGen()->getVar();
+  auto resultVar = qctx->vctx()->anonVarGen()->getVar();
   auto loopSteps = qctx->vctx()->anonVarGen()->getVar();
   subgraphCtx_->loopSteps = loopSteps;
-  auto* subgraph = Subgraph::make(qctx, gn, oneMoreStepOutput, loopSteps, steps.steps() + 1);
+  // The vertices requested in the Nth round are at least (N-1) steps away from the start, so
+  // storage could expand locally for the rest steps. A one step subgraph has only the round of
+  // the edges between the neighbors to save, which isn't worth the expansion in one thread
+  if (steps.steps() > 1) {
+    auto* pool = qctx->objPool();
+    gn->setLocalSteps(ArithmeticExpression::makeMinus(
+        pool,
+        ConstantExpression::make(pool, static_cast<int32_t>(steps.steps() + 1)),
+        VariableExpression::make(pool, loopSteps)));
+  }
+  auto* subgraph = Subgraph::make(qctx, gn, resultVar, loopSteps, steps.steps() + 1);
   subgraph->setOutputVar(input);
   subgraph->setColNames({nebula::kVid});
 
@@ -77,7 +89,7 @@ StatusOr<SubPlan> SubgraphPlanner::nSteps(SubPlan& startVidPlan, const std::stri
 
   auto* dc = DataCollect::make(qctx, DataCollect::DCKind::kSubgraph);
   dc->addDep(loop);
-  dc->setInputVars({gn->outputVar(), oneMoreStepOutput});
+  dc->setInputVars({resultVar});
   dc->setColNames({"VERTICES", "EDGES"});
 
   auto* project = Project::make(qctx, dc, subgraphCtx_->yieldExpr);
@@ -34,6 +34,14 @@ std::unique_ptr<PlanNodeDescription> ConjunctPath::explain() const {
   return desc;
 }
 
+std::unique_ptr<PlanNodeDescription> BiBFSShortestPath::explain() const {
+  auto desc = BinaryInputNode::explain();
+  addDescription("leftVidVar", util::toJson(leftVidVar_), desc.get());
+  addDescription("rightVidVar", util::toJson(rightVidVar_), desc.get());
+  addDescription("steps", util::toJson(steps_), desc.get());
+  return desc;
+}
+
 std::unique_ptr<PlanNodeDescription> ProduceAllPaths::explain() const {
   auto desc = SingleDependencyNode::explain();
   addDescription("noloop ", util::toJson(noLoop_), desc.get());
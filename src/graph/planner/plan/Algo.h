@@ -33,6 +33,52 @@ class BFSShortestPath : public SingleInputNode {
       : SingleInputNode(qctx, Kind::kBFSShortest, input) {}
 };
 
+// Bidirectional BFS of the shortest paths between a single pair of vertices. The left/right inputs
+// are the neighbors of the forward/backward frontiers, and the next frontier to expand is written
+// back to leftVidVar/rightVidVar, which are the inputs of the GetNeighbors.
+class BiBFSShortestPath final : public BinaryInputNode {
+ public:
+  static BiBFSShortestPath* make(QueryContext* qctx,
+                                 PlanNode* left,
+                                 PlanNode* right,
+                                 const std::string& leftVidVar,
+                                 const std::string& rightVidVar,
+                                 size_t steps) {
+    return qctx->objPool()->add(
+        new BiBFSShortestPath(qctx, left, right, leftVidVar, rightVidVar, steps));
+  }
+
+  const std::string& leftVidVar() const {
+    return leftVidVar_;
+  }
+
+  const std::string& rightVidVar() const {
+    return rightVidVar_;
+  }
+
+  size_t steps() const {
+    return steps_;
+  }
+
+  std::unique_ptr<PlanNodeDescription> explain() const override;
+
+ private:
+  BiBFSShortestPath(QueryContext* qctx,
+                    PlanNode* left,
+                    PlanNode* right,
+                    const std::string& leftVidVar,
+                    const std::string& rightVidVar,
+                    size_t steps)
+      : BinaryInputNode(qctx, Kind::kBiBFSShortest, left, right),
+        leftVidVar_(leftVidVar),
+        rightVidVar_(rightVidVar),
+        steps_(steps) {}
+
+  std::string leftVidVar_;
+  std::string rightVidVar_;
+  size_t steps_{0};
+};
+
 class ConjunctPath : public BinaryInputNode {
  public:
   enum class PathKind : uint8_t {
@@ -130,19 +176,21 @@ class CartesianProduct final : public SingleDependencyNode {
   std::vector<std::vector<std::string>> allColNames_;
 };
 
+// Expand the subgraph by the GetNeighbors of input in each round of Loop. The vertices to expand
+// in the next round are written to outputVar, and the neighbors of all steps are written to
+// resultVar once the expansion finishes, one step in each result.
 class Subgraph final : public SingleInputNode {
  public:
   static Subgraph* make(QueryContext* qctx,
                         PlanNode* input,
-                        const std::string& oneMoreStepOutput,
+                        const std::string& resultVar,
                         const std::string& currentStepVar,
                         uint32_t steps) {
-    return qctx->objPool()->add(
-        new Subgraph(qctx, input, oneMoreStepOutput, currentStepVar, steps));
+    return qctx->objPool()->add(new Subgraph(qctx, input, resultVar, currentStepVar, steps));
   }
 
-  const std::string& oneMoreStepOutput() const {
-    return oneMoreStepOutput_;
+  const std::string& resultVar() const {
+    return resultVar_;
   }
 
   const std::string& currentStepVar() const {
@@ -156,15 +204,15 @@ class Subgraph final : public SingleInputNode {
  private:
   Subgraph(QueryContext* qctx,
            PlanNode* input,
-           const std::string& oneMoreStepOutput,
+           const std::string& resultVar,
            const std::string& currentStepVar,
            uint32_t steps)
       : SingleInputNode(qctx, Kind::kSubgraph, input),
-        oneMoreStepOutput_(oneMoreStepOutput),
+        resultVar_(resultVar),
         currentStepVar_(currentStepVar),
         steps_(steps) {}
 
-  std::string oneMoreStepOutput_;
+  std::string resultVar_;
   std::string currentStepVar_;
   uint32_t steps_;
 };
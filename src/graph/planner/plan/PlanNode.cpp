@@ -229,6 +229,8 @@ const char* PlanNode::toString(PlanNode::Kind kind) {
       return "GetConfig";
     case Kind::kBFSShortest:
       return "BFSShortest";
+    case Kind::kBiBFSShortest:
+      return "BiBFSShortest";
     case Kind::kProduceSemiShortestPath:
       return "ProduceSemiShortestPath";
     case Kind::kConjunctPath:
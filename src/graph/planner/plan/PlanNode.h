@@ -59,6 +59,7 @@ class PlanNode {
     kDedup,
     kAssign,
     kBFSShortest,
+    kBiBFSShortest,
     kProduceSemiShortestPath,
     kConjunctPath,
     kProduceAllPaths,
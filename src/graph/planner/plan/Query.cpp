@@ -35,9 +35,34 @@ std::unique_ptr<PlanNodeDescription> Explore::explain() const {
   std::string filter = filter_ == nullptr ? "" : filter_->toString();
   addDescription("filter", filter, desc.get());
   addDescription("orderBy", folly::toJson(util::toJson(orderBy_)), desc.get());
+  if (hasAggregate()) {
+    std::vector<std::string> keys, aggs;
+    for (auto* key : groupKeys_) {
+      keys.emplace_back(key->toString());
+    }
+    for (auto* agg : aggregates_) {
+      aggs.emplace_back(agg->toString());
+    }
+    addDescription("groupKeys", folly::join(", ", keys), desc.get());
+    addDescription("aggregates", folly::join(", ", aggs), desc.get());
+  }
   return desc;
 }
 
+storage::cpp2::AggregateSpec Explore::aggregateSpec() const {
+  storage::cpp2::AggregateSpec spec;
+  std::vector<std::string> keys, aggs;
+  for (auto* key : groupKeys_) {
+    keys.emplace_back(key->encode());
+  }
+  for (auto* agg : aggregates_) {
+    aggs.emplace_back(agg->encode());
+  }
+  spec.group_keys_ref() = std::move(keys);
+  spec.aggregates_ref() = std::move(aggs);
+  return spec;
+}
+
 void Explore::cloneMembers(const Explore& e) {
   SingleInputNode::cloneMembers(e);
 
@@ -46,6 +71,8 @@ void Explore::cloneMembers(const Explore& e) {
   limit_ = e.limit_;
   filter_ = e.filter_;
   orderBy_ = e.orderBy_;
+  groupKeys_ = e.groupKeys_;
+  aggregates_ = e.aggregates_;
 }
 
 std::unique_ptr<PlanNodeDescription> GetNeighbors::explain() const {
@@ -61,6 +88,9 @@ std::unique_ptr<PlanNodeDescription> GetNeighbors::explain() const {
       "statProps", statProps_ ? folly::toJson(util::toJson(*statProps_)) : "", desc.get());
   addDescription("exprs", exprs_ ? folly::toJson(util::toJson(*exprs_)) : "", desc.get());
   addDescription("random", util::toJson(random_), desc.get());
+  if (localSteps_ != nullptr) {
+    addDescription("localSteps", localSteps_->toString(), desc.get());
+  }
   return desc;
 }
 
@@ -77,6 +107,7 @@ void GetNeighbors::cloneMembers(const GetNeighbors& g) {
   setEdgeTypes(g.edgeTypes_);
   setEdgeDirection(g.edgeDirection_);
   setRandom(g.random_);
+  setLocalSteps(g.localSteps_ == nullptr ? nullptr : g.localSteps_->clone());
   if (g.vertexProps_) {
     auto vertexProps = *g.vertexProps_;
     auto vertexPropsPtr = std::make_unique<decltype(vertexProps)>(vertexProps);
@@ -84,6 +84,27 @@ class Explore : public SingleInputNode {
     orderBy_ = std::move(orderBy);
   }
 
+  // The group keys and aggregates evaluated by storage, which returns one row per group instead
+  // of the rows explored, in which the keys are followed by the partial aggregates
+  const std::vector<Expression*>& groupKeys() const {
+    return groupKeys_;
+  }
+
+  const std::vector<Expression*>& aggregates() const {
+    return aggregates_;
+  }
+
+  bool hasAggregate() const {
+    return !groupKeys_.empty() || !aggregates_.empty();
+  }
+
+  void setAggregate(std::vector<Expression*> groupKeys, std::vector<Expression*> aggregates) {
+    groupKeys_ = std::move(groupKeys);
+    aggregates_ = std::move(aggregates);
+  }
+
+  storage::cpp2::AggregateSpec aggregateSpec() const;
+
   std::unique_ptr<PlanNodeDescription> explain() const override;
 
  protected:
@@ -130,6 +151,8 @@ class Explore : public SingleInputNode {
   Expression* limit_{nullptr};
   Expression* filter_{nullptr};
   std::vector<storage::cpp2::OrderBy> orderBy_;
+  std::vector<Expression*> groupKeys_;
+  std::vector<Expression*> aggregates_;
 };
 
 using VertexProp = nebula::storage::cpp2::VertexProp;
@@ -241,6 +264,23 @@ class GetNeighbors : public Explore {
     random_ = random;
   }
 
+  // Get the steps which storage could expand locally in runtime
+  int32_t localSteps(QueryExpressionContext& ctx) const {
+    if (localSteps_ == nullptr) {
+      return 0;
+    }
+    auto steps = localSteps_->eval(ctx);
+    return steps.isInt() ? static_cast<int32_t>(steps.getInt()) : 0;
+  }
+
+  Expression* localStepsExpr() const {
+    return localSteps_;
+  }
+
+  void setLocalSteps(Expression* steps) {
+    localSteps_ = steps;
+  }
+
   PlanNode* clone() const override;
   std::unique_ptr<PlanNodeDescription> explain() const override;
 
@@ -261,6 +301,8 @@ class GetNeighbors : public Explore {
   std::unique_ptr<std::vector<StatProp>> statProps_;
   std::unique_ptr<std::vector<Expr>> exprs_;
   bool random_{false};
+  // Use expression to get the steps in runtime, since it's decided by the current step of Loop
+  Expression* localSteps_{nullptr};
 };
 
 /**
@@ -72,6 +72,34 @@ DEFINE_bool(enable_experimental_feature, false, "Whether to enable experimental
 
 DEFINE_int32(num_rows_to_check_memory, 1024, "number rows to check memory");
 
+DEFINE_bool(enable_neighbor_cache, false, "Whether to cache the neighbors got from storage");
+DEFINE_string(neighbor_cache_spaces,
+              "",
+              "The names of spaces to cache the neighbors, separated by comma, empty for all");
+DEFINE_int64(neighbor_cache_capacity_bytes,
+             64 * 1024 * 1024,
+             "The max bytes of the neighbors cached, estimated by the rows and their keys");
+DEFINE_int64(neighbor_cache_ttl_ms,
+             1000,
+             "How long the cached neighbors could be read, the writes of other graphd are "
+             "visible after it");
+
+DEFINE_int32(max_cursors_per_session,
+             16,
+             "The max number of cursors kept in a session, for the rows not fetched by client yet");
+DEFINE_int32(cursor_idle_timeout_secs,
+             600,
+             "The cursor not fetched for so long is released by the session reclaim, or once "
+             "a new cursor is needed");
+
+DEFINE_int64(query_memory_quota_bytes,
+             0,
+             "The max memory of the results held by a query, the query fails once it exceeds the "
+             "quota, 0 for no quota");
+DEFINE_int64(session_memory_quota_bytes,
+             0,
+             "The max memory of the results held by all queries of a session, 0 for no quota");
+
 // Sanity-checking Flag Values
 static bool ValidateSessIdleTimeout(const char* flagname, int32_t value) {
   // The max timeout is 604800 seconds(a week)
@@ -59,4 +59,15 @@ DECLARE_string(client_white_list);
 
 DECLARE_int32(num_rows_to_check_memory);
 
+DECLARE_bool(enable_neighbor_cache);
+DECLARE_string(neighbor_cache_spaces);
+DECLARE_int64(neighbor_cache_capacity_bytes);
+DECLARE_int64(neighbor_cache_ttl_ms);
+
+DECLARE_int32(max_cursors_per_session);
+DECLARE_int32(cursor_idle_timeout_secs);
+
+DECLARE_int64(query_memory_quota_bytes);
+DECLARE_int64(session_memory_quota_bytes);
+
 #endif  // GRAPH_GRAPHFLAGS_H_
@@ -131,10 +131,68 @@ folly::Future<ExecutionResponse> GraphService::future_executeWithParameter(
     int64_t sessionId,
     const std::string& query,
     const std::unordered_map<std::string, Value>& parameterMap) {
+  return executeQuery(sessionId, query, parameterMap, 0);
+}
+
+folly::Future<ExecutionResponse> GraphService::future_executeWithCursor(
+    int64_t sessionId,
+    const std::string& query,
+    const std::unordered_map<std::string, Value>& parameterMap,
+    int32_t fetchSize) {
+  return executeQuery(sessionId, query, parameterMap, fetchSize > 0 ? fetchSize : 0);
+}
+
+folly::Future<ExecutionResponse> GraphService::future_fetch(int64_t sessionId, int64_t cursorId) {
+  auto ctx = std::make_unique<RequestContext<ExecutionResponse>>();
+  auto future = ctx->future();
+  auto cb = [sessionId, cursorId, ctx = std::move(ctx)](
+                StatusOr<std::shared_ptr<ClientSession>> ret) mutable {
+    if (!ret.ok() || ret.value() == nullptr) {
+      ctx->resp().errorCode = ErrorCode::E_SESSION_INVALID;
+      ctx->resp().errorMsg.reset(
+          new std::string(folly::stringPrintf("SessionId[%ld] does not exist", sessionId)));
+      return ctx->finish();
+    }
+    ctx->setSession(std::move(ret).value());
+    bool hasMore = false;
+    auto data = ctx->session()->fetchCursor(cursorId, &hasMore);
+    if (!data.ok()) {
+      ctx->resp().errorCode = ErrorCode::E_EXECUTION_ERROR;
+      ctx->resp().errorMsg.reset(new std::string(data.status().toString()));
+      return ctx->finish();
+    }
+    ctx->resp().data = std::make_unique<DataSet>(std::move(data).value());
+    ctx->resp().spaceName = std::make_unique<std::string>(ctx->session()->space().name);
+    if (hasMore) {
+      ctx->resp().cursorId = std::make_unique<int64_t>(cursorId);
+    }
+    ctx->resp().latencyInUs = ctx->duration().elapsedInUSec();
+    return ctx->finish();
+  };
+  sessionManager_->findSession(sessionId, getThreadManager()).thenValue(std::move(cb));
+  return future;
+}
+
+void GraphService::closeCursor(int64_t sessionId, int64_t cursorId) {
+  VLOG(2) << "Close cursor " << cursorId << " of session " << sessionId;
+  sessionManager_->findSession(sessionId, getThreadManager())
+      .thenValue([cursorId](StatusOr<std::shared_ptr<ClientSession>> ret) {
+        if (ret.ok() && ret.value() != nullptr) {
+          ret.value()->closeCursor(cursorId);
+        }
+      });
+}
+
+folly::Future<ExecutionResponse> GraphService::executeQuery(
+    int64_t sessionId,
+    const std::string& query,
+    const std::unordered_map<std::string, Value>& parameterMap,
+    size_t fetchSize) {
   auto ctx = std::make_unique<RequestContext<ExecutionResponse>>();
   ctx->setQuery(query);
   ctx->setRunner(getThreadManager());
   ctx->setSessionMgr(sessionManager_.get());
+  ctx->setFetchSize(fetchSize);
   auto future = ctx->future();
   // When the sessionId is 0, it means the clients to ping the connection is ok
   if (sessionId == 0) {
@@ -48,6 +48,16 @@ class GraphService final : public cpp2::GraphServiceSvIf {
   folly::Future<std::string> future_executeJson(int64_t sessionId,
                                                 const std::string& stmt) override;
 
+  folly::Future<ExecutionResponse> future_executeWithCursor(
+      int64_t sessionId,
+      const std::string& stmt,
+      const std::unordered_map<std::string, Value>& parameterMap,
+      int32_t fetchSize) override;
+
+  folly::Future<ExecutionResponse> future_fetch(int64_t sessionId, int64_t cursorId) override;
+
+  void closeCursor(int64_t sessionId, int64_t cursorId) override;
+
   folly::Future<cpp2::VerifyClientVersionResp> future_verifyClientVersion(
       const cpp2::VerifyClientVersionReq& req) override;
 
@@ -56,6 +66,13 @@ class GraphService final : public cpp2::GraphServiceSvIf {
  private:
   Status auth(const std::string& username, const std::string& password);
 
+  // Rows beyond fetchSize are kept in session for the cursor, 0 to return all rows
+  folly::Future<ExecutionResponse> executeQuery(
+      int64_t sessionId,
+      const std::string& stmt,
+      const std::unordered_map<std::string, Value>& parameterMap,
+      size_t fetchSize);
+
   std::unique_ptr<GraphSessionManager> sessionManager_;
   std::unique_ptr<QueryEngine> queryEngine_;
 };
@@ -221,6 +221,22 @@ void QueryInstance::fillRespData(ExecutionResponse *resp) {
   // fill dataset
   auto result = value.moveDataSet();
   if (!result.colNames.empty()) {
+    auto fetchSize = qctx_->rctx()->fetchSize();
+    if (fetchSize > 0 && result.rows.size() > fetchSize) {
+      // Keep the rest rows in session, and release them along with fetching
+      std::deque<Row> rest(std::make_move_iterator(result.rows.begin() + fetchSize),
+                           std::make_move_iterator(result.rows.end()));
+      result.rows.erase(result.rows.begin() + fetchSize, result.rows.end());
+      result.rows.shrink_to_fit();
+      auto *session = qctx_->rctx()->session();
+      auto cursor = session->addCursor(result.colNames, std::move(rest), fetchSize);
+      if (!cursor.ok()) {
+        resp->errorCode = ErrorCode::E_EXECUTION_ERROR;
+        resp->errorMsg = std::make_unique<std::string>(cursor.status().toString());
+        return;
+      }
+      resp->cursorId = std::make_unique<int64_t>(cursor.value());
+    }
     resp->data = std::make_unique<DataSet>(std::move(result));
   } else {
     resp->errorCode = ErrorCode::E_EXECUTION_ERROR;
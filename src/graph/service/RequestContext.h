@@ -98,6 +98,15 @@ class RequestContext final : public boost::noncopyable, public cpp::NonMovable {
     return parameterMap_;
   }
 
+  void setFetchSize(size_t fetchSize) {
+    fetchSize_ = fetchSize;
+  }
+
+  // The max number of rows in response, the rest are fetched by cursor, 0 for all rows
+  size_t fetchSize() const {
+    return fetchSize_;
+  }
+
  private:
   time::Duration duration_;
   std::string query_;
@@ -107,6 +116,7 @@ class RequestContext final : public boost::noncopyable, public cpp::NonMovable {
   folly::Executor* runner_{nullptr};
   GraphSessionManager* sessionMgr_{nullptr};
   std::unordered_map<std::string, Value> parameterMap_;
+  size_t fetchSize_{0};
 };
 
 }  // namespace graph
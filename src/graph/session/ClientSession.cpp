@@ -8,12 +8,14 @@
 #include "common/stats/StatsManager.h"
 #include "common/time/WallClock.h"
 #include "graph/context/QueryContext.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/stats/GraphStats.h"
 
 namespace nebula {
 namespace graph {
 
-ClientSession::ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient) {
+ClientSession::ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient)
+    : memTracker_(FLAGS_session_memory_quota_bytes) {
   session_ = std::move(session);
   metaClient_ = metaClient;
 }
@@ -105,5 +107,126 @@ void ClientSession::markAllQueryKilled() {
         contexts_.size());
   }
 }
+
+namespace {
+
+// The max number of rows read to estimate the size of a row in cursor
+constexpr size_t kCursorSampleRows = 32;
+
+int64_t estimateRowSize(const std::deque<Row>& rows) {
+  if (rows.empty()) {
+    return 0;
+  }
+  auto step = std::max<size_t>(rows.size() / kCursorSampleRows, 1);
+  int64_t sampled = 0;
+  size_t num = 0;
+  for (size_t i = 0; i < rows.size(); i += step) {
+    sampled += sizeof(Row);
+    for (const auto& val : rows[i].values) {
+      sampled += ExecutionContext::estimateSize(val);
+    }
+    num++;
+  }
+  return sampled / static_cast<int64_t>(num);
+}
+
+}  // namespace
+
+StatusOr<int64_t> ClientSession::addCursor(std::vector<std::string> colNames,
+                                           std::deque<Row> rows,
+                                           size_t fetchSize) {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  if (cursors_.size() >= static_cast<size_t>(FLAGS_max_cursors_per_session)) {
+    // Release the cursors abandoned by client
+    reclaimIdleCursorsLocked();
+    if (cursors_.size() >= static_cast<size_t>(FLAGS_max_cursors_per_session)) {
+      return Status::Error("Too many cursors in the session, the max is %d",
+                           FLAGS_max_cursors_per_session);
+    }
+  }
+  auto rowSize = estimateRowSize(rows);
+  auto bytes = rowSize * static_cast<int64_t>(rows.size());
+  memTracker_.consume(bytes);
+  if (memTracker_.exceeded() != nullptr) {
+    memTracker_.release(bytes);
+    stats::StatsManager::addValue(kNumQueriesHitMemoryQuota);
+    return Status::Error("Used memory(%ld bytes) of the session exceeds the quota(%ld bytes)",
+                         memTracker_.used() + bytes,
+                         memTracker_.limit());
+  }
+  auto cursorId = nextCursorId_++;
+  auto& cursor = cursors_[cursorId];
+  cursor.colNames = std::move(colNames);
+  cursor.rows = std::move(rows);
+  cursor.fetchSize = fetchSize;
+  cursor.rowSize = rowSize;
+  return cursorId;
+}
+
+StatusOr<DataSet> ClientSession::fetchCursor(int64_t cursorId, bool* hasMore) {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  auto it = cursors_.find(cursorId);
+  if (it == cursors_.end()) {
+    return Status::Error("Cursor %ld does not exist", cursorId);
+  }
+  auto& cursor = it->second;
+  DataSet ds(cursor.colNames);
+  auto size = std::min(cursor.fetchSize, cursor.rows.size());
+  ds.rows.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    ds.rows.emplace_back(std::move(cursor.rows.front()));
+    cursor.rows.pop_front();
+  }
+  // The fetched rows are owned by the response from now on
+  memTracker_.release(cursor.rowSize * static_cast<int64_t>(size));
+  cursor.idleDuration.reset();
+  *hasMore = !cursor.rows.empty();
+  if (!*hasMore) {
+    cursors_.erase(it);
+  }
+  return ds;
+}
+
+void ClientSession::closeCursor(int64_t cursorId) {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  auto it = cursors_.find(cursorId);
+  if (it != cursors_.end()) {
+    eraseCursorLocked(it);
+  }
+}
+
+void ClientSession::reclaimIdleCursors() {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  reclaimIdleCursorsLocked();
+}
+
+void ClientSession::closeAllCursors() {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  for (auto it = cursors_.begin(); it != cursors_.end();) {
+    it = eraseCursorLocked(it);
+  }
+}
+
+size_t ClientSession::numCursors() {
+  std::lock_guard<std::mutex> guard(cursorLock_);
+  return cursors_.size();
+}
+
+void ClientSession::reclaimIdleCursorsLocked() {
+  for (auto it = cursors_.begin(); it != cursors_.end();) {
+    if (it->second.idleDuration.elapsedInSec() >
+        static_cast<uint64_t>(FLAGS_cursor_idle_timeout_secs)) {
+      it = eraseCursorLocked(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+ClientSession::CursorMap::iterator ClientSession::eraseCursorLocked(CursorMap::iterator it) {
+  memTracker_.release(it->second.rowSize * static_cast<int64_t>(it->second.rows.size()));
+  return cursors_.erase(it);
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -5,7 +5,11 @@
 #ifndef GRAPH_SESSION_CLIENTSESSION_H_
 #define GRAPH_SESSION_CLIENTSESSION_H_
 
+#include <deque>
+
 #include "clients/meta/MetaClient.h"
+#include "common/datatypes/DataSet.h"
+#include "common/memory/MemoryTracker.h"
 #include "common/time/Duration.h"
 #include "interface/gen-cpp2/meta_types.h"
 
@@ -139,11 +143,51 @@ class ClientSession final {
 
   void markAllQueryKilled();
 
+  // Keep the rows not returned to client yet, which are fetched by the cursor at most fetchSize
+  // rows each time. Fail if there are too many cursors in the session.
+  StatusOr<int64_t> addCursor(std::vector<std::string> colNames,
+                              std::deque<Row> rows,
+                              size_t fetchSize);
+
+  // Fetch the next rows of cursor, the cursor is released once all its rows are fetched
+  StatusOr<DataSet> fetchCursor(int64_t cursorId, bool* hasMore);
+
+  void closeCursor(int64_t cursorId);
+
+  // Release the cursors not fetched for cursor_idle_timeout_secs, called by the session reclaim
+  void reclaimIdleCursors();
+
+  // Release all cursors once the session is closed, the requests running may still hold it
+  void closeAllCursors();
+
+  size_t numCursors();
+
+  // The memory used by all queries of the session
+  MemoryTracker* memTracker() {
+    return &memTracker_;
+  }
+
  private:
+  struct Cursor {
+    std::vector<std::string> colNames;
+    // Popped once fetched, so the memory is released along with fetching
+    std::deque<Row> rows;
+    size_t fetchSize{0};
+    // The estimated bytes of a row, charged to the session memory tracker for each row kept
+    int64_t rowSize{0};
+    time::Duration idleDuration;
+  };
+  using CursorMap = std::unordered_map<int64_t, Cursor>;
+
   ClientSession() = default;
 
   explicit ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient);
 
+  void reclaimIdleCursorsLocked();
+
+  // Release the rows of cursor from the memory tracker and erase it
+  CursorMap::iterator eraseCursorLocked(CursorMap::iterator it);
+
  private:
   SpaceInfo space_;
   time::Duration idleDuration_;
@@ -157,6 +201,12 @@ class ClientSession final {
    */
   std::unordered_map<GraphSpaceID, meta::cpp2::RoleType> roles_;
   std::unordered_map<ExecutionPlanID, QueryContext*> contexts_;
+
+  std::mutex cursorLock_;
+  int64_t nextCursorId_{1};
+  CursorMap cursors_;
+
+  MemoryTracker memTracker_;
 };
 
 }  // namespace graph
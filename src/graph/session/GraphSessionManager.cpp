@@ -144,6 +144,7 @@ void GraphSessionManager::removeSession(SessionID id) {
   }
 
   iter->second->markAllQueryKilled();
+  iter->second->closeAllCursors();
   auto resp = metaClient_->removeSession(id).get();
   if (!resp.ok()) {
     // it will delete by reclaim
@@ -181,12 +182,15 @@ void GraphSessionManager::reclaimExpiredSessions() {
     int32_t idleSecs = iter->second->idleSeconds();
     VLOG(2) << "SessionId: " << iter->first << ", idleSecs: " << idleSecs;
     if (idleSecs < FLAGS_session_idle_timeout_secs) {
+      // The session is alive, but some of its cursors may be abandoned by client
+      iter->second->reclaimIdleCursors();
       ++iter;
       continue;
     }
     FLOG_INFO("ClientSession %ld has expired", iter->first);
 
     iter->second->markAllQueryKilled();
+    iter->second->closeAllCursors();
     auto resp = metaClient_->removeSession(iter->first).get();
     if (!resp.ok()) {
       // TODO: Handle cases where the delete client failed
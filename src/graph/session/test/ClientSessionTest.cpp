@@ -0,0 +1,144 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/service/GraphFlags.h"
+#include "graph/session/ClientSession.h"
+
+namespace nebula {
+namespace graph {
+
+class ClientSessionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    meta::cpp2::Session session;
+    session.session_id_ref() = 1;
+    session.user_name_ref() = "root";
+    session_ = ClientSession::create(std::move(session), nullptr);
+  }
+
+  static std::deque<Row> makeRows(int64_t num) {
+    std::deque<Row> rows;
+    for (int64_t i = 0; i < num; ++i) {
+      rows.emplace_back(Row({i, folly::stringPrintf("row_%ld", i)}));
+    }
+    return rows;
+  }
+
+  // Fetch all rows of cursor, return the size of each chunk
+  std::vector<size_t> fetchAll(int64_t cursorId) {
+    std::vector<size_t> chunks;
+    bool hasMore = true;
+    int64_t next = 0;
+    while (hasMore) {
+      auto ds = session_->fetchCursor(cursorId, &hasMore);
+      EXPECT_TRUE(ds.ok());
+      if (!ds.ok()) {
+        break;
+      }
+      EXPECT_EQ(std::vector<std::string>({"id", "name"}), ds.value().colNames);
+      for (const auto& row : ds.value().rows) {
+        EXPECT_EQ(Value(next++), row.values[0]);
+      }
+      chunks.emplace_back(ds.value().rows.size());
+    }
+    return chunks;
+  }
+
+  std::shared_ptr<ClientSession> session_;
+};
+
+TEST_F(ClientSessionTest, FetchInChunks) {
+  auto cursor = session_->addCursor({"id", "name"}, makeRows(5), 2);
+  ASSERT_TRUE(cursor.ok());
+  EXPECT_EQ(1, session_->numCursors());
+  auto used = session_->memTracker()->used();
+  EXPECT_GT(used, 0);
+
+  bool hasMore = false;
+  auto ds = session_->fetchCursor(cursor.value(), &hasMore);
+  ASSERT_TRUE(ds.ok());
+  EXPECT_TRUE(hasMore);
+  EXPECT_EQ(2, ds.value().rows.size());
+  // The fetched rows are released from the session
+  EXPECT_LT(session_->memTracker()->used(), used);
+
+  // The last chunk has no more rows, the cursor is released along with it
+  EXPECT_EQ(std::vector<size_t>({2, 1}), fetchAll(cursor.value()));
+  EXPECT_EQ(0, session_->numCursors());
+  EXPECT_EQ(0, session_->memTracker()->used());
+  EXPECT_FALSE(session_->fetchCursor(cursor.value(), &hasMore).ok());
+}
+
+TEST_F(ClientSessionTest, ExactChunks) {
+  auto cursor = session_->addCursor({"id", "name"}, makeRows(4), 2);
+  ASSERT_TRUE(cursor.ok());
+  EXPECT_EQ(std::vector<size_t>({2, 2}), fetchAll(cursor.value()));
+  EXPECT_EQ(0, session_->numCursors());
+}
+
+TEST_F(ClientSessionTest, MaxCursors) {
+  FLAGS_max_cursors_per_session = 2;
+  auto first = session_->addCursor({"id", "name"}, makeRows(3), 1);
+  ASSERT_TRUE(first.ok());
+  ASSERT_TRUE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  auto used = session_->memTracker()->used();
+  EXPECT_FALSE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  EXPECT_EQ(used, session_->memTracker()->used());
+
+  session_->closeCursor(first.value());
+  EXPECT_EQ(1, session_->numCursors());
+  EXPECT_TRUE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  FLAGS_max_cursors_per_session = 16;
+}
+
+TEST_F(ClientSessionTest, ReclaimIdleCursors) {
+  FLAGS_max_cursors_per_session = 1;
+  FLAGS_cursor_idle_timeout_secs = 1;
+  ASSERT_TRUE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  session_->reclaimIdleCursors();
+  EXPECT_EQ(1, session_->numCursors());
+  EXPECT_FALSE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+
+  sleep(2);
+  // The abandoned cursor is reclaimed once a new cursor is needed
+  ASSERT_TRUE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  EXPECT_EQ(1, session_->numCursors());
+
+  sleep(2);
+  // And by the session reclaim
+  session_->reclaimIdleCursors();
+  EXPECT_EQ(0, session_->numCursors());
+  EXPECT_EQ(0, session_->memTracker()->used());
+  FLAGS_max_cursors_per_session = 16;
+  FLAGS_cursor_idle_timeout_secs = 600;
+}
+
+TEST_F(ClientSessionTest, CloseSession) {
+  ASSERT_TRUE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  ASSERT_TRUE(session_->addCursor({"id", "name"}, makeRows(3), 1).ok());
+  EXPECT_GT(session_->memTracker()->used(), 0);
+  session_->closeAllCursors();
+  EXPECT_EQ(0, session_->numCursors());
+  EXPECT_EQ(0, session_->memTracker()->used());
+}
+
+TEST_F(ClientSessionTest, MemoryQuota) {
+  FLAGS_session_memory_quota_bytes = 1024;
+  meta::cpp2::Session meta;
+  meta.session_id_ref() = 2;
+  auto session = ClientSession::create(std::move(meta), nullptr);
+  FLAGS_session_memory_quota_bytes = 0;
+
+  auto cursor = session->addCursor({"id", "name"}, makeRows(1000), 1);
+  EXPECT_FALSE(cursor.ok());
+  EXPECT_EQ(0, session->numCursors());
+  EXPECT_EQ(0, session->memTracker()->used());
+  EXPECT_TRUE(session->addCursor({"id", "name"}, makeRows(2), 1).ok());
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -27,12 +27,15 @@ stats::CounterId kQueryLatencyUs;
 stats::CounterId kSlowQueryLatencyUs;
 stats::CounterId kNumKilledQueries;
 stats::CounterId kNumQueriesHitMemoryWatermark;
+stats::CounterId kNumQueriesHitMemoryQuota;
 
 stats::CounterId kOptimizerLatencyUs;
 
 stats::CounterId kNumAggregateExecutors;
 stats::CounterId kNumSortExecutors;
 stats::CounterId kNumIndexScanExecutors;
+stats::CounterId kNumNeighborCacheHits;
+stats::CounterId kNumNeighborCacheMisses;
 
 stats::CounterId kNumOpenedSessions;
 stats::CounterId kNumAuthFailedSessions;
@@ -56,6 +59,8 @@ void initGraphStats() {
   kNumKilledQueries = stats::StatsManager::registerStats("num_killed_queries", "rate, sum");
   kNumQueriesHitMemoryWatermark =
       stats::StatsManager::registerStats("num_queries_hit_memory_watermark", "rate, sum");
+  kNumQueriesHitMemoryQuota =
+      stats::StatsManager::registerStats("num_queries_hit_memory_quota", "rate, sum");
 
   kOptimizerLatencyUs = stats::StatsManager::registerHisto(
       "optimizer_latency_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
@@ -65,6 +70,10 @@ void initGraphStats() {
   kNumSortExecutors = stats::StatsManager::registerStats("num_sort_executors", "rate, sum");
   kNumIndexScanExecutors =
       stats::StatsManager::registerStats("num_indexscan_executors", "rate, sum");
+  kNumNeighborCacheHits =
+      stats::StatsManager::registerStats("num_neighbor_cache_hits", "rate, sum");
+  kNumNeighborCacheMisses =
+      stats::StatsManager::registerStats("num_neighbor_cache_misses", "rate, sum");
 
   kNumOpenedSessions = stats::StatsManager::registerStats("num_opened_sessions", "rate, sum");
   kNumAuthFailedSessions =
@@ -25,6 +25,7 @@ extern stats::CounterId kQueryLatencyUs;
 extern stats::CounterId kSlowQueryLatencyUs;
 extern stats::CounterId kNumKilledQueries;
 extern stats::CounterId kNumQueriesHitMemoryWatermark;
+extern stats::CounterId kNumQueriesHitMemoryQuota;
 
 extern stats::CounterId kOptimizerLatencyUs;
 
@@ -32,6 +33,8 @@ extern stats::CounterId kOptimizerLatencyUs;
 extern stats::CounterId kNumAggregateExecutors;
 extern stats::CounterId kNumSortExecutors;
 extern stats::CounterId kNumIndexScanExecutors;
+extern stats::CounterId kNumNeighborCacheHits;
+extern stats::CounterId kNumNeighborCacheMisses;
 
 // Server client traffic
 // extern stats::CounterId kReceivedBytes;
@@ -260,6 +260,27 @@ folly::dynamic toJson(const storage::cpp2::IndexQueryContext &iqc) {
       iqc.get_filter().empty() ? "" : Expression::decode(&tempPool, iqc.get_filter())->toString();
   obj.insert("filter", filter);
   obj.insert("columnHints", toJson(iqc.get_column_hints()));
+  if (iqc.get_skip_scan()) {
+    obj.insert("skipScan", true);
+  }
+  if (iqc.intersect_indexes_ref().has_value()) {
+    folly::dynamic intersects = folly::dynamic::array();
+    for (const auto &index : *iqc.intersect_indexes_ref()) {
+      folly::dynamic intersect = folly::dynamic::object();
+      intersect.insert("index_id", index.get_index_id());
+      intersect.insert("columnHints", toJson(index.get_column_hints()));
+      intersects.push_back(std::move(intersect));
+    }
+    obj.insert("intersectIndexes", std::move(intersects));
+  }
+  if (iqc.nearest_neighbors_ref().has_value()) {
+    const auto &nearest = *iqc.nearest_neighbors_ref();
+    folly::dynamic knn = folly::dynamic::object();
+    knn.insert("column", nearest.get_column_name());
+    knn.insert("point", nearest.get_point().asWKT());
+    knn.insert("k", nearest.get_k());
+    obj.insert("nearestNeighbors", std::move(knn));
+  }
   return obj;
 }
 
@@ -277,6 +298,9 @@ folly::dynamic toJson(const storage::cpp2::IndexColumnHint &hints) {
   obj.insert("includeBegin", includeBegin);
   auto includeEnd = toJson(hints.get_include_end());
   obj.insert("includeEnd", includeEnd);
+  if (hints.in_values_ref().has_value()) {
+    obj.insert("inValues", toJson(*hints.in_values_ref()));
+  }
   return obj;
 }
 
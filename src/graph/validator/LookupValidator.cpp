@@ -226,16 +226,22 @@ StatusOr<Expression*> LookupValidator::checkFilter(Expression* expr) {
     NG_RETURN_IF_ERROR(checkGeoPredicate(expr));
     return rewriteGeoPredicate(expr);
   } else if (expr->isRelExpr()) {
-    // Only starts with can be pushed down as a range scan, so forbid other string-related relExpr
-    if (expr->kind() == ExprKind::kRelREG || expr->kind() == ExprKind::kContains ||
-        expr->kind() == ExprKind::kNotContains || expr->kind() == ExprKind::kEndsWith ||
-        expr->kind() == ExprKind::kNotStartsWith || expr->kind() == ExprKind::kNotEndsWith) {
+    // Only starts with and the regex with a literal prefix can be pushed down as a range scan, so
+    // forbid other string-related relExpr
+    if (expr->kind() == ExprKind::kContains || expr->kind() == ExprKind::kNotContains ||
+        expr->kind() == ExprKind::kEndsWith || expr->kind() == ExprKind::kNotStartsWith ||
+        expr->kind() == ExprKind::kNotEndsWith) {
       return Status::SemanticError(
           "Expression %s is not supported, please use full-text index as an optimal solution",
           expr->toString().c_str());
     }
 
     auto relExpr = static_cast<RelationalExpression*>(expr);
+    // The pattern of regex could not be swapped to the left
+    if (expr->kind() == ExprKind::kRelREG &&
+        relExpr->right()->kind() == ExprKind::kLabelAttribute) {
+      return Status::SemanticError("Expression %s not supported yet", expr->toString().c_str());
+    }
     NG_RETURN_IF_ERROR(checkRelExpr(relExpr));
     return rewriteRelExpr(relExpr);
   }
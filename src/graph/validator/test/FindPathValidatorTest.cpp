@@ -61,9 +61,7 @@ TEST_F(FindPathValidatorTest, SinglePairPath) {
         PK::kDataCollect,
         PK::kLoop,
         PK::kStart,
-        PK::kConjunctPath,
-        PK::kBFSShortest,
-        PK::kBFSShortest,
+        PK::kBiBFSShortest,
         PK::kGetNeighbors,
         PK::kGetNeighbors,
         PK::kPassThrough,
@@ -78,9 +76,7 @@ TEST_F(FindPathValidatorTest, SinglePairPath) {
         PK::kDataCollect,
         PK::kLoop,
         PK::kStart,
-        PK::kConjunctPath,
-        PK::kBFSShortest,
-        PK::kBFSShortest,
+        PK::kBiBFSShortest,
         PK::kGetNeighbors,
         PK::kGetNeighbors,
         PK::kPassThrough,
@@ -396,9 +392,7 @@ TEST_F(FindPathValidatorTest, PathWithFilter) {
         PK::kDataCollect,
         PK::kLoop,
         PK::kStart,
-        PK::kConjunctPath,
-        PK::kBFSShortest,
-        PK::kBFSShortest,
+        PK::kBiBFSShortest,
         PK::kFilter,
         PK::kFilter,
         PK::kGetNeighbors,
@@ -457,6 +457,9 @@ enum ErrorCode {
     // transaction
     E_OUTDATED_LOCK                   = -3047,
 
+    // the snapshot pinned by scan has been released
+    E_SCAN_SNAPSHOT_EXPIRED           = -3048,
+
     // task manager failed
     E_INVALID_TASK_PARA               = -3051,
     E_USER_CANCEL                     = -3052,
@@ -86,6 +86,7 @@ struct ExecutionResponse {
     5: optional binary                  error_msg;
     6: optional PlanDescription         plan_desc;
     7: optional binary                  comment;        // Supplementary instruction
+    8: optional i64                     cursor_id;      // Set if more rows could be fetched
 } (cpp.type = "nebula::ExecutionResponse", cpp.noncopyable)
 
 
@@ -119,6 +120,13 @@ service GraphService {
     // Same as execute(), but response will be a json string
     binary executeJson(1: i64 sessionId, 2: binary stmt)
     binary executeJsonWithParameter(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap)
+
+    // Same as executeWithParameter(), but at most fetchSize rows are returned, the rest are kept
+    // in graphd and fetched by the cursor in response, until the cursor is not returned any more
+    ExecutionResponse executeWithCursor(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap, 4: i32 fetchSize)
+    ExecutionResponse fetch(1: i64 sessionId, 2: i64 cursorId)
+    // Release the rows not fetched yet
+    oneway void closeCursor(1: i64 sessionId, 2: i64 cursorId)
     
     VerifyClientVersionResp verifyClientVersion(1: VerifyClientVersionReq req)
 }
@@ -544,6 +544,20 @@ struct PartitionList {
     1: list<common.PartitionID> part_list;
 }
 
+// Load of a part observed by one storage host, used by data balance
+struct PartLoad {
+    1: common.PartitionID part_id,
+    // approximate bytes of the data in engine
+    2: i64                disk_size,
+    // requests per second served by this host since the last heartbeat
+    3: i64                read_qps,
+    4: i64                write_qps,
+}
+
+struct PartLoadList {
+    1: list<PartLoad> part_loads;
+}
+
 struct HBReq {
     1: HostRole                 role,
     2: common.HostAddr          host,
@@ -557,6 +571,8 @@ struct HBReq {
     7: optional common.DirInfo  dir,
     // version of binary
     8: optional binary          version,
+    9: optional map<common.GraphSpaceID, PartLoadList>
+        (cpp.template = "std::unordered_map") part_loads,
 }
 
 // service(agent/metad/storaged/graphd) info
@@ -79,6 +79,15 @@ struct Expr {
 }
 
 
+// Define a partial aggregation, which is merged by the caller
+struct AggregateSpec {
+    // The expressions to group by, the rows are aggregated into one group if not given
+    1: list<binary>     group_keys,
+    // The aggregate expressions, only count, sum, max and min without distinct are supported
+    2: list<binary>     aggregates,
+}
+
+
 // Define an edge property
 struct EdgeProp {
     // A valid edge type
@@ -150,7 +159,9 @@ struct TraverseSpec {
     6: optional list<EdgeProp>                  edge_props,
     // A list of expressions which are evaluated on each edge
     7: optional list<Expr>                      expressions,
-    // A list of expressions used to sort the result
+    // A list of expressions used to sort the result. Combined with "limit", the top N edges
+    //   of each vertex are returned instead of the first N ones, and the edges which could not
+    //   be in the top N of the whole request may be dropped as well
     8: optional list<OrderBy>                   order_by,
     // Combined with "limit", the random flag makes the result of each query different
     9: optional bool                            random,
@@ -158,6 +169,15 @@ struct TraverseSpec {
     10: optional i64                            limit,
     // If provided, only the rows satisfied the given expression will be returned
     11: optional binary                         filter,
+    // If provided, the neighbors in the parts led by the same host will be expanded locally
+    //   for at most local_steps more steps. Each vertex is returned at most once in one
+    //   request, the neighbors of the last step, in the other hosts or beyond the limit of
+    //   storage are left to the caller. It's ignored if storage queries the parts concurrently
+    12: optional i32                            local_steps,
+    // If provided, the edges are aggregated instead of returned. Each row of the result is a
+    //   group of one part, in which the values of group keys are followed by the partial
+    //   results of aggregates. Conflicts with local_steps
+    13: optional AggregateSpec                  aggregate,
 }
 
 
@@ -229,6 +249,9 @@ struct GetNeighborsResponse {
     //
     //   "_expr:<alias1>:<alias2>:..."
     //
+    // If TraverseSpec::aggregate is given, the dataset is the groups instead, whose columns
+    //   are the group keys followed by the aggregates
+    //
     2: optional common.DataSet vertices,
 }
 /*
@@ -515,6 +538,22 @@ struct IndexColumnHint {
     // and include_end is similar
     5: bool                     include_begin = true,
     6: bool                     include_end = false,
+    // If set, scan_type must be PREFIX and the column equals any of the values, i.e. an IN list.
+    // begin_value is ignored, and a prefix or range is scanned for each of the values
+    7: optional list<common.Value> in_values,
+}
+
+// Another index of the same tag or edge scanned along with the one of IndexQueryContext
+struct IntersectIndex {
+    1: common.IndexID           index_id,
+    2: list<IndexColumnHint>    column_hints,
+}
+
+// The k nearest neighbors of a point on the geography index of points
+struct NearestNeighbors {
+    1: binary                   column_name,
+    2: common.Geography         point,
+    3: i64                      k,
 }
 
 struct IndexQueryContext {
@@ -527,6 +566,15 @@ struct IndexQueryContext {
     //    to be empty, At least one index column must be hit.
     // When the field size of index_id IndexItem is zero, the columns_hints must be empty.
     3: list<IndexColumnHint>    column_hints,
+    // Only the vertices or edges hit by index_id and all the intersect indexes are returned,
+    // and the base data is read after intersecting their index keys
+    4: optional list<IntersectIndex>    intersect_indexes,
+    // The first field of index is not hit by column_hints, which start from the second field.
+    // The index is scanned once for each distinct value of the first field, i.e. skip scan
+    5: bool                     skip_scan = false,
+    // If set, the column_hints are ignored, and only the k vertices or edges nearest to the point
+    // in each part are returned, i.e. ORDER BY ST_Distance(column, point) LIMIT k
+    6: optional NearestNeighbors        nearest_neighbors,
 }
 
 
@@ -549,6 +597,10 @@ struct LookupIndexRequest {
     6: optional i64                         limit,
     7: optional list<OrderBy>               order_by,
     8: optional list<StatProp>              stat_columns,
+    // If provided, the rows are aggregated instead of returned. Each row of data is a group
+    //   of one part, in which the values of group keys are followed by the partial results
+    //   of aggregates
+    9: optional AggregateSpec               aggregate,
 }
 
 
@@ -568,8 +620,13 @@ struct LookupAndTraverseRequest {
  */
 
 struct ScanCursor {
-    // next start key of scan, only valid when has_next is true
+    // next start key of scan, only valid when has_next is true. The scan with enable_snapshot
+    // encodes all of its pending ranges, which are continued by a new snapshot if the lease of
+    // snapshot_id is gone
     1: optional binary                      next_cursor,
+    // the lease of the snapshot pinned by the scan with enable_snapshot, the following pages of
+    // the part read the same snapshot when it is passed back
+    2: optional i64                         snapshot_id,
 }
 
 struct ScanVertexRequest {
@@ -589,6 +646,9 @@ struct ScanVertexRequest {
     // if set to false, forbid follower read
     9: bool                                enable_read_from_follower = true,
     10: optional RequestCommon              common,
+    // if set to true, all pages of a part are read from the same snapshot, and the part is split
+    // into key ranges which are scanned in parallel
+    11: bool                                enable_snapshot = false,
 }
 
 struct ScanEdgeRequest {
@@ -608,6 +668,9 @@ struct ScanEdgeRequest {
     // if set to false, forbid follower read
     9: bool                                enable_read_from_follower = true,
     10: optional RequestCommon              common,
+    // if set to true, all pages of a part are read from the same snapshot, and the part is split
+    // into key ranges which are scanned in parallel
+    11: bool                                enable_snapshot = false,
 }
 
 struct ScanResponse {
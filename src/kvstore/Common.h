@@ -31,12 +31,33 @@ class KVFilter {
    * @param spaceId
    * @param key
    * @param val
-   * @return true Key will not be removed
-   * @return false Key will be removed
+   * @return true Key will be removed
+   * @return false Key will not be removed
    */
   virtual bool filter(GraphSpaceID spaceId,
                       const folly::StringPiece& key,
                       const folly::StringPiece& val) const = 0;
+
+  /**
+   * @brief Rewrite the value of a key kept during compaction
+   *
+   * @param spaceId
+   * @param key
+   * @param val
+   * @param newVal The new value
+   * @return true The value is rewritten into newVal
+   * @return false The value is kept as it is
+   */
+  virtual bool rewrite(GraphSpaceID spaceId,
+                       const folly::StringPiece& key,
+                       const folly::StringPiece& val,
+                       std::string* newVal) const {
+    UNUSED(spaceId);
+    UNUSED(key);
+    UNUSED(val);
+    UNUSED(newVal);
+    return false;
+  }
 };
 
 using KV = std::pair<std::string, std::string>;
@@ -10,6 +10,7 @@
 
 #include "common/base/Base.h"
 #include "common/time/WallClock.h"
+#include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/Common.h"
 
 DECLARE_int32(custom_filter_interval_secs);
@@ -17,6 +18,12 @@ DECLARE_int32(custom_filter_interval_secs);
 namespace nebula {
 namespace kvstore {
 
+/**
+ * @brief Called with the parts which have any vertex or edge removed by a compaction filter
+ */
+using DroppedPartsHandler =
+    std::function<void(GraphSpaceID spaceId, const std::unordered_set<PartitionID>& parts)>;
+
 /**
  * @brief CompactionFilter, built by CompactionFilterFactory
  */
@@ -27,9 +34,18 @@ class KVCompactionFilter final : public rocksdb::CompactionFilter {
    *
    * @param spaceId
    * @param kvFilter A wrapper of filter function
+   * @param dropHandler Notified of the parts with vertices or edges removed, could be empty
    */
-  KVCompactionFilter(GraphSpaceID spaceId, std::unique_ptr<KVFilter> kvFilter)
-      : spaceId_(spaceId), kvFilter_(std::move(kvFilter)) {}
+  KVCompactionFilter(GraphSpaceID spaceId,
+                     std::unique_ptr<KVFilter> kvFilter,
+                     DroppedPartsHandler dropHandler = nullptr)
+      : spaceId_(spaceId), kvFilter_(std::move(kvFilter)), dropHandler_(std::move(dropHandler)) {}
+
+  ~KVCompactionFilter() override {
+    if (dropHandler_ != nullptr && !droppedParts_.empty()) {
+      dropHandler_(spaceId_, droppedParts_);
+    }
+  }
 
   /**
    * @brief whether remove the key during compaction
@@ -37,18 +53,31 @@ class KVCompactionFilter final : public rocksdb::CompactionFilter {
    * @param level Levels of key in rocksdb, not used for now
    * @param key Rocksdb key
    * @param val Rocksdb val
-   * @return true Key will not be removed
-   * @return false Key will be removed
+   * @param newVal The new value if the value is rewritten
+   * @param valChanged Whether the value is rewritten
+   * @return true Key will be removed
+   * @return false Key will not be removed
    */
   bool Filter(int level,
               const rocksdb::Slice& key,
               const rocksdb::Slice& val,
-              std::string*,
-              bool*) const override {
+              std::string* newVal,
+              bool* valChanged) const override {
     UNUSED(level);
-    return kvFilter_->filter(spaceId_,
-                             folly::StringPiece(key.data(), key.size()),
-                             folly::StringPiece(val.data(), val.size()));
+    folly::StringPiece rawKey(key.data(), key.size());
+    folly::StringPiece rawVal(val.data(), val.size());
+    bool remove = kvFilter_->filter(spaceId_, rawKey, rawVal);
+    if (!remove && newVal != nullptr && valChanged != nullptr) {
+      *valChanged = kvFilter_->rewrite(spaceId_, rawKey, rawVal, newVal);
+    }
+    if (remove && dropHandler_ != nullptr && rawKey.size() >= sizeof(NebulaKeyType)) {
+      constexpr int32_t len = static_cast<int32_t>(sizeof(NebulaKeyType));
+      auto type = static_cast<NebulaKeyType>(readInt<uint32_t>(rawKey.data(), len) & kTypeMask);
+      if (type == NebulaKeyType::kTag_ || type == NebulaKeyType::kEdge) {
+        droppedParts_.emplace(NebulaKeyUtils::getPart(rawKey));
+      }
+    }
+    return remove;
   }
 
   const char* Name() const override {
@@ -58,6 +87,9 @@ class KVCompactionFilter final : public rocksdb::CompactionFilter {
  private:
   GraphSpaceID spaceId_;
   std::unique_ptr<KVFilter> kvFilter_;
+  DroppedPartsHandler dropHandler_;
+  // Filter is called by the compaction thread only
+  mutable std::unordered_set<PartitionID> droppedParts_;
 };
 
 /**
@@ -81,13 +113,13 @@ class KVCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
     if (context.is_full_compaction || context.is_manual_compaction) {
       LOG(INFO) << "Do full/manual compaction!";
       lastRunCustomFilterTimeSec_ = now;
-      return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter());
+      return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter(), dropHandler_);
     } else {
       if (FLAGS_custom_filter_interval_secs >= 0 &&
           now - lastRunCustomFilterTimeSec_ > FLAGS_custom_filter_interval_secs) {
         LOG(INFO) << "Do custom minor compaction!";
         lastRunCustomFilterTimeSec_ = now;
-        return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter());
+        return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter(), dropHandler_);
       }
       LOG(INFO) << "Do default minor compaction!";
       return std::unique_ptr<rocksdb::CompactionFilter>(nullptr);
@@ -100,9 +132,18 @@ class KVCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
 
   virtual std::unique_ptr<KVFilter> createKVFilter() = 0;
 
+  /**
+   * @brief Set the handler of parts with vertices or edges removed, must be set before the
+   * factory is used by rocksdb
+   */
+  void setDroppedPartsHandler(DroppedPartsHandler handler) {
+    dropHandler_ = std::move(handler);
+  }
+
  private:
   GraphSpaceID spaceId_;
   int32_t lastRunCustomFilterTimeSec_ = 0;
+  DroppedPartsHandler dropHandler_;
 };
 
 /**
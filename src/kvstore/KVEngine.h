@@ -47,6 +47,16 @@ class WriteBatch {
    * @return nebula::cpp2::ErrorCode
    */
   virtual nebula::cpp2::ErrorCode removeRange(folly::StringPiece start, folly::StringPiece end) = 0;
+
+  /**
+   * @brief Encode the operation of merge operand into the value of key into write batch, it
+   * requires a merge operator registered in kv engine
+   *
+   * @param key Key to merge
+   * @param operand Merge operand
+   * @return nebula::cpp2::ErrorCode
+   */
+  virtual nebula::cpp2::ErrorCode merge(folly::StringPiece key, folly::StringPiece operand) = 0;
 };
 
 /**
@@ -160,11 +170,13 @@ class KVEngine {
    * @param start Start key, inclusive
    * @param prefix The prefix of keys to iterate
    * @param iter Iterator of keys starts with 'prefix' beginning from 'start', returns by kv engine
+   * @param snapshot Snapshot from kv engine. nullptr means no snapshot.
    * @return nebula::cpp2::ErrorCode
    */
   virtual nebula::cpp2::ErrorCode rangeWithPrefix(const std::string& start,
                                                   const std::string& prefix,
-                                                  std::unique_ptr<KVIterator>* iter) = 0;
+                                                  std::unique_ptr<KVIterator>* iter,
+                                                  const void* snapshot = nullptr) = 0;
 
   /**
    * @brief Scan all keys in kv engine
@@ -283,6 +295,23 @@ class KVEngine {
   virtual ErrorOr<nebula::cpp2::ErrorCode, std::string> getProperty(
       const std::string& property) = 0;
 
+  /**
+   * @brief Get the approximate bytes of the data of a part, including the memtables
+   *
+   * @param partId
+   * @return int64_t
+   */
+  virtual int64_t approximatePartSize(PartitionID partId) = 0;
+
+  /**
+   * @brief Get the approximate bytes of the keys in [start, end), including the memtables
+   *
+   * @param start Start key, inclusive
+   * @param end End key, exclusive
+   * @return int64_t
+   */
+  virtual int64_t approximateSize(const std::string& start, const std::string& end) = 0;
+
   /**
    * @brief Do data compation in lsm tree
    *
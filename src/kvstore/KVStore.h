@@ -22,6 +22,19 @@
 namespace nebula {
 namespace kvstore {
 
+/**
+ * @brief MergeOperatorBuilder is a wrapper to build rocksdb MergeOperator for a given space, the
+ * merge operator needs the space info (e.g. vid length and schema) to decode the keys and values
+ */
+class MergeOperatorBuilder {
+ public:
+  MergeOperatorBuilder() = default;
+
+  virtual ~MergeOperatorBuilder() = default;
+
+  virtual std::shared_ptr<rocksdb::MergeOperator> buildMergeOperator(GraphSpaceID spaceId) = 0;
+};
+
 struct KVOptions {
   // HBase thrift server address.
   HostAddr hbaseServer_;
@@ -46,6 +59,9 @@ struct KVOptions {
   // Custom MergeOperator used in rocksdb.merge method.
   std::shared_ptr<rocksdb::MergeOperator> mergeOp_{nullptr};
 
+  // Custom MergeOperator built for each space, it takes precedence over mergeOp_.
+  std::unique_ptr<MergeOperatorBuilder> mergeOpBuilder_{nullptr};
+
   // Custom CompactionFilter used in compaction.
   std::unique_ptr<CompactionFilterFactoryBuilder> cffBuilder_{nullptr};
 };
@@ -217,6 +233,7 @@ class KVStore {
    * @param prefix The prefix of keys to iterate
    * @param iter Iterator of keys starts with 'prefix' beginning from 'start', returns by kv engine
    * @param canReadFromFollower
+   * @param snapshot If set, read from snapshot.
    * @return nebula::cpp2::ErrorCode
    */
   virtual nebula::cpp2::ErrorCode rangeWithPrefix(GraphSpaceID spaceId,
@@ -224,7 +241,8 @@ class KVStore {
                                                   const std::string& start,
                                                   const std::string& prefix,
                                                   std::unique_ptr<KVIterator>* iter,
-                                                  bool canReadFromFollower = false) = 0;
+                                                  bool canReadFromFollower = false,
+                                                  const void* snapshot = nullptr) = 0;
 
   /**
    * @brief To forbid to pass rvalue via the 'rangeWithPrefix' parameter.
@@ -234,7 +252,8 @@ class KVStore {
                                                   std::string&& start,
                                                   std::string&& prefix,
                                                   std::unique_ptr<KVIterator>* iter,
-                                                  bool canReadFromFollower = false) = delete;
+                                                  bool canReadFromFollower = false,
+                                                  const void* snapshot = nullptr) = delete;
 
   /**
    * @brief Synchronize the kvstore across multiple replica
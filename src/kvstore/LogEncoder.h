@@ -30,6 +30,7 @@ enum BatchLogType : char {
   OP_BATCH_PUT = 0x01,
   OP_BATCH_REMOVE = 0x02,
   OP_BATCH_REMOVE_RANGE = 0x03,
+  OP_BATCH_MERGE = 0x04,
 };
 
 /**
@@ -188,6 +189,20 @@ class BatchHolder : public boost::noncopyable, public nebula::cpp::NonMovable {
     batch_.emplace_back(std::move(op));
   }
 
+  /**
+   * @brief Add a merge operation to batch, the operand is folded by the merge operator of engine
+   *
+   * @param key Key to merge
+   * @param operand Merge operand
+   */
+  void merge(std::string&& key, std::string&& operand) {
+    size_ += key.size() + operand.size();
+    auto op = std::make_tuple(BatchLogType::OP_BATCH_MERGE,
+                              std::forward<std::string>(key),
+                              std::forward<std::string>(operand));
+    batch_.emplace_back(std::move(op));
+  }
+
   /**
    * @brief reserve spaces for batch
    */
@@ -13,6 +13,7 @@
 
 #include "common/fs/FileUtils.h"
 #include "common/network/NetworkUtils.h"
+#include "common/time/WallClock.h"
 #include "kvstore/NebulaSnapshotManager.h"
 #include "kvstore/RocksEngine.h"
 
@@ -24,6 +25,10 @@ DEFINE_int32(custom_filter_interval_secs,
 DEFINE_int32(num_workers, 4, "Number of worker threads");
 DEFINE_int32(clean_wal_interval_secs, 600, "interval to trigger clean expired wal");
 DEFINE_bool(auto_remove_invalid_space, false, "whether remove data of invalid space when restart");
+DEFINE_int32(num_part_load_threads,
+             16,
+             "Number of threads to open the parts on disk when starting, the parts of different "
+             "data paths are opened in turn");
 
 DECLARE_bool(rocksdb_disable_wal);
 DECLARE_int32(rocksdb_backup_interval_secs);
@@ -82,7 +87,10 @@ void NebulaStore::loadPartFromDataPath() {
   CHECK(!!options_.partMan_);
   LOG(INFO) << "Scan the local path, and init the spaces_";
   std::unordered_set<std::pair<GraphSpaceID, PartitionID>> spacePartIdSet;
+  // The parts waiting to open of each data path
+  std::vector<std::vector<std::tuple<GraphSpaceID, PartitionID, KVEngine*>>> parts;
   for (auto& path : options_.dataPaths_) {
+    auto& pathParts = parts.emplace_back();
     auto rootPath = folly::stringPrintf("%s/nebula", path.c_str());
     auto dirs = fs::FileUtils::listAllDirsInDir(rootPath.c_str());
     for (auto& dir : dirs) {
@@ -117,8 +125,6 @@ void NebulaStore::loadPartFromDataPath() {
           enginePtr = spaceIt->second->engines_.back().get();
         }
 
-        // partIds is the partition in this host waiting to open
-        std::vector<PartitionID> partIds;
         for (auto& partId : enginePtr->allParts()) {
           if (!options_.partMan_->partExist(storeSvcAddr_, spaceId, partId).ok()) {
             LOG(INFO) << "Part " << partId << " does not exist any more, remove it!";
@@ -128,41 +134,61 @@ void NebulaStore::loadPartFromDataPath() {
             auto spacePart = std::make_pair(spaceId, partId);
             if (spacePartIdSet.find(spacePart) == spacePartIdSet.end()) {
               spacePartIdSet.emplace(spacePart);
-              partIds.emplace_back(partId);
+              pathParts.emplace_back(spaceId, partId, enginePtr);
             }
           }
         }
-        if (partIds.empty()) {
-          continue;
-        }
-
-        std::atomic<size_t> counter(partIds.size());
-        folly::Baton<true, std::atomic> baton;
-        LOG(INFO) << "Need to open " << partIds.size() << " parts of space " << spaceId;
-        for (auto& partId : partIds) {
-          bgWorkers_->addTask([spaceId, partId, enginePtr, &counter, &baton, this]() mutable {
-            auto part = newPart(spaceId, partId, enginePtr, false, {});
-            LOG(INFO) << "Load part " << spaceId << ", " << partId << " from disk";
-
-            {
-              folly::RWSpinLock::WriteHolder holder(&lock_);
-              auto iter = spaces_.find(spaceId);
-              CHECK(iter != spaces_.end());
-              iter->second->parts_.emplace(partId, part);
-            }
-            counter.fetch_sub(1);
-            if (counter.load() == 0) {
-              baton.post();
-            }
-          });
-        }
-        baton.wait();
-        LOG(INFO) << "Load space " << spaceId << " complete";
       } catch (std::exception& e) {
         LOG(FATAL) << "Invalid data directory \"" << dir << "\"";
       }
     }
   }
+
+  // Open the parts of all spaces at once, and take them from each data path in turn, so the
+  // disks are busy at the same time
+  std::vector<std::tuple<GraphSpaceID, PartitionID, KVEngine*>> toOpen;
+  for (size_t i = 0; toOpen.size() < spacePartIdSet.size(); i++) {
+    for (auto& pathParts : parts) {
+      if (i < pathParts.size()) {
+        toOpen.emplace_back(pathParts[i]);
+      }
+    }
+  }
+  if (toOpen.empty()) {
+    return;
+  }
+
+  auto threads = std::min<size_t>(std::max(FLAGS_num_part_load_threads, 1), toOpen.size());
+  LOG(INFO) << "Need to open " << toOpen.size() << " parts by " << threads << " threads";
+  thread::GenericThreadPool loaders;
+  loaders.start(threads, "part-loader");
+  std::atomic<size_t> counter(toOpen.size());
+  folly::Baton<true, std::atomic> baton;
+  for (auto& [spaceId, partId, enginePtr] : toOpen) {
+    loaders.addTask([spaceId = spaceId,
+                     partId = partId,
+                     enginePtr = enginePtr,
+                     &counter,
+                     &baton,
+                     this]() mutable {
+      auto part = newPart(spaceId, partId, enginePtr, false, {});
+      LOG(INFO) << "Load part " << spaceId << ", " << partId << " from disk";
+
+      {
+        folly::RWSpinLock::WriteHolder holder(&lock_);
+        auto iter = spaces_.find(spaceId);
+        CHECK(iter != spaces_.end());
+        iter->second->parts_.emplace(partId, part);
+      }
+      if (counter.fetch_sub(1) == 1) {
+        baton.post();
+      }
+    });
+  }
+  baton.wait();
+  loaders.stop();
+  loaders.wait();
+  LOG(INFO) << "Load " << toOpen.size() << " parts from disk complete";
 }
 
 void NebulaStore::loadPartFromPartManager() {
@@ -233,9 +259,21 @@ std::unique_ptr<KVEngine> NebulaStore::newEngine(GraphSpaceID spaceId,
     if (options_.cffBuilder_ != nullptr) {
       cfFactory = options_.cffBuilder_->buildCfFactory(spaceId);
     }
+    if (cfFactory != nullptr && FLAGS_enable_online_stats) {
+      // Never write to the engine in the compaction thread
+      cfFactory->setDroppedPartsHandler(
+          [this](GraphSpaceID id, const std::unordered_set<PartitionID>& dropped) {
+            std::vector<PartitionID> parts(dropped.begin(), dropped.end());
+            bgWorkers_->addTask(
+                [this, id, parts = std::move(parts)] { invalidatePartStats(id, parts); });
+          });
+    }
+    auto mergeOp = options_.mergeOp_;
+    if (options_.mergeOpBuilder_ != nullptr) {
+      mergeOp = options_.mergeOpBuilder_->buildMergeOperator(spaceId);
+    }
     auto vIdLen = getSpaceVidLen(spaceId);
-    return std::make_unique<RocksEngine>(
-        spaceId, vIdLen, dataPath, walPath, options_.mergeOp_, cfFactory);
+    return std::make_unique<RocksEngine>(spaceId, vIdLen, dataPath, walPath, mergeOp, cfFactory);
   } else {
     LOG(FATAL) << "Unknown engine type " << FLAGS_engine_type;
     return nullptr;
@@ -547,6 +585,31 @@ void NebulaStore::fetchDiskParts(SpaceDiskPartsMap& diskParts) {
   diskMan_->getDiskParts(diskParts);
 }
 
+void NebulaStore::fetchPartLoads(
+    std::unordered_map<GraphSpaceID, meta::cpp2::PartLoadList>& partLoads) {
+  auto now = time::WallClock::fastNowInMilliSec();
+  auto last = lastFetchLoadsTime_.exchange(now);
+  // The requests before the first call are counted in one second
+  auto elapsedMs = last == 0 ? 1000 : std::max<int64_t>(now - last, 1);
+  folly::RWSpinLock::ReadHolder rh(&lock_);
+  for (const auto& [spaceId, space] : spaces_) {
+    std::vector<meta::cpp2::PartLoad> loads;
+    loads.reserve(space->parts_.size());
+    for (const auto& [partId, part] : space->parts_) {
+      auto requests = part->takeRequests();
+      meta::cpp2::PartLoad load;
+      load.part_id_ref() = partId;
+      load.disk_size_ref() = part->engine()->approximatePartSize(partId);
+      load.read_qps_ref() = requests.first * 1000 / elapsedMs;
+      load.write_qps_ref() = requests.second * 1000 / elapsedMs;
+      loads.emplace_back(std::move(load));
+    }
+    if (!loads.empty()) {
+      partLoads[spaceId].part_loads_ref() = std::move(loads);
+    }
+  }
+}
+
 void NebulaStore::updateSpaceOption(GraphSpaceID spaceId,
                                     const std::unordered_map<std::string, std::string>& options,
                                     bool isDbOption) {
@@ -588,6 +651,7 @@ nebula::cpp2::ErrorCode NebulaStore::get(GraphSpaceID spaceId,
     return part->isLeader() ? nebula::cpp2::ErrorCode::E_LEADER_LEASE_FAILED
                             : nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
   }
+  part->addReads(1);
   return part->engine()->get(key, value);
 }
 
@@ -631,6 +695,7 @@ std::pair<nebula::cpp2::ErrorCode, std::vector<Status>> NebulaStore::multiGet(
   if (!checkLeader(part, canReadFromFollower)) {
     return {nebula::cpp2::ErrorCode::E_LEADER_CHANGED, status};
   }
+  part->addReads(keys.size());
   status = part->engine()->multiGet(keys, values);
   auto allExist = std::all_of(status.begin(), status.end(), [](const auto& s) { return s.ok(); });
   if (allExist) {
@@ -654,6 +719,7 @@ nebula::cpp2::ErrorCode NebulaStore::range(GraphSpaceID spaceId,
   if (!checkLeader(part, canReadFromFollower)) {
     return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
   }
+  part->addReads(1);
   return part->engine()->range(start, end, iter);
 }
 
@@ -671,6 +737,7 @@ nebula::cpp2::ErrorCode NebulaStore::prefix(GraphSpaceID spaceId,
   if (!checkLeader(part, canReadFromFollower)) {
     return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
   }
+  part->addReads(1);
   return part->engine()->prefix(prefix, iter, snapshot);
 }
 
@@ -679,7 +746,8 @@ nebula::cpp2::ErrorCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
                                                      const std::string& start,
                                                      const std::string& prefix,
                                                      std::unique_ptr<KVIterator>* iter,
-                                                     bool canReadFromFollower) {
+                                                     bool canReadFromFollower,
+                                                     const void* snapshot) {
   auto ret = part(spaceId, partId);
   if (!ok(ret)) {
     return error(ret);
@@ -688,7 +756,8 @@ nebula::cpp2::ErrorCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
   if (!checkLeader(part, canReadFromFollower)) {
     return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
   }
-  return part->engine()->rangeWithPrefix(start, prefix, iter);
+  part->addReads(1);
+  return part->engine()->rangeWithPrefix(start, prefix, iter, snapshot);
 }
 
 nebula::cpp2::ErrorCode NebulaStore::sync(GraphSpaceID spaceId, PartitionID partId) {
@@ -720,6 +789,7 @@ void NebulaStore::asyncAppendBatch(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
+  part->addWrites(1);
   part->asyncAppendBatch(std::move(batch), std::move(cb));
 }
 
@@ -733,6 +803,7 @@ void NebulaStore::asyncMultiPut(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
+  part->addWrites(keyValues.size());
   part->asyncMultiPut(std::move(keyValues), std::move(cb));
 }
 
@@ -746,6 +817,7 @@ void NebulaStore::asyncRemove(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
+  part->addWrites(1);
   part->asyncRemove(key, std::move(cb));
 }
 
@@ -759,6 +831,7 @@ void NebulaStore::asyncMultiRemove(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
+  part->addWrites(keys.size());
   part->asyncMultiRemove(std::move(keys), std::move(cb));
 }
 
@@ -773,6 +846,7 @@ void NebulaStore::asyncRemoveRange(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
+  part->addWrites(1);
   part->asyncRemoveRange(start, end, std::move(cb));
 }
 
@@ -786,6 +860,7 @@ void NebulaStore::asyncAtomicOp(GraphSpaceID spaceId,
     return;
   }
   auto part = nebula::value(ret);
+  part->addWrites(1);
   part->asyncAtomicOp(std::move(op), std::move(cb));
 }
 
@@ -833,11 +908,21 @@ nebula::cpp2::ErrorCode NebulaStore::ingest(GraphSpaceID spaceId) {
           return code;
         }
       }
+      invalidatePartStats(spaceId, {part});
     }
   }
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+void NebulaStore::invalidatePartStats(GraphSpaceID spaceId, const std::vector<PartitionID>& parts) {
+  for (auto partId : parts) {
+    auto ret = part(spaceId, partId);
+    if (ok(ret)) {
+      value(ret)->invalidateStats();
+    }
+  }
+}
+
 nebula::cpp2::ErrorCode NebulaStore::setOption(GraphSpaceID spaceId,
                                                const std::string& configKey,
                                                const std::string& configValue) {
@@ -1208,6 +1293,7 @@ nebula::cpp2::ErrorCode NebulaStore::restoreFromFiles(GraphSpaceID spaceId,
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return ret;
     }
+    invalidatePartStats(spaceId, engine->allParts());
   }
 
   return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -1229,6 +1315,7 @@ nebula::cpp2::ErrorCode NebulaStore::multiPutWithoutReplicator(GraphSpaceID spac
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return ret;
     }
+    invalidatePartStats(spaceId, engine->allParts());
   }
 
   return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -305,6 +305,7 @@ class NebulaStore : public KVStore, public Handler {
    * @param prefix The prefix of keys to iterate
    * @param iter Iterator of keys starts with 'prefix' beginning from 'start', returns by kv engine
    * @param canReadFromFollower Whether check if current kvstore is leader of given partition
+   * @param snapshot If set, read from snapshot.
    * @return nebula::cpp2::ErrorCode
    */
   nebula::cpp2::ErrorCode rangeWithPrefix(GraphSpaceID spaceId,
@@ -312,7 +313,8 @@ class NebulaStore : public KVStore, public Handler {
                                           const std::string& start,
                                           const std::string& prefix,
                                           std::unique_ptr<KVIterator>* iter,
-                                          bool canReadFromFollower = false) override;
+                                          bool canReadFromFollower = false,
+                                          const void* snapshot = nullptr) override;
 
   /**
    * @brief To forbid to pass rvalue via the 'rangeWithPrefix' parameter.
@@ -322,7 +324,8 @@ class NebulaStore : public KVStore, public Handler {
                                           std::string&& start,
                                           std::string&& prefix,
                                           std::unique_ptr<KVIterator>* iter,
-                                          bool canReadFromFollower = false) override = delete;
+                                          bool canReadFromFollower = false,
+                                          const void* snapshot = nullptr) override = delete;
 
   /**
    * @brief Synchronize the kvstore across multiple replica by add a empty log
@@ -651,6 +654,14 @@ class NebulaStore : public KVStore, public Handler {
    */
   void fetchDiskParts(SpaceDiskPartsMap& diskParts) override;
 
+  /**
+   * @brief Get the disk size and the requests per second since last call of all partitions
+   *
+   * @param partLoads Loads of the partitions grouped by spaceId
+   */
+  void fetchPartLoads(
+      std::unordered_map<GraphSpaceID, meta::cpp2::PartLoadList>& partLoads) override;
+
   /**
    * @brief Write data to local storage engine only
    *
@@ -753,6 +764,14 @@ class NebulaStore : public KVStore, public Handler {
                                       const std::string& dataPath,
                                       const std::string& walPath);
 
+  /**
+   * @brief Drop the online stats of parts whose data is changed without logs
+   *
+   * @param spaceId
+   * @param parts
+   */
+  void invalidatePartStats(GraphSpaceID spaceId, const std::vector<PartitionID>& parts);
+
   /**
    * @brief Start a new part
    *
@@ -838,6 +857,8 @@ class NebulaStore : public KVStore, public Handler {
   std::shared_ptr<raftex::SnapshotManager> snapshot_;
   std::shared_ptr<thrift::ThriftClientManager<raftex::cpp2::RaftexServiceAsyncClient>> clientMan_;
   std::shared_ptr<DiskManager> diskMan_;
+  // the time in ms of last fetchPartLoads, to calculate the requests per second
+  std::atomic<int64_t> lastFetchLoadsTime_{0};
   folly::ConcurrentHashMap<std::string, std::function<void(std::shared_ptr<Part>&)>>
       onNewPartAdded_;
   std::function<void(GraphSpaceID)> beforeRemoveSpace_{nullptr};
@@ -13,6 +13,11 @@
 #include "kvstore/RocksEngineConfig.h"
 
 DEFINE_int32(cluster_id, 0, "A unique id for each cluster");
+DEFINE_bool(enable_online_stats,
+            false,
+            "Whether to maintain the number of vertices and edges of each part by the committed "
+            "logs, instead of scanning all data by stats job. The spaces with ttl are still "
+            "scanned, since the expired data is removed by compaction without logs");
 
 namespace nebula {
 namespace kvstore {
@@ -44,7 +49,9 @@ Part::Part(GraphSpaceID spaceId,
       partId_(partId),
       walPath_(walPath),
       engine_(engine),
-      vIdLen_(vIdLen) {}
+      vIdLen_(vIdLen) {
+  loadStats();
+}
 
 std::pair<LogID, TermID> Part::lastCommittedLogId() {
   std::string val;
@@ -213,6 +220,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
     std::unique_ptr<LogIterator> iter, bool wait) {
   SCOPED_TIMER(&execTime_);
   auto batch = engine_->startBatchWrite();
+  auto tracker = newStatsTracker();
   LogID lastId = kNoCommitLogId;
   TermID lastTerm = kNoCommitLogTerm;
   while (iter->valid()) {
@@ -235,6 +243,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
           VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
         }
+        if (tracker != nullptr) {
+          tracker->put(pieces[0]);
+        }
         break;
       }
       case OP_MULTI_PUT: {
@@ -249,6 +260,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
             VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
           }
+          if (tracker != nullptr) {
+            tracker->put(kvs[i]);
+          }
         }
         break;
       }
@@ -259,6 +273,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
           VLOG(3) << idStr_ << "Failed to call WriteBatch::remove()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
         }
+        if (tracker != nullptr) {
+          tracker->remove(key);
+        }
         break;
       }
       case OP_MULTI_REMOVE: {
@@ -269,6 +286,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
             VLOG(3) << idStr_ << "Failed to call WriteBatch::remove()";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
           }
+          if (tracker != nullptr) {
+            tracker->remove(k);
+          }
         }
         break;
       }
@@ -280,6 +300,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
           VLOG(3) << idStr_ << "Failed to call WriteBatch::removeRange()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
         }
+        if (tracker != nullptr) {
+          tracker->removeRange(range[0], range[1]);
+        }
         break;
       }
       case OP_BATCH_WRITE: {
@@ -294,11 +317,23 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
             code = batch->remove(op.second.first);
           } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
             code = batch->removeRange(op.second.first, op.second.second);
+          } else if (op.first == BatchLogType::OP_BATCH_MERGE) {
+            code = batch->merge(op.second.first, op.second.second);
           }
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
           }
+          if (tracker != nullptr) {
+            if (op.first == BatchLogType::OP_BATCH_REMOVE) {
+              tracker->remove(op.second.first);
+            } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
+              tracker->removeRange(op.second.first, op.second.second);
+            } else {
+              // A merged row always exists
+              tracker->put(op.second.first);
+            }
+          }
         }
         break;
       }
@@ -347,8 +382,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
     }
   }
 
-  auto code = engine_->commitBatchWrite(
-      std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, wait);
+  auto code = commitBatch(std::move(batch), tracker.get(), wait);
   if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
     return {code, lastId, lastTerm};
   } else {
@@ -362,6 +396,7 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
                                                  bool finished) {
   SCOPED_TIMER(&execTime_);
   auto batch = engine_->startBatchWrite();
+  auto tracker = newStatsTracker();
   int64_t count = 0;
   int64_t size = 0;
   for (auto& row : rows) {
@@ -372,6 +407,9 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
       VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
       return std::make_pair(0, 0);
     }
+    if (tracker != nullptr) {
+      tracker->put(kv.first);
+    }
   }
   if (finished) {
     auto retCode = putCommitMsg(batch.get(), committedLogId, committedLogTerm);
@@ -381,8 +419,7 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
     }
   }
   // For snapshot, we open the rocksdb's wal to avoid loss data if crash.
-  auto code = engine_->commitBatchWrite(
-      std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  auto code = commitBatch(std::move(batch), tracker.get(), true);
   if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
     return std::make_pair(0, 0);
   }
@@ -517,8 +554,194 @@ nebula::cpp2::ErrorCode Part::cleanup() {
             << apache::thrift::util::enumNameSafe(ret);
     return ret;
   }
-  return engine_->commitBatchWrite(
+
+  std::lock_guard<std::mutex> guard(statsLock_);
+  ret = batch->remove(NebulaKeyUtils::systemStatsKey(partId_));
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    VLOG(3) << idStr_ << "Remove the part system stats data failed, error "
+            << apache::thrift::util::enumNameSafe(ret);
+    return ret;
+  }
+  ret = engine_->commitBatchWrite(
       std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    // The part is empty now
+    stats_ = PartStats();
+    statsValid_ = newStatsTracker() != nullptr;
+    statsPendingLost_ = true;
+  }
+  return ret;
+}
+
+void Part::loadStats() {
+  auto statsKey = NebulaKeyUtils::systemStatsKey(partId_);
+  if (!FLAGS_enable_online_stats || partId_ == 0) {
+    // The stats would be out of date once any log is committed without them
+    engine_->remove(statsKey);
+    return;
+  }
+  std::string val;
+  auto code = engine_->get(statsKey, &val);
+  if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    statsValid_ = PartStats::decode(val, &stats_);
+    if (!statsValid_) {
+      LOG(WARNING) << idStr_ << "Invalid stats of part, need to rebuild";
+      stats_ = PartStats();
+    }
+    return;
+  }
+  if (code != nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+    return;
+  }
+  // No stats persisted, they are known only if the part has no vertex or edge
+  for (const auto& prefix :
+       {NebulaKeyUtils::tagPrefix(partId_), NebulaKeyUtils::edgePrefix(partId_)}) {
+    std::unique_ptr<KVIterator> iter;
+    if (engine_->prefix(prefix, &iter) != nebula::cpp2::ErrorCode::SUCCEEDED || iter->valid()) {
+      return;
+    }
+  }
+  statsValid_ = true;
+}
+
+std::unique_ptr<PartStatsTracker> Part::newStatsTracker() const {
+  // The parts of meta have no vertex or edge
+  if (!FLAGS_enable_online_stats || partId_ == 0) {
+    return nullptr;
+  }
+  return std::make_unique<PartStatsTracker>(engine_, partId_, vIdLen_);
+}
+
+nebula::cpp2::ErrorCode Part::commitBatch(std::unique_ptr<WriteBatch> batch,
+                                          const PartStatsTracker* tracker,
+                                          bool wait) {
+  auto statsKey = NebulaKeyUtils::systemStatsKey(partId_);
+  folly::Optional<PartStats> delta;
+  if (tracker != nullptr && !tracker->lost()) {
+    // The tags counted by the stats are all the tags a vertex may have, so the tags of the
+    // vertices written are read by multiGet
+    folly::Optional<std::vector<TagID>> knownTags;
+    {
+      std::lock_guard<std::mutex> guard(statsLock_);
+      if (statsValid_) {
+        knownTags.emplace();
+        for (const auto& [tagId, count] : stats_.tagVertices) {
+          if (count > 0) {
+            knownTags->emplace_back(tagId);
+          }
+        }
+      }
+    }
+    // The logs are committed by one thread, so the keys are not changed until the batch is
+    // committed
+    auto ret = tracker->delta(knownTags.has_value() ? knownTags.get_pointer() : nullptr);
+    if (ok(ret)) {
+      delta = std::move(value(ret));
+    } else {
+      LOG(WARNING) << idStr_ << "Failed to compute the stats of part, error "
+                   << apache::thrift::util::enumNameSafe(error(ret));
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(statsLock_);
+  bool valid = statsValid_ && delta.has_value();
+  PartStats stats;
+  if (valid) {
+    stats = stats_;
+    stats.add(*delta);
+    auto code = batch->put(statsKey, stats.encode());
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  } else if (statsValid_) {
+    auto code = batch->remove(statsKey);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  auto code = engine_->commitBatchWrite(
+      std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, wait);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  statsValid_ = valid;
+  stats_ = std::move(stats);
+  if (statsRebuilding_) {
+    if (delta.has_value()) {
+      statsPending_.add(*delta);
+    } else {
+      statsPendingLost_ = true;
+    }
+  }
+  return code;
+}
+
+folly::Optional<PartStats> Part::stats() {
+  std::lock_guard<std::mutex> guard(statsLock_);
+  if (!statsValid_) {
+    return folly::none;
+  }
+  return stats_;
+}
+
+nebula::cpp2::ErrorCode Part::rebuildStats(std::function<bool()> isCanceled) {
+  if (newStatsTracker() == nullptr) {
+    return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+  }
+  const void* snapshot = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(statsLock_);
+    if (statsRebuilding_) {
+      return nebula::cpp2::ErrorCode::E_TASK_EXECUTION_FAILED;
+    }
+    // The logs committed after the snapshot are added to statsPending_
+    snapshot = engine_->GetSnapshot();
+    statsRebuilding_ = true;
+    statsPendingLost_ = false;
+    statsPending_ = PartStats();
+  }
+  auto ret = PartStats::scan(engine_, partId_, vIdLen_, snapshot, std::move(isCanceled));
+  engine_->ReleaseSnapshot(snapshot);
+
+  std::lock_guard<std::mutex> guard(statsLock_);
+  statsRebuilding_ = false;
+  if (!ok(ret)) {
+    return error(ret);
+  }
+  if (statsPendingLost_) {
+    // Some vertices or edges are removed by range during the scan, try again later
+    return nebula::cpp2::ErrorCode::E_TASK_EXECUTION_FAILED;
+  }
+  auto stats = std::move(value(ret));
+  stats.add(statsPending_);
+  auto code = engine_->put(NebulaKeyUtils::systemStatsKey(partId_), stats.encode());
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  stats_ = std::move(stats);
+  statsValid_ = true;
+  return code;
+}
+
+void Part::invalidateStats() {
+  if (newStatsTracker() == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(statsLock_);
+  if (statsRebuilding_) {
+    // The snapshot being scanned may still have the changed data
+    statsPendingLost_ = true;
+  }
+  if (!statsValid_) {
+    return;
+  }
+  auto code = engine_->remove(NebulaKeyUtils::systemStatsKey(partId_));
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    LOG(WARNING) << idStr_ << "Remove the part system stats data failed, error "
+                 << apache::thrift::util::enumNameSafe(code);
+  }
+  statsValid_ = false;
+  stats_ = PartStats();
 }
 
 }  // namespace kvstore
@@ -10,10 +10,13 @@
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/Common.h"
 #include "kvstore/KVEngine.h"
+#include "kvstore/PartStats.h"
 #include "kvstore/raftex/SnapshotManager.h"
 #include "kvstore/wal/FileBasedWal.h"
 #include "raftex/RaftPart.h"
 
+DECLARE_bool(enable_online_stats);
+
 namespace nebula {
 namespace kvstore {
 
@@ -66,6 +69,46 @@ class Part : public raftex::RaftPart {
     return engine_;
   }
 
+  /**
+   * @brief Count the requests served by this part, they are reported to meta as the load of part
+   */
+  void addReads(int64_t num) {
+    reads_.fetch_add(num, std::memory_order_relaxed);
+  }
+
+  void addWrites(int64_t num) {
+    writes_.fetch_add(num, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Return the number of requests counted since last call, and reset them
+   */
+  std::pair<int64_t, int64_t> takeRequests() {
+    return {reads_.exchange(0, std::memory_order_relaxed),
+            writes_.exchange(0, std::memory_order_relaxed)};
+  }
+
+  /**
+   * @brief Return the stats of part maintained by the committed logs, folly::none if they are not
+   * known, e.g. enable_online_stats is turned on with existing data
+   */
+  folly::Optional<PartStats> stats();
+
+  /**
+   * @brief Count the vertices and edges of part by scanning a snapshot, the logs committed during
+   * the scan are added on it, then the stats are maintained by the logs since then.
+   *
+   * @param isCanceled Check whether to stop scanning
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode rebuildStats(std::function<bool()> isCanceled);
+
+  /**
+   * @brief Drop the stats of part when its data is changed without logs, e.g. sst files ingested
+   * or keys removed by compaction filter, they are unknown until rebuildStats
+   */
+  void invalidateStats();
+
   /**
    * @brief Write single key/values to kvstore asynchronously
    *
@@ -290,6 +333,28 @@ class Part : public raftex::RaftPart {
                                        LogID committedLogId,
                                        TermID committedLogTerm);
 
+  /**
+   * @brief Commit the batch to engine, along with the stats of part changed by it
+   *
+   * @param batch Write batch to commit
+   * @param tracker Tracker of the writes in batch, nullptr if enable_online_stats is off
+   * @param wait Whether wait until write result
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode commitBatch(std::unique_ptr<WriteBatch> batch,
+                                      const PartStatsTracker* tracker,
+                                      bool wait);
+
+  /**
+   * @brief Load the persisted stats of part when it is opened
+   */
+  void loadStats();
+
+  /**
+   * @brief Tracker of the writes to be committed, nullptr if the stats are not maintained
+   */
+  std::unique_ptr<PartStatsTracker> newStatsTracker() const;
+
   /**
    * @brief clean up data in listener, called in RaftPart::reset
    *
@@ -327,6 +392,17 @@ class Part : public raftex::RaftPart {
  private:
   KVEngine* engine_ = nullptr;
   int32_t vIdLen_;
+  std::atomic<int64_t> reads_{0};
+  std::atomic<int64_t> writes_{0};
+
+  // Protect the stats, and keep them in the same order as the committed batches
+  std::mutex statsLock_;
+  PartStats stats_;
+  bool statsValid_{false};
+  // The stats changed by the logs committed during rebuildStats
+  bool statsRebuilding_{false};
+  bool statsPendingLost_{false};
+  PartStats statsPending_;
 };
 
 }  // namespace kvstore
@@ -187,6 +187,13 @@ void MetaServerBasedPartManager::fetchDiskParts(SpaceDiskPartsMap& diskParts) {
   }
 }
 
+void MetaServerBasedPartManager::fetchPartLoads(
+    std::unordered_map<GraphSpaceID, meta::cpp2::PartLoadList>& partLoads) {
+  if (handler_ != nullptr) {
+    handler_->fetchPartLoads(partLoads);
+  }
+}
+
 meta::ListenersMap MetaServerBasedPartManager::listeners(const HostAddr& host) {
   auto ret = client_->getListenersByHostFromCache(host);
   if (ret.ok()) {
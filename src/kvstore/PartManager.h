@@ -121,6 +121,14 @@ class Handler {
    * @param diskParts Get all space data path and all partition in the path
    */
   virtual void fetchDiskParts(SpaceDiskPartsMap& diskParts) = 0;
+
+  /**
+   * @brief Get the disk size and traffic of all partitions grouped by spaceId
+   *
+   * @param partLoads Loads of the partitions on this host
+   */
+  virtual void fetchPartLoads(
+      std::unordered_map<GraphSpaceID, meta::cpp2::PartLoadList>& partLoads) = 0;
 };
 
 /**
@@ -474,6 +482,14 @@ class MetaServerBasedPartManager : public PartManager, public meta::MetaChangedL
    */
   void fetchDiskParts(SpaceDiskPartsMap& diskParts) override;
 
+  /**
+   * @brief Fetch the loads of partitions from handler
+   *
+   * @param partLoads Loads of the partitions grouped by spaceId
+   */
+  void fetchPartLoads(
+      std::unordered_map<GraphSpaceID, meta::cpp2::PartLoadList>& partLoads) override;
+
   /**
    * @brief Found a new listener, call handler's method
    *
@@ -0,0 +1,252 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/PartStats.h"
+
+#include "common/utils/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace kvstore {
+
+namespace {
+
+constexpr uint8_t kStatsVersion = 0x01;
+// Check whether to stop scanning every so many keys
+constexpr size_t kCancelCheckInterval = 1024;
+
+template <typename T>
+void encodeInt(std::string& buf, T val) {
+  buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+bool decodeInt(folly::StringPiece& data, T* val) {
+  if (data.size() < sizeof(T)) {
+    return false;
+  }
+  memcpy(val, data.data(), sizeof(T));
+  data.advance(sizeof(T));
+  return true;
+}
+
+template <typename K>
+void appendCounts(std::string& buf, const std::unordered_map<K, int64_t>& counts) {
+  encodeInt<uint32_t>(buf, counts.size());
+  for (const auto& [id, count] : counts) {
+    encodeInt<K>(buf, id);
+    encodeInt<int64_t>(buf, count);
+  }
+}
+
+template <typename K>
+bool readCounts(folly::StringPiece& data, std::unordered_map<K, int64_t>* counts) {
+  uint32_t size = 0;
+  if (!decodeInt(data, &size)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < size; i++) {
+    K id;
+    int64_t count;
+    if (!decodeInt(data, &id) || !decodeInt(data, &count)) {
+      return false;
+    }
+    (*counts)[id] = count;
+  }
+  return true;
+}
+
+// Whether [start, end) covers any key with the prefix
+bool overlaps(folly::StringPiece start, folly::StringPiece end, const std::string& prefix) {
+  if (end <= folly::StringPiece(prefix)) {
+    return false;
+  }
+  return start <= folly::StringPiece(prefix) || start.startsWith(prefix);
+}
+
+}  // namespace
+
+void PartStats::add(const PartStats& delta) {
+  vertices += delta.vertices;
+  for (const auto& [tagId, count] : delta.tagVertices) {
+    tagVertices[tagId] += count;
+  }
+  for (const auto& [edgeType, count] : delta.edges) {
+    edges[edgeType] += count;
+  }
+}
+
+std::string PartStats::encode() const {
+  std::string buf;
+  buf.reserve(sizeof(uint8_t) + sizeof(int64_t) +
+              (sizeof(int32_t) + sizeof(int64_t)) * (tagVertices.size() + edges.size()) +
+              sizeof(uint32_t) * 2);
+  encodeInt<uint8_t>(buf, kStatsVersion);
+  encodeInt<int64_t>(buf, vertices);
+  appendCounts(buf, tagVertices);
+  appendCounts(buf, edges);
+  return buf;
+}
+
+bool PartStats::decode(folly::StringPiece data, PartStats* stats) {
+  uint8_t version = 0;
+  if (!decodeInt(data, &version) || version != kStatsVersion) {
+    return false;
+  }
+  return decodeInt(data, &stats->vertices) && readCounts(data, &stats->tagVertices) &&
+         readCounts(data, &stats->edges) && data.empty();
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, PartStats> PartStats::scan(KVEngine* engine,
+                                                            PartitionID partId,
+                                                            size_t vIdLen,
+                                                            const void* snapshot,
+                                                            std::function<bool()> isCanceled) {
+  PartStats stats;
+  size_t scanned = 0;
+  auto canceled = [&]() {
+    return ++scanned % kCancelCheckInterval == 0 && isCanceled != nullptr && isCanceled();
+  };
+
+  std::unique_ptr<KVIterator> iter;
+  auto code = engine->prefix(NebulaKeyUtils::tagPrefix(partId), &iter, snapshot);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  std::string lastVid;
+  for (; iter->valid(); iter->next()) {
+    if (canceled()) {
+      return nebula::cpp2::ErrorCode::E_USER_CANCEL;
+    }
+    auto key = iter->key();
+    if (!NebulaKeyUtils::isTag(vIdLen, key)) {
+      continue;
+    }
+    stats.tagVertices[NebulaKeyUtils::getTagId(vIdLen, key)]++;
+    auto vid = NebulaKeyUtils::getVertexId(vIdLen, key);
+    if (vid != lastVid) {
+      stats.vertices++;
+      lastVid = vid.str();
+    }
+  }
+
+  code = engine->prefix(NebulaKeyUtils::edgePrefix(partId), &iter, snapshot);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  for (; iter->valid(); iter->next()) {
+    if (canceled()) {
+      return nebula::cpp2::ErrorCode::E_USER_CANCEL;
+    }
+    auto key = iter->key();
+    if (!NebulaKeyUtils::isEdge(vIdLen, key)) {
+      continue;
+    }
+    auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen, key);
+    if (edgeType > 0) {
+      stats.edges[edgeType]++;
+    }
+  }
+  return stats;
+}
+
+void PartStatsTracker::write(folly::StringPiece key, bool exists) {
+  if (NebulaKeyUtils::isTag(vIdLen_, key)) {
+    auto vid = NebulaKeyUtils::getVertexId(vIdLen_, key).str();
+    tags_[vid][key.str()] = exists;
+  } else if (NebulaKeyUtils::isEdge(vIdLen_, key) &&
+             NebulaKeyUtils::getEdgeType(vIdLen_, key) > 0) {
+    edges_[key.str()] = exists;
+  }
+}
+
+void PartStatsTracker::removeRange(folly::StringPiece start, folly::StringPiece end) {
+  if (overlaps(start, end, NebulaKeyUtils::tagPrefix(partId_)) ||
+      overlaps(start, end, NebulaKeyUtils::edgePrefix(partId_))) {
+    lost_ = true;
+  }
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, PartStats> PartStatsTracker::delta(
+    const std::vector<TagID>* knownTags) const {
+  // All the keys to check are read by one multiGet: the edges written, and all the known tags of
+  // the vertices written, so that whether a vertex has any tag is known without iterating
+  std::vector<std::string> keys;
+  keys.reserve(edges_.size() + tags_.size() * (knownTags != nullptr ? knownTags->size() + 1 : 0));
+  for (const auto& edge : edges_) {
+    keys.emplace_back(edge.first);
+  }
+  // vid => [begin, end) of its tag keys in keys
+  std::unordered_map<std::string, std::pair<size_t, size_t>> tagKeys;
+  if (knownTags != nullptr) {
+    for (const auto& [vid, written] : tags_) {
+      auto begin = keys.size();
+      std::unordered_set<TagID> tagIds(knownTags->begin(), knownTags->end());
+      for (const auto& write : written) {
+        tagIds.emplace(NebulaKeyUtils::getTagId(vIdLen_, write.first));
+      }
+      for (auto tagId : tagIds) {
+        keys.emplace_back(NebulaKeyUtils::tagKey(vIdLen_, partId_, vid, tagId));
+      }
+      tagKeys.emplace(vid, std::make_pair(begin, keys.size()));
+    }
+  }
+  std::vector<std::string> values;
+  std::vector<Status> status;
+  if (!keys.empty()) {
+    status = engine_->multiGet(keys, &values);
+  }
+  for (const auto& s : status) {
+    if (!s.ok() && !s.isKeyNotFound()) {
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+
+  PartStats delta;
+  size_t idx = 0;
+  for (const auto& [key, exists] : edges_) {
+    bool existed = status[idx++].ok();
+    if (exists != existed) {
+      delta.edges[NebulaKeyUtils::getEdgeType(vIdLen_, key)] += exists ? 1 : -1;
+    }
+  }
+
+  // A vertex is counted as long as it has any tag
+  for (const auto& [vid, written] : tags_) {
+    std::unordered_set<std::string> existed;
+    auto found = tagKeys.find(vid);
+    if (found != tagKeys.end()) {
+      for (auto i = found->second.first; i < found->second.second; i++) {
+        if (status[i].ok()) {
+          existed.emplace(keys[i]);
+        }
+      }
+    } else {
+      std::unique_ptr<KVIterator> iter;
+      auto code = engine_->prefix(NebulaKeyUtils::tagPrefix(vIdLen_, partId_, vid), &iter);
+      if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return code;
+      }
+      for (; iter->valid(); iter->next()) {
+        if (NebulaKeyUtils::isTag(vIdLen_, iter->key())) {
+          existed.emplace(iter->key().str());
+        }
+      }
+    }
+    auto tags = static_cast<int64_t>(existed.size());
+    for (const auto& [key, exists] : written) {
+      if (exists != (existed.count(key) > 0)) {
+        delta.tagVertices[NebulaKeyUtils::getTagId(vIdLen_, key)] += exists ? 1 : -1;
+        tags += exists ? 1 : -1;
+      }
+    }
+    if ((tags > 0) != !existed.empty()) {
+      delta.vertices += tags > 0 ? 1 : -1;
+    }
+  }
+  return delta;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
@@ -0,0 +1,105 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef KVSTORE_PARTSTATS_H_
+#define KVSTORE_PARTSTATS_H_
+
+#include "common/base/Base.h"
+#include "common/base/ErrorOr.h"
+#include "common/thrift/ThriftTypes.h"
+#include "interface/gen-cpp2/common_types.h"
+#include "kvstore/KVEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * @brief The number of vertices and edges in a part, kept up to date by the logs applied to the
+ * part, and persisted in the system stats key of part along with them.
+ */
+struct PartStats {
+  // The vertices with any tag
+  int64_t vertices{0};
+  std::unordered_map<TagID, int64_t> tagVertices;
+  // Only out edges are counted
+  std::unordered_map<EdgeType, int64_t> edges;
+
+  bool empty() const {
+    return vertices == 0 && tagVertices.empty() && edges.empty();
+  }
+
+  void add(const PartStats& delta);
+
+  std::string encode() const;
+
+  static bool decode(folly::StringPiece data, PartStats* stats);
+
+  /**
+   * @brief Count all the vertices and edges of part by scanning the engine
+   *
+   * @param snapshot Snapshot to scan, nullptr means the latest data
+   * @param isCanceled Check whether to stop scanning
+   */
+  static ErrorOr<nebula::cpp2::ErrorCode, PartStats> scan(KVEngine* engine,
+                                                           PartitionID partId,
+                                                           size_t vIdLen,
+                                                           const void* snapshot,
+                                                           std::function<bool()> isCanceled);
+};
+
+/**
+ * @brief Track the writes of a batch to be committed to part, and compute how they change the
+ * stats of part. The keys are checked against the engine by one multiGet before the batch is
+ * committed, so it must be used by the thread committing to the part.
+ */
+class PartStatsTracker final {
+ public:
+  PartStatsTracker(KVEngine* engine, PartitionID partId, size_t vIdLen)
+      : engine_(engine), partId_(partId), vIdLen_(vIdLen) {}
+
+  void put(folly::StringPiece key) {
+    write(key, true);
+  }
+
+  void remove(folly::StringPiece key) {
+    write(key, false);
+  }
+
+  /**
+   * @brief The vertices and edges removed by range are unknown, so the stats are lost if the
+   * range covers any of them
+   */
+  void removeRange(folly::StringPiece start, folly::StringPiece end);
+
+  bool lost() const {
+    return lost_;
+  }
+
+  /**
+   * @brief The change of stats if all the writes are committed
+   *
+   * @param knownTags All the tags which any vertex of part may have, i.e. the tags counted by the
+   * stats of part. The tags of a vertex are read by prefix instead if it is nullptr.
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, PartStats> delta(
+      const std::vector<TagID>* knownTags = nullptr) const;
+
+ private:
+  void write(folly::StringPiece key, bool exists);
+
+  KVEngine* engine_;
+  PartitionID partId_;
+  size_t vIdLen_;
+  // vid => tag key => whether exists after the writes
+  std::unordered_map<std::string, std::unordered_map<std::string, bool>> tags_;
+  // edge key => whether exists after the writes
+  std::unordered_map<std::string, bool> edges_;
+  bool lost_{false};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+
+#endif  // KVSTORE_PARTSTATS_H_
@@ -8,6 +8,8 @@
 #include <folly/String.h>
 #include <rocksdb/convenience.h>
 
+#include <numeric>
+
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
 #include "common/utils/MetaKeyUtils.h"
@@ -63,6 +65,14 @@ class RocksWriteBatch : public WriteBatch {
     }
   }
 
+  nebula::cpp2::ErrorCode merge(folly::StringPiece key, folly::StringPiece operand) override {
+    if (batch_.Merge(toSlice(key), toSlice(operand)).ok()) {
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    } else {
+      return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+  }
+
   rocksdb::WriteBatch* data() {
     return &batch_;
   }
@@ -270,8 +280,12 @@ nebula::cpp2::ErrorCode RocksEngine::prefixWithoutExtractor(
 
 nebula::cpp2::ErrorCode RocksEngine::rangeWithPrefix(const std::string& start,
                                                      const std::string& prefix,
-                                                     std::unique_ptr<KVIterator>* storageIter) {
+                                                     std::unique_ptr<KVIterator>* storageIter,
+                                                     const void* snapshot) {
   rocksdb::ReadOptions options;
+  if (snapshot != nullptr) {
+    options.snapshot = reinterpret_cast<const rocksdb::Snapshot*>(snapshot);
+  }
   // prefix_same_as_start is false by default
   options.total_order_seek = FLAGS_enable_rocksdb_prefix_filtering;
   rocksdb::Iterator* iter = db_->NewIterator(options);
@@ -377,6 +391,7 @@ void RocksEngine::removePart(PartitionID partId) {
   std::vector<std::string> sysKeysToDelete;
   sysKeysToDelete.emplace_back(partKey(partId));
   sysKeysToDelete.emplace_back(NebulaKeyUtils::systemCommitKey(partId));
+  sysKeysToDelete.emplace_back(NebulaKeyUtils::systemStatsKey(partId));
   auto code = multiRemove(sysKeysToDelete);
   if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
     partsNum_--;
@@ -466,6 +481,46 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> RocksEngine::getProperty(
   }
 }
 
+int64_t RocksEngine::approximatePartSize(PartitionID partId) {
+  // The data of a part which would be sent by snapshot when balance
+  auto prefixes = NebulaKeyUtils::snapshotPrefix(partId);
+  std::vector<std::string> ends;
+  std::vector<rocksdb::Range> ranges;
+  ends.reserve(prefixes.size());
+  ranges.reserve(prefixes.size());
+  for (const auto& prefix : prefixes) {
+    // The smallest key which is greater than all keys with the prefix
+    std::string end = prefix;
+    while (!end.empty() && static_cast<uint8_t>(end.back()) == 0xff) {
+      end.pop_back();
+    }
+    if (end.empty()) {
+      continue;
+    }
+    end.back()++;
+    ends.emplace_back(std::move(end));
+    ranges.emplace_back(prefix, ends.back());
+  }
+  std::vector<uint64_t> sizes(ranges.size(), 0);
+  db_->GetApproximateSizes(ranges.data(),
+                           static_cast<int>(ranges.size()),
+                           sizes.data(),
+                           rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES |
+                               rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES);
+  return std::accumulate(sizes.begin(), sizes.end(), static_cast<int64_t>(0));
+}
+
+int64_t RocksEngine::approximateSize(const std::string& start, const std::string& end) {
+  rocksdb::Range range(start, end);
+  uint64_t size = 0;
+  db_->GetApproximateSizes(&range,
+                           1,
+                           &size,
+                           rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES |
+                               rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES);
+  return static_cast<int64_t>(size);
+}
+
 nebula::cpp2::ErrorCode RocksEngine::compact() {
   rocksdb::CompactRangeOptions options;
   options.change_level = FLAGS_rocksdb_compact_change_level;
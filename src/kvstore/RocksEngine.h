@@ -262,11 +262,13 @@ class RocksEngine : public KVEngine {
    * @param start Start key, inclusive
    * @param prefix The prefix of keys to iterate
    * @param iter Iterator of keys starts with 'prefix' beginning from 'start'
+   * @param snapshot Snapshot from kv engine. nullptr means no snapshot.
    * @return nebula::cpp2::ErrorCode
    */
   nebula::cpp2::ErrorCode rangeWithPrefix(const std::string& start,
                                           const std::string& prefix,
-                                          std::unique_ptr<KVIterator>* iter) override;
+                                          std::unique_ptr<KVIterator>* iter,
+                                          const void* snapshot = nullptr) override;
 
   /**
    * @brief Prefix scan with prefix extractor
@@ -411,6 +413,23 @@ class RocksEngine : public KVEngine {
    */
   ErrorOr<nebula::cpp2::ErrorCode, std::string> getProperty(const std::string& property) override;
 
+  /**
+   * @brief Get the approximate bytes of the data of a part, including the memtables
+   *
+   * @param partId
+   * @return int64_t
+   */
+  int64_t approximatePartSize(PartitionID partId) override;
+
+  /**
+   * @brief Get the approximate bytes of the keys in [start, end), including the memtables
+   *
+   * @param start Start key, inclusive
+   * @param end End key, exclusive
+   * @return int64_t
+   */
+  int64_t approximateSize(const std::string& start, const std::string& end) override;
+
   /**
    * @brief Do data compation in lsm tree
    *
@@ -250,6 +250,127 @@ TEST(PartTest, PartCleanTest) {
   }
 }
 
+TEST(PartTest, PartStatsTest) {
+  fs::TempDir dataPath("/tmp/PartStatsTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, dataPath.path());
+  PartitionID partId = 1;
+  auto tagKey = [&](int vid, TagID tagId) {
+    return NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, std::to_string(vid), tagId);
+  };
+  auto edgeKey = [&](int src, EdgeType type, int dst) {
+    return NebulaKeyUtils::edgeKey(
+        kDefaultVIdLen, partId, std::to_string(src), type, 0, std::to_string(dst));
+  };
+  // Apply the writes of tracker to engine, and return the delta before them
+  auto commit = [&](const PartStatsTracker& tracker,
+                    const PartStats& before,
+                    const std::vector<std::string>& puts,
+                    const std::vector<std::string>& removes) {
+    // The tags of the vertices written are read by multiGet if the tags of part are known, which
+    // is the same as reading them by prefix
+    std::vector<TagID> knownTags;
+    for (const auto& [tagId, count] : before.tagVertices) {
+      if (count > 0) {
+        knownTags.emplace_back(tagId);
+      }
+    }
+    auto ret = tracker.delta(&knownTags);
+    EXPECT_TRUE(ok(ret));
+    auto byPrefix = tracker.delta();
+    EXPECT_TRUE(ok(byPrefix));
+    EXPECT_EQ(value(byPrefix).vertices, value(ret).vertices);
+    EXPECT_EQ(value(byPrefix).tagVertices, value(ret).tagVertices);
+    EXPECT_EQ(value(byPrefix).edges, value(ret).edges);
+    for (const auto& key : puts) {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(key, ""));
+    }
+    for (const auto& key : removes) {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->remove(key));
+    }
+    return value(ret);
+  };
+
+  PartStats stats;
+  {
+    // vertex 1 with tag 1, 2, vertex 2 with tag 1, out edges 1->2, 2->1 and in edge of 1->2
+    std::vector<std::string> puts = {tagKey(1, 1),
+                                     tagKey(1, 2),
+                                     tagKey(2, 1),
+                                     tagKey(2, 1),
+                                     edgeKey(1, 3, 2),
+                                     edgeKey(2, 3, 1),
+                                     edgeKey(2, -3, 1)};
+    PartStatsTracker tracker(engine.get(), partId, kDefaultVIdLen);
+    for (const auto& key : puts) {
+      tracker.put(key);
+    }
+    stats.add(commit(tracker, stats, puts, {}));
+    EXPECT_EQ(2, stats.vertices);
+    EXPECT_EQ(2, stats.tagVertices[1]);
+    EXPECT_EQ(1, stats.tagVertices[2]);
+    EXPECT_EQ(2, stats.edges[3]);
+    EXPECT_EQ(0, stats.edges.count(-3));
+  }
+  {
+    // overwrite existing keys, remove tag 1 of vertex 1 and the only tag of vertex 2
+    std::vector<std::string> puts = {tagKey(1, 2), edgeKey(1, 3, 2)};
+    std::vector<std::string> removes = {tagKey(1, 1), tagKey(2, 1), edgeKey(2, 3, 1)};
+    PartStatsTracker tracker(engine.get(), partId, kDefaultVIdLen);
+    for (const auto& key : puts) {
+      tracker.put(key);
+    }
+    for (const auto& key : removes) {
+      tracker.remove(key);
+    }
+    // remove a key which does not exist
+    tracker.remove(tagKey(3, 1));
+    stats.add(commit(tracker, stats, puts, removes));
+    EXPECT_EQ(1, stats.vertices);
+    EXPECT_EQ(0, stats.tagVertices[1]);
+    EXPECT_EQ(1, stats.tagVertices[2]);
+    EXPECT_EQ(1, stats.edges[3]);
+  }
+  {
+    // the later write of the same key wins
+    PartStatsTracker tracker(engine.get(), partId, kDefaultVIdLen);
+    tracker.put(tagKey(3, 1));
+    tracker.remove(tagKey(3, 1));
+    auto ret = tracker.delta();
+    ASSERT_TRUE(ok(ret));
+    EXPECT_TRUE(value(ret).empty());
+    EXPECT_FALSE(tracker.lost());
+  }
+  {
+    // the stats are the same as scanning all data
+    auto ret = PartStats::scan(engine.get(), partId, kDefaultVIdLen, nullptr, nullptr);
+    ASSERT_TRUE(ok(ret));
+    auto scanned = value(ret);
+    EXPECT_EQ(stats.vertices, scanned.vertices);
+    EXPECT_EQ(stats.tagVertices[2], scanned.tagVertices[2]);
+    EXPECT_EQ(0, scanned.tagVertices.count(1));
+    EXPECT_EQ(stats.edges[3], scanned.edges[3]);
+  }
+  {
+    PartStats decoded;
+    ASSERT_TRUE(PartStats::decode(stats.encode(), &decoded));
+    EXPECT_EQ(stats.vertices, decoded.vertices);
+    EXPECT_EQ(stats.tagVertices, decoded.tagVertices);
+    EXPECT_EQ(stats.edges, decoded.edges);
+    EXPECT_FALSE(PartStats::decode("", &decoded));
+  }
+  {
+    PartStatsTracker tracker(engine.get(), partId, kDefaultVIdLen);
+    auto indexPrefix = IndexKeyUtils::indexPrefix(partId);
+    tracker.removeRange(NebulaKeyUtils::firstKey(indexPrefix, sizeof(IndexID)),
+                        NebulaKeyUtils::lastKey(indexPrefix, sizeof(IndexID)));
+    EXPECT_FALSE(tracker.lost());
+    auto edgePrefix = NebulaKeyUtils::edgePrefix(partId);
+    tracker.removeRange(NebulaKeyUtils::firstKey(edgePrefix, kDefaultVIdLen),
+                        NebulaKeyUtils::lastKey(edgePrefix, kDefaultVIdLen));
+    EXPECT_TRUE(tracker.lost());
+  }
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -11,6 +11,7 @@
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
 #include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/CompactionFilter.h"
 #include "kvstore/RocksEngine.h"
 #include "kvstore/RocksEngineConfig.h"
 
@@ -198,6 +199,57 @@ TEST_P(RocksEngineTest, CompactTest) {
   EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->compact());
 }
 
+TEST_P(RocksEngineTest, CompactionDroppedPartsTest) {
+  // Remove the tags of part 1, the edges of part 3 and all system keys
+  class TestFilter : public KVFilter {
+   public:
+    bool filter(GraphSpaceID,
+                const folly::StringPiece& key,
+                const folly::StringPiece&) const override {
+      auto partId = NebulaKeyUtils::getPart(key);
+      if (NebulaKeyUtils::isSystem(key)) {
+        return true;
+      }
+      return (partId == 1 && NebulaKeyUtils::isTag(kDefaultVIdLen, key)) ||
+             (partId == 3 && NebulaKeyUtils::isEdge(kDefaultVIdLen, key));
+    }
+  };
+  class TestFilterFactory : public KVCompactionFilterFactory {
+   public:
+    explicit TestFilterFactory(GraphSpaceID spaceId) : KVCompactionFilterFactory(spaceId) {}
+
+    std::unique_ptr<KVFilter> createKVFilter() override {
+      return std::make_unique<TestFilter>();
+    }
+  };
+
+  fs::TempDir rootPath("/tmp/rocksdb_engine_CompactionDroppedPartsTest.XXXXXX");
+  auto cfFactory = std::make_shared<TestFilterFactory>(0);
+  std::unordered_set<PartitionID> dropped;
+  cfFactory->setDroppedPartsHandler(
+      [&dropped](GraphSpaceID, const std::unordered_set<PartitionID>& parts) {
+        dropped.insert(parts.begin(), parts.end());
+      });
+  auto engine =
+      std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path(), "", nullptr, cfFactory);
+  std::vector<KV> data;
+  for (PartitionID partId = 1; partId <= 4; partId++) {
+    data.emplace_back(NebulaKeyUtils::tagKey(kDefaultVIdLen, partId, "vertex", 1), "");
+    data.emplace_back(NebulaKeyUtils::edgeKey(kDefaultVIdLen, partId, "src", 1, 0, "dst"), "");
+    data.emplace_back(NebulaKeyUtils::systemCommitKey(partId), "");
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->compact());
+  // The system keys removed do not change the vertices or edges of part
+  EXPECT_EQ((std::unordered_set<PartitionID>{1, 3}), dropped);
+
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND,
+            engine->get(NebulaKeyUtils::tagKey(kDefaultVIdLen, 1, "vertex", 1), &val));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            engine->get(NebulaKeyUtils::tagKey(kDefaultVIdLen, 2, "vertex", 1), &val));
+}
+
 TEST_P(RocksEngineTest, IngestTest) {
   if (FLAGS_rocksdb_table_format == "PlainTable") {
     return;
@@ -7,6 +7,11 @@
 
 #include <utime.h>
 
+#include <folly/FileUtil.h>
+#include <folly/hash/Checksum.h>
+
+#include <climits>
+
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
 #include "common/time/WallClock.h"
@@ -16,12 +21,70 @@ DEFINE_int32(wal_ttl, 14400, "Default wal ttl");
 DEFINE_int64(wal_file_size, 16 * 1024 * 1024, "Default wal file size");
 DEFINE_int32(wal_buffer_size, 8 * 1024 * 1024, "Default wal buffer size");
 DEFINE_bool(wal_sync, false, "Whether fsync needs to be called every write");
+DEFINE_bool(wal_use_manifest,
+            true,
+            "Whether to record the sealed wal files in a manifest, which saves scanning them on "
+            "startup");
 
 namespace nebula {
 namespace wal {
 
 using nebula::fs::FileUtils;
 
+namespace {
+
+constexpr char kManifestName[] = "wal.manifest";
+constexpr uint8_t kManifestVersion = 0x01;
+
+// A wal file which is not written any more, it is trusted only if its size and mtime are the same
+struct ManifestEntry {
+  LogID firstId;
+  LogID lastId;
+  TermID lastTerm;
+  int64_t size;
+  int64_t mtime;
+};
+
+uint32_t checksum(folly::StringPiece data) {
+  return folly::crc32c(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+// The layout is: version | count | entries | crc32c of all the bytes before
+std::unordered_map<LogID, ManifestEntry> readManifest(const std::string& path) {
+  std::unordered_map<LogID, ManifestEntry> entries;
+  std::string data;
+  if (!folly::readFile(path.c_str(), data)) {
+    return entries;
+  }
+  uint32_t count = 0;
+  size_t headSize = sizeof(uint8_t) + sizeof(uint32_t);
+  if (data.size() < headSize + sizeof(uint32_t) ||
+      static_cast<uint8_t>(data[0]) != kManifestVersion) {
+    LOG(WARNING) << "Ignore the invalid wal manifest \"" << path << "\"";
+    return entries;
+  }
+  memcpy(&count, data.data() + sizeof(uint8_t), sizeof(uint32_t));
+  uint32_t crc = 0;
+  size_t bodySize = headSize + count * sizeof(ManifestEntry);
+  if (data.size() != bodySize + sizeof(uint32_t)) {
+    LOG(WARNING) << "Ignore the invalid wal manifest \"" << path << "\"";
+    return entries;
+  }
+  memcpy(&crc, data.data() + bodySize, sizeof(uint32_t));
+  if (crc != checksum(folly::StringPiece(data.data(), bodySize))) {
+    LOG(WARNING) << "Ignore the corrupted wal manifest \"" << path << "\"";
+    return entries;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    ManifestEntry entry;
+    memcpy(&entry, data.data() + headSize + i * sizeof(ManifestEntry), sizeof(ManifestEntry));
+    entries.emplace(entry.firstId, entry);
+  }
+  return entries;
+}
+
+}  // namespace
+
 /**********************************************
  *
  * Implementation of FileBasedWal
@@ -84,6 +147,11 @@ FileBasedWal::~FileBasedWal() {
 
 void FileBasedWal::scanAllWalFiles() {
   std::vector<std::string> files = FileUtils::listAllFilesInDir(dir_.c_str(), false, "*.wal");
+  std::unordered_map<LogID, ManifestEntry> manifest;
+  if (FLAGS_wal_use_manifest) {
+    manifest = readManifest(FileUtils::joinPath(dir_, kManifestName));
+  }
+  size_t trusted = 0;
   for (auto& fn : files) {
     // Split the file name
     // The file name convention is "<first id in the file>.wal"
@@ -115,6 +183,16 @@ void FileBasedWal::scanAllWalFiles() {
     info->setSize(st.st_size);
     info->setMTime(st.st_mtime);
 
+    auto entry = manifest.find(startIdFromName);
+    if (entry != manifest.end() && entry->second.size == st.st_size &&
+        entry->second.mtime == st.st_mtime && entry->second.lastId >= startIdFromName) {
+      // The file is not changed since it is sealed, no need to read its last log
+      info->setLastId(entry->second.lastId);
+      info->setLastTerm(entry->second.lastTerm);
+      trusted++;
+      continue;
+    }
+
     if (info->size() == 0) {
       // Found an empty WAL file
       LOG(WARNING) << "Found empty wal file \"" << fn << "\"";
@@ -224,6 +302,9 @@ void FileBasedWal::scanAllWalFiles() {
     close(fd);
   }
 
+  VLOG(2) << idStr_ << "Found " << walFiles_.size() << " wal files, " << trusted
+          << " of them are recorded in manifest";
+
   if (!walFiles_.empty()) {
     auto it = walFiles_.rbegin();
     // Try to scan last wal, if it is invalid or empty, scan the previous one
@@ -306,6 +387,51 @@ void FileBasedWal::prepareNewFile(LogID startLogId) {
                << "): " << strerror(errno);
   }
   currInfo_ = info;
+  // The previous files won't be written any more
+  writeManifest();
+}
+
+void FileBasedWal::writeManifest() {
+  if (!FLAGS_wal_use_manifest) {
+    return;
+  }
+  std::vector<ManifestEntry> entries;
+  entries.reserve(walFiles_.size());
+  for (const auto& [firstId, info] : walFiles_) {
+    if (info == currInfo_ || info->lastId() < firstId) {
+      continue;
+    }
+    entries.push_back({firstId,
+                       info->lastId(),
+                       info->lastTerm(),
+                       static_cast<int64_t>(info->size()),
+                       static_cast<int64_t>(info->mtime())});
+  }
+
+  std::string buf;
+  auto count = static_cast<uint32_t>(entries.size());
+  buf.reserve(sizeof(uint8_t) + sizeof(uint32_t) * 2 + count * sizeof(ManifestEntry));
+  buf.push_back(static_cast<char>(kManifestVersion));
+  buf.append(reinterpret_cast<const char*>(&count), sizeof(uint32_t));
+  buf.append(reinterpret_cast<const char*>(entries.data()), count * sizeof(ManifestEntry));
+  uint32_t crc = checksum(buf);
+  buf.append(reinterpret_cast<const char*>(&crc), sizeof(uint32_t));
+
+  // Replace the manifest atomically, a stale one is removed if failed
+  auto path = FileUtils::joinPath(dir_, kManifestName);
+  auto tmpPath = path + ".tmp";
+  int32_t fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  bool ok = fd >= 0 && folly::writeFull(fd, buf.data(), buf.size()) == (ssize_t)buf.size() &&
+            ::fsync(fd) == 0;
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (!ok || ::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << idStr_ << "Failed to write wal manifest \"" << path
+                 << "\", error: " << strerror(errno);
+    unlink(tmpPath.c_str());
+    unlink(path.c_str());
+  }
 }
 
 void FileBasedWal::rollbackInFile(WalFileInfoPtr info, LogID logId) {
@@ -439,9 +565,10 @@ void FileBasedWal::scanLastWal(WalFileInfoPtr info, LogID firstId) {
   close(fd);
 }
 
-bool FileBasedWal::appendLogInternal(LogID id, TermID term, ClusterID cluster, std::string msg) {
-  if (lastLogId_ != 0 && firstLogId_ != 0 && id != lastLogId_ + 1) {
-    VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastLogId_
+bool FileBasedWal::stageLog(LogID id, TermID term, ClusterID cluster, std::string msg) {
+  auto lastId = pending_.empty() ? lastLogId_ : pending_.back().id;
+  if (lastId != 0 && (firstLogId_ != 0 || !pending_.empty()) && id != lastId + 1) {
+    VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastId
             << ", and the id being appended is " << id;
     return false;
   }
@@ -451,50 +578,95 @@ bool FileBasedWal::appendLogInternal(LogID id, TermID term, ClusterID cluster, s
     return false;
   }
 
-  // Write to the WAL file first
-  std::string strBuf;
-  strBuf.reserve(sizeof(LogID) + sizeof(TermID) + sizeof(ClusterID) + msg.size() +
-                 2 * sizeof(int32_t));
-  strBuf.append(reinterpret_cast<char*>(&id), sizeof(LogID));
-  strBuf.append(reinterpret_cast<char*>(&term), sizeof(TermID));
-  int32_t len = msg.size();
-  strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
-  strBuf.append(reinterpret_cast<char*>(&cluster), sizeof(ClusterID));
-  strBuf.append(reinterpret_cast<const char*>(msg.data()), msg.size());
-  strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
-
   // Prepare the WAL file if it's not opened
+  size_t size = kLogHeadSize + msg.size() + sizeof(int32_t);
   if (currFd_ < 0) {
+    std::lock_guard<std::mutex> g(walFilesMutex_);
     prepareNewFile(id);
-  } else if (currInfo_->size() + strBuf.size() > policy_.fileSize) {
-    // Need to roll over
+  } else if (currInfo_->size() + pendingBytes_ + size > policy_.fileSize) {
+    // Need to roll over, the staged logs belong to the current file
+    flushPending();
     closeCurrFile();
 
     std::lock_guard<std::mutex> g(walFilesMutex_);
     prepareNewFile(id);
   }
 
-  ssize_t bytesWritten = write(currFd_, strBuf.data(), strBuf.size());
-  if (bytesWritten != (ssize_t)strBuf.size()) {
-    LOG(FATAL) << idStr_ << "bytesWritten:" << bytesWritten << ", expected:" << strBuf.size()
-               << ", error:" << strerror(errno);
+  auto& log = pending_.emplace_back();
+  log.id = id;
+  log.term = term;
+  log.cluster = cluster;
+  log.len = msg.size();
+  char* head = log.head;
+  memcpy(head, &id, sizeof(LogID));
+  head += sizeof(LogID);
+  memcpy(head, &term, sizeof(TermID));
+  head += sizeof(TermID);
+  memcpy(head, &log.len, sizeof(int32_t));
+  head += sizeof(int32_t);
+  memcpy(head, &cluster, sizeof(ClusterID));
+  log.msg = std::move(msg);
+  pendingBytes_ += size;
+  return true;
+}
+
+void FileBasedWal::flushPending() {
+  if (pending_.empty()) {
+    return;
+  }
+  CHECK_GE(currFd_, 0);
+
+  // The head, msg and tail of each log, pending_ won't be reallocated until they are written
+  iovs_.clear();
+  iovs_.reserve(pending_.size() * 3);
+  for (auto& log : pending_) {
+    iovs_.push_back({log.head, kLogHeadSize});
+    iovs_.push_back({log.msg.data(), log.msg.size()});
+    iovs_.push_back({&log.len, sizeof(int32_t)});
+  }
+
+  size_t idx = 0;
+  while (idx < iovs_.size()) {
+    auto count = std::min<size_t>(iovs_.size() - idx, IOV_MAX);
+    ssize_t bytesWritten = ::writev(currFd_, &iovs_[idx], count);
+    if (bytesWritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(FATAL) << idStr_ << "Failed to write " << pendingBytes_ << " bytes of "
+                 << pending_.size() << " logs, error:" << strerror(errno);
+    }
+    // Skip the iovecs written, and continue from where the last one is partially written
+    size_t written = bytesWritten;
+    while (idx < iovs_.size() && written >= iovs_[idx].iov_len) {
+      written -= iovs_[idx].iov_len;
+      idx++;
+    }
+    if (written > 0) {
+      iovs_[idx].iov_base = static_cast<char*>(iovs_[idx].iov_base) + written;
+      iovs_[idx].iov_len -= written;
+    }
   }
 
   if (policy_.sync && ::fsync(currFd_) == -1) {
     LOG(WARNING) << "sync wal \"" << currInfo_->path() << "\" failed, error: " << strerror(errno);
   }
-  currInfo_->setSize(currInfo_->size() + strBuf.size());
-  currInfo_->setLastId(id);
-  currInfo_->setLastTerm(term);
+  const auto& last = pending_.back();
+  currInfo_->setSize(currInfo_->size() + pendingBytes_);
+  currInfo_->setLastId(last.id);
+  currInfo_->setLastTerm(last.term);
 
-  lastLogId_ = id;
-  lastLogTerm_ = term;
+  lastLogId_ = last.id;
+  lastLogTerm_ = last.term;
   if (firstLogId_ == 0) {
-    firstLogId_ = id;
+    firstLogId_ = pending_.front().id;
   }
 
-  logBuffer_->push(id, term, cluster, std::move(msg));
-  return true;
+  for (auto& log : pending_) {
+    logBuffer_->push(log.id, log.term, log.cluster, std::move(log.msg));
+  }
+  pending_.clear();
+  pendingBytes_ = 0;
 }
 
 bool FileBasedWal::appendLog(LogID id, TermID term, ClusterID cluster, std::string msg) {
@@ -502,10 +674,11 @@ bool FileBasedWal::appendLog(LogID id, TermID term, ClusterID cluster, std::stri
     VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
     return false;
   }
-  if (!appendLogInternal(id, term, cluster, std::move(msg))) {
+  if (!stageLog(id, term, cluster, std::move(msg))) {
     VLOG(3) << "Failed to append log for logId " << id;
     return false;
   }
+  flushPending();
   return true;
 }
 
@@ -514,14 +687,16 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
     VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
     return false;
   }
+  // All the logs of batch are written by one writev and synced once, except the ones written
+  // before rolling over. The logs before the failed one are still appended as before.
   for (; iter.valid(); ++iter) {
-    if (!appendLogInternal(
-            iter.logId(), iter.logTerm(), iter.logSource(), iter.logMsg().toString())) {
+    if (!stageLog(iter.logId(), iter.logTerm(), iter.logSource(), iter.logMsg().toString())) {
       VLOG(3) << idStr_ << "Failed to append log for logId " << iter.logId();
+      flushPending();
       return false;
     }
   }
-
+  flushPending();
   return true;
 }
 
@@ -607,6 +782,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
       CHECK_EQ(lastLogId_, id);
       CHECK_EQ(walFiles_.rbegin()->second->lastId(), id);
     }
+    writeManifest();
   }
 
   //------------------------------
@@ -630,6 +806,7 @@ bool FileBasedWal::reset() {
     VLOG(3) << "Removing " << absFn;
     unlink(absFn.c_str());
   }
+  unlink(FileUtils::joinPath(dir_, kManifestName).c_str());
   lastLogId_ = firstLogId_ = 0;
   return true;
 }
@@ -8,6 +8,7 @@
 
 #include <folly/Function.h>
 #include <gtest/gtest_prod.h>
+#include <sys/uio.h>
 
 #include "common/base/Base.h"
 #include "common/base/Cord.h"
@@ -226,6 +227,12 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
    */
   void prepareNewFile(LogID startLogId);
 
+  /**
+   * @brief Record the wal files except the current one in the manifest, so they are not scanned
+   * on startup. Must be called with walFilesMutex_ held
+   */
+  void writeManifest();
+
   /**
    * @brief Rollback to logId in given file
    *
@@ -235,15 +242,22 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
   void rollbackInFile(WalFileInfoPtr info, LogID logId);
 
   /**
-   * @brief The actaul implementation of appendLog()
+   * @brief Check the log and stage it to be written by flushPending(), the staged logs are
+   * flushed first if the current wal file needs to roll over
    *
    * @param id Log id to append
    * @param term Log term to append
    * @param cluster Cluster id in log to append
    * @param msg Log messgage to append
-   * @return Wheter append succeed
+   * @return Wheter the log is staged
    */
-  bool appendLogInternal(LogID id, TermID term, ClusterID cluster, std::string msg);
+  bool stageLog(LogID id, TermID term, ClusterID cluster, std::string msg);
+
+  /**
+   * @brief Write all the staged logs to the current wal file by writev, and sync it once if
+   * needed, then put them into the log buffer
+   */
+  void flushPending();
 
  private:
   using WalFiles = std::map<LogID, WalFileInfoPtr>;
@@ -277,6 +291,25 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
 
   std::shared_ptr<AtomicLogBuffer> logBuffer_;
 
+  // The layout of a log in wal file is: id | term | msg size | cluster | msg | msg size
+  static constexpr size_t kLogHeadSize =
+      sizeof(LogID) + sizeof(TermID) + sizeof(int32_t) + sizeof(ClusterID);
+
+  struct PendingLog {
+    LogID id;
+    TermID term;
+    ClusterID cluster;
+    int32_t len;
+    char head[kLogHeadSize];
+    std::string msg;
+  };
+
+  // The logs staged but not written yet, only accessed by the thread appending logs like currFd_.
+  // The vectors are kept across batches to avoid reallocating them
+  std::vector<PendingLog> pending_;
+  size_t pendingBytes_{0};
+  std::vector<struct iovec> iovs_;
+
   PreProcessor preProcessor_;
 
   std::shared_ptr<kvstore::DiskManager> diskMan_;
@@ -120,6 +120,168 @@ TEST(FileBasedWal, CacheOverflow) {
   EXPECT_EQ(10001, id);
 }
 
+class BatchLogIterator final : public LogIterator {
+ public:
+  explicit BatchLogIterator(std::vector<std::pair<LogID, std::string>> logs)
+      : logs_(std::move(logs)) {}
+
+  LogIterator& operator++() override {
+    idx_++;
+    return *this;
+  }
+
+  bool valid() const override {
+    return idx_ < logs_.size();
+  }
+
+  LogID logId() const override {
+    return logs_[idx_].first;
+  }
+
+  TermID logTerm() const override {
+    return 1;
+  }
+
+  ClusterID logSource() const override {
+    return 0;
+  }
+
+  folly::StringPiece logMsg() const override {
+    return logs_[idx_].second;
+  }
+
+ private:
+  std::vector<std::pair<LogID, std::string>> logs_;
+  size_t idx_{0};
+};
+
+TEST(FileBasedWal, AppendLogsInBatch) {
+  FileBasedWalInfo info;
+  FileBasedWalPolicy policy;
+  policy.fileSize = 1024L * 1024L;
+  policy.bufferSize = 1024L * 1024L;
+  policy.sync = true;
+
+  TempDir walDir("/tmp/testWal.XXXXXX");
+  auto wal = FileBasedWal::getWal(
+      walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+
+  // Append > 10MB logs in batches, the files roll over in the middle of batches
+  for (int i = 1; i <= 10000; i += 100) {
+    std::vector<std::pair<LogID, std::string>> logs;
+    for (int j = i; j < i + 100; j++) {
+      logs.emplace_back(j, folly::stringPrintf(kLongMsg, j));
+    }
+    BatchLogIterator iter(std::move(logs));
+    ASSERT_TRUE(wal->appendLogs(iter));
+  }
+  ASSERT_EQ(10000, wal->lastLogId());
+
+  // The logs before the gap are still appended
+  {
+    std::vector<std::pair<LogID, std::string>> logs;
+    for (int j = 10001; j <= 10005; j++) {
+      logs.emplace_back(j, folly::stringPrintf(kLongMsg, j));
+    }
+    logs.emplace_back(10007, folly::stringPrintf(kLongMsg, 10007));
+    BatchLogIterator iter(std::move(logs));
+    ASSERT_FALSE(wal->appendLogs(iter));
+  }
+  ASSERT_EQ(10005, wal->lastLogId());
+
+  // Close the wal
+  wal.reset();
+
+  // Same as appending the logs one by one
+  auto files = FileUtils::listAllFilesInDir(walDir.path());
+  ASSERT_EQ(11, files.size());
+
+  wal = FileBasedWal::getWal(
+      walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  EXPECT_EQ(10005, wal->lastLogId());
+
+  auto it = wal->iterator(1, 10005);
+  LogID id = 1;
+  while (it->valid()) {
+    ASSERT_EQ(id, it->logId());
+    ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+    ++(*it);
+    ++id;
+  }
+  EXPECT_EQ(10006, id);
+}
+
+TEST(FileBasedWal, ManifestTest) {
+  FileBasedWalInfo info;
+  FileBasedWalPolicy policy;
+  policy.fileSize = 1024L * 1024L;
+  policy.bufferSize = 1024L * 1024L;
+
+  TempDir walDir("/tmp/testWal.XXXXXX");
+  auto wal = FileBasedWal::getWal(
+      walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+      });
+  for (int i = 1; i <= 5000; i++) {
+    ASSERT_TRUE(
+        wal->appendLog(i /*id*/, i /*term*/, 0 /*cluster*/, folly::stringPrintf(kLongMsg, i)));
+  }
+  wal.reset();
+  auto manifest = FileUtils::joinPath(walDir.path(), "wal.manifest");
+  ASSERT_TRUE(FileUtils::exist(manifest));
+
+  auto collect = [](std::shared_ptr<FileBasedWal> w) {
+    std::vector<std::tuple<LogID, LogID, TermID, size_t>> infos;
+    w->accessAllWalInfo([&](WalFileInfoPtr i) {
+      infos.emplace_back(i->firstId(), i->lastId(), i->lastTerm(), i->size());
+      return true;
+    });
+    return infos;
+  };
+  auto openWal = [&]() {
+    return FileBasedWal::getWal(
+        walDir.path(), info, policy, [](LogID, TermID, ClusterID, const std::string&) {
+          return true;
+        });
+  };
+
+  // The files recorded in manifest are the same as the ones scanned
+  wal = openWal();
+  auto withManifest = collect(wal);
+  ASSERT_EQ(6, withManifest.size());
+  EXPECT_EQ(5000, wal->lastLogId());
+  EXPECT_EQ(5000, wal->lastLogTerm());
+  wal.reset();
+
+  ASSERT_TRUE(FileUtils::remove(manifest.c_str()));
+  wal = openWal();
+  EXPECT_EQ(withManifest, collect(wal));
+  wal.reset();
+
+  // A corrupted manifest is ignored
+  {
+    int fd = ::open(manifest.c_str(), O_CREAT | O_WRONLY, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(3, ::write(fd, "bad", 3));
+    ::close(fd);
+  }
+  wal = openWal();
+  EXPECT_EQ(withManifest, collect(wal));
+
+  // Roll back into a sealed file, and the manifest is updated with it
+  ASSERT_TRUE(wal->rollbackToLog(1000));
+  ASSERT_TRUE(wal->appendLog(1001, 1001, 0, folly::stringPrintf(kLongMsg, 1001)));
+  auto rolledBack = collect(wal);
+  wal.reset();
+  wal = openWal();
+  EXPECT_EQ(rolledBack, collect(wal));
+  EXPECT_EQ(1001, wal->lastLogId());
+}
+
 TEST(FileBasedWal, Rollback) {
   // Force to make each file 1MB, each buffer is 1MB, and there are two
   // buffers at most
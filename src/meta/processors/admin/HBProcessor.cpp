@@ -103,6 +103,23 @@ void HBProcessor::process(const cpp2::HBReq& req) {
     }
   }
 
+  // update part loads, which are used to balance data, only the changed ones are written
+  if (req.get_role() == cpp2::HostRole::STORAGE && req.part_loads_ref().has_value()) {
+    std::vector<kvstore::KV> data;
+    for (const auto& [spaceId, partLoads] : *req.get_part_loads()) {
+      auto key = MetaKeyUtils::partLoadsKey(host, spaceId);
+      auto val = MetaKeyUtils::partLoadsVal(partLoads);
+      auto oldVal = doGet(key);
+      if (nebula::ok(oldVal) && nebula::value(oldVal) == val) {
+        continue;
+      }
+      data.emplace_back(std::move(key), std::move(val));
+    }
+    if (!data.empty()) {
+      ret = doSyncPut(std::move(data));
+    }
+  }
+
   // set update time and meta version
   auto lastUpdateTimeRet = LastUpdateTimeMan::get(kvstore_);
   if (nebula::ok(lastUpdateTimeRet)) {
@@ -11,6 +11,16 @@
 #include "kvstore/NebulaStore.h"
 #include "meta/processors/job/JobUtils.h"
 
+DEFINE_double(balance_disk_size_weight,
+              1.0,
+              "Weight of the disk size of parts when balance data by the loads of parts");
+DEFINE_double(balance_read_qps_weight,
+              0.5,
+              "Weight of the read qps of parts when balance data by the loads of parts");
+DEFINE_double(balance_write_qps_weight,
+              0.5,
+              "Weight of the write qps of parts when balance data by the loads of parts");
+
 namespace nebula {
 namespace meta {
 BalanceJobExecutor::BalanceJobExecutor(JobID jobId,
@@ -148,6 +158,20 @@ nebula::cpp2::ErrorCode SpaceInfo::loadInfo(GraphSpaceID spaceId, kvstore::KVSto
     }
     zones_.emplace(zoneName, zone);
   }
+  for (auto& [zn, zone] : zones_) {
+    for (auto& [ha, host] : zone.hosts_) {
+      std::string loadsVal;
+      auto loadsKey = MetaKeyUtils::partLoadsKey(ha, spaceId);
+      if (kvstore->get(kDefaultSpaceId, kDefaultPartId, loadsKey, &loadsVal) !=
+          nebula::cpp2::ErrorCode::SUCCEEDED) {
+        continue;
+      }
+      auto loads = MetaKeyUtils::parsePartLoadsVal(loadsVal);
+      for (auto& load : *loads.part_loads_ref()) {
+        host.loads_.emplace(load.get_part_id(), load);
+      }
+    }
+  }
   const auto& prefix = MetaKeyUtils::partPrefix(spaceId);
   std::unique_ptr<kvstore::KVIterator> iter;
   auto retCode = kvstore->prefix(kDefaultSpaceId, kDefaultPartId, prefix, &iter);
@@ -191,6 +215,63 @@ bool Zone::partExist(PartitionID partId) {
   return false;
 }
 
+std::unordered_map<PartitionID, PartCost> Zone::partCosts() const {
+  std::unordered_map<PartitionID, PartCost> costs;
+  double totalSize = 0;
+  double totalRead = 0;
+  double totalWrite = 0;
+  for (const auto& [ha, host] : hosts_) {
+    for (const auto& [partId, load] : host.loads_) {
+      if (host.parts_.count(partId)) {
+        totalSize += load.get_disk_size();
+        totalRead += load.get_read_qps();
+        totalWrite += load.get_write_qps();
+      }
+    }
+  }
+  double sizeWeight = totalSize > 0 ? FLAGS_balance_disk_size_weight : 0;
+  double readWeight = totalRead > 0 ? FLAGS_balance_read_qps_weight : 0;
+  double writeWeight = totalWrite > 0 ? FLAGS_balance_write_qps_weight : 0;
+  if (sizeWeight + readWeight + writeWeight <= 0) {
+    return costs;
+  }
+  std::vector<PartitionID> unknownParts;
+  double knownCost = 0;
+  double knownSize = 0;
+  for (const auto& [ha, host] : hosts_) {
+    for (auto partId : host.parts_) {
+      auto it = host.loads_.find(partId);
+      if (it == host.loads_.end()) {
+        unknownParts.emplace_back(partId);
+        continue;
+      }
+      const auto& load = it->second;
+      PartCost cost;
+      cost.size = sizeWeight > 0 ? load.get_disk_size() / totalSize : 0;
+      cost.cost = sizeWeight * cost.size;
+      if (readWeight > 0) {
+        cost.cost += readWeight * load.get_read_qps() / totalRead;
+      }
+      if (writeWeight > 0) {
+        cost.cost += writeWeight * load.get_write_qps() / totalWrite;
+      }
+      knownCost += cost.cost;
+      knownSize += cost.size;
+      costs[partId] = cost;
+    }
+  }
+  if (costs.empty()) {
+    return costs;
+  }
+  PartCost avg;
+  avg.cost = knownCost / costs.size();
+  avg.size = knownSize / costs.size();
+  for (auto partId : unknownParts) {
+    costs[partId] = avg;
+  }
+  return costs;
+}
+
 bool SpaceInfo::hasHost(const HostAddr& ha) {
   for (auto p : zones_) {
     if (p.second.hasHost(ha)) {
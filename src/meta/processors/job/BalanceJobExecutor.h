@@ -22,6 +22,15 @@ struct Host {
 
   HostAddr host_;
   std::set<PartitionID> parts_;
+  // loads of the parts reported by the host in heartbeat, the parts without load are unknown
+  std::unordered_map<PartitionID, cpp2::PartLoad> loads_;
+};
+
+struct PartCost {
+  // share of the weighted disk size and traffic of the zone
+  double cost{0};
+  // share of the disk size of the zone, which is the data to move
+  double size{0};
 };
 
 struct Zone {
@@ -53,6 +62,15 @@ struct Zone {
    */
   bool partExist(PartitionID partId);
 
+  /**
+   * @brief Get the cost of each part in the zone by the reported loads, weighted by
+   * balance_disk_size_weight, balance_read_qps_weight and balance_write_qps_weight. The parts
+   * without load get the average cost.
+   *
+   * @return Empty if no host of the zone has reported loads
+   */
+  std::unordered_map<PartitionID, PartCost> partCosts() const;
+
   std::string zoneName_;
   std::map<HostAddr, Host> hosts_;
   int32_t partNum_;
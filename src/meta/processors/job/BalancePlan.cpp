@@ -22,13 +22,21 @@ void BalancePlan::dispatchTasks() {
   for (auto& task : tasks_) {
     partTasks[std::make_pair(task.spaceId_, task.partId_)].emplace_back(index++);
   }
-  buckets_.resize(partTasks.size());
-  int32_t bucketIndex = 0;
+  // The buckets are interleaved by the source host of their first task, so the buckets running
+  // at the same time copy data from different hosts as far as possible, which bounds the disk
+  // throughput taken by balance on each host
+  std::map<HostAddr, std::vector<Bucket>> hostBuckets;
   for (auto it = partTasks.begin(); it != partTasks.end(); it++) {
-    for (auto taskIndex : it->second) {
-      buckets_[bucketIndex].emplace_back(taskIndex);
+    hostBuckets[tasks_[it->second.front()].getSrcHost()].emplace_back(std::move(it->second));
+  }
+  buckets_.clear();
+  buckets_.reserve(partTasks.size());
+  for (size_t round = 0; buckets_.size() < partTasks.size(); round++) {
+    for (auto& [host, bucketList] : hostBuckets) {
+      if (round < bucketList.size()) {
+        buckets_.emplace_back(std::move(bucketList[round]));
+      }
     }
-    bucketIndex++;
   }
 }
 
@@ -105,7 +105,8 @@ class BalancePlan {
   nebula::cpp2::ErrorCode recovery(bool resume = true);
 
   /**
-   * @brief Dispatch tasks to buckets for parallel execution
+   * @brief Dispatch tasks to buckets for parallel execution, the tasks of the same part are in
+   * one bucket, and the buckets of different source hosts are interleaved
    */
   void dispatchTasks();
 
@@ -11,6 +11,10 @@
 #include "kvstore/NebulaStore.h"
 #include "meta/processors/job/JobUtils.h"
 
+DEFINE_double(balance_load_tolerance,
+              0.05,
+              "Hosts are balanced if the gap of their costs is within this ratio of the average");
+
 namespace nebula {
 namespace meta {
 
@@ -63,18 +67,38 @@ Status DataBalanceJobExecutor::buildBalancePlan() {
       return l->parts_.size() < r->parts_.size();
     });
   }
+  // the costs must be calculated before the parts of lost hosts are moved
+  std::map<std::string, std::unordered_map<PartitionID, PartCost>> zoneCosts;
+  for (auto& [zoneName, zone] : spaceInfo_.zones_) {
+    zoneCosts[zoneName] = zone.partCosts();
+  }
+  auto hostCost = [](const Host* host, const std::unordered_map<PartitionID, PartCost>& costs) {
+    double cost = 0;
+    for (PartitionID partId : host->parts_) {
+      cost += costs.at(partId).cost;
+    }
+    return cost;
+  };
   std::map<PartitionID, std::vector<BalanceTask>> existTasks;
   // move parts of lost hosts to active hosts in the same zone
   for (auto& zoneHostEntry : lostZoneHost) {
     const std::string& zoneName = zoneHostEntry.first;
     std::vector<Host*>& lostHostVec = zoneHostEntry.second;
     std::vector<Host*>& activeVec = activeSortedHost[zoneName];
+    const auto& costs = zoneCosts[zoneName];
     if (activeVec.size() == 0) {
       return Status::Error("zone %s has no host", zoneName.c_str());
     }
     for (Host* host : lostHostVec) {
       for (PartitionID partId : host->parts_) {
         Host* dstHost = activeVec.front();
+        if (!costs.empty()) {
+          for (Host* h : activeVec) {
+            if (hostCost(h, costs) < hostCost(dstHost, costs)) {
+              dstHost = h;
+            }
+          }
+        }
         dstHost->parts_.insert(partId);
         existTasks[partId].emplace_back(jobId_,
                                         spaceInfo_.spaceId_,
@@ -164,7 +188,12 @@ Status DataBalanceJobExecutor::buildBalancePlan() {
   };
   for (auto& pair : activeSortedHost) {
     std::vector<Host*>& hvec = pair.second;
-    balanceHostVec(hvec);
+    const auto& costs = zoneCosts[pair.first];
+    if (costs.empty()) {
+      balanceHostVec(hvec);
+    } else {
+      balanceHostsByLoad(hvec, costs, &existTasks);
+    }
   }
   bool emty = std::find_if(existTasks.begin(),
                            existTasks.end(),
@@ -187,6 +216,67 @@ Status DataBalanceJobExecutor::buildBalancePlan() {
   return Status::OK();
 }
 
+void DataBalanceJobExecutor::balanceHostsByLoad(
+    const std::vector<Host*>& hostVec,
+    const std::unordered_map<PartitionID, PartCost>& costs,
+    std::map<PartitionID, std::vector<BalanceTask>>* existTasks) {
+  if (hostVec.size() < 2) {
+    return;
+  }
+  std::vector<double> hostCosts(hostVec.size(), 0);
+  double totalCost = 0;
+  size_t totalPartNum = 0;
+  for (size_t i = 0; i < hostVec.size(); i++) {
+    for (PartitionID partId : hostVec[i]->parts_) {
+      hostCosts[i] += costs.at(partId).cost;
+    }
+    totalCost += hostCosts[i];
+    totalPartNum += hostVec[i]->parts_.size();
+  }
+  double tolerance = FLAGS_balance_load_tolerance * totalCost / hostVec.size();
+  // Every move narrows the costs of hosts, the number of moves is bounded to keep the plan small
+  for (size_t moves = 0; moves < totalPartNum; moves++) {
+    auto minmax = std::minmax_element(hostCosts.begin(), hostCosts.end());
+    size_t dst = minmax.first - hostCosts.begin();
+    size_t src = minmax.second - hostCosts.begin();
+    double gap = hostCosts[src] - hostCosts[dst];
+    if (gap <= tolerance) {
+      break;
+    }
+    PartitionID movePart = -1;
+    double bestNarrowed = 0;
+    double bestSize = 0;
+    for (PartitionID partId : hostVec[src]->parts_) {
+      const auto& cost = costs.at(partId);
+      // a part whose cost is not less than the gap would not narrow it
+      if (cost.cost <= 0 || cost.cost >= gap) {
+        continue;
+      }
+      double narrowed = gap - std::abs(gap - 2 * cost.cost);
+      if (narrowed > bestNarrowed || (narrowed == bestNarrowed && cost.size < bestSize)) {
+        bestNarrowed = narrowed;
+        bestSize = cost.size;
+        movePart = partId;
+      }
+    }
+    if (movePart == -1) {
+      break;
+    }
+    hostVec[src]->parts_.erase(movePart);
+    hostVec[dst]->parts_.insert(movePart);
+    hostCosts[src] -= costs.at(movePart).cost;
+    hostCosts[dst] += costs.at(movePart).cost;
+    insertOneTask(BalanceTask(jobId_,
+                              spaceInfo_.spaceId_,
+                              movePart,
+                              hostVec[src]->host_,
+                              hostVec[dst]->host_,
+                              kvstore_,
+                              adminClient_),
+                  existTasks);
+  }
+}
+
 nebula::cpp2::ErrorCode DataBalanceJobExecutor::stop() {
   stopped_ = true;
   plan_->stop();
@@ -16,6 +16,7 @@ namespace meta {
  */
 class DataBalanceJobExecutor : public BalanceJobExecutor {
   FRIEND_TEST(BalanceTest, BalanceDataPlanTest);
+  FRIEND_TEST(BalanceTest, BalanceDataByLoadTest);
   FRIEND_TEST(BalanceTest, NormalDataTest);
   FRIEND_TEST(BalanceTest, RecoveryTest);
   FRIEND_TEST(BalanceTest, StopPlanTest);
@@ -54,12 +55,28 @@ class DataBalanceJobExecutor : public BalanceJobExecutor {
    * @brief Build a balance plan, which balance data in each zone
    * First, move parts from lost hosts to active hosts
    * Second, rebalance the active hosts in each zone
+   * The hosts are balanced by the cost of parts if the loads of parts are reported, otherwise by
+   * the number of parts.
    *
    * @return
    */
   Status buildBalancePlan() override;
 
  private:
+  /**
+   * @brief Move parts from the host with the most cost to the one with the least cost, until their
+   * gap is within balance_load_tolerance of the average. Each time the part which narrows the gap
+   * most is moved, and the smaller one is preferred among the parts narrowing the same, so the
+   * data to move is as little as possible.
+   *
+   * @param hostVec Active hosts of a zone
+   * @param costs Costs of all parts in the zone
+   * @param existTasks
+   */
+  void balanceHostsByLoad(const std::vector<Host*>& hostVec,
+                          const std::unordered_map<PartitionID, PartCost>& costs,
+                          std::map<PartitionID, std::vector<BalanceTask>>* existTasks);
+
   std::vector<HostAddr> lostHosts_;
   JobDescription jobDescription_;
 };
@@ -122,6 +122,24 @@ void DropSpaceProcessor::process(const cpp2::DropSpaceReq& req) {
   auto localIdkey = MetaKeyUtils::localIdKey(spaceId);
   deleteKeys.emplace_back(localIdkey);
 
+  // 8. Delete the part loads reported by storage hosts
+  auto loadsRet = doPrefix(MetaKeyUtils::partLoadsPrefix());
+  if (!nebula::ok(loadsRet)) {
+    auto retCode = nebula::error(loadsRet);
+    LOG(ERROR) << "Drop space Failed, space " << spaceName
+               << " error: " << apache::thrift::util::enumNameSafe(retCode);
+    handleErrorCode(retCode);
+    onFinished();
+    return;
+  }
+  auto loadsIter = nebula::value(loadsRet).get();
+  while (loadsIter->valid()) {
+    if (MetaKeyUtils::parsePartLoadsSpace(loadsIter->key()) == spaceId) {
+      deleteKeys.emplace_back(loadsIter->key());
+    }
+    loadsIter->next();
+  }
+
   doSyncMultiRemoveAndUpdate(std::move(deleteKeys));
   LOG(INFO) << "Drop space " << spaceName << ", id " << spaceId;
 }
@@ -436,6 +436,71 @@ TEST(BalanceTest, BalanceDataPlanTest) {
   EXPECT_EQ(status, Status::Balanced());
 }
 
+TEST(BalanceTest, BalanceDataByLoadTest) {
+  fs::TempDir rootPath("/tmp/BalanceDataByLoadTest.XXXXXX");
+  std::unique_ptr<kvstore::NebulaStore> store = MockCluster::initMetaKV(rootPath.path());
+  auto setLoads = [](Zone& zone, const HostAddr& ha, int64_t size, int64_t readQps) {
+    auto& host = zone.hosts_[ha];
+    for (auto partId : host.parts_) {
+      cpp2::PartLoad load;
+      load.part_id_ref() = partId;
+      load.disk_size_ref() = size;
+      load.read_qps_ref() = readQps;
+      load.write_qps_ref() = 0;
+      host.loads_.emplace(partId, std::move(load));
+    }
+  };
+  HostAddr host1("127.0.0.1", 11);
+  HostAddr host2("127.0.0.1", 12);
+  {
+    // balanced by the number of parts, but all reads are on host1
+    SpaceInfo spaceInfo = createSpaceInfo(
+        "space1", 1, 1, {{"zone1", {{host1, {1, 2, 3, 4}}, {host2, {5, 6, 7, 8}}}}});
+    auto& zone = spaceInfo.zones_["zone1"];
+    setLoads(zone, host1, 100, 100);
+    setLoads(zone, host2, 100, 0);
+    auto costs = zone.partCosts();
+    ASSERT_EQ(8, costs.size());
+    EXPECT_DOUBLE_EQ(0.25, costs[1].cost);
+    EXPECT_DOUBLE_EQ(0.125, costs[5].cost);
+    EXPECT_DOUBLE_EQ(0.125, costs[5].size);
+
+    DataBalanceJobExecutor balancer(JobDescription(), store.get(), nullptr, {});
+    balancer.spaceInfo_ = spaceInfo;
+    Status status = balancer.buildBalancePlan();
+    EXPECT_EQ(status, Status::OK());
+    // one part of host1 is enough to even out the costs
+    EXPECT_EQ(3, balancer.spaceInfo_.zones_["zone1"].hosts_[host1].parts_.size());
+    EXPECT_EQ(5, balancer.spaceInfo_.zones_["zone1"].hosts_[host2].parts_.size());
+    ASSERT_EQ(1, balancer.plan_->tasks().size());
+    EXPECT_EQ(host1, balancer.plan_->tasks()[0].getSrcHost());
+    EXPECT_EQ(host2, balancer.plan_->tasks()[0].getDstHost());
+  }
+  {
+    // the part without load gets the average cost
+    SpaceInfo spaceInfo =
+        createSpaceInfo("space1", 1, 1, {{"zone1", {{host1, {1, 2}}, {host2, {3}}}}});
+    auto& zone = spaceInfo.zones_["zone1"];
+    setLoads(zone, host1, 100, 0);
+    auto costs = zone.partCosts();
+    ASSERT_EQ(3, costs.size());
+    EXPECT_DOUBLE_EQ(0.5, costs[1].cost);
+    EXPECT_DOUBLE_EQ(0.5, costs[3].cost);
+    EXPECT_DOUBLE_EQ(0.5, costs[3].size);
+  }
+  {
+    // no loads reported, balanced by the number of parts
+    SpaceInfo spaceInfo =
+        createSpaceInfo("space1", 1, 1, {{"zone1", {{host1, {1, 2, 3}}, {host2, {4}}}}});
+    EXPECT_TRUE(spaceInfo.zones_["zone1"].partCosts().empty());
+    DataBalanceJobExecutor balancer(JobDescription(), store.get(), nullptr, {});
+    balancer.spaceInfo_ = spaceInfo;
+    EXPECT_EQ(Status::OK(), balancer.buildBalancePlan());
+    EXPECT_EQ(2, balancer.spaceInfo_.zones_["zone1"].hosts_[host1].parts_.size());
+    EXPECT_EQ(2, balancer.spaceInfo_.zones_["zone1"].hosts_[host2].parts_.size());
+  }
+}
+
 void showHostLoading(kvstore::KVStore* kv, GraphSpaceID spaceId) {
   auto prefix = MetaKeyUtils::partPrefix(spaceId);
   std::unique_ptr<kvstore::KVIterator> iter;
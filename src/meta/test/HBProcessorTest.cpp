@@ -63,6 +63,59 @@ TEST(HBProcessorTest, HBTest) {
   }
 }
 
+TEST(HBProcessorTest, PartLoadsTest) {
+  fs::TempDir rootPath("/tmp/HBPartLoadsTest.XXXXXX");
+  std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
+  HostAddr host("0", 0);
+  {
+    std::vector<kvstore::KV> machines;
+    machines.emplace_back(nebula::MetaKeyUtils::machineKey(host.host, host.port), "");
+    folly::Baton<true, std::atomic> baton;
+    kv->asyncMultiPut(
+        kDefaultSpaceId, kDefaultPartId, std::move(machines), [&](auto) { baton.post(); });
+    baton.wait();
+  }
+
+  const ClusterID kClusterId = 10;
+  auto heartbeat = [&](int64_t diskSize) {
+    cpp2::PartLoad load;
+    load.part_id_ref() = 1;
+    load.disk_size_ref() = diskSize;
+    load.read_qps_ref() = 0;
+    load.write_qps_ref() = 0;
+    cpp2::PartLoadList loads;
+    loads.part_loads_ref() = std::vector<cpp2::PartLoad>{load};
+    cpp2::HBReq req;
+    req.host_ref() = host;
+    req.cluster_id_ref() = kClusterId;
+    req.role_ref() = cpp2::HostRole::STORAGE;
+    std::unordered_map<GraphSpaceID, cpp2::PartLoadList> partLoads;
+    partLoads.emplace(1, std::move(loads));
+    req.part_loads_ref() = std::move(partLoads);
+    auto* processor = HBProcessor::instance(kv.get(), nullptr, kClusterId);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  };
+  auto diskSize = [&]() -> int64_t {
+    std::string val;
+    auto code = kv->get(kDefaultSpaceId, kDefaultPartId, MetaKeyUtils::partLoadsKey(host, 1), &val);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+    auto loads = MetaKeyUtils::parsePartLoadsVal(val);
+    EXPECT_EQ(1, loads.get_part_loads().size());
+    return loads.get_part_loads().front().get_disk_size();
+  };
+
+  heartbeat(100);
+  EXPECT_EQ(100, diskSize());
+  // the same loads are not written again
+  heartbeat(100);
+  EXPECT_EQ(100, diskSize());
+  heartbeat(200);
+  EXPECT_EQ(200, diskSize());
+}
+
 }  // namespace meta
 }  // namespace nebula
 
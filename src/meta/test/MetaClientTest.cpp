@@ -1123,6 +1123,12 @@ class TestListener : public MetaChangedListener {
     LOG(INFO) << "Fetch Disk Paths";
   }
 
+  void fetchPartLoads(
+      std::unordered_map<GraphSpaceID, meta::cpp2::PartLoadList>& partLoads) override {
+    UNUSED(partLoads);
+    LOG(INFO) << "Fetch Part Loads";
+  }
+
   int32_t spaceNum = 0;
   int32_t partNum = 0;
   int32_t partChanged = 0;
@@ -13,6 +13,7 @@
 #include "mock/MockData.h"
 #include "storage/CompactionFilter.h"
 #include "storage/GraphStorageServiceHandler.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/transaction/TransactionManager.h"
 
@@ -200,6 +201,7 @@ void MockCluster::initStorageKV(const char* dataPath,
         new storage::StorageCompactionFilterFactoryBuilder(schemaMan_.get(), indexMan_.get()));
     options.cffBuilder_ = std::move(cffBuilder);
   }
+  options.mergeOpBuilder_ = std::make_unique<storage::NebulaOperatorBuilder>(schemaMan_.get());
   storageKV_ = initKV(std::move(options), addr);
   waitUntilAllElected(storageKV_.get(), 1, parts);
 
@@ -210,6 +212,7 @@ void MockCluster::initStorageKV(const char* dataPath,
   storageEnv_->rebuildIndexGuard_ = std::make_unique<storage::IndexGuard>();
   storageEnv_->verticesML_ = std::make_unique<storage::VerticesMemLock>();
   storageEnv_->edgesML_ = std::make_unique<storage::EdgesMemLock>();
+  storageEnv_->scanSnapshots_ = std::make_unique<storage::ScanSnapshotManager>(storageKV_.get());
 
   txnMan_ = std::make_unique<storage::TransactionManager>(storageEnv_.get());
   storageEnv_->txnMan_ = txnMan_.get();
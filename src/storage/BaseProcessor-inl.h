@@ -7,6 +7,7 @@
 #define STORAGE_BASEPROCESSOR_INL_H
 
 #include "storage/BaseProcessor.h"
+#include "storage/StorageFlags.h"
 
 namespace nebula {
 namespace storage {
@@ -57,6 +58,39 @@ void BaseProcessor<RESP>::handleAsync(GraphSpaceID spaceId,
   }
 }
 
+template <typename RESP>
+template <typename Key, typename Part>
+void BaseProcessor<RESP>::lockPart(GraphSpaceID spaceId,
+                                   PartitionID partId,
+                                   MemoryLockCore<Key>* lock,
+                                   std::vector<Key> keys,
+                                   const Part& part,
+                                   folly::Function<void(const Part&, std::vector<Key>)> then) {
+  auto wait = std::chrono::milliseconds(FLAGS_mutate_lock_wait_ms);
+  if (wait.count() <= 0) {
+    if (!lock->lockBatch(keys).second) {
+      LOG(ERROR) << "Space " << spaceId << ", part " << partId << " is locked by others";
+      handleAsync(spaceId, partId, nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR);
+      return;
+    }
+    then(part, std::move(keys));
+    return;
+  }
+  auto lockKeys = keys;
+  lock->lockBatchAsync(
+      std::move(lockKeys),
+      wait,
+      [this, spaceId, partId, part, keys = std::move(keys), then = std::move(then)](
+          bool locked) mutable {
+        if (!locked) {
+          LOG(ERROR) << "Space " << spaceId << ", part " << partId << " waits lock timeout";
+          handleAsync(spaceId, partId, nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR);
+          return;
+        }
+        then(part, std::move(keys));
+      });
+}
+
 template <typename RESP>
 meta::cpp2::ColumnDef BaseProcessor<RESP>::columnDef(std::string name,
                                                      nebula::cpp2::PropertyType type) {
@@ -101,6 +101,19 @@ class BaseProcessor {
 
   void handleAsync(GraphSpaceID spaceId, PartitionID partId, nebula::cpp2::ErrorCode code);
 
+  // Lock the sorted and deduped keys of a part, then process the part with the locked keys. It
+  // fails fast on conflict if --mutate_lock_wait_ms is non-positive. Otherwise the part waits in
+  // the queues of the keys held by others without blocking the worker, and a copy of the part is
+  // processed since the request may be gone by then. The part gets E_DATA_CONFLICT_ERROR if the
+  // keys are not locked.
+  template <typename Key, typename Part>
+  void lockPart(GraphSpaceID spaceId,
+                PartitionID partId,
+                MemoryLockCore<Key>* lock,
+                std::vector<Key> keys,
+                const Part& part,
+                folly::Function<void(const Part&, std::vector<Key>)> then);
+
   nebula::cpp2::ErrorCode checkStatType(const meta::SchemaProviderIf::Field& field,
                                         cpp2::StatType statType);
 
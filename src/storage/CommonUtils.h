@@ -18,6 +18,7 @@
 #include "interface/gen-cpp2/storage_types.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVStore.h"
+#include "storage/ScanSnapshotManager.h"
 
 namespace nebula {
 namespace storage {
@@ -79,6 +80,7 @@ class StorageEnv {
   TransactionManager* txnMan_{nullptr};
   std::unique_ptr<VerticesMemLock> verticesML_{nullptr};
   std::unique_ptr<EdgesMemLock> edgesML_{nullptr};
+  std::unique_ptr<ScanSnapshotManager> scanSnapshots_{nullptr};
   std::unique_ptr<kvstore::KVEngine> adminStore_{nullptr};
   int32_t adminSeqId_{0};
 
@@ -14,6 +14,7 @@
 #include "common/utils/OperationKeyUtils.h"
 #include "kvstore/CompactionFilter.h"
 #include "storage/CommonUtils.h"
+#include "storage/MergeOperator.h"
 
 namespace nebula {
 namespace storage {
@@ -45,6 +46,19 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
     return false;
   }
 
+  bool rewrite(GraphSpaceID spaceId,
+               const folly::StringPiece& key,
+               const folly::StringPiece& val,
+               std::string* newVal) const override {
+    // Merge the pending merge again once the schema is known by this replica
+    if ((NebulaKeyUtils::isTag(vIdLen_, key) || NebulaKeyUtils::isEdge(vIdLen_, key)) &&
+        NebulaOperator::isPending(val)) {
+      NebulaOperator mergeOp(schemaMan_, spaceId, vIdLen_);
+      return mergeOp.resolvePending(key, val, newVal);
+    }
+    return false;
+  }
+
  private:
   bool tagValid(GraphSpaceID spaceId,
                 const folly::StringPiece& key,
@@ -55,6 +69,9 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
       VLOG(3) << "Space " << spaceId << ", Tag " << tagId << " invalid";
       return false;
     }
+    if (NebulaOperator::isPending(val)) {
+      return true;
+    }
     auto reader = RowReaderWrapper::getTagPropReader(schemaMan_, spaceId, tagId, val);
     if (reader == nullptr) {
       VLOG(3) << "Remove the bad format vertex";
@@ -80,6 +97,9 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
       VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
       return false;
     }
+    if (NebulaOperator::isPending(val)) {
+      return true;
+    }
     auto reader = RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId, std::abs(edgeType), val);
     if (reader == nullptr) {
       VLOG(3) << "Remove the bad format edge!";
@@ -0,0 +1,562 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/MergeOperator.h"
+
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+enum ValueTag : uint8_t {
+  kIntTag = 0x01,
+  kFloatTag = 0x02,
+  kStrTag = 0x03,
+};
+
+bool isIntField(nebula::cpp2::PropertyType type) {
+  switch (type) {
+    case nebula::cpp2::PropertyType::INT8:
+    case nebula::cpp2::PropertyType::INT16:
+    case nebula::cpp2::PropertyType::INT32:
+    case nebula::cpp2::PropertyType::INT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isFloatField(nebula::cpp2::PropertyType type) {
+  return type == nebula::cpp2::PropertyType::FLOAT || type == nebula::cpp2::PropertyType::DOUBLE;
+}
+
+bool isStrField(nebula::cpp2::PropertyType type) {
+  return type == nebula::cpp2::PropertyType::STRING;
+}
+
+// Whether the expression refers to the prop itself, e.g. `$^.player.games` or `serve.times`
+bool isSelfProp(const Expression* expr, const std::string& name) {
+  switch (expr->kind()) {
+    case Expression::Kind::kSrcProperty:
+    case Expression::Kind::kEdgeProperty:
+    case Expression::Kind::kTagProperty:
+      return static_cast<const PropertyExpression*>(expr)->prop() == name;
+    default:
+      return false;
+  }
+}
+
+// Translate `prop + c`, `c + prop` or `prop - c` into a merge operand item
+folly::Optional<MergeOperand::Item> toItem(const meta::SchemaProviderIf::Field* field,
+                                           const std::string& name,
+                                           const Expression* expr) {
+  if (expr->kind() != Expression::Kind::kAdd && expr->kind() != Expression::Kind::kMinus) {
+    return folly::none;
+  }
+  auto* arith = static_cast<const ArithmeticExpression*>(expr);
+  const Expression* constExpr = nullptr;
+  bool propOnLeft = true;
+  if (isSelfProp(arith->left(), name) && arith->right()->kind() == Expression::Kind::kConstant) {
+    constExpr = arith->right();
+  } else if (expr->kind() == Expression::Kind::kAdd && isSelfProp(arith->right(), name) &&
+             arith->left()->kind() == Expression::Kind::kConstant) {
+    constExpr = arith->left();
+    propOnLeft = false;
+  } else {
+    return folly::none;
+  }
+
+  auto delta = static_cast<const ConstantExpression*>(constExpr)->value();
+  auto type = field->type();
+  if (isIntField(type) && delta.isInt()) {
+    auto v = expr->kind() == Expression::Kind::kMinus ? -delta.getInt() : delta.getInt();
+    return MergeOperand::Item{MergeOperand::Op::kAdd, name, v};
+  }
+  if (isFloatField(type) && delta.isNumeric()) {
+    double v = delta.isInt() ? static_cast<double>(delta.getInt()) : delta.getFloat();
+    return MergeOperand::Item{
+        MergeOperand::Op::kAdd, name, expr->kind() == Expression::Kind::kMinus ? -v : v};
+  }
+  // string concatenation is not commutative, only `prop + "suffix"` is allowed
+  if (isStrField(type) && delta.isStr() && expr->kind() == Expression::Kind::kAdd && propOnLeft) {
+    return MergeOperand::Item{MergeOperand::Op::kAppend, name, delta};
+  }
+  return folly::none;
+}
+
+// Whether the result of an operand could be written into the field, e.g. it may be out of the
+// range of a narrow field such as INT8 counter, or the type of field has been changed
+bool fitsField(const meta::SchemaProviderIf::Field* field, const Value& value) {
+  if (value.isNull()) {
+    return field->nullable();
+  }
+  switch (field->type()) {
+    case nebula::cpp2::PropertyType::INT8:
+      return value.isInt() && value.getInt() >= std::numeric_limits<int8_t>::min() &&
+             value.getInt() <= std::numeric_limits<int8_t>::max();
+    case nebula::cpp2::PropertyType::INT16:
+      return value.isInt() && value.getInt() >= std::numeric_limits<int16_t>::min() &&
+             value.getInt() <= std::numeric_limits<int16_t>::max();
+    case nebula::cpp2::PropertyType::INT32:
+      return value.isInt() && value.getInt() >= std::numeric_limits<int32_t>::min() &&
+             value.getInt() <= std::numeric_limits<int32_t>::max();
+    case nebula::cpp2::PropertyType::INT64:
+      return value.isInt();
+    case nebula::cpp2::PropertyType::FLOAT:
+      return value.isFloat() && value.getFloat() >= std::numeric_limits<float>::lowest() &&
+             value.getFloat() <= std::numeric_limits<float>::max();
+    case nebula::cpp2::PropertyType::DOUBLE:
+      return value.isFloat();
+    case nebula::cpp2::PropertyType::STRING:
+    case nebula::cpp2::PropertyType::FIXED_STRING:
+      return value.isStr();
+    default:
+      return false;
+  }
+}
+
+// The value as it is read back from the row, so that the result is the same whether the operands
+// are applied in one merge or across several merges with the row written in between
+Value normalize(const meta::SchemaProviderIf::Field* field, Value value) {
+  if (value.isFloat() && field->type() == nebula::cpp2::PropertyType::FLOAT) {
+    return static_cast<double>(static_cast<float>(value.getFloat()));
+  }
+  if (value.isStr() && field->type() == nebula::cpp2::PropertyType::FIXED_STRING) {
+    auto str = std::move(value).moveStr();
+    str.resize(field->size(), '\0');
+    return str;
+  }
+  return value;
+}
+
+// The pending value keeps the row and operands which could not be merged yet. The first byte is
+// an invalid row header (reader version 3), so it is never read as a row.
+//   mark (1 byte) | has row (1 byte) | row length (uint32) | row | operand count (uint32) |
+//   (operand length (uint32) | operand)...
+constexpr uint8_t kPendingMark = 0x10;
+
+void appendStr(std::string& buf, folly::StringPiece str) {
+  auto len = static_cast<uint32_t>(str.size());
+  buf.append(reinterpret_cast<const char*>(&len), sizeof(uint32_t)).append(str.data(), str.size());
+}
+
+std::string encodePending(const folly::Optional<folly::StringPiece>& row,
+                          const std::vector<folly::StringPiece>& operands) {
+  std::string encoded;
+  uint8_t hasRow = row.has_value() ? 1 : 0;
+  encoded.append(reinterpret_cast<const char*>(&kPendingMark), sizeof(uint8_t))
+      .append(reinterpret_cast<const char*>(&hasRow), sizeof(uint8_t));
+  appendStr(encoded, row.has_value() ? *row : folly::StringPiece());
+  auto num = static_cast<uint32_t>(operands.size());
+  encoded.append(reinterpret_cast<const char*>(&num), sizeof(uint32_t));
+  for (const auto& operand : operands) {
+    appendStr(encoded, operand);
+  }
+  return encoded;
+}
+
+bool decodePending(folly::StringPiece data,
+                   folly::Optional<folly::StringPiece>* row,
+                   std::vector<folly::StringPiece>* operands) {
+  const char* p = data.begin();
+  const char* end = data.end();
+  auto has = [&p, end](size_t len) { return static_cast<size_t>(end - p) >= len; };
+  auto readStr = [&p, &has](folly::StringPiece* str) {
+    if (!has(sizeof(uint32_t))) {
+      return false;
+    }
+    uint32_t len = *reinterpret_cast<const uint32_t*>(p);
+    p += sizeof(uint32_t);
+    if (!has(len)) {
+      return false;
+    }
+    *str = folly::StringPiece(p, len);
+    p += len;
+    return true;
+  };
+  if (!has(2 * sizeof(uint8_t)) || static_cast<uint8_t>(*p) != kPendingMark) {
+    return false;
+  }
+  bool hasRow = p[1] != 0;
+  p += 2 * sizeof(uint8_t);
+  folly::StringPiece str;
+  if (!readStr(&str)) {
+    return false;
+  }
+  if (hasRow) {
+    *row = str;
+  }
+  if (!has(sizeof(uint32_t))) {
+    return false;
+  }
+  uint32_t num = *reinterpret_cast<const uint32_t*>(p);
+  p += sizeof(uint32_t);
+  for (uint32_t i = 0; i < num; i++) {
+    if (!readStr(&str)) {
+      return false;
+    }
+    operands->emplace_back(str);
+  }
+  return p == end;
+}
+
+}  // namespace
+
+std::string MergeOperand::encode(SchemaVer schemaVer,
+                                 const std::vector<Item>& items,
+                                 int64_t timestamp) {
+  std::string encoded;
+  encoded.reserve(64);
+  int64_t ver = schemaVer;
+  encoded.append(reinterpret_cast<const char*>(&kVersion), sizeof(uint8_t))
+      .append(reinterpret_cast<const char*>(&ver), sizeof(int64_t))
+      .append(reinterpret_cast<const char*>(&timestamp), sizeof(int64_t));
+  auto num = static_cast<uint32_t>(items.size());
+  encoded.append(reinterpret_cast<const char*>(&num), sizeof(uint32_t));
+  for (const auto& item : items) {
+    auto op = static_cast<uint8_t>(item.op);
+    auto nameLen = static_cast<uint16_t>(item.name.size());
+    encoded.append(reinterpret_cast<const char*>(&op), sizeof(uint8_t))
+        .append(reinterpret_cast<const char*>(&nameLen), sizeof(uint16_t))
+        .append(item.name);
+    uint8_t tag;
+    if (item.value.isInt()) {
+      tag = kIntTag;
+      int64_t v = item.value.getInt();
+      encoded.append(reinterpret_cast<const char*>(&tag), sizeof(uint8_t))
+          .append(reinterpret_cast<const char*>(&v), sizeof(int64_t));
+    } else if (item.value.isFloat()) {
+      tag = kFloatTag;
+      double v = item.value.getFloat();
+      encoded.append(reinterpret_cast<const char*>(&tag), sizeof(uint8_t))
+          .append(reinterpret_cast<const char*>(&v), sizeof(double));
+    } else {
+      DCHECK(item.value.isStr());
+      tag = kStrTag;
+      const auto& str = item.value.getStr();
+      auto len = static_cast<uint32_t>(str.size());
+      encoded.append(reinterpret_cast<const char*>(&tag), sizeof(uint8_t))
+          .append(reinterpret_cast<const char*>(&len), sizeof(uint32_t))
+          .append(str);
+    }
+  }
+  return encoded;
+}
+
+bool MergeOperand::decode(folly::StringPiece data,
+                          SchemaVer* schemaVer,
+                          int64_t* timestamp,
+                          std::vector<Item>* items) {
+  const char* p = data.begin();
+  const char* end = data.end();
+  auto has = [&p, end](size_t len) { return static_cast<size_t>(end - p) >= len; };
+  if (!has(sizeof(uint8_t) + 2 * sizeof(int64_t) + sizeof(uint32_t)) ||
+      static_cast<uint8_t>(*p) != kVersion) {
+    return false;
+  }
+  p += sizeof(uint8_t);
+  *schemaVer = *reinterpret_cast<const int64_t*>(p);
+  p += sizeof(int64_t);
+  *timestamp = *reinterpret_cast<const int64_t*>(p);
+  p += sizeof(int64_t);
+  uint32_t num = *reinterpret_cast<const uint32_t*>(p);
+  p += sizeof(uint32_t);
+  for (uint32_t i = 0; i < num; i++) {
+    if (!has(sizeof(uint8_t) + sizeof(uint16_t))) {
+      return false;
+    }
+    auto op = static_cast<Op>(*p);
+    p += sizeof(uint8_t);
+    uint16_t nameLen = *reinterpret_cast<const uint16_t*>(p);
+    p += sizeof(uint16_t);
+    if (!has(nameLen + sizeof(uint8_t))) {
+      return false;
+    }
+    std::string name(p, nameLen);
+    p += nameLen;
+    auto tag = static_cast<uint8_t>(*p);
+    p += sizeof(uint8_t);
+    Value value;
+    if (tag == kIntTag && has(sizeof(int64_t))) {
+      value = *reinterpret_cast<const int64_t*>(p);
+      p += sizeof(int64_t);
+    } else if (tag == kFloatTag && has(sizeof(double))) {
+      value = *reinterpret_cast<const double*>(p);
+      p += sizeof(double);
+    } else if (tag == kStrTag && has(sizeof(uint32_t))) {
+      uint32_t len = *reinterpret_cast<const uint32_t*>(p);
+      p += sizeof(uint32_t);
+      if (!has(len)) {
+        return false;
+      }
+      value = std::string(p, len);
+      p += len;
+    } else {
+      return false;
+    }
+    items->emplace_back(Item{op, std::move(name), std::move(value)});
+  }
+  return p == end;
+}
+
+Value MergeOperand::apply(const Item& item, const Value& base) {
+  switch (item.op) {
+    case Op::kAdd:
+    case Op::kAppend:
+      return base + item.value;
+  }
+  return Value::kNullBadType;
+}
+
+StatusOr<Value> MergeOperand::defaultValue(const meta::SchemaProviderIf::Field* field) {
+  if (field->hasDefault()) {
+    ObjectPool pool;
+    auto& exprStr = field->defaultValue();
+    auto expr = Expression::decode(&pool, folly::StringPiece(exprStr.data(), exprStr.size()));
+    if (expr == nullptr || expr->kind() != Expression::Kind::kConstant) {
+      return Status::Error("Default value of %s is not a constant", field->name());
+    }
+    return static_cast<ConstantExpression*>(expr)->value();
+  } else if (field->nullable()) {
+    return Value::kNullValue;
+  }
+  return Status::Error("Prop %s has no default value", field->name());
+}
+
+folly::Optional<std::vector<MergeOperand::Item>> MergeOperand::fromUpdatedProps(
+    const meta::NebulaSchemaProvider* schema, const std::vector<cpp2::UpdatedProp>& updatedProps) {
+  if (schema == nullptr || updatedProps.empty() || CommonUtils::ttlProps(schema).first) {
+    return folly::none;
+  }
+  // the row may not exist, every replica must be able to build it in the same way
+  for (size_t i = 0; i < schema->getNumFields(); i++) {
+    if (!defaultValue(schema->field(i)).ok()) {
+      return folly::none;
+    }
+  }
+
+  ObjectPool pool;
+  std::vector<Item> items;
+  items.reserve(updatedProps.size());
+  for (const auto& prop : updatedProps) {
+    const auto& name = prop.get_name();
+    auto field = schema->field(name);
+    if (field == nullptr) {
+      return folly::none;
+    }
+    auto expr = Expression::decode(&pool, prop.get_value());
+    if (expr == nullptr) {
+      return folly::none;
+    }
+    auto item = toItem(field, name, expr);
+    if (!item.has_value()) {
+      return folly::none;
+    }
+    items.emplace_back(std::move(item).value());
+  }
+  return items;
+}
+
+bool NebulaOperator::isPending(folly::StringPiece val) {
+  return !val.empty() && static_cast<uint8_t>(val.front()) == kPendingMark;
+}
+
+bool NebulaOperator::resolvePending(folly::StringPiece key,
+                                    folly::StringPiece val,
+                                    std::string* row) const {
+  *row = merge(key, val, {});
+  return !isPending(*row);
+}
+
+bool NebulaOperator::FullMergeV2(const MergeOperationInput& merge_in,
+                                 MergeOperationOutput* merge_out) const {
+  folly::Optional<folly::StringPiece> row;
+  if (merge_in.existing_value != nullptr) {
+    row = folly::StringPiece(merge_in.existing_value->data(), merge_in.existing_value->size());
+  }
+  std::vector<folly::StringPiece> operands;
+  operands.reserve(merge_in.operand_list.size());
+  for (const auto& operand : merge_in.operand_list) {
+    operands.emplace_back(operand.data(), operand.size());
+  }
+  merge_out->new_value = merge(folly::StringPiece(merge_in.key.data(), merge_in.key.size()),
+                               std::move(row),
+                               std::move(operands));
+  return true;
+}
+
+std::string NebulaOperator::merge(folly::StringPiece key,
+                                  folly::Optional<folly::StringPiece> row,
+                                  std::vector<folly::StringPiece> operands) const {
+  if (row.has_value() && isPending(*row)) {
+    // Go on with the row and operands left by the last merge
+    folly::Optional<folly::StringPiece> pendingRow;
+    std::vector<folly::StringPiece> pendingOperands;
+    if (decodePending(*row, &pendingRow, &pendingOperands)) {
+      pendingOperands.insert(pendingOperands.end(), operands.begin(), operands.end());
+      row = pendingRow;
+      operands = std::move(pendingOperands);
+    } else {
+      LOG(ERROR) << "Bad format pending merge of key " << folly::hexlify(key);
+      row = folly::none;
+    }
+  }
+  // The result when the row could not be built, it only depends on the input
+  auto keep = [&row]() { return row.has_value() ? row->str() : std::string(); };
+
+  bool isEdge = false;
+  int32_t schemaId = 0;
+  if (NebulaKeyUtils::isTag(vIdLen_, key)) {
+    schemaId = NebulaKeyUtils::getTagId(vIdLen_, key);
+  } else if (NebulaKeyUtils::isEdge(vIdLen_, key)) {
+    isEdge = true;
+    schemaId = std::abs(NebulaKeyUtils::getEdgeType(vIdLen_, key));
+  } else {
+    LOG(ERROR) << "Merge operand on unsupported key " << folly::hexlify(key);
+    return keep();
+  }
+
+  std::vector<MergeOperand::Item> items;
+  SchemaVer ver = -1;
+  // The timestamp of row is the one of the last operand, or the row itself
+  folly::Optional<int64_t> ts;
+  for (const auto& operand : operands) {
+    SchemaVer operandVer;
+    int64_t operandTs;
+    std::vector<MergeOperand::Item> operandItems;
+    if (!MergeOperand::decode(operand, &operandVer, &operandTs, &operandItems)) {
+      LOG(ERROR) << "Skip bad format merge operand of key " << folly::hexlify(key);
+      continue;
+    }
+    ver = std::max(ver, operandVer);
+    ts = operandTs;
+    std::move(operandItems.begin(), operandItems.end(), std::back_inserter(items));
+  }
+  if (row.has_value()) {
+    SchemaVer rowVer;
+    int32_t readerVer;
+    RowReaderWrapper::getVersions(*row, rowVer, readerVer);
+    if (rowVer < 0) {
+      LOG(ERROR) << "Broken row of key " << folly::hexlify(key) << ", build it from scratch";
+      row = folly::none;
+    }
+    ver = std::max(ver, rowVer);
+  }
+  if (ver < 0) {
+    return keep();
+  }
+
+  auto schema = isEdge ? schemaMan_->getEdgeSchema(spaceId_, schemaId, ver)
+                       : schemaMan_->getTagSchema(spaceId_, schemaId, ver);
+  RowReaderWrapper reader;
+  if (schema != nullptr && row.has_value()) {
+    reader = isEdge ? RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId_, schemaId, *row)
+                    : RowReaderWrapper::getTagPropReader(schemaMan_, spaceId_, schemaId, *row);
+  }
+  if (schema == nullptr || (row.has_value() && !reader)) {
+    // The schema is not known by this replica yet, or the tag/edge has been dropped, in which case
+    // compaction filter will remove the key
+    VLOG(1) << "Pending merge of key " << folly::hexlify(key) << ", schema version " << ver;
+    return encodePending(row, operands);
+  }
+
+  // Read the whole row with the schema, build it from default values if not exists
+  std::vector<Value> values;
+  values.reserve(schema->getNumFields());
+  for (size_t i = 0; i < schema->getNumFields(); i++) {
+    auto field = schema->field(i);
+    StatusOr<Value> ret;
+    if (reader) {
+      ret = reader->getValueByName(field->name());
+      if (ret.ok() && ret.value().isNull() && ret.value().getNull() == NullType::UNKNOWN_PROP) {
+        ret = MergeOperand::defaultValue(field);
+      }
+    } else {
+      ret = MergeOperand::defaultValue(field);
+    }
+    if (!ret.ok()) {
+      LOG(ERROR) << "Skip merge operands of key " << folly::hexlify(key) << ", " << ret.status();
+      return keep();
+    }
+    values.emplace_back(normalize(field, std::move(ret).value()));
+  }
+
+  for (const auto& item : items) {
+    auto index = schema->getFieldIndex(item.name);
+    if (index < 0) {
+      // the prop has been dropped
+      continue;
+    }
+    // The operand is skipped if the result could not be written, the same as bad null, otherwise
+    // the row could never be merged again
+    auto field = schema->field(index);
+    auto result = MergeOperand::apply(item, values[index]);
+    if (result.isBadNull() || !fitsField(field, result)) {
+      VLOG(1) << "Skip merge operand on prop " << item.name << ", base value " << values[index]
+              << ", operand " << item.value;
+      continue;
+    }
+    values[index] = normalize(field, std::move(result));
+  }
+
+  RowWriterV2 writer(schema.get());
+  for (size_t i = 0; i < values.size(); i++) {
+    auto wRet = writer.setValue(i, values[i]);
+    if (wRet != WriteResult::SUCCEEDED) {
+      LOG(ERROR) << "Failed to set value of prop " << schema->getFieldName(i) << " when merging";
+      return keep();
+    }
+  }
+  if (writer.finish() != WriteResult::SUCCEEDED) {
+    LOG(ERROR) << "Failed to encode the merged row";
+    return keep();
+  }
+  // RowWriterV2 stamps the row with the local clock in its tail
+  auto encoded = writer.moveEncodedStr();
+  int64_t rowTs = ts.has_value() ? *ts : reader->getTimestamp();
+  memcpy(&encoded[encoded.size() - sizeof(int64_t)], &rowTs, sizeof(int64_t));
+  return encoded;
+}
+
+bool NebulaOperator::PartialMerge(const rocksdb::Slice& key,
+                                  const rocksdb::Slice& left_operand,
+                                  const rocksdb::Slice& right_operand,
+                                  std::string* new_value,
+                                  rocksdb::Logger* logger) const {
+  UNUSED(key);
+  UNUSED(logger);
+  // The items are only concatenated but never summed up, otherwise whether an item is skipped
+  // when merging depends on when rocksdb runs the partial merge, which differs between replicas
+  SchemaVer leftVer;
+  SchemaVer rightVer;
+  int64_t leftTs;
+  int64_t rightTs;
+  std::vector<MergeOperand::Item> items;
+  if (!MergeOperand::decode(folly::StringPiece(left_operand.data(), left_operand.size()),
+                            &leftVer,
+                            &leftTs,
+                            &items) ||
+      !MergeOperand::decode(folly::StringPiece(right_operand.data(), right_operand.size()),
+                            &rightVer,
+                            &rightTs,
+                            &items) ||
+      leftVer != rightVer) {
+    // let rocksdb keep the operands, they would be reported or merged in full merge
+    return false;
+  }
+  *new_value = MergeOperand::encode(leftVer, items, rightTs);
+  return true;
+}
+
+}  // namespace storage
+}  // namespace nebula
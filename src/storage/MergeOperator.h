@@ -3,46 +3,158 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
-#ifndef KVSTORE_MERGEOPERATOR_H_
-#define KVSTORE_MERGEOPERATOR_H_
+#ifndef STORAGE_MERGEOPERATOR_H_
+#define STORAGE_MERGEOPERATOR_H_
 
 #include <rocksdb/merge_operator.h>
 
 #include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+#include "common/meta/NebulaSchemaProvider.h"
+#include "common/meta/SchemaManager.h"
+#include "common/time/WallClock.h"
+#include "interface/gen-cpp2/storage_types.h"
+#include "kvstore/KVStore.h"
 
 namespace nebula {
 namespace storage {
 
+/**
+ * @brief MergeOperand is the operand of a read-free update, which is written by rocksdb::Merge and
+ * folded into the tag/edge row by NebulaOperator during read and compaction.
+ *
+ * Encoded format:
+ *   version (1 byte) | schema version (int64) | timestamp (int64) | item count (uint32) | items...
+ * Each item:
+ *   op (1 byte) | prop name length (uint16) | prop name | value type (1 byte) | value
+ *
+ * The schema version and timestamp are the ones of the leader when the operand is written, so every
+ * replica builds the same row rather than the one by its own cached schema and clock.
+ */
+class MergeOperand final {
+ public:
+  enum class Op : uint8_t {
+    // numeric increment/decrement, e.g. `set count = count + 1`
+    kAdd = 0x01,
+    // string append, e.g. `set tags = tags + "x"`
+    kAppend = 0x02,
+  };
+
+  struct Item {
+    Op op;
+    std::string name;
+    Value value;
+  };
+
+  static constexpr uint8_t kVersion = 0x01;
+
+  static std::string encode(SchemaVer schemaVer,
+                            const std::vector<Item>& items,
+                            int64_t timestamp = time::WallClock::fastNowInMicroSec());
+
+  /**
+   * @brief Decode the operand, the items are appended to the given ones
+   */
+  static bool decode(folly::StringPiece data,
+                     SchemaVer* schemaVer,
+                     int64_t* timestamp,
+                     std::vector<Item>* items);
+
+  /**
+   * @brief Apply one operand item on the value of prop
+   */
+  static Value apply(const Item& item, const Value& base);
+
+  /**
+   * @brief Try to translate the updated props of UPSERT into merge operand items. It only succeeds
+   * when every updated prop is a self increment/append with a constant, and the row could be built
+   * from scratch deterministically on every replica, i.e. schema has no ttl and each prop has a
+   * constant default value or is nullable.
+   *
+   * @param schema Latest schema of tag/edge
+   * @param updatedProps Updated props in request
+   * @return folly::Optional<std::vector<Item>> folly::none if update could not be merged
+   */
+  static folly::Optional<std::vector<Item>> fromUpdatedProps(
+      const meta::NebulaSchemaProvider* schema,
+      const std::vector<cpp2::UpdatedProp>& updatedProps);
+
+  /**
+   * @brief The value of prop when there is no existing row, it must be a constant
+   */
+  static StatusOr<Value> defaultValue(const meta::SchemaProviderIf::Field* field);
+};
+
+/**
+ * @brief Merge operator of tag and edge rows. The row is built with the latest schema version
+ * among the existing row and the operands, and the operands are applied one by one in the order
+ * they are written, so the result is the same on every replica no matter how rocksdb groups the
+ * merges. The merge never fails, otherwise rocksdb would report corruption of the key.
+ *
+ * If the schema version is not known by this replica yet, the row and the operands are kept as
+ * they are in a pending value, which is merged again by the next merge or compaction of the key.
+ */
 class NebulaOperator : public rocksdb::MergeOperator {
  public:
+  NebulaOperator(meta::SchemaManager* schemaMan, GraphSpaceID spaceId, size_t vIdLen)
+      : schemaMan_(schemaMan), spaceId_(spaceId), vIdLen_(vIdLen) {
+    CHECK_NOTNULL(schemaMan_);
+  }
+
   const char* Name() const override {
     return "NebulaMergeOperator";
   }
 
+  /**
+   * @brief Whether the value is a pending merge rather than a row, it is never a valid row
+   */
+  static bool isPending(folly::StringPiece val);
+
+  /**
+   * @brief Merge the pending value again
+   *
+   * @return true if it is merged into a row, false if it is still pending
+   */
+  bool resolvePending(folly::StringPiece key, folly::StringPiece val, std::string* row) const;
+
  private:
   bool FullMergeV2(const MergeOperationInput& merge_in,
-                   MergeOperationOutput* merge_out) const override {
-    UNUSED(merge_in);
-    UNUSED(merge_out);
-    LOG(ERROR) << "NebulaMergeOperator not supported yet";
-    return false;
-  }
+                   MergeOperationOutput* merge_out) const override;
 
   bool PartialMerge(const rocksdb::Slice& key,
                     const rocksdb::Slice& left_operand,
                     const rocksdb::Slice& right_operand,
                     std::string* new_value,
-                    rocksdb::Logger* logger) const override {
-    UNUSED(key);
-    UNUSED(left_operand);
-    UNUSED(right_operand);
-    UNUSED(new_value);
-    UNUSED(logger);
-    LOG(ERROR) << "NebulaMergeOperator not supported yet";
-    return false;
+                    rocksdb::Logger* logger) const override;
+
+  std::string merge(folly::StringPiece key,
+                    folly::Optional<folly::StringPiece> row,
+                    std::vector<folly::StringPiece> operands) const;
+
+ private:
+  meta::SchemaManager* schemaMan_ = nullptr;
+  GraphSpaceID spaceId_;
+  size_t vIdLen_;
+};
+
+class NebulaOperatorBuilder : public kvstore::MergeOperatorBuilder {
+ public:
+  explicit NebulaOperatorBuilder(meta::SchemaManager* schemaMan) : schemaMan_(schemaMan) {}
+
+  virtual ~NebulaOperatorBuilder() = default;
+
+  std::shared_ptr<rocksdb::MergeOperator> buildMergeOperator(GraphSpaceID spaceId) override {
+    auto vIdLen = schemaMan_->getSpaceVidLen(spaceId);
+    if (!vIdLen.ok()) {
+      return nullptr;
+    }
+    return std::make_shared<NebulaOperator>(schemaMan_, spaceId, vIdLen.value());
   }
+
+ private:
+  meta::SchemaManager* schemaMan_ = nullptr;
 };
 
 }  // namespace storage
 }  // namespace nebula
-#endif  // KVSTORE_MERGEOPERATOR_H_
+#endif  // STORAGE_MERGEOPERATOR_H_
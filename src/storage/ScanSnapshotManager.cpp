@@ -0,0 +1,303 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/ScanSnapshotManager.h"
+
+#include "common/time/WallClock.h"
+#include "common/utils/Types.h"
+#include "kvstore/Part.h"
+#include "storage/StorageFlags.h"
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// The first byte of a key is the key type, which is never 0xFF
+constexpr char kRangesCursorMark = '\xFF';
+
+// The smallest key which is greater than all keys with the prefix
+std::string prefixEnd(const std::string& prefix) {
+  std::string end = prefix;
+  while (!end.empty() && static_cast<uint8_t>(end.back()) == 0xff) {
+    end.pop_back();
+  }
+  if (!end.empty()) {
+    end.back()++;
+  }
+  return end;
+}
+
+}  // namespace
+
+ScanSnapshotManager::~ScanSnapshotManager() {
+  stop();
+  std::lock_guard<std::mutex> guard(lock_);
+  for (auto& lease : leases_) {
+    kvstore_->ReleaseSnapshot(lease.second->spaceId, lease.second->partId, lease.second->snapshot);
+  }
+  leases_.clear();
+}
+
+bool ScanSnapshotManager::start() {
+  bgWorker_ = std::make_unique<thread::GenericWorker>();
+  if (!bgWorker_->start("scan-snapshot")) {
+    return false;
+  }
+  auto intervalMs = std::max(1000, FLAGS_scan_snapshot_lease_secs * 1000 / 2);
+  bgWorker_->addRepeatTask(intervalMs, &ScanSnapshotManager::expire, this);
+  return true;
+}
+
+void ScanSnapshotManager::stop() {
+  if (bgWorker_ != nullptr) {
+    bgWorker_->stop();
+    bgWorker_->wait();
+    bgWorker_.reset();
+  }
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<ScanSnapshotManager::Lease>>
+ScanSnapshotManager::pin(GraphSpaceID spaceId,
+                         PartitionID partId,
+                         const std::string& prefix,
+                         const std::string& cursor,
+                         size_t vidLen,
+                         bool canReadFromFollower) {
+  expire();
+  auto lease = std::make_unique<Lease>();
+  if (isRangesCursor(cursor)) {
+    // Continue the ranges of a released lease
+    if (!decodeCursor(prefix, cursor, &lease->ranges)) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+  } else {
+    SizeFunc sizeOf;
+    auto part = kvstore_->part(spaceId, partId);
+    if (nebula::ok(part)) {
+      auto* engine = nebula::value(part)->engine();
+      sizeOf = [engine](const std::string& start, const std::string& end) {
+        return engine->approximateSize(start, end);
+      };
+    }
+    lease->ranges = splitRanges(prefix,
+                                cursor,
+                                vidLen,
+                                std::max(1, std::min(FLAGS_scan_snapshot_sub_ranges, 256)),
+                                sizeOf);
+  }
+  auto* snapshot = kvstore_->GetSnapshot(spaceId, partId, canReadFromFollower);
+  if (snapshot == nullptr) {
+    return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
+  }
+  lease->spaceId = spaceId;
+  lease->partId = partId;
+  lease->snapshot = snapshot;
+  lease->expireAt = time::WallClock::fastNowInSec() + FLAGS_scan_snapshot_lease_secs;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (nextId_ == 0) {
+      // A lease id of the process before restart should not be found
+      nextId_ = time::WallClock::fastNowInMicroSec();
+    }
+    lease->id = nextId_++;
+  }
+  return lease;
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<ScanSnapshotManager::Lease>>
+ScanSnapshotManager::acquire(GraphSpaceID spaceId, PartitionID partId, int64_t id) {
+  expire();
+  std::lock_guard<std::mutex> guard(lock_);
+  auto iter = leases_.find(id);
+  if (iter == leases_.end() || iter->second->spaceId != spaceId ||
+      iter->second->partId != partId) {
+    return nebula::cpp2::ErrorCode::E_SCAN_SNAPSHOT_EXPIRED;
+  }
+  auto lease = std::move(iter->second);
+  leases_.erase(iter);
+  return lease;
+}
+
+void ScanSnapshotManager::renew(std::unique_ptr<Lease> lease) {
+  lease->expireAt = time::WallClock::fastNowInSec() + FLAGS_scan_snapshot_lease_secs;
+  std::lock_guard<std::mutex> guard(lock_);
+  auto id = lease->id;
+  leases_.emplace(id, std::move(lease));
+}
+
+void ScanSnapshotManager::release(std::unique_ptr<Lease> lease) {
+  kvstore_->ReleaseSnapshot(lease->spaceId, lease->partId, lease->snapshot);
+}
+
+size_t ScanSnapshotManager::size() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return leases_.size();
+}
+
+void ScanSnapshotManager::expire() {
+  std::vector<std::unique_ptr<Lease>> expired;
+  {
+    auto now = time::WallClock::fastNowInSec();
+    std::lock_guard<std::mutex> guard(lock_);
+    for (auto iter = leases_.begin(); iter != leases_.end();) {
+      if (iter->second->expireAt <= now) {
+        expired.emplace_back(std::move(iter->second));
+        iter = leases_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+  for (auto& lease : expired) {
+    VLOG(1) << "Release the expired scan snapshot " << lease->id << " of space "
+            << lease->spaceId << " part " << lease->partId;
+    release(std::move(lease));
+  }
+}
+
+std::vector<ScanSnapshotManager::Range> ScanSnapshotManager::splitRanges(
+    const std::string& prefix,
+    const std::string& cursor,
+    size_t vidLen,
+    size_t num,
+    const SizeFunc& sizeOf) {
+  // The keys are mapped to the leading bytes of vid in big endian, which are the same for all keys
+  // of a vertex
+  auto width = std::max<size_t>(1, std::min(vidLen, sizeof(uint64_t)));
+  auto toKey = [&prefix, width](uint64_t pos) {
+    std::string key = prefix;
+    for (size_t i = 0; i < width; i++) {
+      key.push_back(static_cast<char>(pos >> (56 - 8 * i)));
+    }
+    return key;
+  };
+  auto start = cursor.empty() ? prefix : cursor;
+  auto end = prefixEnd(prefix);
+  uint64_t lo = 0;
+  for (size_t i = 0; i < width && prefix.size() + i < start.size(); i++) {
+    lo |= static_cast<uint64_t>(static_cast<uint8_t>(start[prefix.size() + i])) << (56 - 8 * i);
+  }
+
+  int64_t total = sizeOf != nullptr && num > 1 ? sizeOf(start, end) : 0;
+  std::vector<std::string> splits;
+  for (size_t i = 1; i < num; i++) {
+    uint64_t pos;
+    if (total <= 0) {
+      // lo + (2^64 - lo) * i / num
+      uint64_t span = ~lo;
+      pos = lo + span / num * i + (span % num + 1) * i / num;
+    } else {
+      // The first position which has about total * i / num bytes before it
+      auto target = total * static_cast<int64_t>(i) / static_cast<int64_t>(num);
+      auto tolerance = total / static_cast<int64_t>(num * 16);
+      uint64_t l = lo, h = std::numeric_limits<uint64_t>::max();
+      while (l < h) {
+        auto mid = l + (h - l) / 2;
+        auto key = toKey(mid);
+        auto size = key > start ? sizeOf(start, key) : 0;
+        if (std::abs(size - target) <= tolerance) {
+          l = mid;
+          break;
+        }
+        if (size < target) {
+          l = mid + 1;
+        } else {
+          h = mid;
+        }
+      }
+      pos = l;
+      lo = l;
+    }
+    auto key = toKey(pos);
+    // The split keys which are too close are merged
+    if (key > (splits.empty() ? start : splits.back()) && (end.empty() || key < end)) {
+      splits.emplace_back(std::move(key));
+    }
+  }
+
+  std::vector<Range> ranges;
+  ranges.emplace_back(Range{start, ""});
+  for (auto& split : splits) {
+    ranges.back().end = split;
+    ranges.emplace_back(Range{std::move(split), ""});
+  }
+  return ranges;
+}
+
+std::string ScanSnapshotManager::encodeCursor(const std::vector<Range>& ranges) {
+  if (ranges.size() == 1 && ranges.front().end.empty()) {
+    return ranges.front().start;
+  }
+  std::string cursor(1, kRangesCursorMark);
+  for (const auto& range : ranges) {
+    for (const auto* key : {&range.start, &range.end}) {
+      auto len = static_cast<int32_t>(key->size());
+      cursor.append(reinterpret_cast<const char*>(&len), sizeof(int32_t)).append(*key);
+    }
+  }
+  return cursor;
+}
+
+bool ScanSnapshotManager::isRangesCursor(const std::string& cursor) {
+  return !cursor.empty() && cursor.front() == kRangesCursorMark;
+}
+
+bool ScanSnapshotManager::decodeCursor(const std::string& prefix,
+                                       const std::string& cursor,
+                                       std::vector<Range>* ranges) {
+  if (!isRangesCursor(cursor)) {
+    return false;
+  }
+  folly::StringPiece data(cursor);
+  data.advance(1);
+  auto readKey = [&data](std::string* key) {
+    if (data.size() < sizeof(int32_t)) {
+      return false;
+    }
+    auto len = readInt<int32_t>(data.data(), sizeof(int32_t));
+    data.advance(sizeof(int32_t));
+    if (len < 0 || data.size() < static_cast<size_t>(len)) {
+      return false;
+    }
+    key->assign(data.data(), len);
+    data.advance(len);
+    return true;
+  };
+  std::vector<Range> result;
+  while (!data.empty()) {
+    Range range;
+    if (!readKey(&range.start) || !readKey(&range.end)) {
+      return false;
+    }
+    // The ranges are in key order without overlap, and only the last one has no end
+    if (!folly::StringPiece(range.start).startsWith(prefix) ||
+        (!result.empty() && (result.back().end.empty() || range.start < result.back().end)) ||
+        (!range.end.empty() && range.end <= range.start)) {
+      return false;
+    }
+    result.emplace_back(std::move(range));
+  }
+  if (result.empty()) {
+    return false;
+  }
+  *ranges = std::move(result);
+  return true;
+}
+
+std::vector<int64_t> ScanSnapshotManager::splitLimit(int64_t limit, size_t num) {
+  if (num == 0) {
+    return {};
+  }
+  auto n = static_cast<int64_t>(num);
+  std::vector<int64_t> limits(num, limit / n);
+  for (int64_t i = 0; i < limit % n; ++i) {
+    limits[i]++;
+  }
+  return limits;
+}
+
+}  // namespace storage
+}  // namespace nebula
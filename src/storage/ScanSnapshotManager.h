@@ -0,0 +1,144 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_SCANSNAPSHOTMANAGER_H_
+#define STORAGE_SCANSNAPSHOTMANAGER_H_
+
+#include "common/base/Base.h"
+#include "common/base/ErrorOr.h"
+#include "common/thread/GenericWorker.h"
+#include "kvstore/KVStore.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Keep the engine snapshots pinned by ScanVertex/ScanEdge with enable_snapshot. All pages
+ * of a part are read from the snapshot pinned by its first page, which is kept by a lease. The
+ * lease is renewed by every page, and the snapshot is released once the part is done or the lease
+ * expires.
+ *
+ * The keys of the part are split into ranges of about the same bytes by the approximate sizes
+ * of the engine, the split keys are made of the prefix and the leading bytes of vertex id, so the
+ * keys of one vertex never cross two ranges. The position of each range is kept in the lease as
+ * well, so the ranges could be scanned in parallel and each page continues all of them. The
+ * pending ranges are encoded in the cursor returned to client too, so the scan could be resumed
+ * by a new snapshot without any duplicated rows after the lease is gone.
+ */
+class ScanSnapshotManager final {
+ public:
+  struct Range {
+    // the next key to read, inclusive
+    std::string start;
+    // exclusive, empty means the end of the prefix
+    std::string end;
+  };
+
+  struct Lease {
+    int64_t id;
+    GraphSpaceID spaceId;
+    PartitionID partId;
+    const void* snapshot;
+    // the ranges not finished yet, in key order
+    std::vector<Range> ranges;
+    int64_t expireAt;
+  };
+
+  // The approximate bytes of the keys in [start, end)
+  using SizeFunc = std::function<int64_t(const std::string& start, const std::string& end)>;
+
+  explicit ScanSnapshotManager(kvstore::KVStore* kvstore) : kvstore_(kvstore) {}
+
+  ~ScanSnapshotManager();
+
+  /**
+   * @brief Start the background worker to release the expired snapshots, they are released by
+   * pin/acquire as well if it is not started
+   */
+  bool start();
+
+  void stop();
+
+  /**
+   * @brief Pin a new snapshot of the part, and split the keys of prefix beginning from cursor. The
+   * cursor with ranges returned by a previous page is continued as it is.
+   *
+   * @return The lease owned by caller until it is given back by renew/release
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<Lease>> pin(GraphSpaceID spaceId,
+                                                               PartitionID partId,
+                                                               const std::string& prefix,
+                                                               const std::string& cursor,
+                                                               size_t vidLen,
+                                                               bool canReadFromFollower);
+
+  /**
+   * @brief Take the lease of id to scan the next page. A lease which is expired, released, or
+   * being used by another page is not found.
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<Lease>> acquire(GraphSpaceID spaceId,
+                                                                   PartitionID partId,
+                                                                   int64_t id);
+
+  /**
+   * @brief Give back the lease after a page, and extend it by scan_snapshot_lease_secs
+   */
+  void renew(std::unique_ptr<Lease> lease);
+
+  /**
+   * @brief Release the snapshot of lease, when the part is done or failed
+   */
+  void release(std::unique_ptr<Lease> lease);
+
+  size_t size();
+
+  /**
+   * @brief Split the keys of prefix beginning from cursor into at most num ranges of about the
+   * same size. The split keys are the prefix followed by at most 8 leading bytes of vid, the keys
+   * are split evenly by these bytes if the size is unknown.
+   */
+  static std::vector<Range> splitRanges(const std::string& prefix,
+                                        const std::string& cursor,
+                                        size_t vidLen,
+                                        size_t num,
+                                        const SizeFunc& sizeOf);
+
+  /**
+   * @brief The cursor to continue the pending ranges, which is the start key if there is only the
+   * last range left
+   */
+  static std::string encodeCursor(const std::vector<Range>& ranges);
+
+  static bool isRangesCursor(const std::string& cursor);
+
+  /**
+   * @brief Decode the cursor of encodeCursor with ranges
+   *
+   * @return false if the cursor is broken or the ranges are not in the keys of prefix
+   */
+  static bool decodeCursor(const std::string& prefix,
+                           const std::string& cursor,
+                           std::vector<Range>* ranges);
+
+  /**
+   * @brief Split the row limit of a page among the ranges to scan, the former ranges get the
+   * remainder, and the ranges with zero limit are left to the following pages.
+   */
+  static std::vector<int64_t> splitLimit(int64_t limit, size_t num);
+
+ private:
+  void expire();
+
+  kvstore::KVStore* kvstore_;
+  std::unique_ptr<thread::GenericWorker> bgWorker_;
+  std::mutex lock_;
+  std::unordered_map<int64_t, std::unique_ptr<Lease>> leases_;
+  int64_t nextId_{0};
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_SCANSNAPSHOTMANAGER_H_
@@ -42,7 +42,34 @@ DEFINE_bool(trace_toss, false, "output verbose log of toss");
 
 DEFINE_int32(max_edge_returned_per_vertex, INT_MAX, "Max edge number returned searching vertex");
 
+DEFINE_int32(max_local_expanded_vertices,
+             10000,
+             "Max vertices a GetNeighbors request expands locally besides the requested ones, "
+             "the rest are left to the caller");
+
 DEFINE_bool(query_concurrently,
             false,
             "whether to run query of each part concurrently, only lookup and "
             "go are supported");
+
+DEFINE_bool(enable_merge_update,
+            false,
+            "whether to apply upsert of self increment/append by merge operand without reading "
+            "the old row, e.g. `UPSERT ... SET count = count + 1`. Merged updates do not take "
+            "the memory lock of vertex/edge");
+
+DEFINE_int32(mutate_lock_wait_ms,
+             0,
+             "max time in milliseconds an insert/delete waits in queue for the vertices/edges "
+             "locked by others, without blocking the worker thread. Return "
+             "E_DATA_CONFLICT_ERROR immediately on conflict if non-positive");
+
+DEFINE_int32(scan_snapshot_lease_secs,
+             60,
+             "seconds to keep the snapshot pinned by a scan with snapshot since its last page, "
+             "the following pages fail with E_SCAN_SNAPSHOT_EXPIRED once it is released");
+
+DEFINE_int32(scan_snapshot_sub_ranges,
+             4,
+             "number of key ranges to split a part into for the scan with snapshot, the ranges "
+             "are scanned in parallel when query_concurrently is set");
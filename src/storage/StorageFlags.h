@@ -32,6 +32,16 @@ DECLARE_bool(trace_toss);
 
 DECLARE_int32(max_edge_returned_per_vertex);
 
+DECLARE_int32(max_local_expanded_vertices);
+
 DECLARE_bool(query_concurrently);
 
+DECLARE_bool(enable_merge_update);
+
+DECLARE_int32(mutate_lock_wait_ms);
+
+DECLARE_int32(scan_snapshot_lease_secs);
+
+DECLARE_int32(scan_snapshot_sub_ranges);
+
 #endif  // STORAGE_STORAGEFLAGS_H_
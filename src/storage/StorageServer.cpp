@@ -24,6 +24,7 @@
 #include "storage/GraphStorageLocalServer.h"
 #include "storage/GraphStorageServiceHandler.h"
 #include "storage/InternalStorageServiceHandler.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/StorageFlags.h"
 #include "storage/http/StorageHttpAdminHandler.h"
@@ -77,6 +78,7 @@ std::unique_ptr<kvstore::KVStore> StorageServer::getStoreInstance() {
   if (!FLAGS_storage_kv_mode) {
     options.cffBuilder_ =
         std::make_unique<StorageCompactionFilterFactoryBuilder>(schemaMan_.get(), indexMan_.get());
+    options.mergeOpBuilder_ = std::make_unique<NebulaOperatorBuilder>(schemaMan_.get());
   }
   options.schemaMan_ = schemaMan_.get();
   if (FLAGS_store_type == "nebula") {
@@ -230,6 +232,11 @@ bool StorageServer::start() {
 
   env_->verticesML_ = std::make_unique<VerticesMemLock>();
   env_->edgesML_ = std::make_unique<EdgesMemLock>();
+  env_->scanSnapshots_ = std::make_unique<ScanSnapshotManager>(kvstore_.get());
+  if (!env_->scanSnapshots_->start()) {
+    LOG(ERROR) << "Start scan snapshot manager failed!";
+    return false;
+  }
   env_->adminStore_ = getAdminStoreInstance();
   env_->adminSeqId_ = getAdminStoreSeqId();
   taskMgr_ = AdminTaskManager::instance(env_.get());
@@ -405,6 +412,10 @@ void StorageServer::stop() {
   if (metaClient_) {
     metaClient_->notifyStop();
   }
+  // the pinned snapshots must be released before the engines are closed
+  if (env_ && env_->scanSnapshots_) {
+    env_->scanSnapshots_.reset();
+  }
   if (kvstore_) {
     kvstore_.reset();
   }
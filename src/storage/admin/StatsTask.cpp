@@ -10,6 +10,8 @@
 #include "common/base/MurmurHash2.h"
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/Common.h"
+#include "kvstore/Part.h"
+#include "storage/CommonUtils.h"
 
 namespace nebula {
 namespace storage {
@@ -28,6 +30,9 @@ nebula::cpp2::ErrorCode StatsTask::getSchemas(GraphSpaceID spaceId) {
 
   for (auto tag : tags.value()) {
     auto tagId = tag.first;
+    if (!tag.second.empty() && CommonUtils::ttlProps(tag.second.back().get()).first) {
+      hasTtl_ = true;
+    }
     auto tagNameRet = env_->schemaMan_->toTagName(spaceId, tagId);
     if (!tagNameRet.ok()) {
       VLOG(1) << "Can't find spaceId " << spaceId << " tagId " << tagId;
@@ -38,6 +43,9 @@ nebula::cpp2::ErrorCode StatsTask::getSchemas(GraphSpaceID spaceId) {
 
   for (auto edge : edges.value()) {
     auto edgeType = edge.first;
+    if (!edge.second.empty() && CommonUtils::ttlProps(edge.second.back().get()).first) {
+      hasTtl_ = true;
+    }
     auto edgeNameRet = env_->schemaMan_->toEdgeName(spaceId, std::abs(edgeType));
     if (!edgeNameRet.ok()) {
       VLOG(1) << "Can't find spaceId " << spaceId << " edgeType " << std::abs(edgeType);
@@ -101,6 +109,12 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
   auto partitionNum = partitionNumRet.value();
   LOG(INFO) << "Start stats task";
   CHECK_NOTNULL(env_->kvstore_);
+  if (FLAGS_enable_online_stats) {
+    auto code = genOnlineStats(spaceId, part);
+    if (code != nebula::cpp2::ErrorCode::E_UNSUPPORTED) {
+      return code;
+    }
+  }
   auto vertexPrefix = NebulaKeyUtils::tagPrefix(part);
   std::unique_ptr<kvstore::KVIterator> vertexIter;
   auto edgePrefix = NebulaKeyUtils::edgePrefix(part);
@@ -280,6 +294,64 @@ nebula::cpp2::ErrorCode StatsTask::genSubTask(GraphSpaceID spaceId,
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+nebula::cpp2::ErrorCode StatsTask::genOnlineStats(GraphSpaceID spaceId, PartitionID part) {
+  if (hasTtl_) {
+    LOG(INFO) << "Some schemas have ttl, scan the stats of space " << spaceId << ", part " << part;
+    return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+  }
+  auto partRet = env_->kvstore_->part(spaceId, part);
+  if (!ok(partRet)) {
+    LOG(ERROR) << "Get part failed, space " << spaceId << ", part " << part;
+    return error(partRet);
+  }
+  auto kvPart = std::move(value(partRet));
+  auto stats = kvPart->stats();
+  if (!stats.has_value()) {
+    // Not known yet, scan the part once and maintain them by the logs since then
+    LOG(INFO) << "Rebuild the stats of space " << spaceId << ", part " << part;
+    auto code = kvPart->rebuildStats([this]() { return canceled_.load(); });
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      LOG(ERROR) << "Rebuild the stats of part failed, error "
+                 << apache::thrift::util::enumNameSafe(code);
+      return code;
+    }
+    stats = kvPart->stats();
+    if (!stats.has_value()) {
+      return nebula::cpp2::ErrorCode::E_TASK_EXECUTION_FAILED;
+    }
+  }
+
+  // The vertices only with tags not in schema are not counted by scan, but they are in the online
+  // stats, so scan the part instead
+  for (const auto& [tagId, count] : stats->tagVertices) {
+    if (count != 0 && tags_.find(tagId) == tags_.end()) {
+      LOG(INFO) << "Tag " << tagId << " not in schema, scan the stats of space " << spaceId
+                << ", part " << part;
+      return nebula::cpp2::ErrorCode::E_UNSUPPORTED;
+    }
+  }
+
+  // The correlativity of parts is only known by scanning all edges, so it is left empty
+  nebula::meta::cpp2::StatsItem statsItem;
+  for (const auto& [tagId, tagName] : tags_) {
+    auto it = stats->tagVertices.find(tagId);
+    (*statsItem.tag_vertices_ref())
+        .emplace(tagName, it == stats->tagVertices.end() ? 0 : it->second);
+  }
+  int64_t spaceEdges = 0;
+  for (const auto& [edgeType, edgeName] : edges_) {
+    auto it = stats->edges.find(edgeType);
+    auto count = it == stats->edges.end() ? 0 : it->second;
+    (*statsItem.edges_ref()).emplace(edgeName, count);
+    spaceEdges += count;
+  }
+  statsItem.space_vertices_ref() = stats->vertices;
+  statsItem.space_edges_ref() = spaceEdges;
+  statistics_.emplace(part, std::move(statsItem));
+  LOG(INFO) << "Stats task finished";
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 void StatsTask::finish(nebula::cpp2::ErrorCode rc) {
   FLOG_INFO("task(%d, %d) finished, rc=[%s]",
             ctx_.jobId_,
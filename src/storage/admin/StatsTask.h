@@ -43,6 +43,19 @@ class StatsTask : public AdminTask {
  private:
   nebula::cpp2::ErrorCode getSchemas(GraphSpaceID spaceId);
 
+  /**
+   * @brief Get the stats of part maintained by the committed logs when enable_online_stats is on,
+   * instead of scanning all the data of part
+   *
+   * The keys removed by compaction filter, i.e. expired by ttl or of dropped schemas, are not
+   * subtracted from the stats, which are dropped instead and rebuilt by the next stats job. So the
+   * spaces with ttl, which drop the stats on almost every compaction, are always scanned.
+   *
+   * @return E_UNSUPPORTED if they could not be used, e.g. some tags are not in schema or any
+   * schema has ttl, the part should be scanned then
+   */
+  nebula::cpp2::ErrorCode genOnlineStats(GraphSpaceID spaceId, PartitionID part);
+
  protected:
   GraphSpaceID spaceId_;
 
@@ -52,6 +65,9 @@ class StatsTask : public AdminTask {
   // All edgeTypes and edgeName of the spaceId
   std::unordered_map<EdgeType, std::string> edges_;
 
+  // Whether the latest schema of any tag or edge has ttl
+  bool hasTtl_{false};
+
   folly::ConcurrentHashMap<PartitionID, nebula::meta::cpp2::StatsItem> statistics_;
 
   // The number of subtasks equals to the number of parts in request
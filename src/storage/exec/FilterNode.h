@@ -7,6 +7,7 @@
 #define STORAGE_EXEC_FILTERNODE_H_
 
 #include "common/base/Base.h"
+#include "common/expression/ExprProgram.h"
 #include "common/expression/Expression.h"
 #include "storage/context/StorageExpressionContext.h"
 #include "storage/exec/HashJoinNode.h"
@@ -42,6 +43,9 @@ class FilterNode : public IterateNode<T> {
              Expression* exp = nullptr)
       : IterateNode<T>(upstream), context_(context), expCtx_(expCtx), filterExp_(exp) {
     IterateNode<T>::name_ = "FilterNode";
+    if (filterExp_ != nullptr && FLAGS_enable_expr_program) {
+      program_ = ExprProgram::compile(filterExp_);
+    }
   }
 
   nebula::cpp2::ErrorCode doExecute(PartitionID partId, const T& vId) override {
@@ -83,8 +87,12 @@ class FilterNode : public IterateNode<T> {
     }
   }
 
+  const Value& eval() {
+    return program_ != nullptr ? program_->eval(*expCtx_) : filterExp_->eval(*expCtx_);
+  }
+
   bool checkTagOnly() {
-    auto result = filterExp_->eval(*expCtx_);
+    auto result = eval();
     // NULL is always false
     auto ret = result.toBool();
     return ret.isBool() && ret.getBool();
@@ -94,7 +102,7 @@ class FilterNode : public IterateNode<T> {
   bool checkTagAndEdge() {
     expCtx_->reset(this->reader(), this->key().str());
     // result is false when filter out
-    auto result = filterExp_->eval(*expCtx_);
+    auto result = eval();
     // NULL is always false
     auto ret = result.toBool();
     return ret.isBool() && ret.getBool();
@@ -104,6 +112,8 @@ class FilterNode : public IterateNode<T> {
   RuntimeContext* context_;
   StorageExpressionContext* expCtx_;
   Expression* filterExp_;
+  // The filter compiled, nullptr if enable_expr_program is off
+  std::unique_ptr<ExprProgram> program_;
   FilterMode mode_{FilterMode::TAG_AND_EDGE};
   int32_t callCheck{0};
 };
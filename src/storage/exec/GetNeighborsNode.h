@@ -11,6 +11,7 @@
 #include "storage/StorageFlags.h"
 #include "storage/exec/AggregateNode.h"
 #include "storage/exec/HashJoinNode.h"
+#include "storage/exec/IndexTopNNode.h"
 
 namespace nebula {
 namespace storage {
@@ -38,6 +39,11 @@ class GetNeighborsNode : public QueryNode<VertexID> {
     name_ = "GetNeighborsNode";
   }
 
+  // Collect the dst of the returned edges, which is used to expand more steps in storage
+  void setNeighbors(std::vector<std::string>* neighbors) {
+    neighbors_ = neighbors;
+  }
+
   nebula::cpp2::ErrorCode doExecute(PartitionID partId, const VertexID& vId) override {
     auto ret = RelNode::doExecute(partId, vId);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -126,6 +132,14 @@ class GetNeighborsNode : public QueryNode<VertexID> {
       }
       auto& cell = row[columnIdx].mutableList();
       cell.values.emplace_back(std::move(list));
+
+      if (neighbors_ != nullptr) {
+        auto dstId = NebulaKeyUtils::getDstId(context_->vIdLen(), key);
+        if (!context_->isIntId()) {
+          dstId = dstId.subpiece(0, dstId.find_first_of('\0'));
+        }
+        neighbors_->emplace_back(dstId.str());
+      }
     }
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
@@ -136,6 +150,7 @@ class GetNeighborsNode : public QueryNode<VertexID> {
   EdgeContext* edgeContext_;
   nebula::DataSet* resultDataSet_;
   int64_t limit_;
+  std::vector<std::string>* neighbors_{nullptr};
 };
 
 class GetNeighborsSampleNode : public GetNeighborsNode {
@@ -200,6 +215,100 @@ class GetNeighborsSampleNode : public GetNeighborsNode {
   std::unique_ptr<nebula::algorithm::ReservoirSampling<Sample>> sampler_;
 };
 
+// GetNeighborsTopNNode returns the top N edges of each vertex ordered by the given expressions
+// instead of the first N ones, the edges of a vertex are kept by a bounded heap. The sort keys of
+// all the edges met by the node are kept by another heap, so that an edge is dropped once there
+// are N better ones in the request, even if they belong to the other vertices.
+class GetNeighborsTopNNode : public GetNeighborsNode {
+ public:
+  GetNeighborsTopNNode(RuntimeContext* context,
+                       IterateNode<VertexID>* hashJoinNode,
+                       IterateNode<VertexID>* upstream,
+                       EdgeContext* edgeContext,
+                       nebula::DataSet* resultDataSet,
+                       int64_t limit,
+                       StorageExpressionContext* expCtx,
+                       std::vector<std::pair<Expression*, cpp2::OrderDirection>> orderBy)
+      : GetNeighborsNode(context, hashJoinNode, upstream, edgeContext, resultDataSet, limit),
+        expCtx_(expCtx),
+        orderBy_(std::move(orderBy)) {
+    name_ = "GetNeighborsTopNNode";
+    requestTopN_.setHeapSize(limit);
+    requestTopN_.setComparator(
+        [this](std::vector<Value>& lhs, std::vector<Value>& rhs) { return before(lhs, rhs); });
+  }
+
+ private:
+  // sort keys, column index and props of an edge
+  using Candidate = std::tuple<std::vector<Value>, size_t, nebula::List>;
+
+  nebula::cpp2::ErrorCode iterateEdges(std::vector<Value>& row) override {
+    if (edgeContext_->propContexts_.empty() || limit_ <= 0) {
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    TopNHeap<Candidate> topN;
+    topN.setHeapSize(limit_);
+    topN.setComparator([this](Candidate& lhs, Candidate& rhs) {
+      return before(std::get<0>(lhs), std::get<0>(rhs));
+    });
+    for (; upstream_->valid(); upstream_->next()) {
+      if (context_->isPlanKilled()) {
+        return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      }
+      auto key = upstream_->key();
+      auto reader = upstream_->reader();
+      expCtx_->reset(reader, key.str());
+      std::vector<Value> sortKeys;
+      sortKeys.reserve(orderBy_.size());
+      for (auto& order : orderBy_) {
+        sortKeys.emplace_back(order.first->eval(*expCtx_));
+      }
+      // there are already N better edges in the request
+      if (!requestTopN_.push(std::vector<Value>(sortKeys))) {
+        continue;
+      }
+
+      nebula::List list;
+      list.reserve(context_->props_->size());
+      if (!QueryUtils::collectEdgeProps(
+               key, context_->vIdLen(), context_->isIntId(), reader, context_->props_, list)
+               .ok()) {
+        return nebula::cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND;
+      }
+      topN.push(std::make_tuple(std::move(sortKeys), context_->columnIdx_, std::move(list)));
+    }
+
+    for (auto& candidate : topN.moveTopK()) {
+      auto columnIdx = std::get<1>(candidate);
+      // add edge prop value to the target column
+      if (row[columnIdx].empty()) {
+        row[columnIdx].setList(nebula::List());
+      }
+      auto& cell = row[columnIdx].mutableList();
+      cell.values.emplace_back(std::move(std::get<2>(candidate)));
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+  // Whether the edge of lhs is ranked before the one of rhs
+  bool before(const std::vector<Value>& lhs, const std::vector<Value>& rhs) const {
+    for (size_t i = 0; i < orderBy_.size(); ++i) {
+      if (lhs[i] == rhs[i]) {
+        continue;
+      }
+      if (orderBy_[i].second == cpp2::OrderDirection::ASCENDING) {
+        return lhs[i] < rhs[i];
+      }
+      return lhs[i] > rhs[i];
+    }
+    return false;
+  }
+
+  StorageExpressionContext* expCtx_;
+  std::vector<std::pair<Expression*, cpp2::OrderDirection>> orderBy_;
+  TopNHeap<std::vector<Value>> requestTopN_;
+};
+
 }  // namespace storage
 }  // namespace nebula
 
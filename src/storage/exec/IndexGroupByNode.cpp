@@ -0,0 +1,104 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "storage/exec/IndexGroupByNode.h"
+
+#include "storage/exec/IndexSelectionNode.h"
+namespace nebula {
+namespace storage {
+IndexGroupByNode::IndexGroupByNode(const IndexGroupByNode& node)
+    : IndexNode(node),
+      aggregator_(std::make_unique<PartialAggregator>(*node.aggregator_)),
+      colPos_(node.colPos_) {
+  ctx_ = std::make_unique<IndexExprContext>(colPos_);
+}
+
+IndexGroupByNode::IndexGroupByNode(RuntimeContext* context,
+                                   std::unique_ptr<PartialAggregator> aggregator)
+    : IndexNode(context, "IndexGroupByNode"), aggregator_(std::move(aggregator)) {}
+
+::nebula::cpp2::ErrorCode IndexGroupByNode::init(InitContext& ctx) {
+  DCHECK_EQ(children_.size(), 1);
+  SelectionExprVisitor vis;
+  for (auto* key : aggregator_->keys()) {
+    key->accept(&vis);
+  }
+  for (auto* arg : aggregator_->args()) {
+    arg->accept(&vis);
+  }
+  for (auto& col : vis.getRequiredColumns()) {
+    ctx.requiredColumns.insert(col);
+  }
+  auto ret = children_[0]->init(ctx);
+  if (UNLIKELY(ret != ::nebula::cpp2::ErrorCode::SUCCEEDED)) {
+    return ret;
+  }
+  // The child may be a projection, which only returns the columns of request
+  for (auto& col : vis.getRequiredColumns()) {
+    auto iter = ctx.retColMap.find(col);
+    if (iter == ctx.retColMap.end()) {
+      return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    colPos_[col] = iter->second;
+  }
+  ctx_ = std::make_unique<IndexExprContext>(colPos_);
+  ctx.returnColumns = aggregator_->colNames();
+  ctx.retColMap.clear();
+  for (size_t i = 0; i < ctx.returnColumns.size(); i++) {
+    ctx.retColMap[ctx.returnColumns[i]] = i;
+  }
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+::nebula::cpp2::ErrorCode IndexGroupByNode::doExecute(PartitionID partId) {
+  code_ = ::nebula::cpp2::ErrorCode::SUCCEEDED;
+  results_.clear();
+  auto ret = IndexNode::doExecute(partId);
+  if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    code_ = ret;
+    return ret;
+  }
+  auto& child = *children_[0];
+  do {
+    auto result = child.next();
+    if (!result.success()) {
+      // Drop the groups of the failed part
+      aggregator_->finish();
+      code_ = result.code();
+      return code_;
+    }
+    if (!result.hasData()) {
+      break;
+    }
+    ctx_->setRow(result.row());
+    aggregator_->add(*ctx_);
+  } while (true);
+  for (auto& row : aggregator_->finish()) {
+    results_.emplace_back(std::move(row));
+  }
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+IndexNode::Result IndexGroupByNode::doNext() {
+  if (code_ != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return Result(code_);
+  }
+  if (results_.empty()) {
+    return Result();
+  }
+  Result result(std::move(results_.front()));
+  results_.pop_front();
+  return result;
+}
+
+std::unique_ptr<IndexNode> IndexGroupByNode::copy() {
+  return std::make_unique<IndexGroupByNode>(*this);
+}
+
+std::string IndexGroupByNode::identify() {
+  return fmt::format("{}(columns=[{}])", name_, folly::join(",", aggregator_->colNames()));
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,59 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#ifndef STORAGE_EXEC_INDEXGROUPBYNODE_H
+#define STORAGE_EXEC_INDEXGROUPBYNODE_H
+#include "storage/exec/IndexExprContext.h"
+#include "storage/exec/IndexNode.h"
+#include "storage/exec/PartialAggregator.h"
+namespace nebula {
+namespace storage {
+/**
+ *
+ * IndexGroupByNode
+ *
+ * reference: IndexNode, IndexAggregateNode, PartialAggregator
+ *
+ * `IndexGroupByNode` aggregates the rows of child by the group keys of request, and returns one
+ * row per group of each part, which is merged by the caller.
+ *
+ *                   ┌───────────┐
+ *                   │ IndexNode │
+ *                   └─────┬─────┘
+ *                         │
+ *                ┌────────┴─────────┐
+ *                │ IndexGroupByNode │
+ *                └──────────────────┘
+ *
+ * Unlike `IndexAggregateNode`, which calculates the stats of all the parts and returns the rows
+ * as they are, it consumes all the rows of child in `doExecute`, so the rows are not returned.
+ *
+ * Member:
+ * `aggregator_`: the group keys and aggregates, owned by the node
+ * `colPos_`    : the position of column in the rows of child
+ * `ctx_`       : used to eval the keys and aggregates
+ * `results_`   : the groups of current part
+ * `code_`      : the error met while aggregating, returned by the next `doNext`
+ */
+class IndexGroupByNode : public IndexNode {
+ public:
+  IndexGroupByNode(const IndexGroupByNode& node);
+  IndexGroupByNode(RuntimeContext* context, std::unique_ptr<PartialAggregator> aggregator);
+  ::nebula::cpp2::ErrorCode init(InitContext& ctx) override;
+  std::unique_ptr<IndexNode> copy() override;
+  std::string identify() override;
+
+ private:
+  ::nebula::cpp2::ErrorCode doExecute(PartitionID partId) override;
+  Result doNext() override;
+
+  std::unique_ptr<PartialAggregator> aggregator_;
+  Map<std::string, size_t> colPos_;
+  std::unique_ptr<IndexExprContext> ctx_;
+  std::deque<Row> results_;
+  ::nebula::cpp2::ErrorCode code_{::nebula::cpp2::ErrorCode::SUCCEEDED};
+};
+}  // namespace storage
+}  // namespace nebula
+#endif
@@ -0,0 +1,79 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "storage/exec/IndexIntersectNode.h"
+namespace nebula {
+namespace storage {
+IndexIntersectNode::IndexIntersectNode(const IndexIntersectNode& node) : IndexNode(node) {}
+
+IndexIntersectNode::IndexIntersectNode(RuntimeContext* context)
+    : IndexNode(context, "IndexIntersectNode") {}
+
+::nebula::cpp2::ErrorCode IndexIntersectNode::init(InitContext& ctx) {
+  if (children_.size() < 2) {
+    return ::nebula::cpp2::ErrorCode::E_INVALID_OPERATION;
+  }
+  for (auto& child : children_) {
+    if (dynamic_cast<IndexScanNode*>(child.get()) == nullptr) {
+      return ::nebula::cpp2::ErrorCode::E_INVALID_OPERATION;
+    }
+  }
+  // Probes return nothing to parent
+  for (size_t i = 0; i < children_.size() - 1; i++) {
+    InitContext probeCtx;
+    auto ret = children_[i]->init(probeCtx);
+    if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+  }
+  return children_.back()->init(ctx);
+}
+
+::nebula::cpp2::ErrorCode IndexIntersectNode::doExecute(PartitionID partId) {
+  code_ = ::nebula::cpp2::ErrorCode::SUCCEEDED;
+  isEmpty_ = false;
+  auto ret = IndexNode::doExecute(partId);
+  if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    code_ = ret;
+    return ret;
+  }
+  std::shared_ptr<const Set<std::string>> suffixes;
+  for (size_t i = 0; i < children_.size() - 1; i++) {
+    auto probe = scanNode(i);
+    probe->setSuffixFilter(suffixes);
+    auto result = probe->collectSuffixes();
+    if (!nebula::ok(result)) {
+      code_ = nebula::error(result);
+      return code_;
+    }
+    suffixes = std::make_shared<const Set<std::string>>(std::move(nebula::value(result)));
+    if (suffixes->empty()) {
+      isEmpty_ = true;
+      return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+  }
+  scanNode(children_.size() - 1)->setSuffixFilter(std::move(suffixes));
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+IndexNode::Result IndexIntersectNode::doNext() {
+  if (code_ != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return Result(code_);
+  }
+  if (isEmpty_) {
+    return Result();
+  }
+  return children_.back()->next();
+}
+
+std::unique_ptr<IndexNode> IndexIntersectNode::copy() {
+  return std::make_unique<IndexIntersectNode>(*this);
+}
+
+std::string IndexIntersectNode::identify() {
+  return fmt::format("{}(indexes={})", name_, children_.size());
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,57 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#ifndef STORAGE_EXEC_INDEXINTERSECTNODE_H
+#define STORAGE_EXEC_INDEXINTERSECTNODE_H
+#include "storage/exec/IndexNode.h"
+#include "storage/exec/IndexScanNode.h"
+namespace nebula {
+namespace storage {
+/**
+ *
+ * IndexIntersectNode
+ *
+ * reference: IndexNode, IndexScanNode
+ *
+ * `IndexIntersectNode` returns the vertices or edges hit by all of its children, which are
+ * `IndexScanNode` on different indexes of the same tag or edge.
+ *
+ *                   ┌───────────┐
+ *                   │ IndexNode │
+ *                   └─────┬─────┘
+ *                         │
+ *              ┌──────────┴─────────┐
+ *              │ IndexIntersectNode │
+ *              └────────────────────┘
+ *
+ * All children except the last one are probes, which only scan the index keys of a part, and
+ * the set of suffixes(vid or src/rank/dst) qualified by a probe is used to skip the keys of the
+ * next one, so the set only shrinks. The last child is the driver, it returns the rows to parent
+ * and only accesses base data for the keys qualified by all probes.
+ *
+ * Member:
+ * `code_`   : the error met while scanning probes, returned by the next `doNext`
+ * `isEmpty_`: whether nothing is qualified by probes
+ */
+class IndexIntersectNode : public IndexNode {
+ public:
+  IndexIntersectNode(const IndexIntersectNode& node);
+  explicit IndexIntersectNode(RuntimeContext* context);
+  ::nebula::cpp2::ErrorCode init(InitContext& ctx) override;
+  std::unique_ptr<IndexNode> copy() override;
+  std::string identify() override;
+
+ private:
+  ::nebula::cpp2::ErrorCode doExecute(PartitionID partId) override;
+  Result doNext() override;
+  IndexScanNode* scanNode(size_t i) {
+    return static_cast<IndexScanNode*>(children_[i].get());
+  }
+
+  ::nebula::cpp2::ErrorCode code_{::nebula::cpp2::ErrorCode::SUCCEEDED};
+  bool isEmpty_{false};
+};
+}  // namespace storage
+}  // namespace nebula
+#endif
@@ -0,0 +1,175 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "storage/exec/IndexKnnNode.h"
+
+#include <s2/s2earth.h>
+#include <s2/s2latlng.h>
+
+#include <cmath>
+namespace nebula {
+namespace storage {
+namespace {
+// Half of the circumference of earth, the cap of which covers the whole sphere
+const double kMaxRadius = S2Earth::RadiusMeters() * M_PI;
+
+S2LatLng toLatLng(const Point& point) {
+  return S2LatLng::FromDegrees(point.coord.y, point.coord.x);
+}
+}  // namespace
+
+IndexKnnNode::IndexKnnNode(const IndexKnnNode& node)
+    : IndexNode(node), nearest_(node.nearest_), rcParams_(node.rcParams_), colPos_(node.colPos_) {}
+
+IndexKnnNode::IndexKnnNode(RuntimeContext* context, const cpp2::NearestNeighbors* nearest)
+    : IndexNode(context, "IndexKnnNode"), nearest_(nearest) {}
+
+::nebula::cpp2::ErrorCode IndexKnnNode::init(InitContext& ctx) {
+  DCHECK_EQ(children_.size(), 1);
+  const auto& column = nearest_->get_column_name();
+  ctx.requiredColumns.insert(column);
+  auto ret = children_[0]->init(ctx);
+  if (UNLIKELY(ret != ::nebula::cpp2::ErrorCode::SUCCEEDED)) {
+    return ret;
+  }
+  auto scan = scanNode();
+  if (scan == nullptr || nearest_->get_point().shape() != GeoShape::POINT) {
+    return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  // Only the index on a column of points is scanned ring by ring, because the ancestor cells of
+  // other shapes are not in any ring
+  const auto* index = scan->index();
+  const auto& fields = index->get_fields();
+  if (fields.size() != 1 || fields.front().get_name() != column ||
+      fields.front().get_type().get_type() != ::nebula::cpp2::PropertyType::GEOGRAPHY ||
+      fields.front().get_type().geo_shape_ref().value_or(meta::cpp2::GeoShape::ANY) !=
+          meta::cpp2::GeoShape::POINT) {
+    return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  const auto* indexParams = index->get_index_params();
+  if (indexParams != nullptr) {
+    if (indexParams->s2_max_level_ref().has_value()) {
+      rcParams_.maxCellLevel_ = indexParams->s2_max_level_ref().value();
+    }
+    if (indexParams->s2_max_cells_ref().has_value()) {
+      rcParams_.maxCellNum_ = indexParams->s2_max_cells_ref().value();
+    }
+  }
+  colPos_ = ctx.retColMap.at(column);
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+IndexScanNode* IndexKnnNode::scanNode() {
+  IndexNode* node = children_[0].get();
+  while (dynamic_cast<IndexScanNode*>(node) == nullptr) {
+    if (node->children().size() != 1) {
+      return nullptr;
+    }
+    node = node->children()[0].get();
+  }
+  return static_cast<IndexScanNode*>(node);
+}
+
+::nebula::cpp2::ErrorCode IndexKnnNode::doExecute(PartitionID partId) {
+  code_ = ::nebula::cpp2::ErrorCode::SUCCEEDED;
+  results_.clear();
+  auto ret = IndexNode::doExecute(partId);
+  if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    code_ = ret;
+    return ret;
+  }
+  auto k = nearest_->get_k();
+  if (k <= 0) {
+    return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  TopNHeap<Neighbor> heap;
+  heap.setHeapSize(k);
+  heap.setComparator([](Neighbor& lhs, Neighbor& rhs) { return lhs.first < rhs.first; });
+  geo::GeoIndex geoIndex(rcParams_, true);
+  double inner = 0;
+  double outer = kInitialRadius;
+  while (true) {
+    ret = scanRing(geoIndex, inner, outer, heap);
+    if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+      code_ = ret;
+      return ret;
+    }
+    if (heap.size() >= static_cast<size_t>(k) || outer >= kMaxRadius) {
+      break;
+    }
+    inner = outer;
+    outer = std::min(outer * kRadiusGrowth, kMaxRadius);
+  }
+  auto neighbors = heap.moveTopK();
+  std::sort(neighbors.begin(), neighbors.end(), [](const Neighbor& lhs, const Neighbor& rhs) {
+    return lhs.first < rhs.first;
+  });
+  for (auto& neighbor : neighbors) {
+    results_.emplace_back(std::move(neighbor.second));
+  }
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+::nebula::cpp2::ErrorCode IndexKnnNode::scanRing(const geo::GeoIndex& geoIndex,
+                                                 double inner,
+                                                 double outer,
+                                                 TopNHeap<Neighbor>& heap) {
+  const auto& point = nearest_->get_point();
+  auto ranges = geoIndex.dWithinRing(point, inner, outer);
+  std::vector<std::vector<cpp2::IndexColumnHint>> paths;
+  paths.reserve(ranges.size());
+  for (auto& range : ranges) {
+    auto hint = range.toIndexColumnHint();
+    hint.column_name_ref() = nearest_->get_column_name();
+    paths.push_back({std::move(hint)});
+  }
+  auto ret = scanNode()->resetPaths(paths);
+  if (ret != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  auto center = toLatLng(point.point());
+  auto& child = *children_[0];
+  do {
+    auto result = child.next();
+    if (!result.success()) {
+      return result.code();
+    }
+    if (!result.hasData()) {
+      break;
+    }
+    const auto& value = result.row()[colPos_];
+    if (!value.isGeography() || value.getGeography().shape() != GeoShape::POINT) {
+      continue;
+    }
+    auto distance = S2Earth::GetDistanceMeters(center, toLatLng(value.getGeography().point()));
+    if (distance > outer || (inner > 0 && distance <= inner)) {
+      continue;
+    }
+    heap.push(std::make_pair(distance, std::move(result).row()));
+  } while (true);
+  return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+IndexNode::Result IndexKnnNode::doNext() {
+  if (code_ != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return Result(code_);
+  }
+  if (results_.empty()) {
+    return Result();
+  }
+  Result result(std::move(results_.front()));
+  results_.pop_front();
+  return result;
+}
+
+std::unique_ptr<IndexNode> IndexKnnNode::copy() {
+  return std::make_unique<IndexKnnNode>(*this);
+}
+
+std::string IndexKnnNode::identify() {
+  return fmt::format("{}(column={}, k={})", name_, nearest_->get_column_name(), nearest_->get_k());
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,77 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#ifndef STORAGE_EXEC_INDEXKNNNODE_H
+#define STORAGE_EXEC_INDEXKNNNODE_H
+#include "common/geo/GeoIndex.h"
+#include "storage/exec/IndexNode.h"
+#include "storage/exec/IndexScanNode.h"
+#include "storage/exec/IndexTopNNode.h"
+namespace nebula {
+namespace storage {
+/**
+ *
+ * IndexKnnNode
+ *
+ * reference: IndexNode, IndexScanNode, IndexTopNNode
+ *
+ * `IndexKnnNode` returns the k vertices or edges nearest to a point in each part, ordered by the
+ * distance, by scanning the geography index of points.
+ *
+ *                   ┌───────────┐
+ *                   │ IndexNode │
+ *                   └─────┬─────┘
+ *                         │
+ *                  ┌──────┴───────┐
+ *                  │ IndexKnnNode │
+ *                  └──────────────┘
+ *
+ * The index is scanned ring by ring around the point instead of at once. The first ring is the
+ * cap of `kInitialRadius`, and each ring is the cells within the next radius but not covered by
+ * the previous cap, while the radius grows by `kRadiusGrowth` times. The neighbors found in a
+ * ring are pushed into a heap of size k, and it stops once the heap is full, because all the
+ * neighbors nearer than the radius have been found.
+ *
+ * The child is an `IndexScanNode` on the index, or a chain of single-child nodes above it(e.g.
+ * `IndexSelectionNode`), and its paths are replaced for each ring.
+ *
+ * Member:
+ * `nearest_` : the column, point and k
+ * `rcParams_`: the params of index to cover the rings
+ * `colPos_`  : the position of column in the rows of child
+ * `results_` : the neighbors of current part, ordered by the distance
+ * `code_`    : the error met while scanning, returned by the next `doNext`
+ */
+class IndexKnnNode : public IndexNode {
+ public:
+  IndexKnnNode(const IndexKnnNode& node);
+  IndexKnnNode(RuntimeContext* context, const cpp2::NearestNeighbors* nearest);
+  ::nebula::cpp2::ErrorCode init(InitContext& ctx) override;
+  std::unique_ptr<IndexNode> copy() override;
+  std::string identify() override;
+
+ private:
+  using Neighbor = std::pair<double, Row>;
+  static constexpr double kInitialRadius = 100;
+  static constexpr double kRadiusGrowth = 4;
+
+  ::nebula::cpp2::ErrorCode doExecute(PartitionID partId) override;
+  Result doNext() override;
+  IndexScanNode* scanNode();
+  // Push the neighbors whose distance is in (inner, outer] into the heap, or [0, outer] if inner
+  // is 0, so that a neighbor is only pushed by one ring
+  ::nebula::cpp2::ErrorCode scanRing(const geo::GeoIndex& geoIndex,
+                                     double inner,
+                                     double outer,
+                                     TopNHeap<Neighbor>& heap);
+
+  const cpp2::NearestNeighbors* nearest_;
+  geo::RegionCoverParams rcParams_;
+  size_t colPos_{0};
+  std::deque<Row> results_;
+  ::nebula::cpp2::ErrorCode code_{::nebula::cpp2::ErrorCode::SUCCEEDED};
+};
+}  // namespace storage
+}  // namespace nebula
+#endif
@@ -51,6 +51,13 @@ std::unique_ptr<Path> Path::make(nebula::meta::cpp2::IndexItem* index,
   return ret;
 }
 
+std::unique_ptr<Path> Path::clone() const {
+  if (auto rangePath = dynamic_cast<const RangePath*>(this)) {
+    return std::make_unique<RangePath>(*rangePath);
+  }
+  return std::make_unique<PrefixPath>(*dynamic_cast<const PrefixPath*>(this));
+}
+
 QualifiedStrategy::Result Path::qualified(const folly::StringPiece& key) {
   return strategySet_(key);
 }
@@ -360,16 +367,21 @@ IndexScanNode::IndexScanNode(const IndexScanNode& node)
       index_(node.index_),
       indexNullable_(node.indexNullable_),
       columnHints_(node.columnHints_),
+      pathIdx_(node.pathIdx_),
+      skipScan_(node.skipScan_),
+      leading_(node.leading_),
       kvstore_(node.kvstore_),
       requiredColumns_(node.requiredColumns_),
       requiredAndHintColumns_(node.requiredAndHintColumns_),
       ttlProps_(node.ttlProps_),
       needAccessBase_(node.needAccessBase_),
-      colPosMap_(node.colPosMap_) {
-  if (node.path_->isRange()) {
-    path_ = std::make_unique<RangePath>(*dynamic_cast<RangePath*>(node.path_.get()));
-  } else {
-    path_ = std::make_unique<PrefixPath>(*dynamic_cast<PrefixPath*>(node.path_.get()));
+      colPosMap_(node.colPosMap_),
+      suffixLength_(node.suffixLength_) {
+  for (auto& path : node.paths_) {
+    paths_.emplace_back(path->clone());
+  }
+  if (pathIdx_ < paths_.size()) {
+    path_ = paths_[pathIdx_].get();
   }
 }
 
@@ -408,21 +420,177 @@ IndexScanNode::IndexScanNode(const IndexScanNode& node)
   tmp.erase(kDst);
   tmp.erase(kType);
   needAccessBase_ = !tmp.empty();
-  path_ = Path::make(index_.get(), getSchema().back().get(), columnHints_, context_->vIdLen());
+  if (index_->get_schema_id().tag_id_ref().has_value()) {
+    suffixLength_ = context_->vIdLen();
+  } else {
+    suffixLength_ = context_->vIdLen() * 2 + sizeof(EdgeRanking);
+  }
+  if (skipScan_) {
+    // The value of the first field is decoded from the index key to build paths, so it must be
+    // of fixed length and not nullable
+    const auto& fields = index_->get_fields();
+    if (fields.size() < 2 || fields.front().nullable_ref().value_or(false)) {
+      return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    switch (IndexKeyUtils::toValueType(fields.front().get_type().get_type())) {
+      case Value::Type::BOOL:
+      case Value::Type::INT:
+      case Value::Type::DATE:
+      case Value::Type::TIME:
+      case Value::Type::DATETIME:
+        break;
+      default:
+        return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    // The paths are built for each value of the first field during execution
+    return ::nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  return buildPaths(columnHints_);
+}
+
+nebula::cpp2::ErrorCode IndexScanNode::buildPaths(
+    const std::vector<cpp2::IndexColumnHint>& hints) {
+  std::vector<std::vector<cpp2::IndexColumnHint>> expanded(1);
+  for (auto& hint : hints) {
+    if (!hint.in_values_ref().has_value()) {
+      for (auto& h : expanded) {
+        h.emplace_back(hint);
+      }
+      continue;
+    }
+    if (hint.get_scan_type() != cpp2::ScanType::PREFIX) {
+      return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    // The ranges of paths must not overlap, otherwise a key is returned more than once
+    auto values = *hint.in_values_ref();
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    std::vector<std::vector<cpp2::IndexColumnHint>> next;
+    next.reserve(expanded.size() * values.size());
+    for (auto& h : expanded) {
+      for (auto& value : values) {
+        next.emplace_back(h);
+        auto& last = next.back().emplace_back(hint);
+        last.in_values_ref().reset();
+        last.begin_value_ref() = value;
+      }
+    }
+    expanded = std::move(next);
+  }
+  paths_.clear();
+  for (auto& h : expanded) {
+    paths_.emplace_back(Path::make(index_.get(), getSchema().back().get(), h, context_->vIdLen()));
+  }
+  pathIdx_ = 0;
+  path_ = paths_.empty() ? nullptr : paths_.front().get();
   return ::nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+nebula::cpp2::ErrorCode IndexScanNode::resetPaths(
+    const std::vector<std::vector<cpp2::IndexColumnHint>>& paths) {
+  DCHECK(!skipScan_);
+  iter_.reset();
+  paths_.clear();
+  for (auto& hints : paths) {
+    paths_.emplace_back(
+        Path::make(index_.get(), getSchema().back().get(), hints, context_->vIdLen()));
+  }
+  pathIdx_ = 0;
+  if (paths_.empty()) {
+    path_ = nullptr;
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  path_ = paths_.front().get();
+  return resetIter(partId_);
+}
+
 nebula::cpp2::ErrorCode IndexScanNode::doExecute(PartitionID partId) {
   partId_ = partId;
-  auto ret = resetIter(partId);
-  return ret;
+  iter_.reset();
+  if (skipScan_) {
+    leading_.clear();
+    return seekNextLeading();
+  }
+  pathIdx_ = 0;
+  if (paths_.empty()) {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  path_ = paths_.front().get();
+  return resetIter(partId);
+}
+
+nebula::cpp2::ErrorCode IndexScanNode::nextPath() {
+  iter_.reset();
+  if (pathIdx_ + 1 < paths_.size()) {
+    path_ = paths_[++pathIdx_].get();
+    return resetIter(partId_);
+  }
+  if (skipScan_) {
+    return seekNextLeading();
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode IndexScanNode::seekNextLeading() {
+  auto prefix = IndexKeyUtils::indexPrefix(partId_, indexId_);
+  // The smallest key greater than all the keys with the last value of the first field, i.e.
+  // increase the last byte which is not '\xFF'
+  auto start = prefix + leading_;
+  if (!leading_.empty()) {
+    while (start.size() > prefix.size() && start.back() == '\xFF') {
+      start.pop_back();
+    }
+    if (start.size() == prefix.size()) {
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    start.back() = static_cast<char>(static_cast<uint8_t>(start.back()) + 1);
+  }
+  std::unique_ptr<kvstore::KVIterator> iter;
+  auto ret = kvstore_->rangeWithPrefix(spaceId_, partId_, start, prefix, &iter);
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  if (!iter->valid()) {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  const auto& field = index_->get_fields().front();
+  auto type = IndexKeyUtils::toValueType(field.get_type().get_type());
+  auto len = IndexKeyUtils::encodeNullValue(type, field.get_type().get_type_length()).size();
+  leading_ = iter->key().subpiece(prefix.size(), len).str();
+  std::vector<cpp2::IndexColumnHint> hints(1);
+  hints.front().column_name_ref() = field.get_name();
+  hints.front().scan_type_ref() = cpp2::ScanType::PREFIX;
+  hints.front().begin_value_ref() = IndexKeyUtils::decodeValue(leading_, type);
+  hints.insert(hints.end(), columnHints_.begin(), columnHints_.end());
+  ret = buildPaths(hints);
+  if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return ret;
+  }
+  return resetIter(partId_);
 }
 
 IndexNode::Result IndexScanNode::doNext() {
+  do {
+    auto result = nextRow();
+    if (!result.success() || result.hasData()) {
+      return result;
+    }
+    auto ret = nextPath();
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return Result(ret);
+    }
+  } while (iter_ != nullptr);
+  return Result();
+}
+
+IndexNode::Result IndexScanNode::nextRow() {
   for (; iter_ && iter_->valid(); iter_->next()) {
     if (!checkTTL()) {
       continue;
     }
+    if (!checkSuffix(iter_->key())) {
+      continue;
+    }
     auto q = path_->qualified(iter_->key());
     if (q == QualifiedStrategy::INCOMPATIBLE) {
       continue;
@@ -465,6 +633,51 @@ IndexNode::Result IndexScanNode::doNext() {
   return Result();
 }
 
+ErrorOr<nebula::cpp2::ErrorCode, Set<std::string>> IndexScanNode::collectSuffixes() {
+  Set<std::string> suffixes;
+  while (iter_ != nullptr) {
+    auto ret = collectSuffixes(suffixes);
+    if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
+      ret = nextPath();
+    }
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+  }
+  return suffixes;
+}
+
+nebula::cpp2::ErrorCode IndexScanNode::collectSuffixes(Set<std::string>& suffixes) {
+  for (; iter_ && iter_->valid(); iter_->next()) {
+    if (context_->isPlanKilled()) {
+      return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+    }
+    if (!checkTTL() || !checkSuffix(iter_->key())) {
+      continue;
+    }
+    auto q = path_->qualified(iter_->key());
+    if (q == QualifiedStrategy::INCOMPATIBLE) {
+      continue;
+    }
+    if (q == QualifiedStrategy::UNCERTAIN) {
+      std::pair<std::string, std::string> kv;
+      auto ret = getBaseData(iter_->key(), kv);
+      if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+        continue;
+      } else if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+      }
+      if (path_->qualified(decodeFromBase(kv.first, kv.second)) ==
+          QualifiedStrategy::INCOMPATIBLE) {
+        continue;
+      }
+    }
+    auto key = iter_->key();
+    suffixes.emplace(key.subpiece(key.size() - suffixLength_).str());
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 bool IndexScanNode::checkTTL() {
   if (iter_->val().empty() || ttlProps_.first == false) {
     return true;
@@ -483,10 +696,10 @@ nebula::cpp2::ErrorCode IndexScanNode::resetIter(PartitionID partId) {
   path_->resetPart(partId);
   nebula::cpp2::ErrorCode ret = nebula::cpp2::ErrorCode::SUCCEEDED;
   if (path_->isRange()) {
-    auto rangePath = dynamic_cast<RangePath*>(path_.get());
+    auto rangePath = dynamic_cast<RangePath*>(path_);
     kvstore_->range(spaceId_, partId, rangePath->getStartKey(), rangePath->getEndKey(), &iter_);
   } else {
-    auto prefixPath = dynamic_cast<PrefixPath*>(path_.get());
+    auto prefixPath = dynamic_cast<PrefixPath*>(path_);
     ret = kvstore_->prefix(spaceId_, partId, prefixPath->getPrefixKey(), &iter_);
   }
   return ret;
@@ -551,7 +764,14 @@ void IndexScanNode::decodePropFromIndex(folly::StringPiece key,
 }
 
 std::string IndexScanNode::identify() {
-  return fmt::format("{}(IndexID={}, Path=({}))", name_, indexId_, path_->toString());
+  if (skipScan_) {
+    return fmt::format("{}(IndexID={}, SkipScan=true)", name_, indexId_);
+  }
+  std::vector<std::string> paths;
+  for (auto& path : paths_) {
+    paths.emplace_back(fmt::format("({})", path->toString()));
+  }
+  return fmt::format("{}(IndexID={}, Path={})", name_, indexId_, folly::join(", ", paths));
 }
 
 // End of IndexScan
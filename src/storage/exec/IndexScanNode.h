@@ -48,7 +48,11 @@ namespace storage {
  * `index_`                 : index definition
  * `indexNullable_`         : if index contain nullable field or not
  * `columnHints_`           :
- * `path_`                  :
+ * `paths_`                 : paths to scan on each part, there are more than one if some column
+ *                            hints have `in_values`, one for each combination of the values
+ * `path_`                  : current path in `paths_`
+ * `skipScan_`              : the first field of index is not hit by `columnHints_`, `paths_` are
+ *                            built for each distinct value of it found by seeking the index
  * `iter_`                  : current kvstore iterator.It while be reset `doExecute` and iterated
  *                            during `doNext`
  * `kvstore_`               : server kvstore
@@ -113,6 +117,7 @@ namespace storage {
  *
  * Function:
  * `make`                   : construct `PrefixPath` or `RangePath` according to `hints`
+ * `clone`                  : copy the path of derive class
  * `qualified(StringPiece)` : qualified key by bytes
  * `qualified(Map)`         : qualified row by value
  * `resetPart`              : reset current partitionID and reset `iter_`
@@ -145,9 +150,36 @@ class IndexScanNode : public IndexNode {
   ::nebula::cpp2::ErrorCode init(InitContext& ctx) override;
   std::string identify() override;
 
+  /**
+   * The suffix of an index key is the vid of vertex or the src, rank and dst of edge, which is
+   * the same in all the indexes of a tag or an edge. `collectSuffixes` scans the current part and
+   * returns the suffixes of all qualified keys, and the keys whose suffixes are not in the filter
+   * are skipped before accessing base data. They are used by `IndexIntersectNode`.
+   */
+  ErrorOr<nebula::cpp2::ErrorCode, Set<std::string>> collectSuffixes();
+  void setSuffixFilter(std::shared_ptr<const Set<std::string>> suffixes) {
+    suffixFilter_ = std::move(suffixes);
+  }
+  void setSkipScan(bool skipScan) {
+    skipScan_ = skipScan;
+  }
+  /**
+   * Replace the paths of current part, one for each list of hints, and scan from the first one.
+   * It is called after `execute`, and used by `IndexKnnNode` to scan the index ring by ring.
+   */
+  nebula::cpp2::ErrorCode resetPaths(const std::vector<std::vector<cpp2::IndexColumnHint>>& paths);
+  // Only valid after `init`
+  const nebula::meta::cpp2::IndexItem* index() const {
+    return index_.get();
+  }
+
  protected:
   nebula::cpp2::ErrorCode doExecute(PartitionID partId) final;
   Result doNext() final;
+  // The next row of current path
+  Result nextRow();
+  // Collect the suffixes of current path
+  nebula::cpp2::ErrorCode collectSuffixes(Set<std::string>& suffixes);
   void decodePropFromIndex(folly::StringPiece key,
                            const Map<std::string, size_t>& colPosMap,
                            std::vector<Value>& values);
@@ -158,13 +190,28 @@ class IndexScanNode : public IndexNode {
                                                  const std::string& value) = 0;
   virtual const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& getSchema() = 0;
   bool checkTTL();
+  bool checkSuffix(folly::StringPiece key) {
+    return suffixFilter_ == nullptr ||
+           suffixFilter_->count(key.subpiece(key.size() - suffixLength_).str()) > 0;
+  }
   nebula::cpp2::ErrorCode resetIter(PartitionID partId);
+  // Move to the next path of current part, `iter_` is reset to nullptr if there is none
+  nebula::cpp2::ErrorCode nextPath();
+  // Seek the next distinct value of the first field, and build `paths_` for it
+  nebula::cpp2::ErrorCode seekNextLeading();
+  // Build a path for each combination of the `in_values` of hints
+  nebula::cpp2::ErrorCode buildPaths(const std::vector<cpp2::IndexColumnHint>& hints);
   PartitionID partId_;
   const IndexID indexId_;
   std::shared_ptr<nebula::meta::cpp2::IndexItem> index_;
   bool indexNullable_ = false;
   const std::vector<cpp2::IndexColumnHint>& columnHints_;
-  std::unique_ptr<Path> path_;
+  std::vector<std::unique_ptr<Path>> paths_;
+  size_t pathIdx_{0};
+  Path* path_{nullptr};
+  bool skipScan_{false};
+  // The encoded value of the first field which `paths_` are built for, only for skip scan
+  std::string leading_;
   std::unique_ptr<kvstore::KVIterator> iter_;
   nebula::kvstore::KVStore* kvstore_;
   std::vector<std::string> requiredColumns_;
@@ -173,6 +220,8 @@ class IndexScanNode : public IndexNode {
   bool needAccessBase_{false};
   bool fatalOnBaseNotFound_{false};
   Map<std::string, size_t> colPosMap_;
+  size_t suffixLength_{0};
+  std::shared_ptr<const Set<std::string>> suffixFilter_;
 };
 class QualifiedStrategy {
  public:
@@ -338,6 +387,7 @@ class Path {
                                     const meta::SchemaProviderIf* schema,
                                     const std::vector<cpp2::IndexColumnHint>& hints,
                                     int64_t vidLen);
+  std::unique_ptr<Path> clone() const;
   QualifiedStrategy::Result qualified(const folly::StringPiece& key);
   virtual bool isRange() {
     return false;
@@ -6,7 +6,7 @@
 namespace nebula {
 namespace storage {
 IndexSelectionNode::IndexSelectionNode(const IndexSelectionNode& node)
-    : IndexNode(node), expr_(node.expr_), colPos_(node.colPos_) {
+    : IndexNode(node), expr_(node.expr_->clone()), colPos_(node.colPos_) {
   ctx_ = std::make_unique<IndexExprContext>(colPos_);
 }
 
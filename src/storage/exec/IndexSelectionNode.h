@@ -29,7 +29,7 @@ namespace storage {
  *               │ IndexSelectionNode │
  *               └────────────────────┘
  * Member:
- * `expr_`  : expression used to filter
+ * `expr_`  : expression used to filter, cloned by the copies because it is not thread-safe
  * `colPos_`: column's position in Row which is during eval `expr_`
  * `ctx_`   : used to eval expression
  * Function:
@@ -13,25 +13,32 @@ class TopNHeap final {
  public:
   ~TopNHeap() = default;
 
+  // The heap grows on demand, since the size may be far larger than the rows pushed
   void setHeapSize(uint64_t heapSize) {
     heapSize_ = heapSize;
-    v_.reserve(heapSize);
   }
 
   void setComparator(std::function<bool(T&, T&)> comparator) {
     comparator_ = comparator;
   }
 
-  void push(T&& data) {
+  // Return whether the data is kept in the heap
+  bool push(T&& data) {
     if (v_.size() < heapSize_) {
       v_.push_back(std::move(data));
       adjustUp(v_.size() - 1);
-      return;
+      return true;
     }
-    if (comparator_(data, v_[0])) {
+    if (heapSize_ > 0 && comparator_(data, v_[0])) {
       v_[0] = std::move(data);
       adjustDown(0);
+      return true;
     }
+    return false;
+  }
+
+  size_t size() const {
+    return v_.size();
   }
 
   std::vector<T> moveTopK() {
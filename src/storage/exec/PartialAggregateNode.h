@@ -0,0 +1,74 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_EXEC_PARTIALAGGREGATENODE_H_
+#define STORAGE_EXEC_PARTIALAGGREGATENODE_H_
+
+#include "common/base/Base.h"
+#include "storage/context/StorageExpressionContext.h"
+#include "storage/exec/PartialAggregator.h"
+#include "storage/exec/RelNode.h"
+
+namespace nebula {
+namespace storage {
+
+// PartialAggregateNode takes the place of GetNeighborsNode when the request asks to aggregate
+// the edges. It adds each edge from the upstream to the aggregator, instead of collecting its
+// props into a row, and the groups are moved out by the caller once all the vertices of a part
+// are done.
+class PartialAggregateNode : public QueryNode<VertexID> {
+ public:
+  using RelNode::doExecute;
+
+  PartialAggregateNode(RuntimeContext* context,
+                       IterateNode<VertexID>* upstream,
+                       StorageExpressionContext* expCtx,
+                       PartialAggregator* aggregator,
+                       int64_t limit = 0)
+      : context_(context),
+        upstream_(upstream),
+        expCtx_(expCtx),
+        aggregator_(aggregator),
+        limit_(limit) {
+    name_ = "PartialAggregateNode";
+  }
+
+  nebula::cpp2::ErrorCode doExecute(PartitionID partId, const VertexID& vId) override {
+    auto ret = RelNode::doExecute(partId, vId);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    if (context_->isPlanKilled()) {
+      return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+    }
+    if (context_->resultStat_ == ResultStatus::ILLEGAL_DATA) {
+      return nebula::cpp2::ErrorCode::E_INVALID_DATA;
+    }
+
+    int64_t edgeRowCount = 0;
+    for (; upstream_->valid(); upstream_->next(), ++edgeRowCount) {
+      if (context_->isPlanKilled()) {
+        return nebula::cpp2::ErrorCode::E_PLAN_IS_KILLED;
+      }
+      if (edgeRowCount >= limit_) {
+        break;
+      }
+      expCtx_->reset(upstream_->reader(), upstream_->key().str());
+      aggregator_->add(*expCtx_);
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
+ private:
+  RuntimeContext* context_;
+  IterateNode<VertexID>* upstream_;
+  StorageExpressionContext* expCtx_;
+  PartialAggregator* aggregator_;
+  int64_t limit_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_EXEC_PARTIALAGGREGATENODE_H_
@@ -0,0 +1,100 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "storage/exec/PartialAggregator.h"
+
+#include "common/expression/AggregateExpression.h"
+
+namespace nebula {
+namespace storage {
+namespace {
+// The aggregates whose partial results are merged by the same or another function of them
+bool isMergeable(const std::string& name) {
+  static const std::unordered_set<std::string> kMergeable = {"COUNT", "SUM", "MAX", "MIN"};
+  return kMergeable.find(name) != kMergeable.end();
+}
+}  // namespace
+
+PartialAggregator::PartialAggregator(const PartialAggregator& other)
+    : pool_(other.pool_), names_(other.names_), funcs_(other.funcs_) {
+  for (auto* key : other.keys_) {
+    keys_.emplace_back(key->clone());
+  }
+  for (auto* arg : other.args_) {
+    args_.emplace_back(arg->clone());
+  }
+}
+
+nebula::cpp2::ErrorCode PartialAggregator::init(const cpp2::AggregateSpec& spec) {
+  for (const auto& str : spec.get_group_keys()) {
+    auto* key = Expression::decode(pool_, str);
+    if (key == nullptr) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    keys_.emplace_back(key);
+  }
+  for (const auto& str : spec.get_aggregates()) {
+    auto* expr = Expression::decode(pool_, str);
+    if (expr == nullptr || expr->kind() != Expression::Kind::kAggregate) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    auto* agg = static_cast<AggregateExpression*>(expr);
+    auto name = agg->name();
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    if (!isMergeable(name) || agg->distinct() || agg->arg() == nullptr) {
+      return nebula::cpp2::ErrorCode::E_INVALID_STAT_TYPE;
+    }
+    auto func = AggFunctionManager::get(name);
+    if (!func.ok()) {
+      return nebula::cpp2::ErrorCode::E_INVALID_STAT_TYPE;
+    }
+    names_.emplace_back(agg->toString());
+    args_.emplace_back(agg->arg());
+    funcs_.emplace_back(std::move(func).value());
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+void PartialAggregator::add(ExpressionContext& ctx) {
+  List list;
+  list.values.reserve(keys_.size());
+  for (auto* key : keys_) {
+    list.values.emplace_back(key->eval(ctx));
+  }
+  auto iter = groups_.find(list);
+  if (iter == groups_.end()) {
+    std::vector<AggData> aggData(funcs_.size());
+    iter = groups_.emplace(std::move(list), std::move(aggData)).first;
+  }
+  auto& aggData = iter->second;
+  for (size_t i = 0; i < funcs_.size(); ++i) {
+    funcs_[i](&aggData[i], args_[i]->eval(ctx));
+  }
+}
+
+std::vector<Row> PartialAggregator::finish() {
+  std::vector<Row> rows;
+  rows.reserve(groups_.size());
+  for (auto& group : groups_) {
+    Row row(group.first.values);
+    for (auto& aggData : group.second) {
+      row.values.emplace_back(std::move(aggData.result()));
+    }
+    rows.emplace_back(std::move(row));
+  }
+  groups_.clear();
+  return rows;
+}
+
+std::vector<std::string> PartialAggregator::colNames() const {
+  std::vector<std::string> colNames;
+  for (auto* key : keys_) {
+    colNames.emplace_back(key->toString());
+  }
+  colNames.insert(colNames.end(), names_.begin(), names_.end());
+  return colNames;
+}
+
+}  // namespace storage
+}  // namespace nebula
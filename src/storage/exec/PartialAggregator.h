@@ -0,0 +1,71 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#ifndef STORAGE_EXEC_PARTIALAGGREGATOR_H
+#define STORAGE_EXEC_PARTIALAGGREGATOR_H
+
+#include "common/base/Base.h"
+#include "common/base/ObjectPool.h"
+#include "common/context/ExpressionContext.h"
+#include "common/expression/Expression.h"
+#include "common/function/AggFunctionManager.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * PartialAggregator
+ *
+ * `PartialAggregator` aggregates the rows of a request by the `AggregateSpec` of it, so that only
+ * one row per group is returned. The results are partial, the caller merges the groups of all the
+ * parts and hosts, i.e. sums the counts and sums, and takes the max of maxes and the min of mins.
+ *
+ * Member:
+ * `keys_`  : the expressions to group by
+ * `args_`  : the argument of each aggregate
+ * `funcs_` : the function of each aggregate
+ * `groups_`: the partial results of each aggregate, grouped by the values of keys
+ *
+ * A copy has its own expressions and no groups, so that the copies could be used by threads.
+ */
+class PartialAggregator final {
+ public:
+  explicit PartialAggregator(ObjectPool* pool) : pool_(pool) {}
+  PartialAggregator(const PartialAggregator& other);
+
+  // Decode the spec, return E_INVALID_PARM if it could not be decoded, or E_INVALID_STAT_TYPE if
+  // the aggregate could not be merged by the caller
+  nebula::cpp2::ErrorCode init(const cpp2::AggregateSpec& spec);
+
+  // Evaluate the keys and arguments by the context, and add the row to its group
+  void add(ExpressionContext& ctx);
+
+  // Move the groups out, one row per group, in which the values of keys are followed by the
+  // results of aggregates
+  std::vector<Row> finish();
+
+  // The group keys followed by the aggregates
+  std::vector<std::string> colNames() const;
+
+  const std::vector<Expression*>& keys() const {
+    return keys_;
+  }
+
+  const std::vector<Expression*>& args() const {
+    return args_;
+  }
+
+ private:
+  ObjectPool* pool_;
+  std::vector<Expression*> keys_;
+  std::vector<Expression*> args_;
+  std::vector<std::string> names_;
+  std::vector<AggFunctionManager::AggFunction> funcs_;
+  std::unordered_map<List, std::vector<AggData>, std::hash<List>> groups_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif
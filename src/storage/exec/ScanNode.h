@@ -45,6 +45,12 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
     }
   }
 
+  // Read from the snapshot and stop before the end key, used by the scan with snapshot
+  void setSnapshot(const void* snapshot, Cursor end) {
+    snapshot_ = snapshot;
+    end_ = std::move(end);
+  }
+
   nebula::cpp2::ErrorCode doExecute(PartitionID partId, const Cursor& cursor) override {
     auto ret = RelNode::doExecute(partId);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -60,8 +66,13 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
     }
 
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto kvRet = context_->env()->kvstore_->rangeWithPrefix(
-        context_->planContext_->spaceId_, partId, start, prefix, &iter, enableReadFollower_);
+    auto kvRet = context_->env()->kvstore_->rangeWithPrefix(context_->planContext_->spaceId_,
+                                                            partId,
+                                                            start,
+                                                            prefix,
+                                                            &iter,
+                                                            enableReadFollower_,
+                                                            snapshot_);
     if (kvRet != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return kvRet;
     }
@@ -70,7 +81,7 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
     auto vIdLen = context_->vIdLen();
     auto isIntId = context_->isIntId();
     std::string currentVertexId;
-    for (; iter->valid() && static_cast<int64_t>(resultDataSet_->rowSize()) < rowLimit;
+    for (; inRange(iter.get()) && static_cast<int64_t>(resultDataSet_->rowSize()) < rowLimit;
          iter->next()) {
       auto key = iter->key();
       auto tagId = NebulaKeyUtils::getTagId(vIdLen, key);
@@ -94,13 +105,17 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
     }
 
     cpp2::ScanCursor c;
-    if (iter->valid()) {
+    if (inRange(iter.get())) {
       c.next_cursor_ref() = iter->key().str();
     }
     cursors_->emplace(partId, std::move(c));
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
+  bool inRange(kvstore::KVIterator* iter) const {
+    return iter->valid() && (end_.empty() || iter->key().compare(end_) < 0);
+  }
+
   void collectOneRow(bool isIntId, std::size_t vIdLen, const std::string& currentVertexId) {
     List row;
     nebula::cpp2::ErrorCode ret = nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -175,6 +190,8 @@ class ScanVertexPropNode : public QueryNode<Cursor> {
   nebula::DataSet* resultDataSet_;
   StorageExpressionContext* expCtx_{nullptr};
   Expression* filter_{nullptr};
+  const void* snapshot_{nullptr};
+  Cursor end_;
 };
 
 // Node to scan edge of one partition
@@ -204,6 +221,12 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
     }
   }
 
+  // Read from the snapshot and stop before the end key, used by the scan with snapshot
+  void setSnapshot(const void* snapshot, Cursor end) {
+    snapshot_ = snapshot;
+    end_ = std::move(end);
+  }
+
   nebula::cpp2::ErrorCode doExecute(PartitionID partId, const Cursor& cursor) override {
     auto ret = RelNode::doExecute(partId);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -220,7 +243,7 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
 
     std::unique_ptr<kvstore::KVIterator> iter;
     auto kvRet = context_->env()->kvstore_->rangeWithPrefix(
-        context_->spaceId(), partId, start, prefix, &iter, enableReadFollower_);
+        context_->spaceId(), partId, start, prefix, &iter, enableReadFollower_, snapshot_);
     if (kvRet != nebula::cpp2::ErrorCode::SUCCEEDED) {
       return kvRet;
     }
@@ -228,7 +251,7 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
     auto rowLimit = limit_;
     auto vIdLen = context_->vIdLen();
     auto isIntId = context_->isIntId();
-    for (; iter->valid() && static_cast<int64_t>(resultDataSet_->rowSize()) < rowLimit;
+    for (; inRange(iter.get()) && static_cast<int64_t>(resultDataSet_->rowSize()) < rowLimit;
          iter->next()) {
       auto key = iter->key();
       if (!NebulaKeyUtils::isEdge(vIdLen, key)) {
@@ -245,13 +268,17 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
     }
 
     cpp2::ScanCursor c;
-    if (iter->valid()) {
+    if (inRange(iter.get())) {
       c.next_cursor_ref() = iter->key().str();
     }
     cursors_->emplace(partId, std::move(c));
     return nebula::cpp2::ErrorCode::SUCCEEDED;
   }
 
+  bool inRange(kvstore::KVIterator* iter) const {
+    return iter->valid() && (end_.empty() || iter->key().compare(end_) < 0);
+  }
+
   void collectOneRow(bool isIntId, std::size_t vIdLen) {
     List row;
     nebula::cpp2::ErrorCode ret = nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -315,6 +342,8 @@ class ScanEdgePropNode : public QueryNode<Cursor> {
   nebula::DataSet* resultDataSet_;
   StorageExpressionContext* expCtx_{nullptr};
   Expression* filter_{nullptr};
+  const void* snapshot_{nullptr};
+  Cursor end_;
 };
 
 }  // namespace storage
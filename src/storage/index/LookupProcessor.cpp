@@ -14,6 +14,9 @@
 #include "storage/exec/IndexAggregateNode.h"
 #include "storage/exec/IndexDedupNode.h"
 #include "storage/exec/IndexEdgeScanNode.h"
+#include "storage/exec/IndexGroupByNode.h"
+#include "storage/exec/IndexIntersectNode.h"
+#include "storage/exec/IndexKnnNode.h"
 #include "storage/exec/IndexLimitNode.h"
 #include "storage/exec/IndexNode.h"
 #include "storage/exec/IndexProjectionNode.h"
@@ -114,6 +117,10 @@ void LookupProcessor::doProcess(const cpp2::LookupIndexRequest& req) {
 
 ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::buildPlan(
     const cpp2::LookupIndexRequest& req) {
+  // Both are the root of plan, and the stats are only merged from IndexAggregateNode
+  if (req.stat_columns_ref().has_value() && req.aggregate_ref().has_value()) {
+    return ::nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
   std::vector<std::unique_ptr<IndexNode>> nodes;
   for (auto& ctx : req.get_indices().get_contexts()) {
     auto node = buildOneContext(ctx);
@@ -161,6 +168,18 @@ ErrorOr<nebula::cpp2::ErrorCode, std::unique_ptr<IndexNode>> LookupProcessor::bu
     node->addChild(std::move(nodes[0]));
     nodes[0] = std::move(node);
   }
+  if (req.aggregate_ref().has_value()) {
+    auto aggregator = std::make_unique<PartialAggregator>(context_->objPool());
+    auto code = aggregator->init(*req.aggregate_ref());
+    if (code != ::nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+    // The groups are returned instead of the rows
+    resultDataSet_.colNames = aggregator->colNames();
+    auto node = std::make_unique<IndexGroupByNode>(context_.get(), std::move(aggregator));
+    node->addChild(std::move(nodes[0]));
+    nodes[0] = std::move(node);
+  }
   return std::move(nodes[0]);
 }
 
@@ -169,12 +188,28 @@ std::unique_ptr<IndexNode> LookupProcessor::buildOneContext(const cpp2::IndexQue
   DLOG(INFO) << ctx.get_column_hints().size();
   DLOG(INFO) << &ctx.get_column_hints();
   DLOG(INFO) << ::apache::thrift::SimpleJSONSerializer::serialize<std::string>(ctx);
-  if (context_->isEdge()) {
-    node = std::make_unique<IndexEdgeScanNode>(
-        context_.get(), ctx.get_index_id(), ctx.get_column_hints(), context_->env()->kvstore_);
-  } else {
-    node = std::make_unique<IndexVertexScanNode>(
-        context_.get(), ctx.get_index_id(), ctx.get_column_hints(), context_->env()->kvstore_);
+  auto makeScan = [this](IndexID indexId, const std::vector<cpp2::IndexColumnHint>& hints)
+      -> std::unique_ptr<IndexScanNode> {
+    if (context_->isEdge()) {
+      return std::make_unique<IndexEdgeScanNode>(
+          context_.get(), indexId, hints, context_->env()->kvstore_);
+    } else {
+      return std::make_unique<IndexVertexScanNode>(
+          context_.get(), indexId, hints, context_->env()->kvstore_);
+    }
+  };
+  auto scan = makeScan(ctx.get_index_id(), ctx.get_column_hints());
+  scan->setSkipScan(ctx.get_skip_scan());
+  node = std::move(scan);
+  if (ctx.intersect_indexes_ref().has_value() && !ctx.intersect_indexes_ref()->empty()) {
+    // The index of context is the most selective one, so it is probed first to keep the set of
+    // suffixes small, and the last intersect index drives the scan
+    auto intersect = std::make_unique<IndexIntersectNode>(context_.get());
+    intersect->addChild(std::move(node));
+    for (auto& index : *ctx.intersect_indexes_ref()) {
+      intersect->addChild(makeScan(index.get_index_id(), index.get_column_hints()));
+    }
+    node = std::move(intersect);
   }
   if (ctx.filter_ref().is_set() && !ctx.get_filter().empty()) {
     auto expr = Expression::decode(context_->objPool(), *ctx.filter_ref());
@@ -182,6 +217,12 @@ std::unique_ptr<IndexNode> LookupProcessor::buildOneContext(const cpp2::IndexQue
     filterNode->addChild(std::move(node));
     node = std::move(filterNode);
   }
+  if (ctx.nearest_neighbors_ref().has_value()) {
+    // The paths of scan are replaced by the rings around the point
+    auto knn = std::make_unique<IndexKnnNode>(context_.get(), &*ctx.nearest_neighbors_ref());
+    knn->addChild(std::move(node));
+    node = std::move(knn);
+  }
   return node;
 }
 
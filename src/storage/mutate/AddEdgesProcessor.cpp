@@ -151,179 +151,187 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
 
 void AddEdgesProcessor::doProcessWithIndex(const cpp2::AddEdgesRequest& req) {
   const auto& partEdges = req.get_parts();
-  const auto& propNames = req.get_prop_names();
+  propNames_ = req.get_prop_names();
   for (auto& part : partEdges) {
-    IndexCountWrapper wrapper(env_);
-    std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
     auto partId = part.first;
     const auto& newEdges = part.second;
     std::vector<EMLI> dummyLock;
     dummyLock.reserve(newEdges.size());
-    auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
 
     deleteDupEdge(const_cast<std::vector<cpp2::NewEdge>&>(newEdges));
+    // lock all edges of part in sorted order
     for (auto& newEdge : newEdges) {
-      auto edgeKey = *newEdge.key_ref();
-      auto l = std::make_tuple(spaceId_,
-                               partId,
-                               edgeKey.src_ref()->getStr(),
-                               *edgeKey.edge_type_ref(),
-                               *edgeKey.ranking_ref(),
-                               edgeKey.dst_ref()->getStr());
-      if (std::find(dummyLock.begin(), dummyLock.end(), l) == dummyLock.end()) {
-        if (!env_->edgesML_->try_lock(l)) {
-          LOG(ERROR) << folly::sformat("edge locked : src {}, type {}, rank {}, dst {}",
+      auto& edgeKey = *newEdge.key_ref();
+      dummyLock.emplace_back(spaceId_,
+                             partId,
+                             edgeKey.src_ref()->getStr(),
+                             *edgeKey.edge_type_ref(),
+                             *edgeKey.ranking_ref(),
+                             edgeKey.dst_ref()->getStr());
+    }
+    std::sort(dummyLock.begin(), dummyLock.end());
+    dummyLock.erase(std::unique(dummyLock.begin(), dummyLock.end()), dummyLock.end());
+    lockPart<EMLI, std::vector<cpp2::NewEdge>>(
+        spaceId_,
+        partId,
+        env_->edgesML_.get(),
+        std::move(dummyLock),
+        newEdges,
+        [this, partId](const std::vector<cpp2::NewEdge>& locked, std::vector<EMLI> keys) {
+          doPartWithIndex(partId, locked, std::move(keys));
+        });
+  }
+}
+
+void AddEdgesProcessor::doPartWithIndex(PartitionID partId,
+                                        const std::vector<cpp2::NewEdge>& newEdges,
+                                        std::vector<EMLI> dummyLock) {
+  IndexCountWrapper wrapper(env_);
+  std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
+  auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
+  for (auto& newEdge : newEdges) {
+    auto edgeKey = *newEdge.key_ref();
+    VLOG(3) << "PartitionID: " << partId << ", VertexID: " << *edgeKey.src_ref()
+            << ", EdgeType: " << *edgeKey.edge_type_ref()
+            << ", EdgeRanking: " << *edgeKey.ranking_ref()
+            << ", VertexID: " << *edgeKey.dst_ref();
+
+    if (!NebulaKeyUtils::isValidVidLen(
+            spaceVidLen_, edgeKey.src_ref()->getStr(), edgeKey.dst_ref()->getStr())) {
+      LOG(ERROR) << "Space " << spaceId_ << " vertex length invalid, "
+                 << "space vid len: " << spaceVidLen_ << ", edge srcVid: " << *edgeKey.src_ref()
+                 << ", dstVid: " << *edgeKey.dst_ref();
+      code = nebula::cpp2::ErrorCode::E_INVALID_VID;
+      break;
+    }
+
+    auto key = NebulaKeyUtils::edgeKey(spaceVidLen_,
+                                       partId,
                                        edgeKey.src_ref()->getStr(),
                                        *edgeKey.edge_type_ref(),
                                        *edgeKey.ranking_ref(),
                                        edgeKey.dst_ref()->getStr());
-          code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
+    auto schema = env_->schemaMan_->getEdgeSchema(spaceId_, std::abs(*edgeKey.edge_type_ref()));
+    if (!schema) {
+      LOG(ERROR) << "Space " << spaceId_ << ", Edge " << *edgeKey.edge_type_ref() << " invalid";
+      code = nebula::cpp2::ErrorCode::E_EDGE_NOT_FOUND;
+      break;
+    }
+
+    auto props = newEdge.get_props();
+    WriteResult wRet;
+    auto retEnc = encodeRowVal(schema.get(), propNames_, props, wRet);
+    if (!retEnc.ok()) {
+      LOG(ERROR) << retEnc.status();
+      code = writeResultTo(wRet, true);
+      break;
+    }
+    if (*edgeKey.edge_type_ref() > 0) {
+      std::string oldVal;
+      RowReaderWrapper nReader;
+      RowReaderWrapper oReader;
+      if (!ignoreExistedIndex_) {
+        auto obsIdx = findOldValue(partId, key);
+        if (nebula::ok(obsIdx)) {
+          // already exists in kvstore
+          if (ifNotExists_ && !nebula::value(obsIdx).empty()) {
+            continue;
+          }
+          if (!nebula::value(obsIdx).empty()) {
+            oldVal = std::move(value(obsIdx));
+            oReader = RowReaderWrapper::getEdgePropReader(
+                env_->schemaMan_, spaceId_, *edgeKey.edge_type_ref(), oldVal);
+          }
+        } else {
+          code = nebula::error(obsIdx);
           break;
         }
-        dummyLock.emplace_back(std::move(l));
       }
-      VLOG(3) << "PartitionID: " << partId << ", VertexID: " << *edgeKey.src_ref()
-              << ", EdgeType: " << *edgeKey.edge_type_ref()
-              << ", EdgeRanking: " << *edgeKey.ranking_ref()
-              << ", VertexID: " << *edgeKey.dst_ref();
-
-      if (!NebulaKeyUtils::isValidVidLen(
-              spaceVidLen_, edgeKey.src_ref()->getStr(), edgeKey.dst_ref()->getStr())) {
-        LOG(ERROR) << "Space " << spaceId_ << " vertex length invalid, "
-                   << "space vid len: " << spaceVidLen_ << ", edge srcVid: " << *edgeKey.src_ref()
-                   << ", dstVid: " << *edgeKey.dst_ref();
-        code = nebula::cpp2::ErrorCode::E_INVALID_VID;
-        break;
+      if (!retEnc.value().empty()) {
+        nReader = RowReaderWrapper::getEdgePropReader(
+            env_->schemaMan_, spaceId_, *edgeKey.edge_type_ref(), retEnc.value());
       }
-
-      auto key = NebulaKeyUtils::edgeKey(spaceVidLen_,
-                                         partId,
-                                         edgeKey.src_ref()->getStr(),
-                                         *edgeKey.edge_type_ref(),
-                                         *edgeKey.ranking_ref(),
-                                         edgeKey.dst_ref()->getStr());
-      auto schema = env_->schemaMan_->getEdgeSchema(spaceId_, std::abs(*edgeKey.edge_type_ref()));
-      if (!schema) {
-        LOG(ERROR) << "Space " << spaceId_ << ", Edge " << *edgeKey.edge_type_ref() << " invalid";
-        code = nebula::cpp2::ErrorCode::E_EDGE_NOT_FOUND;
-        break;
-      }
-
-      auto props = newEdge.get_props();
-      WriteResult wRet;
-      auto retEnc = encodeRowVal(schema.get(), propNames, props, wRet);
-      if (!retEnc.ok()) {
-        LOG(ERROR) << retEnc.status();
-        code = writeResultTo(wRet, true);
-        break;
-      }
-      if (*edgeKey.edge_type_ref() > 0) {
-        std::string oldVal;
-        RowReaderWrapper nReader;
-        RowReaderWrapper oReader;
-        if (!ignoreExistedIndex_) {
-          auto obsIdx = findOldValue(partId, key);
-          if (nebula::ok(obsIdx)) {
-            // already exists in kvstore
-            if (ifNotExists_ && !nebula::value(obsIdx).empty()) {
-              continue;
-            }
-            if (!nebula::value(obsIdx).empty()) {
-              oldVal = std::move(value(obsIdx));
-              oReader = RowReaderWrapper::getEdgePropReader(
-                  env_->schemaMan_, spaceId_, *edgeKey.edge_type_ref(), oldVal);
-            }
-          } else {
-            code = nebula::error(obsIdx);
-            break;
-          }
-        }
-        if (!retEnc.value().empty()) {
-          nReader = RowReaderWrapper::getEdgePropReader(
-              env_->schemaMan_, spaceId_, *edgeKey.edge_type_ref(), retEnc.value());
-        }
-        for (auto& index : indexes_) {
-          if (*edgeKey.edge_type_ref() == index->get_schema_id().get_edge_type()) {
-            /*
-             * step 1 , Delete old version index if exists.
-             */
-            if (oReader != nullptr) {
-              auto ois = indexKeys(partId, oReader.get(), key, index, schema.get());
-              if (!ois.empty()) {
-                // Check the index is building for the specified partition or not.
-                auto indexState = env_->getIndexState(spaceId_, partId);
-                if (env_->checkRebuilding(indexState)) {
-                  auto delOpKey = OperationKeyUtils::deleteOperationKey(partId);
-                  for (auto& oi : ois) {
-                    batchHolder->put(std::string(delOpKey), std::move(oi));
-                  }
-                } else if (env_->checkIndexLocked(indexState)) {
-                  LOG(ERROR) << "The index has been locked: " << index->get_index_name();
-                  code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-                  break;
-                } else {
-                  for (auto& oi : ois) {
-                    batchHolder->remove(std::move(oi));
-                  }
+      for (auto& index : indexes_) {
+        if (*edgeKey.edge_type_ref() == index->get_schema_id().get_edge_type()) {
+          /*
+           * step 1 , Delete old version index if exists.
+           */
+          if (oReader != nullptr) {
+            auto ois = indexKeys(partId, oReader.get(), key, index, schema.get());
+            if (!ois.empty()) {
+              // Check the index is building for the specified partition or not.
+              auto indexState = env_->getIndexState(spaceId_, partId);
+              if (env_->checkRebuilding(indexState)) {
+                auto delOpKey = OperationKeyUtils::deleteOperationKey(partId);
+                for (auto& oi : ois) {
+                  batchHolder->put(std::string(delOpKey), std::move(oi));
+                }
+              } else if (env_->checkIndexLocked(indexState)) {
+                LOG(ERROR) << "The index has been locked: " << index->get_index_name();
+                code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
+                break;
+              } else {
+                for (auto& oi : ois) {
+                  batchHolder->remove(std::move(oi));
                 }
               }
             }
-            /*
-             * step 2 , Insert new edge index
-             */
-            if (nReader != nullptr) {
-              auto niks = indexKeys(partId, nReader.get(), key, index, schema.get());
-              if (!niks.empty()) {
-                auto v = CommonUtils::ttlValue(schema.get(), nReader.get());
-                auto niv = v.ok() ? IndexKeyUtils::indexVal(std::move(v).value()) : "";
-                // Check the index is building for the specified partition or not.
-                auto indexState = env_->getIndexState(spaceId_, partId);
-                if (env_->checkRebuilding(indexState)) {
-                  for (auto& nik : niks) {
-                    auto opKey = OperationKeyUtils::modifyOperationKey(partId, std::move(nik));
-                    batchHolder->put(std::move(opKey), std::string(niv));
-                  }
-                } else if (env_->checkIndexLocked(indexState)) {
-                  LOG(ERROR) << "The index has been locked: " << index->get_index_name();
-                  code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-                  break;
-                } else {
-                  for (auto& nik : niks) {
-                    batchHolder->put(std::move(nik), std::string(niv));
-                  }
+          }
+          /*
+           * step 2 , Insert new edge index
+           */
+          if (nReader != nullptr) {
+            auto niks = indexKeys(partId, nReader.get(), key, index, schema.get());
+            if (!niks.empty()) {
+              auto v = CommonUtils::ttlValue(schema.get(), nReader.get());
+              auto niv = v.ok() ? IndexKeyUtils::indexVal(std::move(v).value()) : "";
+              // Check the index is building for the specified partition or not.
+              auto indexState = env_->getIndexState(spaceId_, partId);
+              if (env_->checkRebuilding(indexState)) {
+                for (auto& nik : niks) {
+                  auto opKey = OperationKeyUtils::modifyOperationKey(partId, std::move(nik));
+                  batchHolder->put(std::move(opKey), std::string(niv));
+                }
+              } else if (env_->checkIndexLocked(indexState)) {
+                LOG(ERROR) << "The index has been locked: " << index->get_index_name();
+                code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
+                break;
+              } else {
+                for (auto& nik : niks) {
+                  batchHolder->put(std::move(nik), std::string(niv));
                 }
               }
             }
           }
         }
       }
-      if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-        break;
-      }
-      batchHolder->put(std::move(key), std::move(retEnc.value()));
-      stats::StatsManager::addValue(kNumEdgesInserted);
     }
     if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-      env_->edgesML_->unlockBatch(dummyLock);
-      handleAsync(spaceId_, partId, code);
-      continue;
-    }
-    if (consistOp_) {
-      (*consistOp_)(*batchHolder, nullptr);
+      break;
     }
-    auto batch = encodeBatchValue(batchHolder->getBatch());
-    DCHECK(!batch.empty());
-    nebula::MemoryLockGuard<EMLI> lg(env_->edgesML_.get(), std::move(dummyLock), false, false);
-    env_->kvstore_->asyncAppendBatch(spaceId_,
-                                     partId,
-                                     std::move(batch),
-                                     [l = std::move(lg), icw = std::move(wrapper), partId, this](
-                                         nebula::cpp2::ErrorCode retCode) {
-                                       UNUSED(l);
-                                       UNUSED(icw);
-                                       handleAsync(spaceId_, partId, retCode);
-                                     });
+    batchHolder->put(std::move(key), std::move(retEnc.value()));
+    stats::StatsManager::addValue(kNumEdgesInserted);
+  }
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    env_->edgesML_->unlockBatch(dummyLock);
+    handleAsync(spaceId_, partId, code);
+    return;
+  }
+  if (consistOp_) {
+    (*consistOp_)(*batchHolder, nullptr);
   }
+  auto batch = encodeBatchValue(batchHolder->getBatch());
+  DCHECK(!batch.empty());
+  nebula::MemoryLockGuard<EMLI> lg(env_->edgesML_.get(), std::move(dummyLock), false, false);
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   std::move(batch),
+                                   [l = std::move(lg), icw = std::move(wrapper), partId, this](
+                                       nebula::cpp2::ErrorCode retCode) {
+                                     UNUSED(l);
+                                     UNUSED(icw);
+                                     handleAsync(spaceId_, partId, retCode);
+                                   });
 }
 
 ErrorOr<nebula::cpp2::ErrorCode, std::string> AddEdgesProcessor::addEdges(
@@ -51,11 +51,17 @@ class AddEdgesProcessor : public BaseProcessor<cpp2::ExecResponse> {
 
   void deleteDupEdge(std::vector<cpp2::NewEdge>& edges);
 
+  // Called once the edges of the part are locked
+  void doPartWithIndex(PartitionID partId,
+                       const std::vector<cpp2::NewEdge>& newEdges,
+                       std::vector<EMLI> dummyLock);
+
  private:
   GraphSpaceID spaceId_;
   std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>> indexes_;
   bool ifNotExists_{false};
   bool ignoreExistedIndex_{false};
+  std::vector<std::string> propNames_;
 
   /// this is a hook function to keep out-edge and in-edge consist
   using ConsistOper = std::function<void(kvstore::BatchHolder&, std::vector<kvstore::KV>*)>;
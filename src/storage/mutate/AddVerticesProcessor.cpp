@@ -136,178 +136,191 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
 
 void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& req) {
   const auto& partVertices = req.get_parts();
-  const auto& propNamesMap = req.get_prop_names();
+  propNames_ = req.get_prop_names();
   for (auto& part : partVertices) {
-    IndexCountWrapper wrapper(env_);
-    std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
     auto partId = part.first;
     const auto& vertices = part.second;
     std::vector<VMLI> dummyLock;
     dummyLock.reserve(vertices.size());
-    auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
 
     // cache tagKey
     deleteDupVid(const_cast<std::vector<cpp2::NewVertex>&>(vertices));
+    // lock all tags of part in sorted order
     for (auto& vertex : vertices) {
-      auto vid = vertex.get_id().getStr();
-      const auto& newTags = vertex.get_tags();
+      for (auto& newTag : vertex.get_tags()) {
+        dummyLock.emplace_back(spaceId_, partId, newTag.get_tag_id(), vertex.get_id().getStr());
+      }
+    }
+    std::sort(dummyLock.begin(), dummyLock.end());
+    dummyLock.erase(std::unique(dummyLock.begin(), dummyLock.end()), dummyLock.end());
+    lockPart<VMLI, std::vector<cpp2::NewVertex>>(
+        spaceId_,
+        partId,
+        env_->verticesML_.get(),
+        std::move(dummyLock),
+        vertices,
+        [this, partId](const std::vector<cpp2::NewVertex>& locked, std::vector<VMLI> keys) {
+          doPartWithIndex(partId, locked, std::move(keys));
+        });
+  }
+}
 
-      if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vid)) {
-        LOG(ERROR) << "Space " << spaceId_ << ", vertex length invalid, "
-                   << " space vid len: " << spaceVidLen_ << ",  vid is " << vid;
-        code = nebula::cpp2::ErrorCode::E_INVALID_VID;
+void AddVerticesProcessor::doPartWithIndex(PartitionID partId,
+                                           const std::vector<cpp2::NewVertex>& vertices,
+                                           std::vector<VMLI> dummyLock) {
+  IndexCountWrapper wrapper(env_);
+  std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
+  auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
+  for (auto& vertex : vertices) {
+    auto vid = vertex.get_id().getStr();
+    const auto& newTags = vertex.get_tags();
+
+    if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vid)) {
+      LOG(ERROR) << "Space " << spaceId_ << ", vertex length invalid, "
+                 << " space vid len: " << spaceVidLen_ << ",  vid is " << vid;
+      code = nebula::cpp2::ErrorCode::E_INVALID_VID;
+      break;
+    }
+    batchHolder->put(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid), "");
+    for (auto& newTag : newTags) {
+      auto tagId = newTag.get_tag_id();
+      VLOG(3) << "PartitionID: " << partId << ", VertexID: " << vid << ", TagID: " << tagId;
+
+      auto schema = env_->schemaMan_->getTagSchema(spaceId_, tagId);
+      if (!schema) {
+        LOG(ERROR) << "Space " << spaceId_ << ", Tag " << tagId << " invalid";
+        code = nebula::cpp2::ErrorCode::E_TAG_NOT_FOUND;
         break;
       }
-      batchHolder->put(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid), "");
-      for (auto& newTag : newTags) {
-        auto tagId = newTag.get_tag_id();
-        auto l = std::make_tuple(spaceId_, partId, tagId, vid);
-        if (std::find(dummyLock.begin(), dummyLock.end(), l) == dummyLock.end()) {
-          if (!env_->verticesML_->try_lock(l)) {
-            LOG(ERROR) << folly::sformat("The vertex locked : tag {}, vid {}", tagId, vid);
-            code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-            break;
-          }
-          dummyLock.emplace_back(std::move(l));
-        }
-        VLOG(3) << "PartitionID: " << partId << ", VertexID: " << vid << ", TagID: " << tagId;
 
-        auto schema = env_->schemaMan_->getTagSchema(spaceId_, tagId);
-        if (!schema) {
-          LOG(ERROR) << "Space " << spaceId_ << ", Tag " << tagId << " invalid";
-          code = nebula::cpp2::ErrorCode::E_TAG_NOT_FOUND;
-          break;
-        }
-
-        auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vid, tagId);
-        auto props = newTag.get_props();
-        auto iter = propNamesMap.find(tagId);
-        std::vector<std::string> propNames;
-        if (iter != propNamesMap.end()) {
-          propNames = iter->second;
-        }
+      auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vid, tagId);
+      auto props = newTag.get_props();
+      auto iter = propNames_.find(tagId);
+      std::vector<std::string> propNames;
+      if (iter != propNames_.end()) {
+        propNames = iter->second;
+      }
 
-        RowReaderWrapper nReader;
-        RowReaderWrapper oReader;
-        std::string oldVal;
-        if (!ignoreExistedIndex_) {
-          auto obsIdx = findOldValue(partId, vid, tagId);
-          if (nebula::ok(obsIdx)) {
-            if (ifNotExists_ && !nebula::value(obsIdx).empty()) {
-              continue;
-            }
-            if (!nebula::value(obsIdx).empty()) {
-              oldVal = std::move(value(obsIdx));
-              oReader =
-                  RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId, oldVal);
-            }
-          } else {
-            code = nebula::error(obsIdx);
-            break;
+      RowReaderWrapper nReader;
+      RowReaderWrapper oReader;
+      std::string oldVal;
+      if (!ignoreExistedIndex_) {
+        auto obsIdx = findOldValue(partId, vid, tagId);
+        if (nebula::ok(obsIdx)) {
+          if (ifNotExists_ && !nebula::value(obsIdx).empty()) {
+            continue;
           }
-        }
-
-        WriteResult wRet;
-        auto retEnc = encodeRowVal(schema.get(), propNames, props, wRet);
-        if (!retEnc.ok()) {
-          LOG(ERROR) << retEnc.status();
-          code = writeResultTo(wRet, false);
+          if (!nebula::value(obsIdx).empty()) {
+            oldVal = std::move(value(obsIdx));
+            oReader =
+                RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId, oldVal);
+          }
+        } else {
+          code = nebula::error(obsIdx);
           break;
         }
+      }
 
-        if (!retEnc.value().empty()) {
-          nReader =
-              RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId, retEnc.value());
-        }
-        for (auto& index : indexes_) {
-          if (tagId == index->get_schema_id().get_tag_id()) {
-            auto indexFields = index->get_fields();
-            /*
-             * step 1 , Delete old version index if exists.
-             */
-            if (oReader != nullptr) {
-              auto ois = indexKeys(partId, vid, oReader.get(), index, schema.get());
-              if (!ois.empty()) {
-                // Check the index is building for the specified partition or not
-                auto indexState = env_->getIndexState(spaceId_, partId);
-                if (env_->checkRebuilding(indexState)) {
-                  auto delOpKey = OperationKeyUtils::deleteOperationKey(partId);
-                  for (auto& oi : ois) {
-                    batchHolder->put(std::string(delOpKey), std::move(oi));
-                  }
-                } else if (env_->checkIndexLocked(indexState)) {
-                  LOG(ERROR) << "The index has been locked: " << index->get_index_name();
-                  code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-                  break;
-                } else {
-                  for (auto& oi : ois) {
-                    batchHolder->remove(std::move(oi));
-                  }
+      WriteResult wRet;
+      auto retEnc = encodeRowVal(schema.get(), propNames, props, wRet);
+      if (!retEnc.ok()) {
+        LOG(ERROR) << retEnc.status();
+        code = writeResultTo(wRet, false);
+        break;
+      }
+
+      if (!retEnc.value().empty()) {
+        nReader =
+            RowReaderWrapper::getTagPropReader(env_->schemaMan_, spaceId_, tagId, retEnc.value());
+      }
+      for (auto& index : indexes_) {
+        if (tagId == index->get_schema_id().get_tag_id()) {
+          auto indexFields = index->get_fields();
+          /*
+           * step 1 , Delete old version index if exists.
+           */
+          if (oReader != nullptr) {
+            auto ois = indexKeys(partId, vid, oReader.get(), index, schema.get());
+            if (!ois.empty()) {
+              // Check the index is building for the specified partition or not
+              auto indexState = env_->getIndexState(spaceId_, partId);
+              if (env_->checkRebuilding(indexState)) {
+                auto delOpKey = OperationKeyUtils::deleteOperationKey(partId);
+                for (auto& oi : ois) {
+                  batchHolder->put(std::string(delOpKey), std::move(oi));
+                }
+              } else if (env_->checkIndexLocked(indexState)) {
+                LOG(ERROR) << "The index has been locked: " << index->get_index_name();
+                code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
+                break;
+              } else {
+                for (auto& oi : ois) {
+                  batchHolder->remove(std::move(oi));
                 }
               }
             }
+          }
 
-            /*
-             * step 2 , Insert new vertex index
-             */
-            if (nReader != nullptr) {
-              auto niks = indexKeys(partId, vid, nReader.get(), index, schema.get());
-              if (!niks.empty()) {
-                auto v = CommonUtils::ttlValue(schema.get(), nReader.get());
-                auto niv = v.ok() ? IndexKeyUtils::indexVal(std::move(v).value()) : "";
-                // Check the index is building for the specified partition or
-                // not.
-                auto indexState = env_->getIndexState(spaceId_, partId);
-                if (env_->checkRebuilding(indexState)) {
-                  for (auto& nik : niks) {
-                    auto opKey = OperationKeyUtils::modifyOperationKey(partId, nik);
-                    batchHolder->put(std::move(opKey), std::string(niv));
-                  }
-                } else if (env_->checkIndexLocked(indexState)) {
-                  LOG(ERROR) << "The index has been locked: " << index->get_index_name();
-                  code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-                  break;
-                } else {
-                  for (auto& nik : niks) {
-                    batchHolder->put(std::move(nik), std::string(niv));
-                  }
+          /*
+           * step 2 , Insert new vertex index
+           */
+          if (nReader != nullptr) {
+            auto niks = indexKeys(partId, vid, nReader.get(), index, schema.get());
+            if (!niks.empty()) {
+              auto v = CommonUtils::ttlValue(schema.get(), nReader.get());
+              auto niv = v.ok() ? IndexKeyUtils::indexVal(std::move(v).value()) : "";
+              // Check the index is building for the specified partition or
+              // not.
+              auto indexState = env_->getIndexState(spaceId_, partId);
+              if (env_->checkRebuilding(indexState)) {
+                for (auto& nik : niks) {
+                  auto opKey = OperationKeyUtils::modifyOperationKey(partId, nik);
+                  batchHolder->put(std::move(opKey), std::string(niv));
+                }
+              } else if (env_->checkIndexLocked(indexState)) {
+                LOG(ERROR) << "The index has been locked: " << index->get_index_name();
+                code = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
+                break;
+              } else {
+                for (auto& nik : niks) {
+                  batchHolder->put(std::move(nik), std::string(niv));
                 }
               }
             }
           }
-        }  // for index data
-        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-          break;
         }
-        /*
-         * step 3 , Insert new vertex data
-         */
-        batchHolder->put(std::move(key), std::move(retEnc.value()));
-        stats::StatsManager::addValue(kNumVerticesInserted);
-      }
+      }  // for index data
       if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
         break;
       }
+      /*
+       * step 3 , Insert new vertex data
+       */
+      batchHolder->put(std::move(key), std::move(retEnc.value()));
+      stats::StatsManager::addValue(kNumVerticesInserted);
     }
     if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-      env_->verticesML_->unlockBatch(dummyLock);
-      handleAsync(spaceId_, partId, code);
-      continue;
+      break;
     }
-    auto batch = encodeBatchValue(batchHolder->getBatch());
-    DCHECK(!batch.empty());
-    nebula::MemoryLockGuard<VMLI> lg(env_->verticesML_.get(), std::move(dummyLock), false, false);
-    env_->kvstore_->asyncAppendBatch(spaceId_,
-                                     partId,
-                                     std::move(batch),
-                                     [l = std::move(lg), icw = std::move(wrapper), partId, this](
-                                         nebula::cpp2::ErrorCode retCode) {
-                                       UNUSED(l);
-                                       UNUSED(icw);
-                                       handleAsync(spaceId_, partId, retCode);
-                                     });
   }
-}  // namespace storage
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    env_->verticesML_->unlockBatch(dummyLock);
+    handleAsync(spaceId_, partId, code);
+    return;
+  }
+  auto batch = encodeBatchValue(batchHolder->getBatch());
+  DCHECK(!batch.empty());
+  nebula::MemoryLockGuard<VMLI> lg(env_->verticesML_.get(), std::move(dummyLock), false, false);
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   std::move(batch),
+                                   [l = std::move(lg), icw = std::move(wrapper), partId, this](
+                                       nebula::cpp2::ErrorCode retCode) {
+                                     UNUSED(l);
+                                     UNUSED(icw);
+                                     handleAsync(spaceId_, partId, retCode);
+                                   });
+}
 
 ErrorOr<nebula::cpp2::ErrorCode, std::string> AddVerticesProcessor::findOldValue(
     PartitionID partId, const VertexID& vId, TagID tagId) {
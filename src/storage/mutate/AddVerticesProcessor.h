@@ -46,11 +46,17 @@ class AddVerticesProcessor : public BaseProcessor<cpp2::ExecResponse> {
 
   void deleteDupVid(std::vector<cpp2::NewVertex>& vertices);
 
+  // Called once the tags of the part are locked
+  void doPartWithIndex(PartitionID partId,
+                       const std::vector<cpp2::NewVertex>& vertices,
+                       std::vector<VMLI> dummyLock);
+
  private:
   GraphSpaceID spaceId_;
   std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>> indexes_;
   bool ifNotExists_{false};
   bool ignoreExistedIndex_{false};
+  std::unordered_map<TagID, std::vector<std::string>> propNames_;
 };
 
 }  // namespace storage
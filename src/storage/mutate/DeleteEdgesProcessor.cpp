@@ -96,58 +96,56 @@ void DeleteEdgesProcessor::process(const cpp2::DeleteEdgesRequest& req) {
     }
   } else {
     for (auto& part : partEdges) {
-      IndexCountWrapper wrapper(env_);
       auto partId = part.first;
       std::vector<EMLI> dummyLock;
       dummyLock.reserve(part.second.size());
 
-      nebula::cpp2::ErrorCode err = nebula::cpp2::ErrorCode::SUCCEEDED;
       for (const auto& edgeKey : part.second) {
-        auto l = std::make_tuple(spaceId_,
-                                 partId,
-                                 edgeKey.src_ref()->getStr(),
-                                 *edgeKey.edge_type_ref(),
-                                 *edgeKey.ranking_ref(),
-                                 edgeKey.dst_ref()->getStr());
-        if (std::find(dummyLock.begin(), dummyLock.end(), l) == dummyLock.end()) {
-          if (!env_->edgesML_->try_lock(l)) {
-            LOG(ERROR) << folly::sformat("The edge locked : src {}, type {}, tank {}, dst {}",
-                                         edgeKey.src_ref()->getStr(),
-                                         *edgeKey.edge_type_ref(),
-                                         *edgeKey.ranking_ref(),
-                                         edgeKey.dst_ref()->getStr());
-            err = nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-            break;
-          }
-          dummyLock.emplace_back(std::move(l));
-        }
-      }
-      if (err != nebula::cpp2::ErrorCode::SUCCEEDED) {
-        env_->edgesML_->unlockBatch(dummyLock);
-        handleAsync(spaceId_, partId, err);
-        continue;
-      }
-      auto batch = deleteEdges(partId, std::move(part.second));
-      if (!nebula::ok(batch)) {
-        env_->edgesML_->unlockBatch(dummyLock);
-        handleAsync(spaceId_, partId, nebula::error(batch));
-        continue;
+        dummyLock.emplace_back(spaceId_,
+                               partId,
+                               edgeKey.src_ref()->getStr(),
+                               *edgeKey.edge_type_ref(),
+                               *edgeKey.ranking_ref(),
+                               edgeKey.dst_ref()->getStr());
       }
-      DCHECK(!nebula::value(batch).empty());
-      nebula::MemoryLockGuard<EMLI> lg(env_->edgesML_.get(), std::move(dummyLock), false, false);
-      env_->kvstore_->asyncAppendBatch(spaceId_,
-                                       partId,
-                                       std::move(nebula::value(batch)),
-                                       [l = std::move(lg), icw = std::move(wrapper), partId, this](
-                                           nebula::cpp2::ErrorCode code) {
-                                         UNUSED(l);
-                                         UNUSED(icw);
-                                         handleAsync(spaceId_, partId, code);
-                                       });
+      std::sort(dummyLock.begin(), dummyLock.end());
+      dummyLock.erase(std::unique(dummyLock.begin(), dummyLock.end()), dummyLock.end());
+      lockPart<EMLI, std::vector<cpp2::EdgeKey>>(
+          spaceId_,
+          partId,
+          env_->edgesML_.get(),
+          std::move(dummyLock),
+          part.second,
+          [this, partId](const std::vector<cpp2::EdgeKey>& locked, std::vector<EMLI> keys) {
+            removePart(partId, locked, std::move(keys));
+          });
     }
   }
 }
 
+void DeleteEdgesProcessor::removePart(PartitionID partId,
+                                      const std::vector<cpp2::EdgeKey>& edges,
+                                      std::vector<EMLI> dummyLock) {
+  IndexCountWrapper wrapper(env_);
+  auto batch = deleteEdges(partId, edges);
+  if (!nebula::ok(batch)) {
+    env_->edgesML_->unlockBatch(dummyLock);
+    handleAsync(spaceId_, partId, nebula::error(batch));
+    return;
+  }
+  DCHECK(!nebula::value(batch).empty());
+  nebula::MemoryLockGuard<EMLI> lg(env_->edgesML_.get(), std::move(dummyLock), false, false);
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   std::move(nebula::value(batch)),
+                                   [l = std::move(lg), icw = std::move(wrapper), partId, this](
+                                       nebula::cpp2::ErrorCode code) {
+                                     UNUSED(l);
+                                     UNUSED(icw);
+                                     handleAsync(spaceId_, partId, code);
+                                   });
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteEdgesProcessor::deleteEdges(
     PartitionID partId, const std::vector<cpp2::EdgeKey>& edges) {
   std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
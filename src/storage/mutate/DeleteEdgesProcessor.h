@@ -37,6 +37,11 @@ class DeleteEdgesProcessor : public BaseProcessor<cpp2::ExecResponse> {
   ErrorOr<nebula::cpp2::ErrorCode, std::string> deleteEdges(
       PartitionID partId, const std::vector<cpp2::EdgeKey>& edges);
 
+  // Called once the edges of the part are locked
+  void removePart(PartitionID partId,
+                  const std::vector<cpp2::EdgeKey>& edges,
+                  std::vector<EMLI> dummyLock);
+
  private:
   GraphSpaceID spaceId_;
   std::vector<std::shared_ptr<nebula::meta::cpp2::IndexItem>> indexes_;
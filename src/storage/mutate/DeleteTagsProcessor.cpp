@@ -66,51 +66,67 @@ void DeleteTagsProcessor::process(const cpp2::DeleteTagsRequest& req) {
     }
   } else {
     for (const auto& part : parts) {
-      IndexCountWrapper wrapper(env_);
       auto partId = part.first;
+      // Lock all the keys of the part in sorted order, so that concurrent deletes and inserts
+      // always acquire them in the same order and never deadlock
       std::vector<VMLI> lockedKeys;
-      auto batch = deleteTags(partId, part.second, lockedKeys);
-      if (!nebula::ok(batch)) {
-        env_->verticesML_->unlockBatch(lockedKeys);
-        handleAsync(spaceId_, partId, nebula::error(batch));
-        continue;
+      for (const auto& entry : part.second) {
+        for (const auto& tagId : entry.get_tags()) {
+          lockedKeys.emplace_back(spaceId_, partId, tagId, entry.get_id().getStr());
+        }
       }
-      // keys has been locked in deleteTags
-      nebula::MemoryLockGuard<VMLI> lg(
-          env_->verticesML_.get(), std::move(lockedKeys), false, false);
-      env_->kvstore_->asyncAppendBatch(spaceId_,
-                                       partId,
-                                       std::move(nebula::value(batch)),
-                                       [l = std::move(lg), icw = std::move(wrapper), partId, this](
-                                           nebula::cpp2::ErrorCode code) {
-                                         UNUSED(l);
-                                         UNUSED(icw);
-                                         handleAsync(spaceId_, partId, code);
-                                       });
+      std::sort(lockedKeys.begin(), lockedKeys.end());
+      lockedKeys.erase(std::unique(lockedKeys.begin(), lockedKeys.end()), lockedKeys.end());
+      lockPart<VMLI, std::vector<cpp2::DelTags>>(
+          spaceId_,
+          partId,
+          env_->verticesML_.get(),
+          std::move(lockedKeys),
+          part.second,
+          [this, partId](const std::vector<cpp2::DelTags>& locked, std::vector<VMLI> keys) {
+            removePart(partId, locked, std::move(keys));
+          });
     }
   }
 }
 
+void DeleteTagsProcessor::removePart(PartitionID partId,
+                                     const std::vector<cpp2::DelTags>& delTags,
+                                     std::vector<VMLI> lockedKeys) {
+  IndexCountWrapper wrapper(env_);
+  auto batch = deleteTags(partId, delTags);
+  if (!nebula::ok(batch)) {
+    env_->verticesML_->unlockBatch(lockedKeys);
+    handleAsync(spaceId_, partId, nebula::error(batch));
+    return;
+  }
+  nebula::MemoryLockGuard<VMLI> lg(env_->verticesML_.get(), std::move(lockedKeys), false, false);
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   std::move(nebula::value(batch)),
+                                   [l = std::move(lg), icw = std::move(wrapper), partId, this](
+                                       nebula::cpp2::ErrorCode code) {
+                                     UNUSED(l);
+                                     UNUSED(icw);
+                                     handleAsync(spaceId_, partId, code);
+                                   });
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteTagsProcessor::deleteTags(
-    PartitionID partId, const std::vector<cpp2::DelTags>& delTags, std::vector<VMLI>& lockedKeys) {
+    PartitionID partId, const std::vector<cpp2::DelTags>& delTags) {
   std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
+  std::unordered_set<std::string> deleted;
   for (const auto& entry : delTags) {
     const auto& vId = entry.get_id().getStr();
     for (const auto& tagId : entry.get_tags()) {
       auto key = NebulaKeyUtils::tagKey(spaceVidLen_, partId, vId, tagId);
-      auto tup = std::make_tuple(spaceId_, partId, tagId, vId);
       // ignore if there are duplicate delete
-      if (std::find(lockedKeys.begin(), lockedKeys.end(), tup) != lockedKeys.end()) {
+      if (!deleted.emplace(key).second) {
         continue;
       }
-      if (!env_->verticesML_->try_lock(tup)) {
-        LOG(WARNING) << folly::sformat("The vertex locked : vId {}, tagId {}", vId, tagId);
-        return nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
-      }
 
       std::string val;
       auto code = env_->kvstore_->get(spaceId_, partId, key, &val);
-      lockedKeys.emplace_back(std::move(tup));
       if (code == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
         continue;
       } else if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -29,8 +29,13 @@ class DeleteTagsProcessor : public BaseProcessor<cpp2::ExecResponse> {
   DeleteTagsProcessor(StorageEnv* env, const ProcessorCounters* counters)
       : BaseProcessor<cpp2::ExecResponse>(env, counters) {}
 
+  // Called once the tags of the part are locked
+  void removePart(PartitionID partId,
+                  const std::vector<cpp2::DelTags>& delTags,
+                  std::vector<VMLI> lockedKeys);
+
   ErrorOr<nebula::cpp2::ErrorCode, std::string> deleteTags(
-      PartitionID partId, const std::vector<cpp2::DelTags>& delTags, std::vector<VMLI>& lockKeys);
+      PartitionID partId, const std::vector<cpp2::DelTags>& delTags);
 
  private:
   GraphSpaceID spaceId_;
@@ -85,33 +85,75 @@ void DeleteVerticesProcessor::process(const cpp2::DeleteVerticesRequest& req) {
     }
   } else {
     for (auto& pv : partVertices) {
-      IndexCountWrapper wrapper(env_);
       auto partId = pv.first;
       std::vector<VMLI> dummyLock;
-      auto batch = deleteVertices(partId, std::move(pv).second, dummyLock);
-      if (!nebula::ok(batch)) {
-        env_->verticesML_->unlockBatch(dummyLock);
-        handleAsync(spaceId_, partId, nebula::error(batch));
+      auto code = tagsToLock(partId, pv.second, dummyLock);
+      if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        handleAsync(spaceId_, partId, code);
         continue;
       }
-      DCHECK(!nebula::value(batch).empty());
-      nebula::MemoryLockGuard<VMLI> lg(env_->verticesML_.get(), std::move(dummyLock), false, false);
-      env_->kvstore_->asyncAppendBatch(spaceId_,
-                                       partId,
-                                       std::move(nebula::value(batch)),
-                                       [l = std::move(lg), icw = std::move(wrapper), partId, this](
-                                           nebula::cpp2::ErrorCode code) {
-                                         UNUSED(l);
-                                         UNUSED(icw);
-                                         handleAsync(spaceId_, partId, code);
-                                       });
+      lockPart<VMLI, std::vector<Value>>(
+          spaceId_,
+          partId,
+          env_->verticesML_.get(),
+          std::move(dummyLock),
+          pv.second,
+          [this, partId](const std::vector<Value>& locked, std::vector<VMLI> keys) {
+            removePart(partId, locked, std::move(keys));
+          });
+    }
+  }
+}
+
+void DeleteVerticesProcessor::removePart(PartitionID partId,
+                                         const std::vector<Value>& vertices,
+                                         std::vector<VMLI> dummyLock) {
+  IndexCountWrapper wrapper(env_);
+  auto batch = deleteVertices(partId, vertices, dummyLock);
+  if (!nebula::ok(batch)) {
+    env_->verticesML_->unlockBatch(dummyLock);
+    handleAsync(spaceId_, partId, nebula::error(batch));
+    return;
+  }
+  DCHECK(!nebula::value(batch).empty());
+  nebula::MemoryLockGuard<VMLI> lg(env_->verticesML_.get(), std::move(dummyLock), false, false);
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   std::move(nebula::value(batch)),
+                                   [l = std::move(lg), icw = std::move(wrapper), partId, this](
+                                       nebula::cpp2::ErrorCode code) {
+                                     UNUSED(l);
+                                     UNUSED(icw);
+                                     handleAsync(spaceId_, partId, code);
+                                   });
+}
+
+nebula::cpp2::ErrorCode DeleteVerticesProcessor::tagsToLock(PartitionID partId,
+                                                            const std::vector<Value>& vertices,
+                                                            std::vector<VMLI>& target) {
+  target.reserve(vertices.size());
+  // Lock the tags of all the vertices in sorted order before reading them, so that concurrent
+  // deletes and inserts always acquire the keys in the same order and never deadlock
+  for (auto& vertex : vertices) {
+    auto prefix = NebulaKeyUtils::tagPrefix(spaceVidLen_, partId, vertex.getStr());
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      VLOG(3) << "Error! ret = " << static_cast<int32_t>(ret) << ", spaceId " << spaceId_;
+      return ret;
+    }
+    for (; iter->valid(); iter->next()) {
+      auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, iter->key());
+      target.emplace_back(spaceId_, partId, tagId, vertex.getStr());
     }
   }
+  std::sort(target.begin(), target.end());
+  target.erase(std::unique(target.begin(), target.end()), target.end());
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
 ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVertices(
     PartitionID partId, const std::vector<Value>& vertices, std::vector<VMLI>& target) {
-  target.reserve(vertices.size());
   std::unique_ptr<kvstore::BatchHolder> batchHolder = std::make_unique<kvstore::BatchHolder>();
   for (auto& vertex : vertices) {
     batchHolder->remove(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vertex.getStr()));
@@ -127,12 +169,14 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> DeleteVerticesProcessor::deleteVer
       auto key = iter->key();
       auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
       auto l = std::make_tuple(spaceId_, partId, tagId, vertex.getStr());
-      if (std::find(target.begin(), target.end(), l) == target.end()) {
+      // The tag is inserted after the keys are collected, it is locked without waiting, since it
+      // is out of the order
+      if (!std::binary_search(target.begin(), target.end(), l)) {
         if (!env_->verticesML_->try_lock(l)) {
           LOG(ERROR) << folly::sformat("The vertex locked: tag {}, vid {}", tagId, vertex.getStr());
           return nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
         }
-        target.emplace_back(std::move(l));
+        target.insert(std::upper_bound(target.begin(), target.end(), l), std::move(l));
       }
       auto schema = env_->schemaMan_->getTagSchema(spaceId_, tagId);
       RowReaderWrapper reader;
@@ -29,6 +29,16 @@ class DeleteVerticesProcessor : public BaseProcessor<cpp2::ExecResponse> {
   DeleteVerticesProcessor(StorageEnv* env, const ProcessorCounters* counters)
       : BaseProcessor<cpp2::ExecResponse>(env, counters) {}
 
+  // Collect the existing tags of the vertices to lock, sorted and deduped
+  nebula::cpp2::ErrorCode tagsToLock(PartitionID partId,
+                                     const std::vector<Value>& vertices,
+                                     std::vector<VMLI>& target);
+
+  // Called once the tags of the part are locked
+  void removePart(PartitionID partId,
+                  const std::vector<Value>& vertices,
+                  std::vector<VMLI> dummyLock);
+
   ErrorOr<nebula::cpp2::ErrorCode, std::string> deleteVertices(PartitionID partId,
                                                                const std::vector<Value>& vertices,
                                                                std::vector<VMLI>& target);
@@ -7,6 +7,7 @@
 
 #include "common/base/Base.h"
 #include "common/utils/NebulaKeyUtils.h"
+#include "storage/MergeOperator.h"
 #include "storage/exec/EdgeNode.h"
 #include "storage/exec/FilterNode.h"
 #include "storage/exec/UpdateNode.h"
@@ -73,6 +74,10 @@ void UpdateEdgeProcessor::doProcess(const cpp2::UpdateEdgeRequest& req) {
   }
   indexes_ = std::move(iRet).value();
 
+  if (mergeUpdate(partId)) {
+    return;
+  }
+
   VLOG(3) << "Update edge, spaceId: " << spaceId_ << ", partId:  " << partId
           << ", src: " << edgeKey_.get_src() << ", edge_type: " << edgeKey_.get_edge_type()
           << ", dst: " << edgeKey_.get_dst() << ", ranking: " << edgeKey_.get_ranking();
@@ -289,6 +294,48 @@ nebula::cpp2::ErrorCode UpdateEdgeProcessor::buildEdgeContext(const cpp2::Update
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+bool UpdateEdgeProcessor::mergeUpdate(PartitionID partId) {
+  // Only upsert could be applied blindly, the condition and return props need the old row, and
+  // toss needs to write extra kvs along with the edge
+  if (!FLAGS_enable_merge_update || !insertable_ || filterExp_ != nullptr ||
+      !returnPropsExp_.empty() || !ctxAdjuster_.empty() || edgeKey_.get_edge_type() <= 0) {
+    return false;
+  }
+  for (auto& index : indexes_) {
+    if (index->get_schema_id().get_edge_type() == edgeKey_.get_edge_type()) {
+      return false;
+    }
+  }
+  auto items = MergeOperand::fromUpdatedProps(context_->edgeSchema_, updatedProps_);
+  if (!items.has_value()) {
+    return false;
+  }
+
+  VLOG(3) << "Merge update edge, spaceId: " << spaceId_ << ", partId: " << partId
+          << ", src: " << edgeKey_.get_src() << ", edge_type: " << edgeKey_.get_edge_type()
+          << ", dst: " << edgeKey_.get_dst() << ", ranking: " << edgeKey_.get_ranking();
+  kvstore::BatchHolder batchHolder;
+  batchHolder.merge(NebulaKeyUtils::edgeKey(spaceVidLen_,
+                                            partId,
+                                            edgeKey_.get_src().getStr(),
+                                            edgeKey_.get_edge_type(),
+                                            edgeKey_.get_ranking(),
+                                            edgeKey_.get_dst().getStr()),
+                    MergeOperand::encode(context_->edgeSchema_->getVersion(), items.value()));
+
+  callingNum_ = 1;
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   encodeBatchValue(batchHolder.getBatch()),
+                                   [partId, this](nebula::cpp2::ErrorCode code) {
+                                     if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+                                       onProcessFinished();
+                                     }
+                                     handleAsync(spaceId_, partId, code);
+                                   });
+  return true;
+}
+
 void UpdateEdgeProcessor::onProcessFinished() {
   resp_.props_ref() = std::move(resultDataSet_);
 }
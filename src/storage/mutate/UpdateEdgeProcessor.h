@@ -49,6 +49,11 @@ class UpdateEdgeProcessor
   // filter expression, update props expression
   nebula::cpp2::ErrorCode buildEdgeContext(const cpp2::UpdateEdgeRequest& req);
 
+  // Apply the upsert by merge operand without reading the old row if possible,
+  // return false if the request needs the read-modify-write plan. The processor is finished
+  // asynchronously once the operand is committed
+  bool mergeUpdate(PartitionID partId);
+
   void onProcessFinished() override;
 
   std::vector<Expression*> getReturnPropsExp() {
@@ -7,6 +7,7 @@
 
 #include "common/base/Base.h"
 #include "common/utils/NebulaKeyUtils.h"
+#include "storage/MergeOperator.h"
 #include "storage/exec/FilterNode.h"
 #include "storage/exec/TagNode.h"
 #include "storage/exec/UpdateNode.h"
@@ -71,6 +72,10 @@ void UpdateVertexProcessor::doProcess(const cpp2::UpdateVertexRequest& req) {
   }
   indexes_ = std::move(iRet).value();
 
+  if (mergeUpdate(partId, vId.getStr())) {
+    return;
+  }
+
   VLOG(3) << "Update vertex, spaceId: " << spaceId_ << ", partId: " << partId << ", vId: " << vId;
   auto plan = buildPlan(&resultDataSet_);
   auto ret = plan.go(partId, vId.getStr());
@@ -271,6 +276,42 @@ nebula::cpp2::ErrorCode UpdateVertexProcessor::buildTagContext(
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+bool UpdateVertexProcessor::mergeUpdate(PartitionID partId, const VertexID& vId) {
+  // Only upsert could be applied blindly, the condition and return props need the old row
+  if (!FLAGS_enable_merge_update || !insertable_ || filterExp_ != nullptr ||
+      !returnPropsExp_.empty()) {
+    return false;
+  }
+  for (auto& index : indexes_) {
+    if (index->get_schema_id().get_tag_id() == tagId_) {
+      return false;
+    }
+  }
+  auto items = MergeOperand::fromUpdatedProps(context_->tagSchema_, updatedProps_);
+  if (!items.has_value()) {
+    return false;
+  }
+
+  VLOG(3) << "Merge update vertex, spaceId: " << spaceId_ << ", partId: " << partId
+          << ", vId: " << vId;
+  kvstore::BatchHolder batchHolder;
+  batchHolder.put(NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vId), "");
+  batchHolder.merge(NebulaKeyUtils::tagKey(spaceVidLen_, partId, vId, tagId_),
+                    MergeOperand::encode(context_->tagSchema_->getVersion(), items.value()));
+
+  callingNum_ = 1;
+  env_->kvstore_->asyncAppendBatch(spaceId_,
+                                   partId,
+                                   encodeBatchValue(batchHolder.getBatch()),
+                                   [partId, this](nebula::cpp2::ErrorCode code) {
+                                     if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+                                       onProcessFinished();
+                                     }
+                                     handleAsync(spaceId_, partId, code);
+                                   });
+  return true;
+}
+
 void UpdateVertexProcessor::onProcessFinished() {
   resp_.props_ref() = std::move(resultDataSet_);
 }
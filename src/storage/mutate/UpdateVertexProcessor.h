@@ -47,6 +47,11 @@ class UpdateVertexProcessor
   // filter expression, update props expression
   nebula::cpp2::ErrorCode buildTagContext(const cpp2::UpdateVertexRequest& req);
 
+  // Apply the upsert by merge operand without reading the old row if possible,
+  // return false if the request needs the read-modify-write plan. The processor is finished
+  // asynchronously once the operand is committed
+  bool mergeUpdate(PartitionID partId, const VertexID& vId);
+
   void onProcessFinished() override;
 
   std::vector<Expression*> getReturnPropsExp() {
@@ -5,6 +5,7 @@
 
 #include "storage/query/GetNeighborsProcessor.h"
 
+#include "kvstore/Part.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/AggregateNode.h"
 #include "storage/exec/EdgeNode.h"
@@ -12,6 +13,7 @@
 #include "storage/exec/GetNeighborsNode.h"
 #include "storage/exec/HashJoinNode.h"
 #include "storage/exec/MultiTagNode.h"
+#include "storage/exec/PartialAggregateNode.h"
 #include "storage/exec/TagNode.h"
 
 namespace nebula {
@@ -64,6 +66,20 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
     }
   }
 
+  // The local expansion is skipped when the parts are queried concurrently, the caller expands
+  // the neighbors in the next round as usual
+  int32_t localSteps = (*req.traverse_spec_ref()).local_steps_ref().value_or(0);
+  if (localSteps > 0 && !FLAGS_query_concurrently && !random && aggregator_ == nullptr &&
+      orderBy_.empty() && env_->metaClient_ != nullptr) {
+    auto partsNum = env_->metaClient_->partsNum(spaceId_);
+    if (partsNum.ok()) {
+      partsNum_ = partsNum.value();
+      // the local expansion goes across the parts, so it runs in one thread
+      runInSingleThread(req, limit, random, localSteps);
+      return;
+    }
+  }
+
   // todo(doodle): specify by each query
   if (!FLAGS_query_concurrently) {
     runInSingleThread(req, limit, random);
@@ -74,10 +90,26 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
 
 void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& req,
                                               int64_t limit,
-                                              bool random) {
+                                              bool random,
+                                              int32_t localSteps) {
   contexts_.emplace_back(RuntimeContext(planContext_.get()));
   expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
-  auto plan = buildPlan(&contexts_.front(), &expCtxs_.front(), &resultDataSet_, limit, random);
+  std::vector<std::string> neighbors;
+  auto plan = buildPlan(&contexts_.front(),
+                        &expCtxs_.front(),
+                        &resultDataSet_,
+                        limit,
+                        random,
+                        localSteps > 0 ? &neighbors : nullptr,
+                        aggregator_.get());
+  if (localSteps > 0) {
+    for (const auto& partEntry : req.get_parts()) {
+      for (const auto& row : partEntry.second) {
+        visited_.emplace(row.values[0].getStr());
+      }
+    }
+  }
+  std::vector<std::pair<PartitionID, VertexID>> frontier;
   std::unordered_set<PartitionID> failedParts;
   for (const auto& partEntry : req.get_parts()) {
     contexts_.front().resultStat_ = ResultStatus::NORMAL;
@@ -102,6 +134,42 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
           handleErrorCode(ret, spaceId_, partId);
         }
       }
+      if (localSteps > 0) {
+        collectLocalNeighbors(neighbors, frontier);
+      }
+    }
+    if (aggregator_ != nullptr) {
+      // The groups of each part are returned, unless some vertex of the part failed
+      auto groups = aggregator_->finish();
+      if (failedParts.find(partId) == failedParts.end()) {
+        for (auto& group : groups) {
+          resultDataSet_.rows.emplace_back(std::move(group));
+        }
+      }
+    }
+  }
+
+  // Expand the neighbors in the local parts, the failed ones are just not returned, and will be
+  // expanded by the caller again
+  for (int32_t step = 1; step <= localSteps && !frontier.empty(); ++step) {
+    std::vector<std::pair<PartitionID, VertexID>> current;
+    current.swap(frontier);
+    for (const auto& [partId, vId] : current) {
+      contexts_.front().resultStat_ = ResultStatus::NORMAL;
+      auto ret = plan.go(partId, vId);
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        if (failedParts.find(partId) == failedParts.end()) {
+          failedParts.emplace(partId);
+          handleErrorCode(ret, spaceId_, partId);
+        }
+        neighbors.clear();
+        continue;
+      }
+      if (step < localSteps) {
+        collectLocalNeighbors(neighbors, frontier);
+      } else {
+        neighbors.clear();
+      }
     }
   }
   if (UNLIKELY(profileDetailFlag_)) {
@@ -111,6 +179,31 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
   onFinished();
 }
 
+void GetNeighborsProcessor::collectLocalNeighbors(
+    std::vector<std::string>& neighbors, std::vector<std::pair<PartitionID, VertexID>>& frontier) {
+  for (auto& vId : neighbors) {
+    // The hubs may reach too many vertices, the ones beyond the limit are left to the caller
+    if (localExpanded_ >= FLAGS_max_local_expanded_vertices) {
+      break;
+    }
+    if (visited_.find(vId) != visited_.end()) {
+      continue;
+    }
+    auto partId = env_->metaClient_->partId(partsNum_, vId);
+    auto leader = localLeaders_.find(partId);
+    if (leader == localLeaders_.end()) {
+      auto part = env_->kvstore_->part(spaceId_, partId);
+      leader = localLeaders_.emplace(partId, ok(part) && nebula::value(part)->isLeader()).first;
+    }
+    if (leader->second) {
+      localExpanded_++;
+      visited_.emplace(vId);
+      frontier.emplace_back(partId, std::move(vId));
+    }
+  }
+  neighbors.clear();
+}
+
 void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest& req,
                                                 int64_t limit,
                                                 bool random) {
@@ -119,12 +212,16 @@ void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest&
     results_.emplace_back(std::move(result));
     contexts_.emplace_back(RuntimeContext(planContext_.get()));
     expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
+    if (aggregator_ != nullptr) {
+      aggregators_.emplace_back(std::make_unique<PartialAggregator>(*aggregator_));
+    }
   }
   size_t i = 0;
   std::vector<folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>>> futures;
   for (const auto& [partId, rows] : req.get_parts()) {
-    futures.emplace_back(
-        runInExecutor(&contexts_[i], &expCtxs_[i], &results_[i], partId, rows, limit, random));
+    auto* aggregator = aggregator_ != nullptr ? aggregators_[i].get() : nullptr;
+    futures.emplace_back(runInExecutor(
+        &contexts_[i], &expCtxs_[i], &results_[i], partId, rows, limit, random, aggregator));
     i++;
   }
 
@@ -152,10 +249,20 @@ folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> GetNeighborsProce
     PartitionID partId,
     const std::vector<nebula::Row>& rows,
     int64_t limit,
-    bool random) {
+    bool random,
+    PartialAggregator* aggregator) {
   return folly::via(
-      executor_, [this, context, expCtx, result, partId, input = std::move(rows), limit, random]() {
-        auto plan = buildPlan(context, expCtx, result, limit, random);
+      executor_,
+      [this,
+       context,
+       expCtx,
+       result,
+       partId,
+       input = std::move(rows),
+       limit,
+       random,
+       aggregator]() {
+        auto plan = buildPlan(context, expCtx, result, limit, random, nullptr, aggregator);
         for (const auto& row : input) {
           CHECK_GE(row.values.size(), 1);
           auto vId = row.values[0].getStr();
@@ -172,6 +279,9 @@ folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> GetNeighborsProce
             return std::make_pair(ret, partId);
           }
         }
+        if (aggregator != nullptr) {
+          result->rows = aggregator->finish();
+        }
         if (UNLIKELY(this->profileDetailFlag_)) {
           profilePlan(plan);
         }
@@ -183,7 +293,9 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
                                                        StorageExpressionContext* expCtx,
                                                        nebula::DataSet* result,
                                                        int64_t limit,
-                                                       bool random) {
+                                                       bool random,
+                                                       std::vector<std::string>* neighbors,
+                                                       PartialAggregator* aggregator) {
   /*
   The StoragePlan looks like this:
              +------------------+                      or, if there is no edge:
@@ -270,13 +382,30 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
     plan.addNode(std::move(agg));
   }
 
+  if (aggregator != nullptr) {
+    // The edges are aggregated instead of returned, which always has edges
+    auto output =
+        std::make_unique<PartialAggregateNode>(context, upstream, expCtx, aggregator, limit);
+    output->addDependency(upstream);
+    plan.addNode(std::move(output));
+    return plan;
+  }
+
   std::unique_ptr<GetNeighborsNode> output;
   if (random) {
     output = std::make_unique<GetNeighborsSampleNode>(
         context, join, upstream, &edgeContext_, result, limit);
+  } else if (!orderBy_.empty()) {
+    std::vector<std::pair<Expression*, cpp2::OrderDirection>> orderBy;
+    for (const auto& order : orderBy_) {
+      orderBy.emplace_back(order.first->clone(), order.second);
+    }
+    output = std::make_unique<GetNeighborsTopNNode>(
+        context, join, upstream, &edgeContext_, result, limit, expCtx, std::move(orderBy));
   } else {
     output =
         std::make_unique<GetNeighborsNode>(context, join, upstream, &edgeContext_, result, limit);
+    output->setNeighbors(neighbors);
   }
   output->addDependency(upstream);
   plan.addNode(std::move(output));
@@ -320,6 +449,67 @@ nebula::cpp2::ErrorCode GetNeighborsProcessor::checkAndBuildContexts(
   if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
     return code;
   }
+  if (req.get_traverse_spec().aggregate_ref().has_value()) {
+    code = buildAggregator(*req.get_traverse_spec().aggregate_ref());
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  // The order only makes sense when the edges of each vertex are limited
+  const auto& spec = req.get_traverse_spec();
+  if (spec.order_by_ref().has_value() && spec.limit_ref().has_value()) {
+    code = buildOrderBy(*spec.order_by_ref());
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode GetNeighborsProcessor::buildOrderBy(
+    const std::vector<cpp2::OrderBy>& orderBy) {
+  if (edgeContext_.propContexts_.empty()) {
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+  for (const auto& order : orderBy) {
+    auto* expr = Expression::decode(&this->planContext_->objPool_, order.get_prop());
+    if (expr == nullptr) {
+      return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    // The props are read by the expression context as the filter does
+    auto code = checkExp(expr, false, true);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+    orderBy_.emplace_back(expr, order.get_direction());
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode GetNeighborsProcessor::buildAggregator(const cpp2::AggregateSpec& spec) {
+  if (edgeContext_.propContexts_.empty()) {
+    return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+  }
+  auto aggregator = std::make_unique<PartialAggregator>(&this->planContext_->objPool_);
+  auto code = aggregator->init(spec);
+  if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+    return code;
+  }
+  // The props are read by the expression context as the filter does
+  for (auto* key : aggregator->keys()) {
+    code = checkExp(key, false, true);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  for (auto* arg : aggregator->args()) {
+    code = checkExp(arg, false, true);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return code;
+    }
+  }
+  resultDataSet_.colNames = aggregator->colNames();
+  aggregator_ = std::move(aggregator);
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
@@ -9,6 +9,7 @@
 #include <gtest/gtest_prod.h>
 
 #include "common/base/Base.h"
+#include "storage/exec/PartialAggregator.h"
 #include "storage/exec/StoragePlan.h"
 #include "storage/query/QueryBaseProcessor.h"
 
@@ -41,7 +42,9 @@ class GetNeighborsProcessor
                                   StorageExpressionContext* expCtx,
                                   nebula::DataSet* result,
                                   int64_t limit = 0,
-                                  bool random = false);
+                                  bool random = false,
+                                  std::vector<std::string>* neighbors = nullptr,
+                                  PartialAggregator* aggregator = nullptr);
 
   void onProcessFinished() override;
 
@@ -60,7 +63,16 @@ class GetNeighborsProcessor
   // add PropContext of stat
   nebula::cpp2::ErrorCode handleEdgeStatProps(const std::vector<cpp2::StatProp>& statProps);
 
-  void runInSingleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
+  // build the aggregator when the request asks to aggregate the edges
+  nebula::cpp2::ErrorCode buildAggregator(const cpp2::AggregateSpec& spec);
+
+  // build the expressions to sort the edges of each vertex by
+  nebula::cpp2::ErrorCode buildOrderBy(const std::vector<cpp2::OrderBy>& orderBy);
+
+  void runInSingleThread(const cpp2::GetNeighborsRequest& req,
+                         int64_t limit,
+                         bool random,
+                         int32_t localSteps = 0);
   void runInMultipleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
 
   folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
@@ -70,13 +82,33 @@ class GetNeighborsProcessor
       PartitionID partId,
       const std::vector<nebula::Row>& rows,
       int64_t limit,
-      bool random);
+      bool random,
+      PartialAggregator* aggregator);
   void profilePlan(StoragePlan<VertexID>& plan);
 
+  // Move the unvisited neighbors in the parts led by this host to the next frontier
+  void collectLocalNeighbors(std::vector<std::string>& neighbors,
+                             std::vector<std::pair<PartitionID, VertexID>>& frontier);
+
  private:
   std::vector<RuntimeContext> contexts_;
   std::vector<StorageExpressionContext> expCtxs_;
   std::vector<nebula::DataSet> results_;
+  // The groups are returned instead of the neighbors if it is not null, and each thread has a
+  // copy of it
+  std::unique_ptr<PartialAggregator> aggregator_;
+  std::vector<std::unique_ptr<PartialAggregator>> aggregators_;
+  // The top N edges of each vertex are returned by them if it is not empty, each plan has a clone
+  // of the expressions
+  std::vector<std::pair<Expression*, cpp2::OrderDirection>> orderBy_;
+
+  // Used when the request asks to expand the local neighbors for more steps
+  int32_t partsNum_{0};
+  std::unordered_map<PartitionID, bool> localLeaders_;
+  // vertices reached by this request, each of them is returned at most once
+  std::unordered_set<VertexID> visited_;
+  // number of vertices expanded locally besides the requested ones
+  int32_t localExpanded_{0};
 };
 
 }  // namespace storage
@@ -0,0 +1,160 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+namespace nebula {
+namespace storage {
+
+template <typename REQ>
+bool ScanBaseProcessor<REQ>::withSnapshot(const REQ& req) const {
+  if (this->env_->scanSnapshots_ == nullptr) {
+    return false;
+  }
+  if (req.get_enable_snapshot()) {
+    return true;
+  }
+  for (const auto& part : req.get_parts()) {
+    const auto& cursor = part.second.next_cursor_ref();
+    if (cursor.has_value() && ScanSnapshotManager::isRangesCursor(cursor.value())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename REQ>
+void ScanBaseProcessor<REQ>::runWithSnapshot(const REQ& req) {
+  auto* snapshots = this->env_->scanSnapshots_.get();
+  for (const auto& [partId, cursor] : req.get_parts()) {
+    auto ret = cursor.snapshot_id_ref().has_value()
+                   ? snapshots->acquire(this->spaceId_, partId, *cursor.snapshot_id_ref())
+                   : snapshots->pin(this->spaceId_,
+                                    partId,
+                                    scanPrefix(partId),
+                                    cursor.next_cursor_ref().has_value()
+                                        ? cursor.next_cursor_ref().value()
+                                        : "",
+                                    this->spaceVidLen_,
+                                    enableReadFollower_);
+    if (!nebula::ok(ret)) {
+      this->handleErrorCode(nebula::error(ret), this->spaceId_, partId);
+      continue;
+    }
+    leases_.emplace_back(std::move(nebula::value(ret)));
+  }
+
+  // The limit of page is shared by all pending ranges of all parts
+  size_t numRanges = 0;
+  for (const auto& lease : leases_) {
+    numRanges += lease->ranges.size();
+  }
+  auto limits = ScanSnapshotManager::splitLimit(limit_, numRanges);
+  size_t k = 0;
+  for (size_t i = 0; i < leases_.size(); i++) {
+    for (size_t j = 0; j < leases_[i]->ranges.size(); j++, k++) {
+      if (limits[k] > 0) {
+        snapshotTasks_.emplace_back(SnapshotTask{i, j, limits[k]});
+      }
+    }
+  }
+  cursorsOfPart_.resize(snapshotTasks_.size());
+  for (size_t i = 0; i < snapshotTasks_.size(); i++) {
+    nebula::DataSet result = this->resultDataSet_;
+    results_.emplace_back(std::move(result));
+    contexts_.emplace_back(RuntimeContext(this->planContext_.get()));
+    expCtxs_.emplace_back(StorageExpressionContext(this->spaceVidLen_, this->isIntId_));
+  }
+
+  if (this->executor_ == nullptr) {
+    std::vector<nebula::cpp2::ErrorCode> codes;
+    for (size_t i = 0; i < snapshotTasks_.size(); i++) {
+      codes.emplace_back(scanSnapshotRange(i));
+    }
+    finishSnapshotScan(codes);
+    return;
+  }
+  std::vector<folly::Future<nebula::cpp2::ErrorCode>> futures;
+  for (size_t i = 0; i < snapshotTasks_.size(); i++) {
+    futures.emplace_back(folly::via(this->executor_, [this, i]() { return scanSnapshotRange(i); }));
+  }
+  folly::collectAll(futures).via(this->executor_).thenTry([this](auto&& t) mutable {
+    CHECK(!t.hasException());
+    std::vector<nebula::cpp2::ErrorCode> codes;
+    for (const auto& tryCode : t.value()) {
+      CHECK(!tryCode.hasException());
+      codes.emplace_back(tryCode.value());
+    }
+    finishSnapshotScan(codes);
+  });
+}
+
+template <typename REQ>
+nebula::cpp2::ErrorCode ScanBaseProcessor<REQ>::scanSnapshotRange(size_t taskIdx) {
+  const auto& task = snapshotTasks_[taskIdx];
+  const auto& lease = leases_[task.leaseIdx];
+  const auto& range = lease->ranges[task.rangeIdx];
+  auto plan = buildPlan(&contexts_[taskIdx],
+                        &results_[taskIdx],
+                        &cursorsOfPart_[taskIdx],
+                        &expCtxs_[taskIdx],
+                        task.limit,
+                        lease->snapshot,
+                        range.end);
+  return plan.go(lease->partId, range.start);
+}
+
+template <typename REQ>
+void ScanBaseProcessor<REQ>::finishSnapshotScan(
+    const std::vector<nebula::cpp2::ErrorCode>& codes) {
+  std::vector<bool> failed(leases_.size(), false);
+  for (size_t i = 0; i < snapshotTasks_.size(); i++) {
+    auto leaseIdx = snapshotTasks_[i].leaseIdx;
+    if (codes[i] != nebula::cpp2::ErrorCode::SUCCEEDED && !failed[leaseIdx]) {
+      failed[leaseIdx] = true;
+      this->handleErrorCode(codes[i], this->spaceId_, leases_[leaseIdx]->partId);
+    }
+  }
+  for (size_t i = 0; i < snapshotTasks_.size(); i++) {
+    const auto& task = snapshotTasks_[i];
+    auto& lease = leases_[task.leaseIdx];
+    if (failed[task.leaseIdx]) {
+      continue;
+    }
+    this->resultDataSet_.append(std::move(results_[i]));
+    auto& next = cursorsOfPart_[i][lease->partId];
+    // An empty start marks the range as finished, the start of range always has the prefix
+    lease->ranges[task.rangeIdx].start =
+        next.next_cursor_ref().has_value() ? next.next_cursor_ref().value() : "";
+  }
+
+  auto* snapshots = this->env_->scanSnapshots_.get();
+  for (size_t i = 0; i < leases_.size(); i++) {
+    auto& lease = leases_[i];
+    if (failed[i]) {
+      snapshots->release(std::move(lease));
+      continue;
+    }
+    auto& ranges = lease->ranges;
+    ranges.erase(std::remove_if(ranges.begin(),
+                                ranges.end(),
+                                [](const auto& range) { return range.start.empty(); }),
+                 ranges.end());
+    cpp2::ScanCursor c;
+    if (ranges.empty()) {
+      cursors_.emplace(lease->partId, std::move(c));
+      snapshots->release(std::move(lease));
+      continue;
+    }
+    // All pending ranges, the scan could be resumed by them after the lease is gone
+    c.next_cursor_ref() = ScanSnapshotManager::encodeCursor(ranges);
+    c.snapshot_id_ref() = lease->id;
+    cursors_.emplace(lease->partId, std::move(c));
+    snapshots->renew(std::move(lease));
+  }
+  this->onProcessFinished();
+  this->onFinished();
+}
+
+}  // namespace storage
+}  // namespace nebula
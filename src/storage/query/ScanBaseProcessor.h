@@ -0,0 +1,73 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_QUERY_SCANBASEPROCESSOR_H_
+#define STORAGE_QUERY_SCANBASEPROCESSOR_H_
+
+#include "common/base/Base.h"
+#include "storage/ScanSnapshotManager.h"
+#include "storage/exec/ScanNode.h"
+#include "storage/exec/StoragePlan.h"
+#include "storage/query/QueryBaseProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief Common part of ScanVertexProcessor and ScanEdgeProcessor, REQ is the request type of
+ * them. The scan with snapshot reads the pending ranges of each part from its pinned snapshot,
+ * see ScanSnapshotManager.
+ */
+template <typename REQ>
+class ScanBaseProcessor : public QueryBaseProcessor<REQ, cpp2::ScanResponse> {
+ protected:
+  ScanBaseProcessor(StorageEnv* env, const ProcessorCounters* counters, folly::Executor* executor)
+      : QueryBaseProcessor<REQ, cpp2::ScanResponse>(env, counters, executor) {}
+
+  virtual StoragePlan<Cursor> buildPlan(RuntimeContext* context,
+                                        nebula::DataSet* result,
+                                        std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
+                                        StorageExpressionContext* expCtx,
+                                        int64_t limit,
+                                        const void* snapshot = nullptr,
+                                        Cursor end = "") = 0;
+
+  // The prefix of keys to scan in part
+  virtual std::string scanPrefix(PartitionID partId) const = 0;
+
+  // The cursor with ranges returned by the scan with snapshot is only continued by snapshot
+  bool withSnapshot(const REQ& req) const;
+
+  void runWithSnapshot(const REQ& req);
+
+  nebula::cpp2::ErrorCode scanSnapshotRange(size_t taskIdx);
+
+  void finishSnapshotScan(const std::vector<nebula::cpp2::ErrorCode>& codes);
+
+ protected:
+  std::vector<RuntimeContext> contexts_;
+  std::vector<StorageExpressionContext> expCtxs_;
+  std::vector<nebula::DataSet> results_;
+  std::vector<std::unordered_map<PartitionID, cpp2::ScanCursor>> cursorsOfPart_;
+
+  struct SnapshotTask {
+    size_t leaseIdx;
+    size_t rangeIdx;
+    int64_t limit;
+  };
+  std::vector<std::unique_ptr<ScanSnapshotManager::Lease>> leases_;
+  std::vector<SnapshotTask> snapshotTasks_;
+
+  std::unordered_map<PartitionID, cpp2::ScanCursor> cursors_;
+  int64_t limit_{-1};
+  bool enableReadFollower_{false};
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#include "storage/query/ScanBaseProcessor-inl.h"
+
+#endif  // STORAGE_QUERY_SCANBASEPROCESSOR_H_
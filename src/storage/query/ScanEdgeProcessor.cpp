@@ -49,7 +49,9 @@ void ScanEdgeProcessor::doProcess(const cpp2::ScanEdgeRequest& req) {
     return;
   }
 
-  if (!FLAGS_query_concurrently) {
+  if (withSnapshot(req)) {
+    runWithSnapshot(req);
+  } else if (!FLAGS_query_concurrently) {
     runInSingleThread(req);
   } else {
     runInMultipleThread(req);
@@ -90,11 +92,18 @@ void ScanEdgeProcessor::onProcessFinished() {
   resp_.cursors_ref() = std::move(cursors_);
 }
 
+std::string ScanEdgeProcessor::scanPrefix(PartitionID partId) const {
+  return NebulaKeyUtils::edgePrefix(partId);
+}
+
 StoragePlan<Cursor> ScanEdgeProcessor::buildPlan(
     RuntimeContext* context,
     nebula::DataSet* result,
     std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
-    StorageExpressionContext* expCtx) {
+    StorageExpressionContext* expCtx,
+    int64_t limit,
+    const void* snapshot,
+    Cursor end) {
   StoragePlan<Cursor> plan;
   std::vector<std::unique_ptr<FetchEdgeNode>> edges;
   for (const auto& ec : edgeContext_.propContexts_) {
@@ -102,7 +111,10 @@ StoragePlan<Cursor> ScanEdgeProcessor::buildPlan(
         std::make_unique<FetchEdgeNode>(context, &edgeContext_, ec.first, &ec.second));
   }
   auto output = std::make_unique<ScanEdgePropNode>(
-      context, std::move(edges), enableReadFollower_, limit_, cursors, result, expCtx, filter_);
+      context, std::move(edges), enableReadFollower_, limit, cursors, result, expCtx, filter_);
+  if (snapshot != nullptr) {
+    output->setSnapshot(snapshot, std::move(end));
+  }
 
   plan.addNode(std::move(output));
   return plan;
@@ -117,7 +129,7 @@ folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> ScanEdgeProcessor
     StorageExpressionContext* expCtx) {
   return folly::via(executor_,
                     [this, context, result, cursors, partId, input = std::move(cursor), expCtx]() {
-                      auto plan = buildPlan(context, result, cursors, expCtx);
+                      auto plan = buildPlan(context, result, cursors, expCtx, limit_);
 
                       auto ret = plan.go(partId, input);
                       if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -131,7 +143,8 @@ void ScanEdgeProcessor::runInSingleThread(const cpp2::ScanEdgeRequest& req) {
   contexts_.emplace_back(RuntimeContext(planContext_.get()));
   expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   std::unordered_set<PartitionID> failedParts;
-  auto plan = buildPlan(&contexts_.front(), &resultDataSet_, &cursors_, &expCtxs_.front());
+  auto plan =
+      buildPlan(&contexts_.front(), &resultDataSet_, &cursors_, &expCtxs_.front(), limit_);
   for (const auto& partEntry : req.get_parts()) {
     auto partId = partEntry.first;
     auto cursor = partEntry.second;
@@ -51,7 +51,9 @@ void ScanVertexProcessor::doProcess(const cpp2::ScanVertexRequest& req) {
     return;
   }
 
-  if (!FLAGS_query_concurrently) {
+  if (withSnapshot(req)) {
+    runWithSnapshot(req);
+  } else if (!FLAGS_query_concurrently) {
     runInSingleThread(req);
   } else {
     runInMultipleThread(req);
@@ -94,18 +96,28 @@ void ScanVertexProcessor::onProcessFinished() {
   resp_.cursors_ref() = std::move(cursors_);
 }
 
+std::string ScanVertexProcessor::scanPrefix(PartitionID partId) const {
+  return NebulaKeyUtils::tagPrefix(partId);
+}
+
 StoragePlan<Cursor> ScanVertexProcessor::buildPlan(
     RuntimeContext* context,
     nebula::DataSet* result,
     std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
-    StorageExpressionContext* expCtx) {
+    StorageExpressionContext* expCtx,
+    int64_t limit,
+    const void* snapshot,
+    Cursor end) {
   StoragePlan<Cursor> plan;
   std::vector<std::unique_ptr<TagNode>> tags;
   for (const auto& tc : tagContext_.propContexts_) {
     tags.emplace_back(std::make_unique<TagNode>(context, &tagContext_, tc.first, &tc.second));
   }
   auto output = std::make_unique<ScanVertexPropNode>(
-      context, std::move(tags), enableReadFollower_, limit_, cursors, result, expCtx, filter_);
+      context, std::move(tags), enableReadFollower_, limit, cursors, result, expCtx, filter_);
+  if (snapshot != nullptr) {
+    output->setSnapshot(snapshot, std::move(end));
+  }
 
   plan.addNode(std::move(output));
   return plan;
@@ -121,7 +133,7 @@ folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> ScanVertexProcess
   return folly::via(
       executor_,
       [this, context, result, cursorsOfPart, partId, input = std::move(cursor), expCtx]() {
-        auto plan = buildPlan(context, result, cursorsOfPart, expCtx);
+        auto plan = buildPlan(context, result, cursorsOfPart, expCtx, limit_);
 
         auto ret = plan.go(partId, input);
         if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -135,7 +147,8 @@ void ScanVertexProcessor::runInSingleThread(const cpp2::ScanVertexRequest& req)
   contexts_.emplace_back(RuntimeContext(planContext_.get()));
   expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   std::unordered_set<PartitionID> failedParts;
-  auto plan = buildPlan(&contexts_.front(), &resultDataSet_, &cursors_, &expCtxs_.front());
+  auto plan =
+      buildPlan(&contexts_.front(), &resultDataSet_, &cursors_, &expCtxs_.front(), limit_);
   for (const auto& partEntry : req.get_parts()) {
     auto partId = partEntry.first;
     auto cursor = partEntry.second;
@@ -9,14 +9,14 @@
 #include "common/base/Base.h"
 #include "storage/exec/ScanNode.h"
 #include "storage/exec/StoragePlan.h"
-#include "storage/query/QueryBaseProcessor.h"
+#include "storage/query/ScanBaseProcessor.h"
 
 namespace nebula {
 namespace storage {
 
 extern ProcessorCounters kScanVertexCounters;
 
-class ScanVertexProcessor : public QueryBaseProcessor<cpp2::ScanVertexRequest, cpp2::ScanResponse> {
+class ScanVertexProcessor : public ScanBaseProcessor<cpp2::ScanVertexRequest> {
  public:
   static ScanVertexProcessor* instance(StorageEnv* env,
                                        const ProcessorCounters* counters = &kScanVertexCounters,
@@ -30,7 +30,7 @@ class ScanVertexProcessor : public QueryBaseProcessor<cpp2::ScanVertexRequest, c
 
  private:
   ScanVertexProcessor(StorageEnv* env, const ProcessorCounters* counters, folly::Executor* executor)
-      : QueryBaseProcessor<cpp2::ScanVertexRequest, cpp2::ScanResponse>(env, counters, executor) {}
+      : ScanBaseProcessor<cpp2::ScanVertexRequest>(env, counters, executor) {}
 
   nebula::cpp2::ErrorCode checkAndBuildContexts(const cpp2::ScanVertexRequest& req) override;
 
@@ -39,7 +39,12 @@ class ScanVertexProcessor : public QueryBaseProcessor<cpp2::ScanVertexRequest, c
   StoragePlan<Cursor> buildPlan(RuntimeContext* context,
                                 nebula::DataSet* result,
                                 std::unordered_map<PartitionID, cpp2::ScanCursor>* cursors,
-                                StorageExpressionContext* expCtx);
+                                StorageExpressionContext* expCtx,
+                                int64_t limit,
+                                const void* snapshot = nullptr,
+                                Cursor end = "") override;
+
+  std::string scanPrefix(PartitionID partId) const override;
 
   folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
       RuntimeContext* context,
@@ -54,16 +59,6 @@ class ScanVertexProcessor : public QueryBaseProcessor<cpp2::ScanVertexRequest, c
   void runInMultipleThread(const cpp2::ScanVertexRequest& req);
 
   void onProcessFinished() override;
-
- private:
-  std::vector<RuntimeContext> contexts_;
-  std::vector<StorageExpressionContext> expCtxs_;
-  std::vector<nebula::DataSet> results_;
-  std::vector<std::unordered_map<PartitionID, cpp2::ScanCursor>> cursorsOfPart_;
-
-  std::unordered_map<PartitionID, cpp2::ScanCursor> cursors_;
-  int64_t limit_{-1};
-  bool enableReadFollower_{false};
 };
 
 }  // namespace storage
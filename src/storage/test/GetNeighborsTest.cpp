@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 
 #include "common/base/Base.h"
+#include "common/expression/AggregateExpression.h"
+#include "common/expression/ConstantExpression.h"
 #include "common/fs/TempDir.h"
 #include "storage/query/GetNeighborsProcessor.h"
 #include "storage/test/QueryTestUtils.h"
@@ -2020,6 +2022,177 @@ TEST(GetNeighborsTest, FilterTest) {
   }
 }
 
+TEST(GetNeighborsTest, AggregateTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  TagID player = 1;
+  EdgeType serve = 101;
+  auto serveName = folly::to<std::string>(serve);
+
+  {
+    LOG(INFO) << "GroupByEdgeProp";
+    std::vector<VertexID> vertices = {"LeBron James"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    // group by serve.teamName yield count(*), sum(serve.teamGames), max(serve.startYear)
+    cpp2::AggregateSpec spec;
+    spec.group_keys_ref() = {
+        Expression::encode(*EdgePropertyExpression::make(pool, serveName, "teamName"))};
+    spec.aggregates_ref() = {
+        Expression::encode(
+            *AggregateExpression::make(pool, "COUNT", ConstantExpression::make(pool, "*"))),
+        Expression::encode(*AggregateExpression::make(
+            pool, "SUM", EdgePropertyExpression::make(pool, serveName, "teamGames"))),
+        Expression::encode(*AggregateExpression::make(
+            pool, "MAX", EdgePropertyExpression::make(pool, serveName, "startYear")))};
+    (*req.traverse_spec_ref()).aggregate_ref() = std::move(spec);
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    auto& dataset = *resp.vertices_ref();
+    ASSERT_EQ(4, dataset.colNames.size());
+    std::vector<Row> expected = {
+        Row({"Cavaliers", 2, 548 + 301, 2014}),
+        Row({"Heat", 1, 294, 2010}),
+        Row({"Lakers", 1, 115, 2018}),
+    };
+    auto rows = dataset.rows;
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(expected, rows);
+  }
+  {
+    LOG(INFO) << "AggregateNotMergeable";
+    std::vector<VertexID> vertices = {"LeBron James"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    edges.emplace_back(serve, std::vector<std::string>{"teamName"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    // The partial averages could not be merged
+    cpp2::AggregateSpec spec;
+    spec.aggregates_ref() = {Expression::encode(*AggregateExpression::make(
+        pool, "AVG", EdgePropertyExpression::make(pool, serveName, "teamGames")))};
+    (*req.traverse_spec_ref()).aggregate_ref() = std::move(spec);
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(1, (*resp.result_ref()).failed_parts.size());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_STAT_TYPE,
+              (*resp.result_ref()).failed_parts.front().get_code());
+  }
+}
+
+TEST(GetNeighborsTest, TopNTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  EdgeType serve = 101;
+  auto serveName = folly::to<std::string>(serve);
+
+  {
+    LOG(INFO) << "OrderByEdgePropDesc";
+    std::vector<VertexID> vertices = {"LeBron James", "Dwyane Wade"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "teamGames"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    // order by serve.teamGames desc limit 2
+    cpp2::OrderBy orderBy;
+    orderBy.prop_ref() =
+        Expression::encode(*EdgePropertyExpression::make(pool, serveName, "teamGames"));
+    orderBy.direction_ref() = cpp2::OrderDirection::DESCENDING;
+    (*req.traverse_spec_ref()).order_by_ref() = {orderBy};
+    (*req.traverse_spec_ref()).limit_ref() = 2;
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    auto& dataset = *resp.vertices_ref();
+    ASSERT_EQ(2, dataset.rows.size());
+    // The top 2 edges of LeBron James are 548 and 301 games, and the ones of Dwyane Wade are 855
+    // and 93 games. The edges worse than the top 2 of the request may be dropped as well.
+    std::unordered_set<int64_t> candidates = {548, 301, 855, 93};
+    std::vector<int64_t> games;
+    for (const auto& row : dataset.rows) {
+      ASSERT_TRUE(row[2].isList());
+      const auto& cell = row[2].getList();
+      EXPECT_LE(cell.size(), 2);
+      for (const auto& edge : cell.values) {
+        auto teamGames = edge.getList().values[1].getInt();
+        EXPECT_EQ(1, candidates.count(teamGames));
+        games.emplace_back(teamGames);
+      }
+    }
+    std::sort(games.begin(), games.end(), std::greater<int64_t>());
+    ASSERT_LE(2, games.size());
+    EXPECT_EQ(855, games[0]);
+    EXPECT_EQ(548, games[1]);
+  }
+  {
+    LOG(INFO) << "OrderByEdgePropAsc";
+    std::vector<VertexID> vertices = {"LeBron James"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "teamGames"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    // order by serve.teamGames limit 3
+    cpp2::OrderBy orderBy;
+    orderBy.prop_ref() =
+        Expression::encode(*EdgePropertyExpression::make(pool, serveName, "teamGames"));
+    orderBy.direction_ref() = cpp2::OrderDirection::ASCENDING;
+    (*req.traverse_spec_ref()).order_by_ref() = {orderBy};
+    (*req.traverse_spec_ref()).limit_ref() = 3;
+
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+
+    ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    auto& dataset = *resp.vertices_ref();
+    ASSERT_EQ(1, dataset.rows.size());
+    std::vector<int64_t> games;
+    for (const auto& edge : dataset.rows[0][2].getList().values) {
+      games.emplace_back(edge.getList().values[1].getInt());
+    }
+    std::sort(games.begin(), games.end());
+    EXPECT_EQ((std::vector<int64_t>{115, 294, 301}), games);
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
 
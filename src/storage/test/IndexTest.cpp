@@ -23,6 +23,8 @@
 #include "kvstore/KVIterator.h"
 #include "storage/exec/IndexDedupNode.h"
 #include "storage/exec/IndexEdgeScanNode.h"
+#include "storage/exec/IndexIntersectNode.h"
+#include "storage/exec/IndexKnnNode.h"
 #include "storage/exec/IndexLimitNode.h"
 #include "storage/exec/IndexNode.h"
 #include "storage/exec/IndexProjectionNode.h"
@@ -421,6 +423,178 @@ TEST_F(IndexScanTest, Vertex) {
     }
   }  // End of Case 2
 }
+TEST_F(IndexScanTest, Intersect) {
+  auto rows = R"(
+    int | int | int
+    1   | 1   | 10
+    1   | 2   | 20
+    2   | 1   | 30
+    1   | 1   | 40
+  )"_row;
+  auto schema = R"(
+    a   | int | | false
+    b   | int | | false
+    c   | int | | false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):a
+    (i2,3):b
+  )"_index(schema);
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  for (auto& item : kv[1]) {
+    kvstore->put(item.first, item.second);
+  }
+  for (auto& item : kv[2]) {
+    kvstore->put(item.first, item.second);
+  }
+  // Only put the base data of the vertices hit by both indexes, so the driver would fail on
+  // accessing the others
+  for (auto& item : kv[0]) {
+    auto vid = NebulaKeyUtils::getVertexId(8, item.first).subpiece(0, 1);
+    if (vid == "0" || vid == "3") {
+      kvstore->put(item.first, item.second);
+    }
+  }
+  std::vector<ColumnHint> hintsA{makeColumnHint("a", Value(1))};                      // a=1
+  std::vector<ColumnHint> hintsB{makeColumnHint<true, false>("b", Value(1), Value(2))};  // 1<=b<2
+  auto context = makeContext(1, 0);
+  IndexScanTestHelper helper;
+  auto probe = std::make_unique<IndexVertexScanNode>(context.get(), 2, hintsA, kvstore.get());
+  helper.setIndex(probe.get(), indices[0]);
+  helper.setTag(probe.get(), schema);
+  auto driver = std::make_unique<IndexVertexScanNode>(context.get(), 3, hintsB, kvstore.get());
+  helper.setIndex(driver.get(), indices[1]);
+  helper.setTag(driver.get(), schema);
+  helper.setFatal(driver.get(), true);
+  auto intersect = std::make_unique<IndexIntersectNode>(context.get());
+  intersect->addChild(std::move(probe));
+  intersect->addChild(std::move(driver));
+
+  InitContext initCtx;
+  initCtx.requiredColumns = {kVid, "c"};
+  ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, intersect->init(initCtx));
+  ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, intersect->execute(0));
+  std::vector<Row> result;
+  while (true) {
+    auto res = intersect->next();
+    ASSERT(res.success());
+    if (!res.hasData()) {
+      break;
+    }
+    result.emplace_back(std::move(res).row());
+  }
+  auto expect = R"(
+    string | int
+    0      | 10
+    3      | 40
+  )"_row;
+  std::vector<std::string> colOrder = {kVid, "c"};
+  ASSERT_EQ(result.size(), expect.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    for (size_t j = 0; j < expect[i].size(); j++) {
+      ASSERT_EQ(expect[i][j], result[i][initCtx.retColMap[colOrder[j]]]);
+    }
+  }
+}
+TEST_F(IndexScanTest, MultiRange) {
+  auto rows = R"(
+    int | int | int
+    1   | 5   | 10
+    1   | 15  | 20
+    2   | 12  | 30
+    3   | 20  | 40
+    2   | 8   | 50
+  )"_row;
+  auto schema = R"(
+    a   | int | | false
+    b   | int | | false
+    c   | int | | false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):a,b
+  )"_index(schema);
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  for (auto& item : kv[0]) {
+    kvstore->put(item.first, item.second);
+  }
+  for (auto& item : kv[1]) {
+    kvstore->put(item.first, item.second);
+  }
+  auto check = [&](const std::vector<ColumnHint>& columnHints, bool skipScan, const auto& expect) {
+    auto context = makeContext(1, 0);
+    auto scanNode =
+        std::make_unique<IndexVertexScanNode>(context.get(), 2, columnHints, kvstore.get());
+    IndexScanTestHelper helper;
+    helper.setIndex(scanNode.get(), indices[0]);
+    helper.setTag(scanNode.get(), schema);
+    scanNode->setSkipScan(skipScan);
+    InitContext initCtx;
+    initCtx.requiredColumns = {kVid, "c"};
+    ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, scanNode->init(initCtx));
+    ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, scanNode->execute(0));
+    std::vector<Row> result;
+    while (true) {
+      auto res = scanNode->next();
+      ASSERT(res.success());
+      if (!res.hasData()) {
+        break;
+      }
+      result.emplace_back(std::move(res).row());
+    }
+    std::vector<std::string> colOrder = {kVid, "c"};
+    ASSERT_EQ(result.size(), expect.size());
+    for (size_t i = 0; i < result.size(); i++) {
+      for (size_t j = 0; j < expect[i].size(); j++) {
+        ASSERT_EQ(expect[i][j], result[i][initCtx.retColMap[colOrder[j]]]);
+      }
+    }
+  };
+  {  // Case 1: a IN [3, 1, 3] AND b > 10
+    auto hintA = makeColumnHint("a", Value());
+    hintA.in_values_ref() = std::vector<Value>{Value(3), Value(1), Value(3)};
+    std::vector<ColumnHint> columnHints{hintA, makeBeginColumnHint<false>("b", Value(10))};
+    auto expect = R"(
+      string | int
+      1      | 20
+      3      | 40
+    )"_row;
+    check(columnHints, false, expect);
+  }
+  {  // Case 2: a IN [1, 2] AND b IN [5, 8]
+    auto hintA = makeColumnHint("a", Value());
+    hintA.in_values_ref() = std::vector<Value>{Value(1), Value(2)};
+    auto hintB = makeColumnHint("b", Value());
+    hintB.in_values_ref() = std::vector<Value>{Value(5), Value(8)};
+    auto expect = R"(
+      string | int
+      0      | 10
+      4      | 50
+    )"_row;
+    check({hintA, hintB}, false, expect);
+  }
+  {  // Case 3: skip scan of a, b >= 12
+    std::vector<ColumnHint> columnHints{makeBeginColumnHint<true>("b", Value(12))};
+    auto expect = R"(
+      string | int
+      1      | 20
+      2      | 30
+      3      | 40
+    )"_row;
+    check(columnHints, true, expect);
+  }
+  {  // Case 4: skip scan of a, b == 8
+    std::vector<ColumnHint> columnHints{makeColumnHint("b", Value(8))};
+    auto expect = R"(
+      string | int
+      4      | 50
+    )"_row;
+    check(columnHints, true, expect);
+  }
+}
 TEST_F(IndexScanTest, Edge) {
   auto rows = R"(
     int | int | int
@@ -1865,6 +2039,67 @@ TEST_F(IndexScanTest, Geography) {
   }
 }
 
+TEST_F(IndexScanTest, NearestNeighbors) {
+  auto rows = R"(
+    geography
+    POINT(1.0 1.0)
+    POINT(1.0 1.001)
+    POINT(1.0 1.01)
+    POINT(1.0 1.1)
+    POINT(1.02 1.0)
+    POINT(-50.0 -20.0)
+  )"_row;
+  auto schema = R"(
+    geo   | geography | | false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):geo
+  )"_index(schema);
+  (*indices[0]->fields_ref())[0].type_ref()->geo_shape_ref() = meta::cpp2::GeoShape::POINT;
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  for (auto& iter : kv) {
+    for (auto& item : iter) {
+      kvstore->put(item.first, item.second);
+    }
+  }
+  auto check = [&](int64_t k, const std::vector<std::string>& expect) {
+    cpp2::NearestNeighbors nearest;
+    nearest.column_name_ref() = "geo";
+    nearest.point_ref() = Geography::fromWKT("POINT(1.0 1.0004)").value();
+    nearest.k_ref() = k;
+    auto context = makeContext(1, 0);
+    auto scanNode = std::make_unique<IndexVertexScanNode>(
+        context.get(), 2, std::vector<ColumnHint>{}, kvstore.get());
+    IndexScanTestHelper helper;
+    helper.setIndex(scanNode.get(), indices[0]);
+    helper.setTag(scanNode.get(), schema);
+    auto knnNode = std::make_unique<IndexKnnNode>(context.get(), &nearest);
+    knnNode->addChild(std::move(scanNode));
+    InitContext initCtx;
+    initCtx.requiredColumns = {kVid};
+    ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, knnNode->init(initCtx));
+    ASSERT_EQ(::nebula::cpp2::ErrorCode::SUCCEEDED, knnNode->execute(0));
+    std::vector<std::string> result;
+    while (true) {
+      auto res = knnNode->next();
+      ASSERT(res.success());
+      if (!res.hasData()) {
+        break;
+      }
+      result.emplace_back(res.row()[initCtx.retColMap[kVid]].getStr());
+    }
+    EXPECT_EQ(expect, result);
+  };
+  // Ordered by the distance: 44m, 67m, 1.07km, 2.2km, 11km, far away
+  check(0, {});
+  check(1, {"0"});
+  check(3, {"0", "1", "2"});
+  check(5, {"0", "1", "2", "4", "3"});
+  // The ring grows to the whole sphere
+  check(10, {"0", "1", "2", "4", "3", "5"});
+}
 TEST_F(IndexScanTest, Compound) {
   // TODO(hs.zhang): add unittest
 }
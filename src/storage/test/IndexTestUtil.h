@@ -199,10 +199,12 @@ class MockKVStore : public ::nebula::kvstore::KVStore {
                                           const std::string& start,
                                           const std::string& prefix,
                                           std::unique_ptr<KVIterator>* iter,
-                                          bool canReadFromFollower = false) override {
+                                          bool canReadFromFollower = false,
+                                          const void* snapshot = nullptr) override {
     UNUSED(canReadFromFollower);
     UNUSED(spaceId);
     UNUSED(partId);
+    UNUSED(snapshot);
     CHECK_EQ(spaceId, spaceId_);
     auto mockIter = std::make_unique<MockKVIterator>(kv_, kv_.lower_bound(start));
     mockIter->setValidFunc([prefix](const decltype(kv_)::iterator& it) {
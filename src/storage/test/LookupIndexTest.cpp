@@ -9,6 +9,7 @@
 #include "codec/RowWriterV2.h"
 #include "codec/test/RowWriterV1.h"
 #include "common/base/Base.h"
+#include "common/expression/AggregateExpression.h"
 #include "common/expression/ConstantExpression.h"
 #include "common/expression/LogicalExpression.h"
 #include "common/expression/PropertyExpression.h"
@@ -3552,6 +3553,62 @@ TEST_P(LookupIndexTest, AggregateEdgePropNotInReturnColumnsTest) {
   QueryTestUtils::checkStatResponse(resp, expectStatColumns, expectStatRow);
 }
 
+// stat_columns and aggregate could not be both pushed down
+TEST_P(LookupIndexTest, AggregateWithStatColumnsTest) {
+  fs::TempDir rootPath("/tmp/AggregateWithStatColumnsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  GraphSpaceID spaceId = 1;
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_TRUE(QueryTestUtils::mockVertexData(env, totalParts, true));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  auto* processor = LookupProcessor::instance(env, nullptr, threadPool.get());
+
+  cpp2::LookupIndexRequest req;
+  nebula::storage::cpp2::IndexSpec indices;
+  req.space_id_ref() = spaceId;
+  nebula::cpp2::SchemaID schemaId;
+  schemaId.tag_id_ref() = 1;
+  indices.schema_id_ref() = schemaId;
+  std::vector<PartitionID> parts;
+  for (int32_t p = 1; p <= totalParts; p++) {
+    parts.emplace_back(p);
+  }
+  req.parts_ref() = std::move(parts);
+  req.return_columns_ref() = std::vector<std::string>{kVid, "age"};
+
+  cpp2::IndexQueryContext context;
+  context.filter_ref() = "";
+  context.index_id_ref() = 1;
+  decltype(indices.contexts) contexts;
+  contexts.emplace_back(std::move(context));
+  indices.contexts_ref() = std::move(contexts);
+  req.indices_ref() = std::move(indices);
+
+  cpp2::StatProp statProp;
+  statProp.alias_ref() = "total age";
+  const auto& exp = *TagPropertyExpression::make(pool, folly::to<std::string>(1), "age");
+  statProp.prop_ref() = Expression::encode(exp);
+  statProp.stat_ref() = cpp2::StatType::SUM;
+  req.stat_columns_ref() = std::vector<cpp2::StatProp>{std::move(statProp)};
+
+  cpp2::AggregateSpec spec;
+  spec.aggregates_ref() = std::vector<std::string>{Expression::encode(
+      *AggregateExpression::make(pool, "COUNT", ConstantExpression::make(pool, "*")))};
+  req.aggregate_ref() = std::move(spec);
+
+  auto fut = processor->getFuture();
+  processor->process(req);
+  auto resp = std::move(fut).get();
+
+  ASSERT_EQ(totalParts, resp.result.failed_parts.size());
+  for (const auto& part : resp.result.failed_parts) {
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_INVALID_PARM, part.code);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(Lookup_concurrently, LookupIndexTest, ::testing::Values(false, true));
 
 }  // namespace storage
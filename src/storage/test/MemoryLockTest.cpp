@@ -3,6 +3,7 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <folly/synchronization/Baton.h>
 #include <gtest/gtest.h>
 
 #include "common/base/Base.h"
@@ -122,6 +123,116 @@ TEST_F(MemoryLockTest, DedupTest) {
   EXPECT_EQ(0, mlock.size());
 }
 
+TEST_F(MemoryLockTest, WaitTest) {
+  MemoryLockCore<std::string> mlock;
+  {
+    // locked in place if nobody holds the keys
+    bool locked = false;
+    mlock.lockBatchAsync({"1", "2"}, std::chrono::seconds(10), [&](bool ok) { locked = ok; });
+    EXPECT_TRUE(locked);
+    EXPECT_EQ(2, mlock.size());
+    mlock.unlockBatch(std::vector<std::string>{"1", "2"});
+    EXPECT_EQ(0, mlock.size());
+  }
+  {
+    // fail in place without waiting
+    EXPECT_TRUE(mlock.try_lock("2"));
+    bool called = false;
+    mlock.lockBatchAsync({"1", "2"}, std::chrono::milliseconds(0), [&](bool ok) {
+      EXPECT_FALSE(ok);
+      called = true;
+    });
+    EXPECT_TRUE(called);
+    // locked keys are released on failure
+    EXPECT_EQ(1, mlock.size());
+    mlock.unlock("2");
+  }
+  {
+    // timeout when the holder does not release the key
+    EXPECT_TRUE(mlock.try_lock("2"));
+    folly::Baton<> baton;
+    bool locked = true;
+    mlock.lockBatchAsync({"1", "2", "3"}, std::chrono::milliseconds(10), [&](bool ok) {
+      locked = ok;
+      baton.post();
+    });
+    baton.wait();
+    EXPECT_FALSE(locked);
+    EXPECT_EQ(1, mlock.size());
+    mlock.unlock("2");
+    EXPECT_EQ(0, mlock.size());
+  }
+  {
+    // the key is handed over to the waiter once released, and the rest keys are locked then
+    EXPECT_TRUE(mlock.try_lock("2"));
+    folly::Baton<> baton;
+    bool locked = false;
+    mlock.lockBatchAsync({"1", "2", "3"}, std::chrono::seconds(10), [&](bool ok) {
+      locked = ok;
+      baton.post();
+    });
+    // the caller is not blocked, only the keys before the held one are locked
+    EXPECT_FALSE(baton.ready());
+    EXPECT_EQ(2, mlock.size());
+    mlock.unlock("2");
+    baton.wait();
+    EXPECT_TRUE(locked);
+    EXPECT_EQ(3, mlock.size());
+    mlock.unlockBatch(std::vector<std::string>{"1", "2", "3"});
+    EXPECT_EQ(0, mlock.size());
+  }
+}
+
+TEST_F(MemoryLockTest, FifoTest) {
+  MemoryLockCore<std::string> mlock;
+  EXPECT_TRUE(mlock.try_lock("1"));
+  std::mutex lock;
+  std::vector<int> order;
+  std::vector<std::unique_ptr<folly::Baton<>>> batons;
+  for (int i = 0; i < 4; i++) {
+    batons.emplace_back(std::make_unique<folly::Baton<>>());
+    auto* baton = batons.back().get();
+    // the waiters are queued in place, in order
+    mlock.lockBatchAsync({"1"}, std::chrono::seconds(10), [&, i, baton](bool ok) {
+      EXPECT_TRUE(ok);
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        order.emplace_back(i);
+      }
+      mlock.unlock("1");
+      baton->post();
+    });
+  }
+  mlock.unlock("1");
+  for (auto& baton : batons) {
+    baton->wait();
+  }
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), order);
+  EXPECT_EQ(0, mlock.size());
+}
+
+TEST_F(MemoryLockTest, ExpiredWaiterTest) {
+  MemoryLockCore<std::string> mlock;
+  EXPECT_TRUE(mlock.try_lock("1"));
+  folly::Baton<> expired;
+  mlock.lockBatchAsync({"1"}, std::chrono::milliseconds(10), [&](bool ok) {
+    EXPECT_FALSE(ok);
+    expired.post();
+  });
+  folly::Baton<> granted;
+  mlock.lockBatchAsync({"1"}, std::chrono::seconds(10), [&](bool ok) {
+    EXPECT_TRUE(ok);
+    granted.post();
+  });
+  expired.wait();
+  // the expired waiter is skipped
+  mlock.unlock("1");
+  granted.wait();
+  EXPECT_EQ(1, mlock.size());
+  mlock.unlock("1");
+  EXPECT_EQ(0, mlock.size());
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,428 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "common/base/Base.h"
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/fs/TempDir.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/RocksEngine.h"
+#include "mock/AdHocSchemaManager.h"
+#include "mock/MockCluster.h"
+#include "storage/MergeOperator.h"
+#include "storage/mutate/UpdateVertexProcessor.h"
+
+DECLARE_bool(enable_merge_update);
+
+namespace nebula {
+namespace storage {
+
+const GraphSpaceID kSpaceId = 1;
+const TagID kTagId = 1;
+const size_t kVIdLen = 32;
+
+class MergeOperatorTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    schemaMan_ = std::make_unique<mock::AdHocSchemaManager>();
+    std::shared_ptr<meta::NebulaSchemaProvider> schema(new meta::NebulaSchemaProvider(0));
+    schema->addField("count",
+                     nebula::cpp2::PropertyType::INT64,
+                     0,
+                     false,
+                     ConstantExpression::make(&pool_, 0L)->encode());
+    schema->addField("score", nebula::cpp2::PropertyType::DOUBLE, 0, true);
+    schema->addField("log",
+                     nebula::cpp2::PropertyType::STRING,
+                     0,
+                     false,
+                     ConstantExpression::make(&pool_, "")->encode());
+    schema->addField("small",
+                     nebula::cpp2::PropertyType::INT8,
+                     0,
+                     false,
+                     ConstantExpression::make(&pool_, 0L)->encode());
+    schemaMan_->addTagSchema(kSpaceId, kTagId, schema);
+  }
+
+  std::unique_ptr<kvstore::RocksEngine> newEngine(const char* path) {
+    auto mergeOp = std::make_shared<NebulaOperator>(schemaMan_.get(), kSpaceId, kVIdLen);
+    return std::make_unique<kvstore::RocksEngine>(kSpaceId, kVIdLen, path, "", mergeOp);
+  }
+
+  void merge(kvstore::RocksEngine* engine,
+             const std::string& key,
+             std::vector<MergeOperand::Item> items) {
+    auto batch = engine->startBatchWrite();
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              batch->merge(key, MergeOperand::encode(0, items)));
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              engine->commitBatchWrite(std::move(batch), false, false, true));
+  }
+
+  // Merge the operands into the existing value by the merge operator directly
+  std::string fullMerge(const std::string& key,
+                        const std::string* existing,
+                        const std::vector<std::string>& operands) {
+    auto mergeOp = std::make_shared<NebulaOperator>(schemaMan_.get(), kSpaceId, kVIdLen);
+    rocksdb::Slice existingSlice;
+    if (existing != nullptr) {
+      existingSlice = *existing;
+    }
+    std::vector<rocksdb::Slice> operandList(operands.begin(), operands.end());
+    rocksdb::MergeOperator::MergeOperationInput in(
+        key, existing != nullptr ? &existingSlice : nullptr, operandList, nullptr);
+    std::string result;
+    rocksdb::Slice existingOperand;
+    rocksdb::MergeOperator::MergeOperationOutput out(result, existingOperand);
+    EXPECT_TRUE(std::static_pointer_cast<rocksdb::MergeOperator>(mergeOp)->FullMergeV2(in, &out));
+    return result;
+  }
+
+  Value readRow(const std::string& row, const std::string& prop) {
+    auto reader = RowReaderWrapper::getTagPropReader(schemaMan_.get(), kSpaceId, kTagId, row);
+    EXPECT_TRUE(!!reader);
+    return reader ? reader->getValueByName(prop) : Value();
+  }
+
+  Value read(kvstore::RocksEngine* engine, const std::string& key, const std::string& prop) {
+    std::string val;
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get(key, &val));
+    auto reader = RowReaderWrapper::getTagPropReader(schemaMan_.get(), kSpaceId, kTagId, val);
+    EXPECT_TRUE(!!reader);
+    return reader->getValueByName(prop);
+  }
+
+ protected:
+  ObjectPool pool_;
+  std::unique_ptr<mock::AdHocSchemaManager> schemaMan_;
+};
+
+TEST_F(MergeOperatorTest, EncodeAndDecode) {
+  std::vector<MergeOperand::Item> items = {{MergeOperand::Op::kAdd, "count", 1L},
+                                           {MergeOperand::Op::kAdd, "score", 1.5},
+                                           {MergeOperand::Op::kAppend, "log", "abc"}};
+  auto encoded = MergeOperand::encode(2, items, 100);
+  SchemaVer ver;
+  int64_t ts;
+  std::vector<MergeOperand::Item> decoded;
+  ASSERT_TRUE(MergeOperand::decode(encoded, &ver, &ts, &decoded));
+  EXPECT_EQ(2, ver);
+  EXPECT_EQ(100, ts);
+  ASSERT_EQ(3, decoded.size());
+  for (size_t i = 0; i < items.size(); i++) {
+    EXPECT_EQ(items[i].op, decoded[i].op);
+    EXPECT_EQ(items[i].name, decoded[i].name);
+    EXPECT_EQ(items[i].value, decoded[i].value);
+  }
+  decoded.clear();
+  EXPECT_FALSE(MergeOperand::decode(encoded.substr(0, encoded.size() - 1), &ver, &ts, &decoded));
+}
+
+TEST_F(MergeOperatorTest, MergeWithoutExistingRow) {
+  fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+  auto engine = newEngine(rootPath.path());
+  auto key = NebulaKeyUtils::tagKey(kVIdLen, 1, "vertex", kTagId);
+  for (int i = 0; i < 10; i++) {
+    merge(engine.get(), key, {{MergeOperand::Op::kAdd, "count", 1L}});
+  }
+  merge(engine.get(), key, {{MergeOperand::Op::kAppend, "log", "a"}});
+  merge(engine.get(), key, {{MergeOperand::Op::kAppend, "log", "b"}});
+
+  EXPECT_EQ(Value(10L), read(engine.get(), key, "count"));
+  EXPECT_EQ(Value("ab"), read(engine.get(), key, "log"));
+  // null + 1.0 is still null, the same as read-modify-write
+  EXPECT_TRUE(read(engine.get(), key, "score").isNull());
+
+  // operands are folded into the row after compaction
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->compact());
+  EXPECT_EQ(Value(10L), read(engine.get(), key, "count"));
+  EXPECT_EQ(Value("ab"), read(engine.get(), key, "log"));
+}
+
+TEST_F(MergeOperatorTest, MergeWithExistingRow) {
+  fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+  auto engine = newEngine(rootPath.path());
+  auto key = NebulaKeyUtils::tagKey(kVIdLen, 1, "vertex", kTagId);
+  {
+    auto schema = schemaMan_->getTagSchema(kSpaceId, kTagId);
+    RowWriterV2 writer(schema.get());
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("count", 100L));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("score", 1.0));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("log", "x"));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("small", 0L));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.finish());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put(key, writer.moveEncodedStr()));
+  }
+  merge(engine.get(),
+        key,
+        {{MergeOperand::Op::kAdd, "count", -10L},
+         {MergeOperand::Op::kAdd, "score", 0.5},
+         {MergeOperand::Op::kAppend, "log", "y"}});
+  // bad type and unknown prop are skipped
+  merge(engine.get(),
+        key,
+        {{MergeOperand::Op::kAdd, "count", "z"}, {MergeOperand::Op::kAdd, "unknown", 1L}});
+
+  EXPECT_EQ(Value(90L), read(engine.get(), key, "count"));
+  EXPECT_EQ(Value(1.5), read(engine.get(), key, "score"));
+  EXPECT_EQ(Value("xy"), read(engine.get(), key, "log"));
+}
+
+TEST_F(MergeOperatorTest, Overflow) {
+  fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+  auto engine = newEngine(rootPath.path());
+  auto key = NebulaKeyUtils::tagKey(kVIdLen, 1, "vertex", kTagId);
+  // 100 + 100 is out of the range of INT8, the operand is skipped and the row is still readable
+  merge(engine.get(), key, {{MergeOperand::Op::kAdd, "small", 100L}});
+  merge(engine.get(), key, {{MergeOperand::Op::kAdd, "small", 100L}});
+  merge(engine.get(), key, {{MergeOperand::Op::kAdd, "small", 20L}});
+  EXPECT_EQ(Value(120L), read(engine.get(), key, "small"));
+
+  // the same for INT64
+  auto max = std::numeric_limits<int64_t>::max();
+  merge(engine.get(), key, {{MergeOperand::Op::kAdd, "count", max}});
+  merge(engine.get(), key, {{MergeOperand::Op::kAdd, "count", 1L}});
+  EXPECT_EQ(Value(max), read(engine.get(), key, "count"));
+
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->compact());
+  EXPECT_EQ(Value(120L), read(engine.get(), key, "small"));
+  EXPECT_EQ(Value(max), read(engine.get(), key, "count"));
+  merge(engine.get(), key, {{MergeOperand::Op::kAdd, "small", -121L}});
+  EXPECT_EQ(Value(-1L), read(engine.get(), key, "small"));
+}
+
+TEST_F(MergeOperatorTest, PartialMergeNeverFolds) {
+  std::shared_ptr<rocksdb::MergeOperator> mergeOp =
+      std::make_shared<NebulaOperator>(schemaMan_.get(), kSpaceId, kVIdLen);
+  auto key = NebulaKeyUtils::tagKey(kVIdLen, 1, "vertex", kTagId);
+  auto left = MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "count", 1L}}, 1);
+  auto right = MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "count", 1L}}, 2);
+  std::string merged;
+  ASSERT_TRUE(mergeOp->PartialMerge(key, left, right, &merged, nullptr));
+  // the items are concatenated in order, with the timestamp of the later one
+  SchemaVer ver;
+  int64_t ts;
+  std::vector<MergeOperand::Item> items;
+  ASSERT_TRUE(MergeOperand::decode(merged, &ver, &ts, &items));
+  ASSERT_EQ(2, items.size());
+  EXPECT_EQ(0, ver);
+  EXPECT_EQ(2, ts);
+
+  // the operands of different schema versions are kept apart
+  right = MergeOperand::encode(1, {{MergeOperand::Op::kAdd, "count", 1L}});
+  EXPECT_FALSE(mergeOp->PartialMerge(key, left, right, &merged, nullptr));
+}
+
+TEST_F(MergeOperatorTest, SameRowOfAnyMergeOrder) {
+  auto key = NebulaKeyUtils::tagKey(kVIdLen, 1, "vertex", kTagId);
+  // 100 + 20 + 10 is out of the range of INT8, so the third one is skipped. It would not be if
+  // the last two were summed up before merging.
+  std::vector<std::string> operands = {
+      MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "small", 100L}}, 1),
+      MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "small", 20L}}, 2),
+      MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "small", 10L}}, 3),
+      MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "small", -10L}}, 4)};
+  auto once = fullMerge(key, nullptr, operands);
+  EXPECT_EQ(Value(110L), readRow(once, "small"));
+
+  // merged into the row one by one, e.g. by compaction between each write
+  std::string row;
+  for (size_t i = 0; i < operands.size(); i++) {
+    row = fullMerge(key, i == 0 ? nullptr : &row, {operands[i]});
+  }
+  EXPECT_EQ(once, row);
+
+  // partial merged first
+  std::shared_ptr<rocksdb::MergeOperator> mergeOp =
+      std::make_shared<NebulaOperator>(schemaMan_.get(), kSpaceId, kVIdLen);
+  std::string left;
+  std::string right;
+  ASSERT_TRUE(mergeOp->PartialMerge(key, operands[0], operands[1], &left, nullptr));
+  ASSERT_TRUE(mergeOp->PartialMerge(key, operands[2], operands[3], &right, nullptr));
+  EXPECT_EQ(once, fullMerge(key, nullptr, {left, right}));
+}
+
+TEST_F(MergeOperatorTest, PendingSchema) {
+  auto key = NebulaKeyUtils::tagKey(kVIdLen, 1, "vertex", kTagId);
+  auto row =
+      fullMerge(key, nullptr, {MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "count", 1L}})});
+  // The operand is written by a leader which knows the schema version 1, but this replica does not
+  std::vector<std::string> operands = {
+      MergeOperand::encode(1, {{MergeOperand::Op::kAdd, "count", 1L}}),
+      MergeOperand::encode(1, {{MergeOperand::Op::kAdd, "games", 2L}})};
+  auto pending = fullMerge(key, &row, operands);
+  EXPECT_TRUE(NebulaOperator::isPending(pending));
+  EXPECT_FALSE(RowReaderWrapper::getTagPropReader(schemaMan_.get(), kSpaceId, kTagId, pending));
+  // Still pending if more operands come
+  auto more = MergeOperand::encode(0, {{MergeOperand::Op::kAdd, "count", 1L}});
+  pending = fullMerge(key, &pending, {more});
+  EXPECT_TRUE(NebulaOperator::isPending(pending));
+
+  // The schema version 1 is known by this replica
+  std::shared_ptr<meta::NebulaSchemaProvider> schema(new meta::NebulaSchemaProvider(1));
+  auto oldSchema = schemaMan_->getTagSchema(kSpaceId, kTagId, 0);
+  for (size_t i = 0; i < oldSchema->getNumFields(); i++) {
+    auto field = oldSchema->field(i);
+    schema->addField(field->name(),
+                     field->type(),
+                     0,
+                     field->nullable(),
+                     field->hasDefault() ? field->defaultValue() : "");
+  }
+  schema->addField("games",
+                   nebula::cpp2::PropertyType::INT64,
+                   0,
+                   false,
+                   ConstantExpression::make(&pool_, 0L)->encode());
+  schemaMan_->addTagSchema(kSpaceId, kTagId, schema);
+
+  std::string resolved;
+  NebulaOperator mergeOp(schemaMan_.get(), kSpaceId, kVIdLen);
+  ASSERT_TRUE(mergeOp.resolvePending(key, pending, &resolved));
+  EXPECT_EQ(Value(3L), readRow(resolved, "count"));
+  EXPECT_EQ(Value(2L), readRow(resolved, "games"));
+  // The same as the replica which knows the schema all the time
+  operands.emplace_back(std::move(more));
+  EXPECT_EQ(fullMerge(key, &row, operands), resolved);
+}
+
+TEST_F(MergeOperatorTest, UpsertByProcessor) {
+  fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto parts = cluster.getTotalParts();
+  auto spaceVidLen = env->schemaMan_->getSpaceVidLen(kSpaceId).value();
+
+  // A tag without index, each prop of which has a default value
+  TagID tagId = 100;
+  {
+    std::shared_ptr<meta::NebulaSchemaProvider> schema(new meta::NebulaSchemaProvider(0));
+    schema->addField("count",
+                     nebula::cpp2::PropertyType::INT64,
+                     0,
+                     false,
+                     ConstantExpression::make(&pool_, 0L)->encode());
+    schema->addField("small",
+                     nebula::cpp2::PropertyType::INT8,
+                     0,
+                     false,
+                     ConstantExpression::make(&pool_, 0L)->encode());
+    static_cast<mock::AdHocSchemaManager*>(cluster.schemaMan_.get())
+        ->addTagSchema(kSpaceId, tagId, schema);
+  }
+
+  VertexID vId("Tim Duncan");
+  PartitionID partId = std::hash<std::string>()(vId) % parts + 1;
+  auto upsert = [&](const std::string& prop, int64_t delta) {
+    cpp2::UpdateVertexRequest req;
+    req.space_id_ref() = kSpaceId;
+    req.part_id_ref() = partId;
+    req.vertex_id_ref() = vId;
+    req.tag_id_ref() = tagId;
+    req.insertable_ref() = true;
+    cpp2::UpdatedProp updatedProp;
+    updatedProp.name_ref() = prop;
+    auto* self = SourcePropertyExpression::make(&pool_, folly::to<std::string>(tagId), prop);
+    updatedProp.value_ref() = Expression::encode(
+        *ArithmeticExpression::makeAdd(&pool_, self, ConstantExpression::make(&pool_, delta)));
+    req.updated_props_ref() = {updatedProp};
+
+    auto* processor = UpdateVertexProcessor::instance(env, nullptr);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+  };
+  auto get = [&](const std::string& prop) {
+    std::string val;
+    auto key = NebulaKeyUtils::tagKey(spaceVidLen, partId, vId, tagId);
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, env->kvstore_->get(kSpaceId, partId, key, &val));
+    auto reader = RowReaderWrapper::getTagPropReader(env->schemaMan_, kSpaceId, tagId, val);
+    EXPECT_TRUE(!!reader);
+    return reader ? reader->getValueByName(prop) : Value();
+  };
+
+  FLAGS_enable_merge_update = true;
+  for (int i = 0; i < 3; i++) {
+    upsert("count", 1);
+  }
+  upsert("small", 100);
+  // out of the range of INT8, skipped when merging
+  upsert("small", 100);
+  upsert("small", -1);
+  EXPECT_EQ(Value(3L), get("count"));
+  EXPECT_EQ(Value(99L), get("small"));
+
+  // the operands are folded into the row by compaction
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, env->kvstore_->flush(kSpaceId));
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, env->kvstore_->compact(kSpaceId));
+  EXPECT_EQ(Value(3L), get("count"));
+  EXPECT_EQ(Value(99L), get("small"));
+  upsert("count", -5);
+  EXPECT_EQ(Value(-2L), get("count"));
+  FLAGS_enable_merge_update = false;
+}
+
+TEST_F(MergeOperatorTest, FromUpdatedProps) {
+  auto schema = schemaMan_->getTagSchema(kSpaceId, kTagId);
+  auto updatedProp = [](const std::string& name, Expression* expr) {
+    cpp2::UpdatedProp prop;
+    prop.name_ref() = name;
+    prop.value_ref() = Expression::encode(*expr);
+    return prop;
+  };
+  auto self = [this](const std::string& name) {
+    return SourcePropertyExpression::make(&pool_, "tag", name);
+  };
+  auto constant = [this](Value v) { return ConstantExpression::make(&pool_, std::move(v)); };
+  {
+    std::vector<cpp2::UpdatedProp> props = {
+        updatedProp("count", ArithmeticExpression::makeAdd(&pool_, self("count"), constant(1L))),
+        updatedProp("score", ArithmeticExpression::makeMinus(&pool_, self("score"), constant(2L))),
+        updatedProp("log", ArithmeticExpression::makeAdd(&pool_, self("log"), constant("s")))};
+    auto items = MergeOperand::fromUpdatedProps(schema.get(), props);
+    ASSERT_TRUE(items.has_value());
+    ASSERT_EQ(3, items->size());
+    EXPECT_EQ(Value(1L), (*items)[0].value);
+    EXPECT_EQ(Value(-2.0), (*items)[1].value);
+    EXPECT_EQ(MergeOperand::Op::kAppend, (*items)[2].op);
+  }
+  {
+    // assignment needs the read-modify-write plan
+    std::vector<cpp2::UpdatedProp> props = {updatedProp("count", constant(1L))};
+    EXPECT_FALSE(MergeOperand::fromUpdatedProps(schema.get(), props).has_value());
+  }
+  {
+    // prepend is not supported
+    std::vector<cpp2::UpdatedProp> props = {
+        updatedProp("log", ArithmeticExpression::makeAdd(&pool_, constant("s"), self("log")))};
+    EXPECT_FALSE(MergeOperand::fromUpdatedProps(schema.get(), props).has_value());
+  }
+  {
+    // depends on other prop
+    std::vector<cpp2::UpdatedProp> props = {
+        updatedProp("count", ArithmeticExpression::makeAdd(&pool_, self("score"), constant(1L)))};
+    EXPECT_FALSE(MergeOperand::fromUpdatedProps(schema.get(), props).has_value());
+  }
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  return RUN_ALL_TESTS();
+}
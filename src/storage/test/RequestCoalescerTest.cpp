@@ -0,0 +1,394 @@
+/* Copyright (c) 2022 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/init/Init.h>
+#include <folly/io/async/EventBase.h>
+#include <gtest/gtest.h>
+
+#include "clients/storage/RequestCoalescer.h"
+#include "clients/storage/stats/StorageClientStats.h"
+#include "common/base/Base.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * The fake storage of coalescer, which records the requests sent and returns a row of each input
+ * vertex, or fails with the exception if it is set.
+ */
+template <class Request, class Response>
+class FakeSender {
+ public:
+  using SendFunc = typename RequestSender<Request, Response>::SendFunc;
+
+  SendFunc send() {
+    return [this](const Request& req) {
+      sent_.emplace_back(req);
+      if (fail_) {
+        return folly::makeFuture<Response>(std::runtime_error("storage is down"));
+      }
+      Response resp;
+      cpp2::ResponseCommon result;
+      result.failed_parts_ref() = failedParts_;
+      resp.result_ref() = std::move(result);
+      DataSet ds({kVid, "name"});
+      for (const auto& part : req.get_parts()) {
+        for (const auto& row : part.second) {
+          ds.rows.emplace_back(List({row.values.front(), row.values.front().getStr() + "_name"}));
+        }
+      }
+      setDataSet(resp, std::move(ds));
+      return folly::makeFuture<Response>(std::move(resp));
+    };
+  }
+
+  static void setDataSet(cpp2::GetPropResponse& resp, DataSet&& ds) {
+    resp.props_ref() = std::move(ds);
+  }
+
+  static void setDataSet(cpp2::GetNeighborsResponse& resp, DataSet&& ds) {
+    resp.vertices_ref() = std::move(ds);
+  }
+
+  std::vector<Request> sent_;
+  std::vector<cpp2::PartitionResult> failedParts_;
+  bool fail_{false};
+};
+
+using FakePropSender = FakeSender<cpp2::GetPropRequest, cpp2::GetPropResponse>;
+using FakeNeighborsSender = FakeSender<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse>;
+
+class RequestCoalescerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    FLAGS_storage_client_coalesce_window_ms = 0;
+    FLAGS_storage_client_coalesce_max_rows = 1024;
+  }
+
+  static cpp2::GetPropRequest propRequest(
+      const std::unordered_map<PartitionID, std::vector<std::string>>& parts, bool dedup = false) {
+    cpp2::GetPropRequest req;
+    req.space_id_ref() = 1;
+    for (const auto& [partId, vids] : parts) {
+      auto& rows = (*req.parts_ref())[partId];
+      for (const auto& vid : vids) {
+        rows.emplace_back(List({vid}));
+      }
+    }
+    cpp2::VertexProp prop;
+    prop.tag_ref() = 1;
+    prop.props_ref() = {"name"};
+    req.vertex_props_ref() = {prop};
+    req.dedup_ref() = dedup;
+    cpp2::RequestCommon common;
+    common.session_id_ref() = 1;
+    req.common_ref() = std::move(common);
+    return req;
+  }
+
+  static cpp2::GetNeighborsRequest neighborsRequest(
+      const std::unordered_map<PartitionID, std::vector<std::string>>& parts) {
+    cpp2::GetNeighborsRequest req;
+    req.space_id_ref() = 1;
+    req.column_names_ref() = {kVid};
+    for (const auto& [partId, vids] : parts) {
+      auto& rows = (*req.parts_ref())[partId];
+      for (const auto& vid : vids) {
+        rows.emplace_back(List({vid}));
+      }
+    }
+    cpp2::TraverseSpec spec;
+    spec.edge_types_ref() = {1};
+    req.traverse_spec_ref() = std::move(spec);
+    return req;
+  }
+
+  // The sorted vertex ids of rows
+  static std::vector<std::string> vids(const DataSet* ds) {
+    std::vector<std::string> result;
+    if (ds != nullptr) {
+      for (const auto& row : ds->rows) {
+        result.emplace_back(row.values.front().getStr());
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  static std::vector<std::string> vids(const std::vector<Row>& rows) {
+    std::vector<std::string> result;
+    for (const auto& row : rows) {
+      result.emplace_back(row.values.front().getStr());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  folly::EventBase evb_;
+  HostAddr host_{"127.0.0.1", 9779};
+};
+
+TEST_F(RequestCoalescerTest, MergeCallers) {
+  GetPropCoalescer coalescer;
+  FakePropSender sender;
+  auto req1 = propRequest({{1, {"a", "b"}}});
+  auto req2 = propRequest({{1, {"b", "c"}}, {2, {"d"}}});
+  auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+  auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+  // sent in the following loop
+  EXPECT_TRUE(sender.sent_.empty());
+  evb_.loopOnce();
+
+  ASSERT_EQ(1, sender.sent_.size());
+  const auto& merged = sender.sent_.front();
+  EXPECT_FALSE(merged.common_ref().has_value());
+  ASSERT_EQ(2, merged.get_parts().size());
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), vids(merged.get_parts().at(1)));
+  EXPECT_EQ((std::vector<std::string>{"d"}), vids(merged.get_parts().at(2)));
+
+  ASSERT_TRUE(f1.isReady());
+  ASSERT_TRUE(f2.isReady());
+  auto resp1 = std::move(f1).get();
+  auto resp2 = std::move(f2).get();
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), vids(resp1.get_props()));
+  EXPECT_EQ((std::vector<std::string>{"b", "c", "d"}), vids(resp2.get_props()));
+  EXPECT_EQ((std::vector<std::string>{kVid, "name"}), resp1.get_props()->colNames);
+  for (const auto& row : resp2.get_props()->rows) {
+    EXPECT_EQ(row.values[0].getStr() + "_name", row.values[1].getStr());
+  }
+
+  // The request which has different props is not merged
+  auto req3 = propRequest({{1, {"a"}}});
+  auto req4 = propRequest({{1, {"a"}}}, true);
+  auto f3 = coalescer.submit(&evb_, host_, req3, sender.send());
+  auto f4 = coalescer.submit(&evb_, host_, req4, sender.send());
+  evb_.loopOnce();
+  EXPECT_EQ(3, sender.sent_.size());
+  EXPECT_TRUE(std::move(f3).get().get_props() != nullptr);
+  EXPECT_TRUE(std::move(f4).get().get_props() != nullptr);
+}
+
+TEST_F(RequestCoalescerTest, DedupByPart) {
+  {
+    LOG(INFO) << "The duplicated vertices of GetNeighbors are read once and returned to each";
+    GetNeighborsCoalescer coalescer;
+    FakeNeighborsSender sender;
+    auto req1 = neighborsRequest({{1, {"a", "a", "b"}}});
+    auto req2 = neighborsRequest({{1, {"a"}}});
+    auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+    auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+    evb_.loopOnce();
+    ASSERT_EQ(1, sender.sent_.size());
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), vids(sender.sent_.front().get_parts().at(1)));
+    EXPECT_EQ((std::vector<std::string>{"a", "a", "b"}), vids(std::move(f1).get().get_vertices()));
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f2).get().get_vertices()));
+  }
+  {
+    LOG(INFO) << "GetProp with dedup returns each vertex once";
+    GetPropCoalescer coalescer;
+    FakePropSender sender;
+    auto req1 = propRequest({{1, {"a", "a"}}, {2, {"b"}}}, true);
+    auto req2 = propRequest({{1, {"a"}}}, true);
+    auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+    auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+    evb_.loopOnce();
+    ASSERT_EQ(1, sender.sent_.size());
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(sender.sent_.front().get_parts().at(1)));
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), vids(std::move(f1).get().get_props()));
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f2).get().get_props()));
+  }
+  {
+    LOG(INFO) << "GetProp without dedup returns each input row";
+    GetPropCoalescer coalescer;
+    FakePropSender sender;
+    auto req1 = propRequest({{1, {"a", "a"}}});
+    auto req2 = propRequest({{1, {"a"}}});
+    auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+    auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+    evb_.loopOnce();
+    ASSERT_EQ(1, sender.sent_.size());
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(sender.sent_.front().get_parts().at(1)));
+    EXPECT_EQ((std::vector<std::string>{"a", "a"}), vids(std::move(f1).get().get_props()));
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f2).get().get_props()));
+  }
+}
+
+TEST_F(RequestCoalescerTest, FailedPartsOfCaller) {
+  GetPropCoalescer coalescer;
+  FakePropSender sender;
+  for (PartitionID partId : {1, 2}) {
+    cpp2::PartitionResult failed;
+    failed.code_ref() = nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
+    failed.part_id_ref() = partId;
+    sender.failedParts_.emplace_back(std::move(failed));
+  }
+  auto req1 = propRequest({{1, {"a"}}, {3, {"c"}}});
+  auto req2 = propRequest({{2, {"b"}}});
+  auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+  auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+  evb_.loopOnce();
+  ASSERT_EQ(1, sender.sent_.size());
+
+  auto resp1 = std::move(f1).get();
+  ASSERT_EQ(1, resp1.get_result().get_failed_parts().size());
+  EXPECT_EQ(1, resp1.get_result().get_failed_parts().front().get_part_id());
+  auto resp2 = std::move(f2).get();
+  ASSERT_EQ(1, resp2.get_result().get_failed_parts().size());
+  EXPECT_EQ(2, resp2.get_result().get_failed_parts().front().get_part_id());
+}
+
+TEST_F(RequestCoalescerTest, ExceptionToAllCallers) {
+  GetNeighborsCoalescer coalescer;
+  FakeNeighborsSender sender;
+  sender.fail_ = true;
+  auto req1 = neighborsRequest({{1, {"a"}}});
+  auto req2 = neighborsRequest({{2, {"b"}}});
+  auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+  auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+  evb_.loopOnce();
+  ASSERT_EQ(1, sender.sent_.size());
+  auto t1 = std::move(f1).getTry();
+  auto t2 = std::move(f2).getTry();
+  ASSERT_TRUE(t1.hasException());
+  ASSERT_TRUE(t2.hasException());
+  EXPECT_NE(std::string::npos, t1.exception().what().find("storage is down"));
+  EXPECT_NE(std::string::npos, t2.exception().what().find("storage is down"));
+}
+
+TEST_F(RequestCoalescerTest, FlushAtMaxRows) {
+  FLAGS_storage_client_coalesce_max_rows = 3;
+  GetPropCoalescer coalescer;
+  FakePropSender sender;
+  auto req1 = propRequest({{1, {"a", "b"}}});
+  auto req2 = propRequest({{1, {"c", "d"}}});
+  auto req3 = propRequest({{1, {"e"}}});
+  auto req4 = propRequest({{1, {"f"}}});
+  auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+  auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+  // The batch is full and sent at once
+  ASSERT_EQ(1, sender.sent_.size());
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c", "d"}),
+            vids(sender.sent_.front().get_parts().at(1)));
+  EXPECT_TRUE(f1.isReady());
+  EXPECT_TRUE(f2.isReady());
+
+  // The following requests go to a new batch, which is not flushed by the loop callback of the
+  // full batch before the loop
+  auto f3 = coalescer.submit(&evb_, host_, req3, sender.send());
+  auto f4 = coalescer.submit(&evb_, host_, req4, sender.send());
+  EXPECT_EQ(1, sender.sent_.size());
+  evb_.loopOnce();
+  ASSERT_EQ(2, sender.sent_.size());
+  EXPECT_EQ((std::vector<std::string>{"e", "f"}), vids(sender.sent_.back().get_parts().at(1)));
+
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), vids(std::move(f1).get().get_props()));
+  EXPECT_EQ((std::vector<std::string>{"c", "d"}), vids(std::move(f2).get().get_props()));
+  EXPECT_EQ((std::vector<std::string>{"e"}), vids(std::move(f3).get().get_props()));
+  EXPECT_EQ((std::vector<std::string>{"f"}), vids(std::move(f4).get().get_props()));
+
+  // No more rpc by the pending callbacks
+  evb_.loopOnce();
+  EXPECT_EQ(2, sender.sent_.size());
+}
+
+TEST_F(RequestCoalescerTest, NeighborsNotMerged) {
+  std::vector<cpp2::GetNeighborsRequest> reqs;
+  {
+    auto req = neighborsRequest({{1, {"a"}}});
+    cpp2::RequestCommon common;
+    common.profile_detail_ref() = true;
+    req.common_ref() = std::move(common);
+    reqs.emplace_back(std::move(req));
+  }
+  {
+    auto req = neighborsRequest({{1, {"a"}}});
+    req.traverse_spec_ref()->local_steps_ref() = 1;
+    reqs.emplace_back(std::move(req));
+  }
+  {
+    auto req = neighborsRequest({{1, {"a"}}});
+    req.traverse_spec_ref()->aggregate_ref() = cpp2::AggregateSpec();
+    reqs.emplace_back(std::move(req));
+  }
+  {
+    auto req = neighborsRequest({{1, {"a"}}});
+    req.traverse_spec_ref()->order_by_ref() = {cpp2::OrderBy()};
+    reqs.emplace_back(std::move(req));
+  }
+  for (const auto& req : reqs) {
+    GetNeighborsCoalescer coalescer;
+    FakeNeighborsSender sender;
+    // Sent as it is at once, even if there is another request the same
+    auto f1 = coalescer.submit(&evb_, host_, req, sender.send());
+    auto f2 = coalescer.submit(&evb_, host_, req, sender.send());
+    ASSERT_EQ(2, sender.sent_.size());
+    EXPECT_EQ(req, sender.sent_.front());
+    EXPECT_EQ(req, sender.sent_.back());
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f1).get().get_vertices()));
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f2).get().get_vertices()));
+  }
+}
+
+TEST_F(RequestCoalescerTest, PropNotMerged) {
+  std::vector<cpp2::GetPropRequest> reqs;
+  {
+    auto req = propRequest({{1, {"a"}}});
+    req.common_ref()->profile_detail_ref() = true;
+    reqs.emplace_back(std::move(req));
+  }
+  {
+    auto req = propRequest({{1, {"a"}}});
+    req.vertex_props_ref().reset();
+    cpp2::EdgeProp prop;
+    prop.type_ref() = 1;
+    req.edge_props_ref() = {prop};
+    reqs.emplace_back(std::move(req));
+  }
+  {
+    auto req = propRequest({{1, {"a"}}});
+    req.limit_ref() = 10;
+    reqs.emplace_back(std::move(req));
+  }
+  {
+    auto req = propRequest({{1, {"a"}}});
+    req.order_by_ref() = {cpp2::OrderBy()};
+    reqs.emplace_back(std::move(req));
+  }
+  for (const auto& req : reqs) {
+    GetPropCoalescer coalescer;
+    FakePropSender sender;
+    auto f1 = coalescer.submit(&evb_, host_, req, sender.send());
+    auto f2 = coalescer.submit(&evb_, host_, req, sender.send());
+    ASSERT_EQ(2, sender.sent_.size());
+    EXPECT_EQ(req, sender.sent_.front());
+    EXPECT_EQ(req, sender.sent_.back());
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f1).get().get_props()));
+    EXPECT_EQ((std::vector<std::string>{"a"}), vids(std::move(f2).get().get_props()));
+  }
+
+  // An empty order by or the max limit could still be merged
+  auto req1 = propRequest({{1, {"a"}}});
+  req1.order_by_ref() = std::vector<cpp2::OrderBy>();
+  req1.limit_ref() = std::numeric_limits<int64_t>::max();
+  auto req2 = req1;
+  GetPropCoalescer coalescer;
+  FakePropSender sender;
+  auto f1 = coalescer.submit(&evb_, host_, req1, sender.send());
+  auto f2 = coalescer.submit(&evb_, host_, req2, sender.send());
+  EXPECT_TRUE(sender.sent_.empty());
+  evb_.loopOnce();
+  EXPECT_EQ(1, sender.sent_.size());
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+  nebula::initStorageClientStats();
+  return RUN_ALL_TESTS();
+}
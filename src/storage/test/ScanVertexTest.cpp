@@ -8,6 +8,7 @@
 
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
+#include "storage/ScanSnapshotManager.h"
 #include "storage/query/ScanVertexProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -501,6 +502,203 @@ TEST(ScanVertexTest, FilterTest) {
   }
 }
 
+TEST(ScanVertexTest, SnapshotTest) {
+  fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+  TagID player = 1;
+  auto tag = std::make_pair(player, std::vector<std::string>{kVid, "name"});
+  auto scan = [&](PartitionID partId, const cpp2::ScanCursor& cursor, bool enableSnapshot) {
+    auto req = buildRequest({partId}, {""}, {tag}, 3);
+    (*req.parts_ref())[partId] = cursor;
+    req.enable_snapshot_ref() = enableSnapshot;
+    auto* processor = ScanVertexProcessor::instance(env, nullptr);
+    auto f = processor->getFuture();
+    processor->process(req);
+    return std::move(f).get();
+  };
+
+  {
+    LOG(INFO) << "Remove the vertices after the first page, the following pages read the snapshot";
+    size_t totalRowCount = 0;
+    for (PartitionID partId = 1; partId <= totalParts; partId++) {
+      cpp2::ScanCursor cursor;
+      bool removed = false;
+      while (true) {
+        auto resp = scan(partId, cursor, true);
+        ASSERT_EQ(0, resp.result.failed_parts.size());
+        ASSERT_LE(resp.props_ref()->rows.size(), 3);
+        checkResponse(*resp.props_ref(), tag, tag.second.size() + 1 /* kVid */, totalRowCount);
+        if (!removed) {
+          auto prefix = NebulaKeyUtils::tagPrefix(partId);
+          folly::Baton<true, std::atomic> baton;
+          env->kvstore_->asyncRemoveRange(
+              1, partId, prefix, prefix + std::string(64, '\xFF'), [&](auto code) {
+                EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+                baton.post();
+              });
+          baton.wait();
+          removed = true;
+        }
+        cursor = resp.get_cursors().at(partId);
+        if (!cursor.next_cursor_ref().has_value()) {
+          EXPECT_FALSE(cursor.snapshot_id_ref().has_value());
+          break;
+        }
+        EXPECT_TRUE(cursor.snapshot_id_ref().has_value());
+      }
+    }
+    EXPECT_EQ(mock::MockData::players_.size(), totalRowCount);
+    // all snapshots are released once the parts are done
+    EXPECT_EQ(0, env->scanSnapshots_->size());
+  }
+  {
+    LOG(INFO) << "The vertices have been removed";
+    for (PartitionID partId = 1; partId <= totalParts; partId++) {
+      auto resp = scan(partId, cpp2::ScanCursor(), false);
+      ASSERT_EQ(0, resp.result.failed_parts.size());
+      EXPECT_EQ(0, resp.props_ref()->rows.size());
+    }
+  }
+  {
+    LOG(INFO) << "The snapshot lease is not found";
+    cpp2::ScanCursor cursor;
+    cursor.snapshot_id_ref() = 1;
+    auto resp = scan(1, cursor, true);
+    ASSERT_EQ(1, resp.result.failed_parts.size());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::E_SCAN_SNAPSHOT_EXPIRED,
+              resp.result.failed_parts.front().get_code());
+  }
+}
+
+TEST(ScanVertexTest, ResumeWithoutLease) {
+  fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+  TagID player = 1;
+  auto tag = std::make_pair(player, std::vector<std::string>{kVid, "name"});
+  LOG(INFO) << "Every page pins a new snapshot by the pending ranges in cursor, no row is "
+               "returned twice";
+  size_t totalRowCount = 0;
+  for (PartitionID partId = 1; partId <= totalParts; partId++) {
+    cpp2::ScanCursor cursor;
+    while (true) {
+      auto req = buildRequest({partId}, {""}, {tag}, 3);
+      (*req.parts_ref())[partId] = cursor;
+      // the lease is lost, only the first page enables snapshot explicitly
+      req.enable_snapshot_ref() = !cursor.next_cursor_ref().has_value();
+      auto* processor = ScanVertexProcessor::instance(env, nullptr);
+      auto f = processor->getFuture();
+      processor->process(req);
+      auto resp = std::move(f).get();
+      ASSERT_EQ(0, resp.result.failed_parts.size());
+      checkResponse(*resp.props_ref(), tag, tag.second.size() + 1 /* kVid */, totalRowCount);
+      cursor = resp.get_cursors().at(partId);
+      if (!cursor.next_cursor_ref().has_value()) {
+        break;
+      }
+      cursor.snapshot_id_ref().reset();
+    }
+  }
+  EXPECT_EQ(mock::MockData::players_.size(), totalRowCount);
+}
+
+TEST(ScanVertexTest, SplitRanges) {
+  std::string prefix = "p";
+  {
+    LOG(INFO) << "Split evenly by the first byte if the size is unknown";
+    auto ranges = ScanSnapshotManager::splitRanges(prefix, "", 1, 4, nullptr);
+    ASSERT_EQ(4, ranges.size());
+    EXPECT_EQ("p", ranges[0].start);
+    EXPECT_EQ(std::string("p\x40"), ranges[0].end);
+    EXPECT_EQ(std::string("p\xC0"), ranges[3].start);
+    EXPECT_TRUE(ranges[3].end.empty());
+
+    // the keys before cursor are skipped
+    auto cursor = std::string("p\x80") + "abc";
+    ranges = ScanSnapshotManager::splitRanges(prefix, cursor, 1, 2, nullptr);
+    ASSERT_EQ(2, ranges.size());
+    EXPECT_EQ(cursor, ranges[0].start);
+    EXPECT_EQ(std::string("p\xC0"), ranges[0].end);
+  }
+  {
+    LOG(INFO) << "Split the ascii vids by size";
+    // 100 vertices with two tags each, all vids begin with 'v'
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; i++) {
+      auto vid = folly::stringPrintf("v%02d", i);
+      keys.emplace_back(prefix + vid + "1");
+      keys.emplace_back(prefix + vid + "2");
+    }
+    auto sizeOf = [&keys](const std::string& start, const std::string& end) {
+      return static_cast<int64_t>(std::count_if(keys.begin(), keys.end(), [&](const auto& key) {
+        return key >= start && key < end;
+      }));
+    };
+    auto ranges = ScanSnapshotManager::splitRanges(prefix, "", 3, 4, sizeOf);
+    ASSERT_EQ(4, ranges.size());
+    EXPECT_EQ(prefix, ranges.front().start);
+    EXPECT_TRUE(ranges.back().end.empty());
+    for (size_t i = 0; i < ranges.size(); i++) {
+      auto end = ranges[i].end.empty() ? std::string("q") : ranges[i].end;
+      auto size = sizeOf(ranges[i].start, end);
+      EXPECT_LE(45, size);
+      EXPECT_GE(55, size);
+      // the keys of one vertex are in the same range
+      EXPECT_EQ(0, size % 2);
+      if (i > 0) {
+        EXPECT_EQ(ranges[i - 1].end, ranges[i].start);
+      }
+    }
+
+    // continue from cursor
+    auto cursor = prefix + "v50" + "1";
+    ranges = ScanSnapshotManager::splitRanges(prefix, cursor, 3, 2, sizeOf);
+    ASSERT_EQ(2, ranges.size());
+    EXPECT_EQ(cursor, ranges[0].start);
+    EXPECT_LE(45, sizeOf(cursor, ranges[0].end));
+    EXPECT_GE(53, sizeOf(cursor, ranges[0].end));
+  }
+
+  EXPECT_EQ((std::vector<int64_t>{2, 2, 1}), ScanSnapshotManager::splitLimit(5, 3));
+  EXPECT_EQ((std::vector<int64_t>{1, 1, 0}), ScanSnapshotManager::splitLimit(2, 3));
+}
+
+TEST(ScanVertexTest, RangesCursor) {
+  std::string prefix = "p";
+  std::vector<ScanSnapshotManager::Range> ranges{{"pa", "pb"}, {"pc", "pd"}, {"pe", ""}};
+  auto cursor = ScanSnapshotManager::encodeCursor(ranges);
+  ASSERT_TRUE(ScanSnapshotManager::isRangesCursor(cursor));
+  std::vector<ScanSnapshotManager::Range> decoded;
+  ASSERT_TRUE(ScanSnapshotManager::decodeCursor(prefix, cursor, &decoded));
+  ASSERT_EQ(3, decoded.size());
+  for (size_t i = 0; i < ranges.size(); i++) {
+    EXPECT_EQ(ranges[i].start, decoded[i].start);
+    EXPECT_EQ(ranges[i].end, decoded[i].end);
+  }
+
+  // The last range is returned as a plain key
+  cursor = ScanSnapshotManager::encodeCursor({{"pe", ""}});
+  EXPECT_EQ("pe", cursor);
+  EXPECT_FALSE(ScanSnapshotManager::isRangesCursor(cursor));
+
+  // broken or out of the prefix
+  cursor = ScanSnapshotManager::encodeCursor(ranges);
+  EXPECT_FALSE(ScanSnapshotManager::decodeCursor(
+      prefix, cursor.substr(0, cursor.size() - 1), &decoded));
+  EXPECT_FALSE(ScanSnapshotManager::decodeCursor("q", cursor, &decoded));
+  cursor = ScanSnapshotManager::encodeCursor({{"pc", "pd"}, {"pa", "pb"}});
+  EXPECT_FALSE(ScanSnapshotManager::decodeCursor(prefix, cursor, &decoded));
+}
+
 }  // namespace storage
 }  // namespace nebula
 
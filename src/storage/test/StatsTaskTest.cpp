@@ -14,8 +14,13 @@
 #include "storage/admin/StatsTask.h"
 #include "storage/mutate/AddEdgesProcessor.h"
 #include "storage/mutate/AddVerticesProcessor.h"
+#include "storage/test/QueryTestUtils.h"
 #include "storage/test/TestUtils.h"
 
+DECLARE_bool(enable_online_stats);
+DECLARE_bool(mock_ttl_col);
+DECLARE_int32(mock_ttl_duration);
+
 namespace nebula {
 namespace storage {
 
@@ -389,6 +394,84 @@ TEST_F(StatsTaskTest, StatsTagAndEdgeData) {
   }
 }
 
+// The online stats are not used for the space with ttl, so the data expired and removed by
+// compaction is not counted
+TEST(OnlineStatsTest, ScanSpaceWithTtl) {
+  FLAGS_enable_online_stats = true;
+  FLAGS_mock_ttl_col = true;
+  FLAGS_mock_ttl_duration = 1;
+
+  fs::TempDir rootPath("/tmp/OnlineStatsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path(), HostAddr("", 0), 1, true, false, {}, true);
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  GraphSpaceID spaceId = 1;
+  ASSERT_TRUE(QueryTestUtils::mockVertexData(env, totalParts));
+
+  auto stats = [&]() {
+    cpp2::TaskPara parameter;
+    parameter.space_id_ref() = spaceId;
+    std::vector<PartitionID> parts;
+    for (PartitionID partId = 1; partId <= totalParts; partId++) {
+      parts.emplace_back(partId);
+    }
+    parameter.parts_ref() = std::move(parts);
+    cpp2::AddTaskRequest request;
+    request.cmd_ref() = meta::cpp2::AdminCmd::STATS;
+    request.job_id_ref() = ++gJobId;
+    request.task_id_ref() = 15;
+    request.para_ref() = std::move(parameter);
+
+    nebula::meta::cpp2::StatsItem statsItem;
+    auto callback = [&](nebula::cpp2::ErrorCode ret, nebula::meta::cpp2::StatsItem& result) {
+      if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {
+        statsItem = std::move(result);
+      }
+    };
+    StatsTask task(env, TaskContext(request, callback));
+    auto subTasks = task.genSubTasks();
+    EXPECT_TRUE(nebula::ok(subTasks));
+    auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
+    for (auto& subTask : nebula::value(subTasks)) {
+      auto ret = subTask.invoke();
+      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        code = ret;
+      }
+    }
+    task.finish(code);
+    return statsItem;
+  };
+
+  {
+    auto statsItem = stats();
+    ASSERT_EQ(nebula::meta::cpp2::JobStatus::FINISHED, statsItem.get_status());
+    EXPECT_EQ(mock::MockData::players_.size(), statsItem.get_tag_vertices().at("1"));
+    EXPECT_EQ(mock::MockData::teams_.size(), statsItem.get_tag_vertices().at("2"));
+  }
+
+  LOG(INFO) << "Compact after the players expired";
+  sleep(FLAGS_mock_ttl_duration + 1);
+  auto* ns = dynamic_cast<kvstore::NebulaStore*>(env->kvstore_);
+  ns->compact(spaceId);
+  {
+    auto statsItem = stats();
+    ASSERT_EQ(nebula::meta::cpp2::JobStatus::FINISHED, statsItem.get_status());
+    EXPECT_EQ(0, statsItem.get_tag_vertices().at("1"));
+    EXPECT_EQ(mock::MockData::teams_.size(), statsItem.get_tag_vertices().at("2"));
+    EXPECT_EQ(mock::MockData::teams_.size(), *statsItem.space_vertices_ref());
+  }
+  // The part is scanned without building the online stats
+  for (PartitionID partId = 1; partId <= totalParts; partId++) {
+    auto part = env->kvstore_->part(spaceId, partId);
+    ASSERT_TRUE(nebula::ok(part));
+    EXPECT_FALSE(nebula::value(part)->stats().has_value());
+  }
+
+  FLAGS_mock_ttl_col = false;
+  FLAGS_enable_online_stats = false;
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -38,7 +38,30 @@ Feature: Lookup edge index full scan
       """
       LOOKUP ON edge_1 WHERE edge_1.col1_str =~ "\\w+\\d+" YIELD edge_1.col1_str
       """
-    Then a SemanticError should be raised at runtime: Expression (edge_1.col1_str=~"\w+\d+") is not supported, please use full-text index as an optimal solution
+    Then the result should be, in any order:
+      | edge_1.col1_str |
+      | "Red1"          |
+    When executing query:
+      """
+      LOOKUP ON edge_1 WHERE edge_1.col1_str =~ "Re\\w*" YIELD edge_1.col1_str
+      """
+    Then the result should be, in any order:
+      | edge_1.col1_str |
+      | "Red1"          |
+    When executing query:
+      """
+      LOOKUP ON edge_1 WHERE edge_1.col1_str =~ "Bl(ue|ack)" OR edge_1.col1_str =~ "Y.*w" YIELD edge_1.col1_str
+      """
+    Then the result should be, in any order:
+      | edge_1.col1_str |
+      | "Blue"          |
+      | "Yellow"        |
+    When executing query:
+      """
+      LOOKUP ON edge_1 WHERE edge_1.col1_str =~ "Re" YIELD edge_1.col1_str
+      """
+    Then the result should be, in any order:
+      | edge_1.col1_str |
 
   Scenario: Edge with relational NE filter
     When profiling query:
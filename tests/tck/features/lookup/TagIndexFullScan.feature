@@ -6,9 +6,19 @@ Feature: Lookup tag index full scan
   Scenario: Tag with relational RegExp filter[1]
     When executing query:
       """
-      LOOKUP ON team where team.name =~ "\\d+\\w+" YIELD vertex as node
+      LOOKUP ON team where team.name =~ "\\d+\\w+" YIELD id(vertex) as id
       """
-    Then a SemanticError should be raised at runtime: Expression (team.name=~"\d+\w+") is not supported, please use full-text index as an optimal solution
+    Then the result should be, in any order:
+      | id      |
+      | "76ers" |
+    When executing query:
+      """
+      LOOKUP ON team where team.name =~ "B.+s" YIELD id(vertex) as id
+      """
+    Then the result should be, in any order:
+      | id      |
+      | "Bucks" |
+      | "Bulls" |
 
   Scenario: Tag with relational NE filter
     When profiling query:
@@ -0,0 +1,106 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Geo knn index scan rule
+
+  Background:
+    Given an empty graph
+    And create a space with following options:
+      | partition_num  | 9                |
+      | replica_factor | 1                |
+      | vid_type       | FIXED_STRING(30) |
+      | charset        | utf8             |
+      | collate        | utf8_bin         |
+    And having executed:
+      """
+      CREATE TAG pt(geo geography(point) NOT NULL);
+      CREATE TAG pt_null(geo geography(point));
+      """
+    And wait 3 seconds
+    And having executed:
+      """
+      CREATE TAG INDEX pt_geo_index ON pt(geo);
+      CREATE TAG INDEX pt_null_geo_index ON pt_null(geo);
+      """
+    And wait 3 seconds
+    And having executed:
+      """
+      INSERT VERTEX pt(geo) VALUES
+        "1":(ST_Point(0, 1)),
+        "2":(ST_Point(0, 2)),
+        "3":(ST_Point(0, 3)),
+        "4":(ST_Point(3, 3)),
+        "5":(ST_Point(0, 0.5));
+      INSERT VERTEX pt_null(geo) VALUES
+        "1":(ST_Point(0, 1)),
+        "2":(ST_Point(0, 2)),
+        "3":(NULL);
+      """
+
+  Scenario: search the k nearest neighbors on the geography index
+    When profiling query:
+      """
+      LOOKUP ON pt YIELD id(vertex) AS id, ST_Distance(pt.geo, ST_Point(0, 0)) AS d |
+      ORDER BY $-.d |
+      LIMIT 3
+      """
+    Then the result should be, in order:
+      | id  | d        |
+      | "5" | /[\d.]+/ |
+      | "1" | /[\d.]+/ |
+      | "2" | /[\d.]+/ |
+    And the execution plan should be:
+      | id | name             | dependencies | operator info                                                 |
+      | 4  | DataCollect      | 5            |                                                               |
+      | 5  | TopN             | 6            |                                                               |
+      | 6  | Project          | 7            |                                                               |
+      | 7  | TagIndexFullScan | 0            | {"indexCtx": {"nearestNeighbors": {"column": "geo", "k": 3}}} |
+      | 0  | Start            |              |                                                               |
+    When profiling query:
+      """
+      LOOKUP ON pt YIELD id(vertex) AS id, ST_Distance(ST_Point(3, 3.1), pt.geo) AS d |
+      ORDER BY $-.d |
+      LIMIT 1, 2
+      """
+    Then the result should be, in order:
+      | id  | d        |
+      | "3" | /[\d.]+/ |
+      | "2" | /[\d.]+/ |
+    And the execution plan should be:
+      | id | name             | dependencies | operator info                                                 |
+      | 4  | DataCollect      | 5            |                                                               |
+      | 5  | TopN             | 6            |                                                               |
+      | 6  | Project          | 7            |                                                               |
+      | 7  | TagIndexFullScan | 0            | {"indexCtx": {"nearestNeighbors": {"column": "geo", "k": 3}}} |
+      | 0  | Start            |              |                                                               |
+
+  Scenario: keep the full scan of a nullable geography column
+    # NULL is sorted after all distances but not found around the point
+    When profiling query:
+      """
+      LOOKUP ON pt_null YIELD id(vertex) AS id, ST_Distance(pt_null.geo, ST_Point(0, 0)) AS d |
+      ORDER BY $-.d |
+      LIMIT 3
+      """
+    Then the result should be, in order:
+      | id  | d        |
+      | "1" | /[\d.]+/ |
+      | "2" | /[\d.]+/ |
+      | "3" | BAD_TYPE |
+    And the execution plan should be:
+      | id | name             | dependencies | operator info |
+      | 4  | DataCollect      | 5            |               |
+      | 5  | TopN             | 6            |               |
+      | 6  | Project          | 7            |               |
+      | 7  | TagIndexFullScan | 0            |               |
+      | 0  | Start            |              |               |
+    When executing query:
+      """
+      LOOKUP ON pt_null YIELD id(vertex) AS id, ST_Distance(pt_null.geo, ST_Point(0, 0)) AS d |
+      ORDER BY $-.d |
+      LIMIT 2
+      """
+    Then the result should be, in order:
+      | id  | d        |
+      | "1" | /[\d.]+/ |
+      | "2" | /[\d.]+/ |
@@ -0,0 +1,79 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Push Aggregate down storage rule
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: push aggregate down to GetNeighbors
+    When profiling query:
+      """
+      GO FROM "LeBron James" OVER serve
+      YIELD serve._dst AS team, serve.start_year AS start_year |
+      GROUP BY $-.team YIELD $-.team AS team, count(*) AS cnt, max($-.start_year) AS last
+      """
+    Then the result should be, in any order:
+      | team        | cnt | last |
+      | "Cavaliers" | 2   | 2014 |
+      | "Heat"      | 1   | 2010 |
+      | "Lakers"    | 1   | 2018 |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info |
+      | 4  | Aggregate    | 5            |               |
+      | 5  | GetNeighbors | 0            |               |
+      | 0  | Start        |              |               |
+
+  Scenario: push sum of numeric properties down to GetNeighbors
+    When profiling query:
+      """
+      GO FROM "LeBron James" OVER serve
+      YIELD serve._dst AS team, serve.end_year - serve.start_year AS years |
+      GROUP BY $-.team YIELD $-.team AS team, sum($-.years) AS years
+      """
+    Then the result should be, in any order:
+      | team        | years |
+      | "Cavaliers" | 11    |
+      | "Heat"      | 4     |
+      | "Lakers"    | 1     |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info |
+      | 4  | Aggregate    | 5            |               |
+      | 5  | GetNeighbors | 0            |               |
+      | 0  | Start        |              |               |
+
+  Scenario: not push aggregates which could not be merged
+    When profiling query:
+      """
+      GO FROM "LeBron James" OVER serve
+      YIELD serve._dst AS team, serve.start_year AS start_year |
+      GROUP BY $-.team YIELD $-.team AS team, avg($-.start_year) AS start_year
+      """
+    Then the result should be, in any order:
+      | team        | start_year |
+      | "Cavaliers" | 2008.5     |
+      | "Heat"      | 2010.0     |
+      | "Lakers"    | 2018.0     |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info |
+      | 4  | Aggregate    | 3            |               |
+      | 3  | Project      | 2            |               |
+      | 2  | GetNeighbors | 0            |               |
+      | 0  | Start        |              |               |
+
+  Scenario: not push aggregate down to GetNeighbors with properties of source vertex
+    When profiling query:
+      """
+      GO FROM "LeBron James" OVER serve
+      YIELD $^.player.name AS name, serve._dst AS team |
+      GROUP BY $-.name YIELD $-.name AS name, count(*) AS cnt
+      """
+    Then the result should be, in any order:
+      | name           | cnt |
+      | "LeBron James" | 4   |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info |
+      | 4  | Aggregate    | 3            |               |
+      | 3  | Project      | 2            |               |
+      | 2  | GetNeighbors | 0            |               |
+      | 0  | Start        |              |               |
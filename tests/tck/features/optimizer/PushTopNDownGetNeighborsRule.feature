@@ -0,0 +1,48 @@
+# Copyright (c) 2022 vesoft inc. All rights reserved.
+#
+# This source code is licensed under Apache 2.0 License.
+Feature: Push TopN down GetNeighbors rule
+
+  Background:
+    Given a graph with space named "nba"
+
+  Scenario: push topn down to GetNeighbors
+    When profiling query:
+      """
+      GO 1 STEPS FROM "Marco Belinelli" OVER like
+      YIELD like.likeness AS likeness |
+      ORDER BY $-.likeness |
+      LIMIT 2
+      """
+    Then the result should be, in order:
+      | likeness |
+      | 50       |
+      | 55       |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info  |
+      | 0  | DataCollect  | 1            |                |
+      | 1  | TopN         | 2            |                |
+      | 2  | Project      | 3            |                |
+      | 3  | GetNeighbors | 4            | {"limit": "2"} |
+      | 4  | Start        |              |                |
+
+  Scenario: push topn down to GetNeighbors of multiple vertices
+    When profiling query:
+      """
+      GO 1 STEPS FROM "Marco Belinelli", "Tim Duncan" OVER like
+      YIELD like.likeness AS likeness |
+      ORDER BY $-.likeness DESC |
+      LIMIT 3
+      """
+    Then the result should be, in order:
+      | likeness |
+      | 95       |
+      | 95       |
+      | 60       |
+    And the execution plan should be:
+      | id | name         | dependencies | operator info  |
+      | 0  | DataCollect  | 1            |                |
+      | 1  | TopN         | 2            |                |
+      | 2  | Project      | 3            |                |
+      | 3  | GetNeighbors | 4            | {"limit": "3"} |
+      | 4  | Start        |              |                |